@@ -0,0 +1,275 @@
+/*
+ * If not stated otherwise in this file or this component's license file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2024 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/**
+ * @file AampBufferPool.cpp
+ * @brief Size classed memory pool backing AampGrowableBuffer
+ */
+
+#include "AampBufferPool.h"
+#include "AampLogManager.h"
+#include <glib.h>
+#include <cstring>
+
+std::atomic<bool> AampBufferPool::sEnabled(false);
+
+/**
+ * @brief AampBufferPool Constructor
+ */
+AampBufferPool::AampBufferPool() : mClasses(), mBytesInUse(0), mPeakBytesInUse(0), mBytesCached(0), mHits(0), mMisses(0)
+{
+	for( int i = 0; i < AAMP_BUFFER_POOL_NUM_CLASSES; i++ )
+	{ // 4K, 6K, 8K, 12K, 16K ... 32M; worst case slack is 50% instead of 100% for plain power of two classes
+		size_t base = (size_t)AAMP_BUFFER_POOL_MIN_CLASS_SIZE << (i/2);
+		mClasses[i].size = (i%2) ? (base + base/2) : base;
+	}
+	for( auto &expected : mExpectedSize )
+	{
+		expected = 0;
+	}
+}
+
+/**
+ * @brief AampBufferPool Destructor
+ */
+AampBufferPool::~AampBufferPool()
+{
+	Trim();
+}
+
+/**
+ * @brief Get the singleton instance of the pool
+ */
+AampBufferPool& AampBufferPool::GetInstance()
+{
+	static AampBufferPool instance;
+	return instance;
+}
+
+/**
+ * @brief Enable or disable pooled allocation for new AampGrowableBuffer allocations
+ */
+void AampBufferPool::SetEnabled(bool enable)
+{
+	sEnabled = enable;
+}
+
+/**
+ * @brief Check if pooled allocation is enabled
+ */
+bool AampBufferPool::IsEnabled()
+{
+	return sEnabled;
+}
+
+/**
+ * @brief Find the smallest size class that fits size
+ */
+int AampBufferPool::GetClassIndex(size_t size)
+{
+	int index = -1;
+	for( int i = 0; i < AAMP_BUFFER_POOL_NUM_CLASSES; i++ )
+	{
+		if( size <= mClasses[i].size )
+		{
+			index = i;
+			break;
+		}
+	}
+	return index;
+}
+
+/**
+ * @brief Add to the in use accounting and update the high watermark
+ */
+void AampBufferPool::AddInUse(size_t size)
+{
+	size_t inUse = (mBytesInUse += size);
+	size_t peak = mPeakBytesInUse;
+	while( inUse > peak && !mPeakBytesInUse.compare_exchange_weak(peak, inUse) )
+	{
+	}
+}
+
+/**
+ * @brief Allocate a block of at least size bytes
+ */
+void *AampBufferPool::Allocate(size_t size, size_t &allocated)
+{
+	void *ptr = NULL;
+	allocated = 0;
+	int index = GetClassIndex(size);
+	if( index >= 0 )
+	{
+		SizeClass &sizeClass = mClasses[index];
+		{
+			std::lock_guard<std::mutex> lock(sizeClass.mutex);
+			if( !sizeClass.freeList.empty() )
+			{
+				ptr = sizeClass.freeList.back();
+				sizeClass.freeList.pop_back();
+				mBytesCached -= sizeClass.size;
+			}
+		}
+		if( ptr )
+		{
+			mHits++;
+		}
+		else
+		{
+			mMisses++;
+			ptr = g_malloc(sizeClass.size);
+		}
+		if( ptr )
+		{
+			allocated = sizeClass.size;
+		}
+	}
+	else
+	{ // too big to be worth retaining, plain heap allocation
+		mMisses++;
+		ptr = g_malloc(size);
+		if( ptr )
+		{
+			allocated = size;
+		}
+	}
+	if( ptr )
+	{
+		AddInUse(allocated);
+	}
+	return ptr;
+}
+
+/**
+ * @brief Grow a block, preserving its content
+ */
+void *AampBufferPool::Reallocate(void *ptr, size_t len, size_t avail, size_t size, size_t &allocated)
+{
+	void *mem = Allocate(size, allocated);
+	if( mem && ptr )
+	{
+		memcpy(mem, ptr, len);
+		Release(ptr, avail);
+	}
+	return mem;
+}
+
+/**
+ * @brief Return a block to the pool
+ */
+void AampBufferPool::Release(void *ptr, size_t avail)
+{
+	if( ptr )
+	{
+		bool cached = false;
+		mBytesInUse -= avail;
+		int index = GetClassIndex(avail);
+		if( index >= 0 && mClasses[index].size == avail )
+		{
+			SizeClass &sizeClass = mClasses[index];
+			std::lock_guard<std::mutex> lock(sizeClass.mutex);
+			if( sizeClass.freeList.size() < AAMP_BUFFER_POOL_MAX_FREE_PER_CLASS &&
+				mBytesCached + avail <= AAMP_BUFFER_POOL_MAX_CACHED_BYTES )
+			{
+				sizeClass.freeList.push_back(ptr);
+				mBytesCached += avail;
+				cached = true;
+			}
+		}
+		if( !cached )
+		{
+			g_free(ptr);
+		}
+	}
+}
+
+/**
+ * @brief Account for a block whose ownership was handed over outside of the pool
+ */
+void AampBufferPool::Detach(size_t avail)
+{
+	mBytesInUse -= avail;
+}
+
+/**
+ * @brief Record the size of a completed download, to learn the expected size per media type
+ */
+void AampBufferPool::UpdateExpectedSize(AampMediaType mediaType, size_t size)
+{
+	if( mediaType >= eMEDIATYPE_VIDEO && mediaType <= eMEDIATYPE_DEFAULT && size )
+	{
+		size_t expected = mExpectedSize[mediaType];
+		// running average, weighted towards history so that a single odd sized download has little effect
+		mExpectedSize[mediaType] = expected ? ((expected * 7 + size) / 8) : size;
+	}
+}
+
+/**
+ * @brief Get the learned expected download size of a media type
+ */
+size_t AampBufferPool::GetExpectedSize(AampMediaType mediaType)
+{
+	size_t expected = 0;
+	if( mediaType >= eMEDIATYPE_VIDEO && mediaType <= eMEDIATYPE_DEFAULT )
+	{
+		expected = mExpectedSize[mediaType];
+	}
+	return expected;
+}
+
+/**
+ * @brief Get a snapshot of pool statistics
+ */
+void AampBufferPool::GetStats(AampBufferPoolStats &stats)
+{
+	stats.bytesInUse = mBytesInUse;
+	stats.peakBytesInUse = mPeakBytesInUse;
+	stats.bytesCached = mBytesCached;
+	stats.hits = mHits;
+	stats.misses = mMisses;
+}
+
+/**
+ * @brief Log pool statistics
+ */
+void AampBufferPool::LogStats()
+{
+	AampBufferPoolStats stats;
+	GetStats(stats);
+	AAMPLOG_MIL("BufferPool inUse=%zu peak=%zu cached=%zu hits=%zu misses=%zu hitRate=%.2f",
+				stats.bytesInUse, stats.peakBytesInUse, stats.bytesCached, stats.hits, stats.misses, stats.GetHitRate());
+}
+
+/**
+ * @brief Release all cached free blocks back to the heap
+ */
+void AampBufferPool::Trim()
+{
+	for( auto &sizeClass : mClasses )
+	{
+		std::lock_guard<std::mutex> lock(sizeClass.mutex);
+		for( auto ptr : sizeClass.freeList )
+		{
+			g_free(ptr);
+			mBytesCached -= sizeClass.size;
+		}
+		sizeClass.freeList.clear();
+	}
+}
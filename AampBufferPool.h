@@ -0,0 +1,209 @@
+/*
+ * If not stated otherwise in this file or this component's license file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2024 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/**
+ * @file AampBufferPool.h
+ * @brief Size classed memory pool backing AampGrowableBuffer
+ */
+
+#ifndef __AAMP_BUFFER_POOL_H__
+#define __AAMP_BUFFER_POOL_H__
+
+#include <stddef.h>
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include "AampMediaType.h"
+
+#define AAMP_BUFFER_POOL_MIN_CLASS_SIZE		(4*1024)			/**< Smallest size class */
+#define AAMP_BUFFER_POOL_MAX_CLASS_SIZE		(32*1024*1024)		/**< Largest size class; bigger requests bypass the pool */
+#define AAMP_BUFFER_POOL_NUM_CLASSES		27					/**< Power of two classes with a 1.5x step in between, 4KB..32MB */
+#define AAMP_BUFFER_POOL_MAX_FREE_PER_CLASS	8					/**< Max free blocks retained per size class */
+#define AAMP_BUFFER_POOL_MAX_CACHED_BYTES	(64*1024*1024)		/**< Max total bytes retained in free lists */
+
+/**
+ * @struct AampBufferPoolStats
+ * @brief Snapshot of buffer pool usage
+ */
+struct AampBufferPoolStats
+{
+	size_t bytesInUse;		/**< Bytes currently handed out by the pool */
+	size_t peakBytesInUse;	/**< High watermark of bytesInUse */
+	size_t bytesCached;		/**< Bytes held in free lists for reuse */
+	size_t hits;			/**< Allocations served from a free list */
+	size_t misses;			/**< Allocations that had to go to the heap */
+
+	AampBufferPoolStats() : bytesInUse(0), peakBytesInUse(0), bytesCached(0), hits(0), misses(0)
+	{
+	}
+
+	/**
+	 * @brief Get the ratio of allocations served from the free lists
+	 * @return hit rate in range 0..1
+	 */
+	double GetHitRate() const
+	{
+		size_t total = hits + misses;
+		return total ? ((double)hits / total) : 0.0;
+	}
+};
+
+/**
+ * @class AampBufferPool
+ * @brief Process wide size classed pool used by AampGrowableBuffer when enabled
+ *
+ * Requests are rounded up to a size class and served from a per class free list,
+ * so that fragments of similar size recycle the same blocks instead of going back
+ * to the heap on every download. Each class has its own lock, so fetch threads
+ * working on different media types rarely contend.
+ *
+ * Blocks are allocated with g_malloc, so memory handed over to GStreamer (see
+ * AampGrowableBuffer::Transfer) is released with g_free outside of the pool; it
+ * is then only dropped from the in use accounting.
+ */
+class AampBufferPool
+{
+public:
+	/**
+	 * @brief Get the singleton instance of the pool
+	 * @return AampBufferPool instance
+	 */
+	static AampBufferPool& GetInstance();
+
+	/**
+	 * @brief Enable or disable pooled allocation for new AampGrowableBuffer allocations
+	 * @param[in] enable - true to allocate from the pool
+	 */
+	static void SetEnabled(bool enable);
+
+	/**
+	 * @brief Check if pooled allocation is enabled
+	 * @return true if enabled
+	 */
+	static bool IsEnabled();
+
+	/**
+	 * @brief Allocate a block of at least size bytes
+	 * @param[in] size - requested size
+	 * @param[out] allocated - usable size of the returned block
+	 * @return block pointer, NULL on failure
+	 */
+	void *Allocate(size_t size, size_t &allocated);
+
+	/**
+	 * @brief Grow a block, preserving its content
+	 * @param[in] ptr - current block, may be NULL
+	 * @param[in] len - bytes in use to be preserved
+	 * @param[in] avail - usable size of the current block
+	 * @param[in] size - requested new size
+	 * @param[out] allocated - usable size of the returned block
+	 * @return new block pointer, NULL on failure (current block left untouched)
+	 */
+	void *Reallocate(void *ptr, size_t len, size_t avail, size_t size, size_t &allocated);
+
+	/**
+	 * @brief Return a block to the pool
+	 * @param[in] ptr - block pointer
+	 * @param[in] avail - usable size of the block as returned by Allocate/Reallocate
+	 */
+	void Release(void *ptr, size_t avail);
+
+	/**
+	 * @brief Account for a block whose ownership was handed over outside of the pool
+	 * @param[in] avail - usable size of the block
+	 */
+	void Detach(size_t avail);
+
+	/**
+	 * @brief Record the size of a completed download, to learn the expected size per media type
+	 * @param[in] mediaType - media type of the download
+	 * @param[in] size - downloaded size in bytes
+	 */
+	void UpdateExpectedSize(AampMediaType mediaType, size_t size);
+
+	/**
+	 * @brief Get the learned expected download size of a media type
+	 * @param[in] mediaType - media type
+	 * @return expected size in bytes, 0 if not known yet
+	 */
+	size_t GetExpectedSize(AampMediaType mediaType);
+
+	/**
+	 * @brief Get a snapshot of pool statistics
+	 * @param[out] stats - filled with current values
+	 */
+	void GetStats(AampBufferPoolStats &stats);
+
+	/**
+	 * @brief Log pool statistics
+	 */
+	void LogStats();
+
+	/**
+	 * @brief Release all cached free blocks back to the heap
+	 */
+	void Trim();
+
+	AampBufferPool(const AampBufferPool&) = delete;
+	AampBufferPool& operator=(const AampBufferPool&) = delete;
+
+private:
+	/**
+	 * @struct SizeClass
+	 * @brief Free list of equally sized blocks
+	 */
+	struct SizeClass
+	{
+		size_t size;
+		std::mutex mutex;
+		std::vector<void*> freeList;
+
+		SizeClass() : size(0), mutex(), freeList()
+		{
+		}
+	};
+
+	AampBufferPool();
+	~AampBufferPool();
+
+	/**
+	 * @brief Find the smallest size class that fits size
+	 * @param[in] size - requested size
+	 * @return class index, -1 if above the largest class
+	 */
+	int GetClassIndex(size_t size);
+
+	/**
+	 * @brief Add to the in use accounting and update the high watermark
+	 * @param[in] size - bytes handed out
+	 */
+	void AddInUse(size_t size);
+
+	static std::atomic<bool> sEnabled;
+
+	SizeClass mClasses[AAMP_BUFFER_POOL_NUM_CLASSES];
+	std::atomic<size_t> mBytesInUse;
+	std::atomic<size_t> mPeakBytesInUse;
+	std::atomic<size_t> mBytesCached;
+	std::atomic<size_t> mHits;
+	std::atomic<size_t> mMisses;
+	std::atomic<size_t> mExpectedSize[eMEDIATYPE_DEFAULT + 1];	/**< running average of download size per media type */
+};
+
+#endif /* __AAMP_BUFFER_POOL_H__ */
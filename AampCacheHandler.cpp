@@ -18,8 +18,12 @@
 */
 
 #include "AampCacheHandler.h"
+#include "AampDiskCache.h"
+#include <string.h>
 
-AampCacheHandler::AampCacheHandler( int playerId ): mAsyncCleanUpTaskThreadId(), mCacheActive(false),mAsyncCacheCleanUpThread(false), mCondVarMutex(), mCondVar(), mPlaylistCache(eCACHE_TYPE_PLAYLIST), mbCleanUpTaskInitialized(false), mInitFragmentCache(eCACHE_TYPE_INIT_FRAGMENT), mPlayerId(playerId)
+#define AAMP_HTTP_CACHE_POLICY_MAX_ENTRIES 32 /**< bound on pending Cache-Control policies not yet claimed by an insert */
+
+AampCacheHandler::AampCacheHandler( int playerId ): mAsyncCleanUpTaskThreadId(), mCacheActive(false),mAsyncCacheCleanUpThread(false), mCondVarMutex(), mCondVar(), mPlaylistCacheMutex(), mInitFragCacheMutex(), mCleanUpTaskMutex(), mHttpCachePolicyMutex(), mHttpCacheMaxAge(), mHttpCachePolicyOrder(), mPlaylistCache(eCACHE_TYPE_PLAYLIST), mbCleanUpTaskInitialized(false), mInitFragmentCache(eCACHE_TYPE_INIT_FRAGMENT), mPlayerId(playerId)
 {
 }
 
@@ -33,15 +37,22 @@ AampCacheHandler::~AampCacheHandler( void )
 
 void AampCacheHandler::InsertToPlaylistCache( const std::string &url, const AampGrowableBuffer* buffer, const std::string &effectiveUrl, bool isLive, AampMediaType mediaType )
 {
-	std::lock_guard<std::mutex> lock(mCacheAccessMutex);
 	assert( !effectiveUrl.empty() );
 	if( mediaType==eMEDIATYPE_MANIFEST || !isLive )
 	{
 		InitializeIfNeeded();
 		// First check point; Caching is allowed only if its VOD and for Main Manifest(HLS) for both VOD/Live
 		// For Main manifest; mediaType will bypass storing for live content
-		mPlaylistCache.Insert( url, buffer, effectiveUrl, mediaType );
-		AAMPLOG_TRACE( "Inserted %s URL %s into cache", GetMediaTypeName(mediaType), url.c_str());
+		{
+			std::lock_guard<std::mutex> lock(mPlaylistCacheMutex);
+			mPlaylistCache.Insert( url, buffer, effectiveUrl, mediaType );
+			AAMPLOG_TRACE( "Inserted %s URL %s into cache", GetMediaTypeName(mediaType), url.c_str());
+		}
+		int maxAge = TakeHttpCacheMaxAge( url );
+		if( AampDiskCache::GetInstance().IsEnabled() && IsPersistablePlaylist( buffer, mediaType ) )
+		{
+			AampDiskCache::GetInstance().Store( url, buffer, effectiveUrl, mediaType, maxAge );
+		}
 	}
 }
 
@@ -62,23 +73,41 @@ void AampCacheHandler::StopPlaylistCache( void )
 bool AampCacheHandler::RetrieveFromPlaylistCache( const std::string &url, AampGrowableBuffer* buffer, std::string& effectiveUrl, AampMediaType mediaType  )
 {
 	bool ret = false;
-	std::lock_guard<std::mutex> lock(mCacheAccessMutex);
-	AampCachedData *cachedData = mPlaylistCache.Find(url);
-	if( cachedData )
 	{
-		effectiveUrl = cachedData->effectiveUrl;
-		if( effectiveUrl.empty() )
+		std::lock_guard<std::mutex> lock(mPlaylistCacheMutex);
+		AampCachedData *cachedData = mPlaylistCache.Find(url);
+		if( cachedData )
 		{
-			effectiveUrl = url;
+			effectiveUrl = cachedData->effectiveUrl;
+			if( effectiveUrl.empty() )
+			{
+				effectiveUrl = url;
+			}
+			buffer->Clear();
+			buffer->AppendBytes( cachedData->buffer->GetPtr(), cachedData->buffer->GetLen() );
+			// below fails when playing an HLS playlist directly, then seeking or retuning
+			// assert( mediaType == cachedData->mediaType );
+			AAMPLOG_TRACE( "%s %s found", GetMediaTypeName(cachedData->mediaType), url.c_str() );
+			ret = true;
 		}
-		buffer->Clear();
-		buffer->AppendBytes( cachedData->buffer->GetPtr(), cachedData->buffer->GetLen() );
-		// below fails when playing an HLS playlist directly, then seeking or retuning
-		// assert( mediaType == cachedData->mediaType );
-		AAMPLOG_TRACE( "%s %s found", GetMediaTypeName(cachedData->mediaType), url.c_str() );
-		ret = true;
 	}
-	else
+	if( !ret && AampDiskCache::GetInstance().IsEnabled() )
+	{ // fall back to the persistent tier, then keep the entry in memory for the rest of the session
+		std::string diskEffectiveUrl;
+		AampMediaType diskMediaType = mediaType;
+		if( AampDiskCache::GetInstance().Load( url, buffer, diskEffectiveUrl, diskMediaType ) )
+		{
+			effectiveUrl = diskEffectiveUrl;
+			InitializeIfNeeded();
+			std::lock_guard<std::mutex> lock(mPlaylistCacheMutex);
+			if( !mPlaylistCache.Find(url) )
+			{
+				mPlaylistCache.Insert( url, buffer, effectiveUrl, diskMediaType );
+			}
+			ret = true;
+		}
+	}
+	if( !ret )
 	{
 		AAMPLOG_TRACE("%s %s not found", GetMediaTypeName(mediaType), url.c_str());
 	}
@@ -87,63 +116,141 @@ bool AampCacheHandler::RetrieveFromPlaylistCache( const std::string &url, AampGr
 
 void AampCacheHandler::SetMaxPlaylistCacheSize(int maxBytes)
 {
-	std::lock_guard<std::mutex> lock(mCacheAccessMutex);
+	std::lock_guard<std::mutex> lock(mPlaylistCacheMutex);
 	mPlaylistCache.maxPlaylistCacheBytes = maxBytes;
 	AAMPLOG_MIL("Setting maxPlaylistCacheBytes to :%d", maxBytes);
 }
 
 void AampCacheHandler::SetMaxInitFragCacheSize( int maxFragmentsPerTrack )
 {
-	std::lock_guard<std::mutex> lock(mCacheAccessMutex);
+	std::lock_guard<std::mutex> lock(mInitFragCacheMutex);
 	mInitFragmentCache.maxCachedInitFragmentsPerTrack = maxFragmentsPerTrack;
 	AAMPLOG_MIL("Setting maxCachedInitFragmentsPerTrack to :%d",maxFragmentsPerTrack);
 }
 
 bool AampCacheHandler::IsPlaylistUrlCached( const std::string &playlistUrl )
 {
-	std::lock_guard<std::mutex> lock(mCacheAccessMutex);
+	std::lock_guard<std::mutex> lock(mPlaylistCacheMutex);
 	return mPlaylistCache.Find(playlistUrl) != NULL;
 }
 
 void AampCacheHandler::RemoveFromPlaylistCache( const std::string &url )
 {
-	std::lock_guard<std::mutex> lock(mCacheAccessMutex);
-	mPlaylistCache.Remove( url );
+	{
+		std::lock_guard<std::mutex> lock(mPlaylistCacheMutex);
+		mPlaylistCache.Remove( url );
+	}
+	if( AampDiskCache::GetInstance().IsEnabled() )
+	{
+		AampDiskCache::GetInstance().Remove( url );
+	}
 }
 
 void AampCacheHandler::InsertToInitFragCache( const std::string &url, const AampGrowableBuffer* buffer, const std::string &effectiveUrl, AampMediaType mediaType )
 {
-	std::lock_guard<std::mutex> lock(mCacheAccessMutex);
 	assert( !effectiveUrl.empty() );
 	InitializeIfNeeded();
-	mInitFragmentCache.Insert( url, buffer, effectiveUrl, mediaType );
+	{
+		std::lock_guard<std::mutex> lock(mInitFragCacheMutex);
+		mInitFragmentCache.Insert( url, buffer, effectiveUrl, mediaType );
+	}
+	int maxAge = TakeHttpCacheMaxAge( url );
+	if( AampDiskCache::GetInstance().IsEnabled() )
+	{
+		AampDiskCache::GetInstance().Store( url, buffer, effectiveUrl, mediaType, maxAge );
+	}
 }
 
 bool AampCacheHandler::RetrieveFromInitFragmentCache(const std::string &url, AampGrowableBuffer* buffer, std::string& effectiveUrl)
 {
 	bool ret = false;
-	std::lock_guard<std::mutex> lock(mCacheAccessMutex);
-	AampCachedData *cachedData = mInitFragmentCache.Find(url);
-	if( cachedData )
 	{
-		std::shared_ptr<AampGrowableBuffer> buf = cachedData->buffer;
-		if (cachedData->effectiveUrl.empty())
+		std::lock_guard<std::mutex> lock(mInitFragCacheMutex);
+		AampCachedData *cachedData = mInitFragmentCache.Find(url);
+		if( cachedData )
 		{
-			effectiveUrl = url;
+			std::shared_ptr<AampGrowableBuffer> buf = cachedData->buffer;
+			if (cachedData->effectiveUrl.empty())
+			{
+				effectiveUrl = url;
+			}
+			else
+			{
+				effectiveUrl = cachedData->effectiveUrl;
+			}
+			buffer->Clear();
+			buffer->AppendBytes( buf->GetPtr(), buf->GetLen() );
+			AAMPLOG_INFO("%s %s found", GetMediaTypeName(cachedData->mediaType), url.c_str());
+			ret = true;
 		}
-		else
+	}
+	if( !ret && AampDiskCache::GetInstance().IsEnabled() )
+	{ // fall back to the persistent tier, then keep the entry in memory for the rest of the session
+		std::string diskEffectiveUrl;
+		AampMediaType diskMediaType = eMEDIATYPE_DEFAULT;
+		if( AampDiskCache::GetInstance().Load( url, buffer, diskEffectiveUrl, diskMediaType ) )
 		{
-			effectiveUrl = cachedData->effectiveUrl;
+			effectiveUrl = diskEffectiveUrl;
+			InitializeIfNeeded();
+			std::lock_guard<std::mutex> lock(mInitFragCacheMutex);
+			if( !mInitFragmentCache.Find(url) )
+			{
+				mInitFragmentCache.Insert( url, buffer, effectiveUrl, diskMediaType );
+			}
+			ret = true;
 		}
-		buffer->Clear();
-		buffer->AppendBytes( buf->GetPtr(), buf->GetLen() );
-		AAMPLOG_INFO("%s %s found", GetMediaTypeName(cachedData->mediaType), url.c_str());
-		ret = true;
 	}
-	else
+	if( !ret )
 	{
 		AAMPLOG_INFO("%s %s not found.", GetMediaTypeName(eMEDIATYPE_DEFAULT), url.c_str());
 	}
 	return ret;
 }
 
+
+void AampCacheHandler::SetHttpCachePolicy( const std::string &url, int maxAgeSeconds )
+{
+	std::lock_guard<std::mutex> lock(mHttpCachePolicyMutex);
+	auto iter = mHttpCacheMaxAge.find(url);
+	if( iter != mHttpCacheMaxAge.end() )
+	{
+		iter->second.first = maxAgeSeconds;
+		mHttpCachePolicyOrder.splice( mHttpCachePolicyOrder.end(), mHttpCachePolicyOrder, iter->second.second );
+	}
+	else
+	{
+		if( mHttpCacheMaxAge.size() >= AAMP_HTTP_CACHE_POLICY_MAX_ENTRIES )
+		{ // policies of downloads that were never inserted (e.g. live playlists) must not accumulate; drop the oldest
+			mHttpCacheMaxAge.erase( mHttpCachePolicyOrder.front() );
+			mHttpCachePolicyOrder.pop_front();
+		}
+		auto orderPos = mHttpCachePolicyOrder.insert( mHttpCachePolicyOrder.end(), url );
+		mHttpCacheMaxAge.emplace( url, std::make_pair(maxAgeSeconds, orderPos) );
+	}
+}
+
+int AampCacheHandler::TakeHttpCacheMaxAge( const std::string &url )
+{
+	int maxAge = AAMP_DISK_CACHE_MAX_AGE_UNSPECIFIED;
+	std::lock_guard<std::mutex> lock(mHttpCachePolicyMutex);
+	auto iter = mHttpCacheMaxAge.find(url);
+	if( iter != mHttpCacheMaxAge.end() )
+	{
+		maxAge = iter->second.first;
+		mHttpCachePolicyOrder.erase(iter->second.second);
+		mHttpCacheMaxAge.erase(iter);
+	}
+	return maxAge;
+}
+
+bool AampCacheHandler::IsPersistablePlaylist( const AampGrowableBuffer* buffer, AampMediaType mediaType )
+{
+	bool ret = true;
+	if( mediaType == eMEDIATYPE_MANIFEST )
+	{ // main manifest is cached for live too; only a multivariant or complete (VOD) playlist stays valid across tunes
+		const char *ptr = buffer->GetPtr();
+		size_t len = buffer->GetLen();
+		ret = ptr && ( memmem( ptr, len, "#EXT-X-STREAM-INF", 17 ) || memmem( ptr, len, "#EXT-X-ENDLIST", 14 ) );
+	}
+	return ret;
+}
@@ -27,6 +27,7 @@
 #include <iostream>
 #include <memory>
 #include <unordered_map>
+#include <list>
 #include <exception>
 #include "priv_aamp.h"
 #include <mutex>
@@ -46,7 +47,7 @@ public:
 	std::string effectiveUrl;
 	std::shared_ptr<AampGrowableBuffer> buffer;
 	AampMediaType mediaType;
-	long seqNo;
+	std::list<std::string>::iterator lruPos; /**< position in per media type LRU list; main entries only */
 
 	~AampCachedData() {};
 
@@ -59,13 +60,12 @@ public:
 	 *
 	 * @param buffer data payload associated with cache entry (initialization fragment or playlist)
 	 * @param mediaType type of cache entry
-	 * @param seqNo bigger for more recent usage; used to drive LRU purging heuristic
 	 */
 	AampCachedData(const std::string &effectiveUrl, std::shared_ptr<AampGrowableBuffer> buffer, AampMediaType mediaType)
 		: effectiveUrl(effectiveUrl)
 		, buffer(buffer)
 		, mediaType(mediaType)
-		, seqNo()
+		, lruPos()
 	{
 	}
 };
@@ -76,12 +76,41 @@ typedef enum
 	eCACHE_TYPE_PLAYLIST
 } AampCacheType;
 
+typedef std::unordered_map<std::string, AampCachedData *> AampCacheMap;
+
 class AampCache
 {
 private:
 	AampCacheType cacheType;
 	size_t totalCachedBytes;
-	long seqNo;
+	std::list<std::string> lruList[eMEDIATYPE_DEFAULT+1]; /**< main entry urls per media type, least recently used first */
+	std::unordered_map<std::string, int> effectiveUrlRefs; /**< number of main entries sharing each alias (effectiveUrl) entry */
+
+	/**
+	 *   @brief remove an entry, keeping LRU order, alias references and size accounting in sync
+	 *   @param[in] iter entry to remove
+	 *
+	 *   @return iterator following the removed entry
+	 */
+	AampCacheMap::iterator eraseEntry( AampCacheMap::iterator iter )
+	{
+		AampCachedData *cachedData = iter->second;
+		if( !cachedData->effectiveUrl.empty() )
+		{ // not alias; reclaim space
+			totalCachedBytes -= cachedData->buffer->GetLen();
+			lruList[cachedData->mediaType].erase( cachedData->lruPos );
+			if( cachedData->effectiveUrl != iter->first )
+			{
+				auto ref = effectiveUrlRefs.find( cachedData->effectiveUrl );
+				if( ref != effectiveUrlRefs.end() && --ref->second <= 0 )
+				{
+					effectiveUrlRefs.erase( ref );
+				}
+			}
+		}
+		SAFE_DELETE(cachedData);
+		return cache.erase(iter);
+	}
 
 	/**
 	 *   @fn allocatePlaylistCacheSlot
@@ -104,12 +133,7 @@ private:
 			}
 			else
 			{
-				if( !cachedData->effectiveUrl.empty() )
-				{ // not alias; reclaim space
-					totalCachedBytes -= cachedData->buffer->GetLen();
-				}
-				SAFE_DELETE(cachedData);
-				iter = cache.erase(iter);
+				iter = eraseEntry(iter);
 			}
 		}
 
@@ -127,12 +151,7 @@ private:
 				}
 				else
 				{
-					if( !cachedData->effectiveUrl.empty() )
-					{
-						totalCachedBytes -= cachedData->buffer->GetLen();
-					}
-					SAFE_DELETE(cachedData);
-					iter = cache.erase(iter);
+					iter = eraseEntry(iter);
 				}
 			}
 		}
@@ -158,54 +177,26 @@ private:
 
 	bool makeRoomForInitFragment( AampMediaType mediaType )
 	{
-		int count = 0;
-		std::unordered_map<std::string, AampCachedData *>::iterator lru = cache.end();
-		auto iter = cache.begin();
-		while( iter != cache.end() )
-		{
-			AampCachedData *cachedData = iter->second;
-			if(cachedData->mediaType == mediaType && !cachedData->effectiveUrl.empty() )
-			{
-				if( lru==cache.end() || cachedData->seqNo < lru->second->seqNo )
-				{
-					lru = iter;
-				}
-				count++;
-			}
-			iter++;
-		}
-		if( count >= maxCachedInitFragmentsPerTrack )
+		std::list<std::string> &lru = lruList[mediaType];
+		if( !lru.empty() && (int)lru.size() >= maxCachedInitFragmentsPerTrack )
 		{
 			AAMPLOG_WARN( "removing entry from %s init fragment cache", GetMediaTypeName(mediaType) );
-			Remove( lru->first );
+			std::string lruUrl = lru.front(); // copy, as Remove releases the list node
+			Remove( lruUrl );
 		}
 		return true; // success
 	}
 
-	int countReferencesToEffectiveUrl( const std::string effectiveUrl )
-	{
-		int count = 0;
-		for (auto& it: cache)
-		{
-			AampCachedData *cachedData = it.second;
-			if(cachedData->effectiveUrl == effectiveUrl)
-			{
-				count++;
-			}
-		}
-		return count;
-	}
-
 public:
 	int maxCachedInitFragmentsPerTrack;
 	int maxPlaylistCacheBytes;
-	std::unordered_map<std::string, AampCachedData *> cache;
+	AampCacheMap cache;
 
 	AampCache()
 	{
 	}
 
-	AampCache( AampCacheType cacheType ) : cacheType(cacheType), cache(), totalCachedBytes(), maxPlaylistCacheBytes(MAX_PLAYLIST_CACHE_SIZE*1024), maxCachedInitFragmentsPerTrack(MAX_INIT_FRAGMENT_CACHE_PER_TRACK), seqNo()
+	AampCache( AampCacheType cacheType ) : cacheType(cacheType), cache(), totalCachedBytes(), lruList(), effectiveUrlRefs(), maxPlaylistCacheBytes(MAX_PLAYLIST_CACHE_SIZE*1024), maxCachedInitFragmentsPerTrack(MAX_INIT_FRAGMENT_CACHE_PER_TRACK)
 	{
 	}
 
@@ -245,7 +236,8 @@ public:
 				cachedData->buffer->AppendBytes( buffer->GetPtr(), len );
 
 				cache[url] = cachedData;
-				cachedData->seqNo = ++seqNo;
+				std::list<std::string> &lru = lruList[mediaType];
+				cachedData->lruPos = lru.insert( lru.end(), url );
 				totalCachedBytes += len;
 				AAMPLOG_MIL( "inserted %s %s", GetMediaTypeName(mediaType), url.c_str() ); // used by l2tests
 				// There are cases where main url and effective url will be different (often for main manifest)
@@ -255,9 +247,11 @@ public:
 				// So need to have two entries in cache table but both pointing to same CachedBuffer (no space is consumed for storage)
 				if( url != effectiveUrl )
 				{ // re-use buffer without extra copy
-					if ( cache.find(effectiveUrl) != cache.end() )
+					effectiveUrlRefs[effectiveUrl]++;
+					auto existing = cache.find(effectiveUrl);
+					if ( existing != cache.end() )
 					{	// effective url was already in cache, so delete the old one
-						SAFE_DELETE(cache[effectiveUrl]);
+						eraseEntry(existing);
 					}
 					AampCachedData *newData = new AampCachedData( "", cachedData->buffer, mediaType );
 					cache[effectiveUrl] = newData;
@@ -272,20 +266,17 @@ public:
 		auto iter = cache.find(url);
 		assert( iter != cache.end() );
 		AampCachedData *cachedData = iter->second;
-		totalCachedBytes -= cachedData->buffer->GetLen();
 		assert( !cachedData->effectiveUrl.empty() );
-		if(( url != cachedData->effectiveUrl ) &&
-			(countReferencesToEffectiveUrl(cachedData->effectiveUrl) == 1))
-		{ // remove main entry with payload
-			auto iter2 = cache.find(cachedData->effectiveUrl);
+		std::string effectiveUrl = cachedData->effectiveUrl;
+		eraseEntry(iter);
+		if(( url != effectiveUrl ) &&
+			(effectiveUrlRefs.find(effectiveUrl) == effectiveUrlRefs.end()))
+		{ // last main entry sharing the alias is gone; remove alias entry too
+			auto iter2 = cache.find(effectiveUrl);
 			assert( iter2 != cache.end() );
-			AampCachedData *cachedData2 = iter2->second;
-			assert( cachedData2->effectiveUrl.empty() );
-			SAFE_DELETE(cachedData2);
-			cache.erase(iter2);
+			assert( iter2->second->effectiveUrl.empty() );
+			eraseEntry(iter2);
 		}
-		SAFE_DELETE(cachedData);
-		cache.erase(iter);
 	}
 
 	void Clear( void )
@@ -296,6 +287,11 @@ public:
 			SAFE_DELETE(cachedData);
 		}
 		cache.clear();
+		for( auto &lru : lruList )
+		{
+			lru.clear();
+		}
+		effectiveUrlRefs.clear();
 		totalCachedBytes = 0;
 	}
 
@@ -306,7 +302,11 @@ public:
 		if( it != cache.end() )
 		{ // cache hit
 			cachedData = it->second;
-			cachedData->seqNo = ++seqNo;
+			if( !cachedData->effectiveUrl.empty() )
+			{ // mark as most recently used
+				std::list<std::string> &lru = lruList[cachedData->mediaType];
+				lru.splice( lru.end(), lru, cachedData->lruPos );
+			}
 		}
 		return cachedData;
 	}
@@ -321,7 +321,12 @@ class AampCacheHandler
 {
 private:
 	int mPlayerId;
-	std::mutex mCacheAccessMutex;
+	std::mutex mPlaylistCacheMutex;		/**< guards mPlaylistCache */
+	std::mutex mInitFragCacheMutex;		/**< guards mInitFragmentCache; separate so playlist caching does not stall init fragment lookups */
+	std::mutex mCleanUpTaskMutex;		/**< serializes clean up thread creation */
+	std::mutex mHttpCachePolicyMutex;	/**< guards mHttpCacheMaxAge and mHttpCachePolicyOrder */
+	std::unordered_map<std::string, std::pair<int, std::list<std::string>::iterator>> mHttpCacheMaxAge;	/**< Cache-Control max-age of downloads pending insert and position in mHttpCachePolicyOrder, by url */
+	std::list<std::string> mHttpCachePolicyOrder;	/**< urls of mHttpCacheMaxAge, oldest first */
 	AampCache mPlaylistCache;
 	AampCache mInitFragmentCache;
 	bool mbCleanUpTaskInitialized;
@@ -331,6 +336,23 @@ private:
 	std::condition_variable mCondVar;
 	std::thread mAsyncCleanUpTaskThreadId;
 
+	/**
+	 *   @brief claim the Cache-Control max-age recorded for a download
+	 *   @param[in] url - URL
+	 *
+	 *   @return max-age in seconds, AAMP_DISK_CACHE_MAX_AGE_UNSPECIFIED if none recorded
+	 */
+	int TakeHttpCacheMaxAge( const std::string &url );
+
+	/**
+	 *   @brief check if a playlist remains valid across tunes, so is worth persisting
+	 *   @param[in] buffer - playlist
+	 *   @param[in] mediaType - type of playlist
+	 *
+	 *   @return true if playlist can be stored in disk cache
+	 */
+	bool IsPersistablePlaylist( const AampGrowableBuffer* buffer, AampMediaType mediaType );
+
 protected:
 	/**
 	 *  @brief Thread function for Async Cache clean
@@ -349,8 +371,14 @@ protected:
 				if( status == std::cv_status::timeout )
 				{
 					AAMPLOG_MIL("[%p] Cacheflush timed out", this);
-					mPlaylistCache.Clear();
-					mInitFragmentCache.Clear();
+					{
+						std::lock_guard<std::mutex> playlistLock(mPlaylistCacheMutex);
+						mPlaylistCache.Clear();
+					}
+					{
+						std::lock_guard<std::mutex> initFragLock(mInitFragCacheMutex);
+						mInitFragmentCache.Clear();
+					}
 				}
 			}
 		}
@@ -358,9 +386,11 @@ protected:
 
 	/**
 	* @fn Init
+	* @note must not be called with a cache mutex held; the clean up thread takes them while holding mCondVarMutex
 	*/
 	void InitializeIfNeeded( void )
 	{
+		std::lock_guard<std::mutex> guard(mCleanUpTaskMutex);
 		if( !mbCleanUpTaskInitialized )
 		{
 			try
@@ -397,8 +427,14 @@ protected:
 			{
 				mAsyncCleanUpTaskThreadId.join();
 			}
-			mPlaylistCache.Clear();
-			mInitFragmentCache.Clear();
+			{
+				std::lock_guard<std::mutex> playlistLock(mPlaylistCacheMutex);
+				mPlaylistCache.Clear();
+			}
+			{
+				std::lock_guard<std::mutex> initFragLock(mInitFragCacheMutex);
+				mInitFragmentCache.Clear();
+			}
 			mbCleanUpTaskInitialized = false;
 		}
 	}
@@ -437,7 +473,7 @@ public:
 	void InsertToPlaylistCache( const std::string &url, const AampGrowableBuffer* buffer, const std::string &effectiveUrl, bool isLive, AampMediaType mediaType );
 
 	/**
-	 *   @brief Find playlist in cache
+	 *   @brief Find playlist in cache, falling back to the disk cache when enabled
 	 *   @param[in] url - URL
 	 *   @param[out] buffer - Pointer to growable buffer
 	 *   @param[out] effectiveUrl - Final URL
@@ -481,7 +517,7 @@ public:
 	void InsertToInitFragCache( const std::string &url, const AampGrowableBuffer* buffer, const std::string &effectiveUrl, AampMediaType mediaType );
 
 	/**
-	 *   @brief Find initialization fragment in cache
+	 *   @brief Find initialization fragment in cache, falling back to the disk cache when enabled
 	 *
 	 *   @param[in] url - URL
 	 *   @param[out] buffer - Pointer to growable buffer
@@ -507,6 +543,16 @@ public:
 	*/
 	int GetMaxInitFragCacheSize() { return mInitFragmentCache.maxCachedInitFragmentsPerTrack; }
 
+	/**
+	*   @brief record the Cache-Control freshness of a download, applied when it is inserted into the disk cache
+	*
+	*   @param[in] url - URL
+	*   @param[in] maxAgeSeconds - max-age, 0 if the response must not be stored
+	*
+	*   @return None
+	*/
+	void SetHttpCachePolicy( const std::string &url, int maxAgeSeconds );
+
 	/**
 	 * @brief Copy constructor disabled
 	 */
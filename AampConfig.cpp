@@ -230,6 +230,8 @@ static const ConfigLookupEntryString mConfigLookupTableString[AAMPCONFIG_STRING_
 	{"","gstlevel", eAAMPConfig_GstDebugLevel,false},
 	{"","tsbType", eAAMPConfig_TsbType, false},
 	{DEFAULT_TSB_LOCATION,"tsbLocation",eAAMPConfig_TsbLocation, true},
+	{DEFAULT_DISK_CACHE_LOCATION,"diskCacheLocation",eAAMPConfig_DiskCacheLocation, false},
+	{"","logModuleLevels",eAAMPConfig_LogModuleLevels, false},
 };
 
 /**
@@ -367,7 +369,20 @@ static const ConfigLookupEntryBool mConfigLookupTableBool[AAMPCONFIG_BOOL_COUNT]
 	{true, "overrideMediaHeaderDuration", eAAMPConfig_OverrideMediaHeaderDuration, true},
 	{false, "useMp4Demux", eAAMPConfig_UseMp4Demux,false },
 	{false, "curlThroughput", eAAMPConfig_CurlThroughput, false },
-	{false, "useFireboltSDK", eAAMPConfig_UseFireboltSDK, false}
+	{false, "useFireboltSDK", eAAMPConfig_UseFireboltSDK, false},
+	{false, "useCurlMulti", eAAMPConfig_UseCurlMulti, false},
+	{false, "useBufferPool", eAAMPConfig_UseBufferPool, false},
+	{false, "enableDiskCache", eAAMPConfig_EnableDiskCache, false},
+	{false, "tsbPosixIo", eAAMPConfig_TsbPosixIo, false},
+	{false, "tsbPackFiles", eAAMPConfig_TsbPackFiles, false},
+	{false, "mpdIncrementalRefresh", eAAMPConfig_MPDIncrementalRefresh, false},
+	{false, "mpdStreamingParser", eAAMPConfig_MPDStreamingParser, false},
+	{false, "hlsIncrementalIndex", eAAMPConfig_HLSIncrementalIndex, false},
+	{false, "asyncLogging", eAAMPConfig_AsyncLogging, false},
+	{false, "useGstBufferList", eAAMPConfig_UseGstBufferList, false},
+	{false, "eventBatching", eAAMPConfig_EventBatching, false},
+	{false, "useThreadPool", eAAMPConfig_UseThreadPool, false},
+	{false, "streamingDecrypt", eAAMPConfig_StreamingDecrypt, false}
 };
 
 #define CONFIG_INT_ALIAS_COUNT 2
@@ -466,6 +481,12 @@ static const ConfigLookupEntryInt mConfigLookupTableInt[AAMPCONFIG_INT_COUNT+CON
 	{DEFAULT_MONITOR_AV_JUMP_THRESHOLD_MS,"monitorAVJumpThreshold",eAAMPConfig_MonitorAVJumpThreshold,true,eCONFIG_RANGE_MONITOR_AVSYNC_JUMP_THRESHOLD },
 	{DEFAULT_PROGRESS_LOGGING_DIVISOR,"progressLoggingDivisor",eAAMPConfig_ProgressLoggingDivisor,false},
 	{DEFAULT_MONITOR_AV_REPORTING_INTERVAL, "monitorAVReportingInterval", eAAMPConfig_MonitorAVReportingInterval, false},
+	{DEFAULT_DISK_CACHE_MAX_SIZE, "diskCacheMaxSize", eAAMPConfig_DiskCacheMaxSize, false},
+	{DEFAULT_DISK_CACHE_TTL, "diskCacheTTL", eAAMPConfig_DiskCacheTTL, false},
+	{DEFAULT_TSB_DIRECT_IO_THRESHOLD_KB, "tsbDirectIoThreshold", eAAMPConfig_TsbDirectIoThreshold, false},
+	{DEFAULT_TSB_PACK_FILE_SIZE_MB, "tsbPackFileSize", eAAMPConfig_TsbPackFileSize, false},
+	{DEFAULT_TSB_WRITE_QUEUE_DEPTH, "tsbWriteQueueDepth", eAAMPConfig_TsbWriteQueueDepth, false},
+	{DEFAULT_LICENSE_PREFETCH_WORKERS, "licensePrefetchWorkers", eAAMPConfig_LicensePrefetchWorkers, false},
 	// aliases, kept for backwards compatibility
 	{DEFAULT_INIT_BITRATE,"defaultBitrate",eAAMPConfig_DefaultBitrate,true },
 	{DEFAULT_INIT_BITRATE_4K,"defaultBitrate4K",eAAMPConfig_DefaultBitrate4K,true },
@@ -1802,6 +1823,7 @@ void AampConfig::ConfigureLogSettings()
 		AampLogManager::setLogLevel(eLOGLEVEL_INFO);
 		AampLogManager::lockLogLevel(true);
 	}
+	AampLogManager::setModuleLogLevels(configValueString[eAAMPConfig_LogModuleLevels].value);
 }
 
 /**
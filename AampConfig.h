@@ -213,6 +213,19 @@ typedef enum
 	eAAMPConfig_UseMp4Demux,
 	eAAMPConfig_CurlThroughput,
 	eAAMPConfig_UseFireboltSDK,						/**< Config to use Firebolt SDK for license Acquisition */
+	eAAMPConfig_UseCurlMulti,						/**< Config to perform downloads on the curl_multi engine of the player */
+	eAAMPConfig_UseBufferPool,						/**< Config to allocate AampGrowableBuffer memory from the size classed buffer pool; process wide, applied from the initial config only */
+	eAAMPConfig_EnableDiskCache,					/**< Config to persist init fragments and playlists in an on-disk cache across tunes */
+	eAAMPConfig_TsbPosixIo,							/**< Config to use the file descriptor based TSB Store I/O backend */
+	eAAMPConfig_TsbPackFiles,						/**< Config to append TSB segments to pack files instead of a file per segment */
+	eAAMPConfig_MPDIncrementalRefresh,				/**< Config to reuse Periods/AdaptationSets unchanged since the previous refresh when parsing a live MPD */
+	eAAMPConfig_MPDStreamingParser,					/**< Config to build the MPD node tree from SAX callbacks instead of xmlTextReader */
+	eAAMPConfig_HLSIncrementalIndex,				/**< Config to reuse index entries of fragments unchanged since the previous HLS playlist refresh */
+	eAAMPConfig_AsyncLogging,						/**< Config to write log messages from a background thread */
+	eAAMPConfig_UseGstBufferList,					/**< Config to inject demuxed mp4 samples as one GstBufferList per fragment */
+	eAAMPConfig_EventBatching,						/**< Config to dispatch pending async events in batches, coalescing superseded ones */
+	eAAMPConfig_UseThreadPool,						/**< Config to run track worker jobs on the process wide thread pool; process wide, applied from the initial config only */
+	eAAMPConfig_StreamingDecrypt,					/**< Config to decrypt AES-128 HLS fragments in place while they are downloaded */
 	eAAMPConfig_BoolMaxValue						/**< Max value of bool config always last element */
 
 } AAMPConfigSettingBool;
@@ -309,6 +322,12 @@ typedef enum
 	eAAMPConfig_MonitorAVJumpThreshold,				/**< configures threshold aligned audio,video positions advancing together by unexpectedly large delta to be reported as jump in milliseconds*/
 	eAAMPConfig_ProgressLoggingDivisor,				/**<  Divisor to avoid printing the progress report too frequently in the log */
 	eAAMPConfig_MonitorAVReportingInterval,			/**< Timeout in milliseconds for reporting MonitorAV events */
+	eAAMPConfig_DiskCacheMaxSize,					/**< Max size of the on-disk cache in KB */
+	eAAMPConfig_DiskCacheTTL,						/**< Max time in seconds an on-disk cache entry is considered fresh */
+	eAAMPConfig_TsbDirectIoThreshold,				/**< Min TSB segment size in KB written with direct I/O, 0 to disable */
+	eAAMPConfig_TsbPackFileSize,					/**< Size in MB at which a TSB pack file is closed */
+	eAAMPConfig_TsbWriteQueueDepth,					/**< Max TSB fragments queued for writing per track */
+	eAAMPConfig_LicensePrefetchWorkers,				/**< License requests prefetched concurrently per player */
 	eAAMPConfig_IntMaxValue							/**< Max value of int config always last element*/
 } AAMPConfigSettingInt;
 #define AAMPCONFIG_INT_COUNT (eAAMPConfig_IntMaxValue)
@@ -369,6 +388,8 @@ typedef enum
 	eAAMPConfig_GstDebugLevel,							/**< gstreamer debug level as you'd define in GST_DEBUG */
 	eAAMPConfig_TsbType,
 	eAAMPConfig_TsbLocation,                                                        /**< tsbType location for local TSB storage*/
+	eAAMPConfig_DiskCacheLocation,						/**< Directory of the on-disk init fragment and playlist cache */
+	eAAMPConfig_LogModuleLevels,						/**< Per module log levels overriding the global log level, e.g. "fragmentcollector_mpd:debug,drm:info" */
 	eAAMPConfig_StringMaxValue						/**< Max value for string config always last element */
 } AAMPConfigSettingString;
 #define AAMPCONFIG_STRING_COUNT (eAAMPConfig_StringMaxValue)
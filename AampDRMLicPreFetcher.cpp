@@ -23,6 +23,7 @@
 #include "priv_aamp.h"
 #include "AampDRMLicManager.h"
 #include "PlayerSecInterface.h"
+#include <algorithm>
 /**
  * @brief For generating IDs for LicensePreFetchObject
  * 
@@ -35,8 +36,10 @@ int LicensePreFetchObject::staticId = 1;
  * @param aamp PrivateInstanceAAMP instance
  * @param fetcherInstance AampLicenseFetcher instance
  */
-AampLicensePreFetcher::AampLicensePreFetcher(PrivateInstanceAAMP *aamp) : mPreFetchThread(),
+AampLicensePreFetcher::AampLicensePreFetcher(PrivateInstanceAAMP *aamp) : mPreFetchThreads(),
 		mFetchQueue(),
+		mInFlight(),
+		mStats(),
 		mQMutex(),
 		mQCond(),
 		mPreFetchThreadStarted(false),
@@ -50,7 +53,8 @@ AampLicensePreFetcher::AampLicensePreFetcher(PrivateInstanceAAMP *aamp) : mPreFe
 		mVssFetchQueue(),
 		mQVssMutex(),
 		mQVssCond(),
-		mVssPreFetchThreadStarted(false)
+		mVssPreFetchThreadStarted(false),
+		mPlayerStateMutex()
 {
 	mTrackStatus.fill(false);
 	mIsSecClientError = isSecFeatureEnabled();
@@ -69,9 +73,13 @@ AampLicensePreFetcher::~AampLicensePreFetcher()
 	}
 	if (mPreFetchThreadStarted)
 	{
-		mQCond.notify_one();
-		AAMPLOG_WARN("Joining mPreFetchThread");
-		mPreFetchThread.join();
+		mQCond.notify_all();
+		AAMPLOG_WARN("Joining %zu mPreFetchThreads", mPreFetchThreads.size());
+		for (auto &thread : mPreFetchThreads)
+		{
+			thread.join();
+		}
+		mPreFetchThreads.clear();
 		mPreFetchThreadStarted = false;
 	}
 	if (mVssPreFetchThreadStarted)
@@ -96,13 +104,15 @@ bool AampLicensePreFetcher::Init()
 	{
 		AAMPLOG_WARN("PreFetch thread is already started when calling Init!!");
 	}
+	std::lock_guard<std::mutex>lock(mQMutex);
 	mTrackStatus.fill(false);
+	mStats = LicensePreFetchStats();
 	mExitLoop = false;
 	return ret;
 }
 
 /**
- * @brief Check to see if a key is already on the queue
+ * @brief Check to see if a key is already on the queue or being processed for the same track
  * 
  * @param fetchObject the key object to look for
  * @return true if key is on the queue
@@ -114,11 +124,21 @@ bool AampLicensePreFetcher::KeyIsQueued(LicensePreFetchObjectPtr &fetchObject)
 	std::vector<uint8_t> queuedKeyIdArray;
 
 	fetchObject->mHelper->getKey(fetchKeyIdArray);
-	for (auto queuedObject : mFetchQueue)
+	auto matches = [&](const LicensePreFetchObjectPtr &queuedObject)
 	{
 		queuedObject->mHelper->getKey(queuedKeyIdArray);
-		if ((queuedObject->mType == fetchObject->mType) &&
-			(queuedKeyIdArray == fetchKeyIdArray))
+		return (queuedObject->mType == fetchObject->mType) && (queuedKeyIdArray == fetchKeyIdArray);
+	};
+	for (auto &queuedObject : mFetchQueue)
+	{
+		if (matches(queuedObject) || std::any_of(queuedObject->mDuplicates.begin(), queuedObject->mDuplicates.end(), matches))
+		{
+			return true;
+		}
+	}
+	for (auto &queuedObject : mInFlight)
+	{
+		if (matches(queuedObject) || std::any_of(queuedObject->mDuplicates.begin(), queuedObject->mDuplicates.end(), matches))
 		{
 			return true;
 		}
@@ -126,6 +146,33 @@ bool AampLicensePreFetcher::KeyIsQueued(LicensePreFetchObjectPtr &fetchObject)
 	return false;
 }
 
+/**
+ * @brief Find a queued or in progress request of another track for the same key ID; caller holds mQMutex
+ */
+LicensePreFetchObjectPtr AampLicensePreFetcher::FindRequestForKey(LicensePreFetchObjectPtr &fetchObject)
+{
+	std::vector<uint8_t> fetchKeyIdArray;
+	std::vector<uint8_t> queuedKeyIdArray;
+
+	fetchObject->mHelper->getKey(fetchKeyIdArray);
+	if (fetchKeyIdArray.empty())
+	{
+		return nullptr;
+	}
+	auto matches = [&](const LicensePreFetchObjectPtr &queuedObject)
+	{
+		queuedObject->mHelper->getKey(queuedKeyIdArray);
+		return (queuedKeyIdArray == fetchKeyIdArray) && (queuedObject->mHelper->ocdmSystemId() == fetchObject->mHelper->ocdmSystemId());
+	};
+	auto inFlight = std::find_if(mInFlight.begin(), mInFlight.end(), matches);
+	if (inFlight != mInFlight.end())
+	{
+		return *inFlight;
+	}
+	auto queued = std::find_if(mFetchQueue.begin(), mFetchQueue.end(), matches);
+	return (queued != mFetchQueue.end()) ? *queued : nullptr;
+}
+
 
 /**
  * @brief Queue a content protection info to be processed later
@@ -134,10 +181,11 @@ bool AampLicensePreFetcher::KeyIsQueued(LicensePreFetchObjectPtr &fetchObject)
  * @param periodId ID of the period to which CP belongs to
  * @param adapId Index of the adaptation to which CP belongs to
  * @param type media type
+ * @param timeToPlay seconds until the content is expected to play, 0 if playing now
  * @return true if successfully queued
  * @return false if error occurred
  */
-bool AampLicensePreFetcher::QueueContentProtection(DrmHelperPtr drmHelper, std::string periodId, uint32_t adapIdx, AampMediaType type, bool isVssPeriod)
+bool AampLicensePreFetcher::QueueContentProtection(DrmHelperPtr drmHelper, std::string periodId, uint32_t adapIdx, AampMediaType type, bool isVssPeriod, double timeToPlay)
 {
 	bool ret = true;
 	if(!mExitLoop)
@@ -145,6 +193,8 @@ bool AampLicensePreFetcher::QueueContentProtection(DrmHelperPtr drmHelper, std::
 		LicensePreFetchObjectPtr fetchObject = std::make_shared<LicensePreFetchObject>(drmHelper, periodId, adapIdx, type, isVssPeriod);
 		if (fetchObject)
 		{
+			fetchObject->mQueuedTimeMs = NOW_STEADY_TS_MS;
+			fetchObject->mDeadlineMs = fetchObject->mQueuedTimeMs + (long long)(std::max(timeToPlay, 0.0) * 1000);
 			if(isVssPeriod)
 			{
 				std::lock_guard<std::mutex>lock(mQVssMutex);
@@ -173,16 +223,32 @@ bool AampLicensePreFetcher::QueueContentProtection(DrmHelperPtr drmHelper, std::
 					return true;
 				}
 
+				// Let the request of another track for the same key ID serve this track too
+				LicensePreFetchObjectPtr request = FindRequestForKey(fetchObject);
+				if (request)
+				{
+					AAMPLOG_INFO("Key already queued for type:%d, type:%d will use it", request->mType, fetchObject->mType);
+					request->mDuplicates.push_back(fetchObject);
+					request->mDeadlineMs = std::min(request->mDeadlineMs, fetchObject->mDeadlineMs);
+					mStats.deduplicated++;
+					return true;
+				}
+
 				mFetchQueue.push_back(fetchObject);
 				if (!mPreFetchThreadStarted)
 				{
-					AAMPLOG_WARN("Starting mPreFetchThread");
-					mPreFetchThread = std::thread(&AampLicensePreFetcher::PreFetchThread, this);
+					int workers = mPrivAAMP->mConfig->GetConfigValue(eAAMPConfig_LicensePrefetchWorkers);
+					workers = std::min(std::max(workers, 1), MAX_LICENSE_PREFETCH_WORKERS);
+					AAMPLOG_WARN("Starting %d mPreFetchThreads", workers);
+					for (int i = 0; i < workers; i++)
+					{
+						mPreFetchThreads.push_back(std::thread(&AampLicensePreFetcher::PreFetchThread, this));
+					}
 					mPreFetchThreadStarted = true;
 				}
 				else
 				{
-					AAMPLOG_WARN("Notify mPreFetchThread");
+					AAMPLOG_WARN("Notify mPreFetchThreads");
 					mQCond.notify_one();
 				}
 			}
@@ -217,16 +283,24 @@ bool AampLicensePreFetcher::Term()
 		{
 			mVssFetchQueue.pop_front();
 		}
+		// Requests still being processed complete without updating mTrackStatus, see CompleteRequest
+		mInFlight.clear();
+		if (mStats.requests)
+		{
+			AAMPLOG_MIL("License prefetch requests=%u failures=%u deduplicated=%u missedDeadlines=%u avgLatencyMs=%lld maxLatencyMs=%lld maxWaitMs=%lld",
+						mStats.requests, mStats.failures, mStats.deduplicated, mStats.missedDeadlines,
+						mStats.totalLatencyMs / mStats.requests, mStats.maxLatencyMs, mStats.maxWaitMs);
+		}
+		mTrackStatus.fill(false);
 	}
 	
-	mTrackStatus.fill(false);
 	mFetchInstance = nullptr;
 	return ret;
 }
 
 /**
  * @brief Thread for processing content protection queued using QueueContentProtection
- * Thread will be joined when Term is called
+ * Several threads take requests concurrently, the one of the content to play soonest first
  * 
  */
 void AampLicensePreFetcher::PreFetchThread()
@@ -242,13 +316,19 @@ void AampLicensePreFetcher::PreFetchThread()
 		}
 		else
 		{
-			LicensePreFetchObjectPtr obj = mFetchQueue.front(); // Leave the request on the queue
+			// Earliest deadline first, queue order among equal deadlines
+			auto next = std::min_element(mFetchQueue.begin(), mFetchQueue.end(),
+				[](const LicensePreFetchObjectPtr &a, const LicensePreFetchObjectPtr &b) { return a->mDeadlineMs < b->mDeadlineMs; });
+			LicensePreFetchObjectPtr obj = *next;
+			mFetchQueue.erase(next);
+			mInFlight.push_back(obj); // Keep the request visible to KeyIsQueued and NotifyDrmFailure
+			long long startTimeMs = NOW_STEADY_TS_MS;
 			queueLock.unlock();
 
+			bool keyStatus = false;
 			if (!mExitLoop)
 			{
 				bool skip = false;
-				bool keyStatus = false;
 				std::vector<uint8_t> keyIdArray;
 				obj->mHelper->getKey(keyIdArray);
 				if (!keyIdArray.empty() && mPrivAAMP->mDRMLicenseManager->mDrmSessionManager->IsKeyIdProcessed(keyIdArray, keyStatus))
@@ -269,30 +349,75 @@ void AampLicensePreFetcher::PreFetchThread()
 						keyStatus = true;
 					}
 				}
-				if (keyStatus)
-				{
-					AAMPLOG_INFO("Updating mTrackStatus to true for type:%d", obj->mType);
-					try
-					{
-						mTrackStatus.at(obj->mType) = true;
-					}
-					catch (std::out_of_range const& exc)
-					{
-						AAMPLOG_ERR("Unable to set the mTrackStatus for type:%d, caught exception: %s", obj->mType, exc.what());
-					}
-				}
 			}
 			queueLock.lock();
 
 			// Remove the request now we have processed it
-			if (!mFetchQueue.empty())
+			CompleteRequest(obj, startTimeMs, keyStatus);
+		}
+	}
+}
+
+/**
+ * @brief Update statistics and track status for a processed request, unless Term dropped it; caller holds mQMutex
+ */
+void AampLicensePreFetcher::CompleteRequest(LicensePreFetchObjectPtr obj, long long startTimeMs, bool keyStatus)
+{
+	auto inFlight = std::find(mInFlight.begin(), mInFlight.end(), obj);
+	if (inFlight == mInFlight.end())
+	{
+		// Dropped by Term while being processed; its result belongs to the previous tune
+		AAMPLOG_WARN("Ignoring license prefetch for type:%d period ID:%s completed after Term", obj->mType, obj->mPeriodId.c_str());
+		return;
+	}
+	mInFlight.erase(inFlight);
+
+	long long endTimeMs = NOW_STEADY_TS_MS;
+	long long waitMs = startTimeMs - obj->mQueuedTimeMs;
+	long long latencyMs = endTimeMs - obj->mQueuedTimeMs;
+	mStats.requests++;
+	mStats.totalLatencyMs += latencyMs;
+	mStats.maxLatencyMs = std::max(mStats.maxLatencyMs, latencyMs);
+	mStats.maxWaitMs = std::max(mStats.maxWaitMs, waitMs);
+	if (!keyStatus)
+	{
+		mStats.failures++;
+	}
+	if ((obj->mDeadlineMs > obj->mQueuedTimeMs) && (endTimeMs > obj->mDeadlineMs))
+	{
+		mStats.missedDeadlines++;
+		AAMPLOG_WARN("License for type:%d period ID:%s ready %lld ms after its content was due to play", obj->mType, obj->mPeriodId.c_str(), endTimeMs - obj->mDeadlineMs);
+	}
+	AAMPLOG_INFO("License prefetch for type:%d period ID:%s status:%d waitMs:%lld latencyMs:%lld tracks:%zu", obj->mType, obj->mPeriodId.c_str(), keyStatus, waitMs, latencyMs, obj->mDuplicates.size() + 1);
+
+	if (keyStatus)
+	{
+		std::vector<LicensePreFetchObjectPtr> served(obj->mDuplicates);
+		served.push_back(obj);
+		for (auto &request : served)
+		{
+			AAMPLOG_INFO("Updating mTrackStatus to true for type:%d", request->mType);
+			try
 			{
-				mFetchQueue.pop_front();
+				mTrackStatus.at(request->mType) = true;
+			}
+			catch (std::out_of_range const& exc)
+			{
+				AAMPLOG_ERR("Unable to set the mTrackStatus for type:%d, caught exception: %s", request->mType, exc.what());
 			}
 		}
 	}
 }
 
+/**
+ * @brief Get the pre-fetch statistics
+ */
+LicensePreFetchStats AampLicensePreFetcher::GetStats()
+{
+	std::lock_guard<std::mutex>lock(mQMutex);
+	return mStats;
+}
+
 /**
  * @brief Thread for processing VSS content protection queued using QueueContentProtection
  * Thread will be joined when Term is called
@@ -351,6 +476,7 @@ void AampLicensePreFetcher::VssPreFetchThread()
 				if (keyStatus)
 				{
 					AAMPLOG_INFO("Updating mTrackStatus to true for type:%d", obj->mType);
+					std::lock_guard<std::mutex>lock(mQMutex);
 					try
 					{
 						mTrackStatus.at(obj->mType) = true;
@@ -382,6 +508,7 @@ void AampLicensePreFetcher::NotifyDrmFailure(LicensePreFetchObjectPtr fetchObj,
 	// and skip below check. Maybe introduce a better data structure for mTrackStatus based on periodId
 	if (fetchObj && !mSendErrorOnFailure)
 	{
+		std::lock_guard<std::mutex>lock(mQMutex);
 		try
 		{
 			// Check if license already acquired for this track, then skip the error event broadcast
@@ -398,25 +525,17 @@ void AampLicensePreFetcher::NotifyDrmFailure(LicensePreFetchObjectPtr fetchObj,
 
 		if (!skipErrorEvent)
 		{
-			// Check if the mFetchQueue has a request for this track type queued
+			// Check if the mFetchQueue has, or another thread is processing, a request for this track type
 			// TODO: Check for race conditions between license acquisition and adding into fetch queue
-			std::lock_guard<std::mutex>lock(mQMutex);
-
-			for (auto obj : mFetchQueue)
+			auto isPending = [&fetchObj](const LicensePreFetchObjectPtr &obj)
 			{
-				if (obj == fetchObj)
-				{
-					// The current key is still on the queue so if pointers match we will ignore this check
-					// (this shoud be the first item in the queue)
-					continue;
-				}
-
-				if (obj->mType == fetchObj->mType)
-				{
-					skipErrorEvent = true;
-					AAMPLOG_WARN("Skipping DRM failure event, since a pending request exists for this track type:%d", fetchObj->mType);
-					break;
-				}
+				// The current key is still in mInFlight so if pointers match we will ignore this check
+				return (obj != fetchObj) && (obj->mType == fetchObj->mType);
+			};
+			if (std::any_of(mFetchQueue.begin(), mFetchQueue.end(), isPending) || std::any_of(mInFlight.begin(), mInFlight.end(), isPending))
+			{
+				skipErrorEvent = true;
+				AAMPLOG_WARN("Skipping DRM failure event, since a pending request exists for this track type:%d", fetchObj->mType);
 			}
 		}
 	}
@@ -444,6 +563,7 @@ void AampLicensePreFetcher::NotifyDrmFailure(LicensePreFetchObjectPtr fetchObj,
 			mPrivAAMP->SendDRMMetaData(event);	//Send Header response first for failure case.
 			AAMPLOG_ERR("Failed DRM Session sending error event");
 			mPrivAAMP->SendDrmErrorEvent(event, isRetryEnabled);
+			std::lock_guard<std::mutex>lock(mPlayerStateMutex);
 			mPrivAAMP->profiler.SetDrmErrorCode((int)failure);
 			mPrivAAMP->profiler.ProfileError(PROFILE_BUCKET_LA_TOTAL, (int)failure);
 		}
@@ -483,7 +603,10 @@ bool AampLicensePreFetcher::CreateDRMSession(LicensePreFetchObjectPtr fetchObj)
 	}
 	mPrivAAMP->setCurrentDrm(fetchObj->mHelper);
 
-	mPrivAAMP->profiler.ProfileBegin(PROFILE_BUCKET_LA_TOTAL);
+	{
+		std::lock_guard<std::mutex>lock(mPlayerStateMutex);
+		mPrivAAMP->profiler.ProfileBegin(PROFILE_BUCKET_LA_TOTAL);
+	}
 	DrmSession *drmSession = licenseManger->createDrmSession( fetchObj->mHelper, mPrivAAMP, e, (int)fetchObj->mType);
 
 
@@ -502,6 +625,7 @@ bool AampLicensePreFetcher::CreateDRMSession(LicensePreFetchObjectPtr fetchObj)
 			mPrivAAMP->SendDRMMetaData(e);
 		}
 	}
+	std::lock_guard<std::mutex>lock(mPlayerStateMutex);
 	mPrivAAMP->profiler.ProfileEnd(PROFILE_BUCKET_LA_TOTAL);
 	if(mPrivAAMP->mIsFakeTune)
 	{
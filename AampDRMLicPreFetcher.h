@@ -50,6 +50,9 @@ struct LicensePreFetchObject
 	int mId;                                /** Object ID*/
 	static int staticId;
 	bool mIsVssPeriod;
+	long long mQueuedTimeMs;                /** Steady clock time at which the object was queued*/
+	long long mDeadlineMs;                  /** Steady clock time at which the content is expected to play*/
+	std::vector<std::shared_ptr<LicensePreFetchObject>> mDuplicates; /** Requests of other tracks for the same key ID, served by this one*/
 
 	/**
 	 * @brief Construct a new License Pre Fetch Object object
@@ -65,7 +68,10 @@ struct LicensePreFetchObject
 															mAdaptationIdx(adapIdx),
 															mType(type),
 															mId(staticId++),
-															mIsVssPeriod(isVssPeriod)
+															mIsVssPeriod(isVssPeriod),
+															mQueuedTimeMs(0),
+															mDeadlineMs(0),
+															mDuplicates()
 	{
 		AAMPLOG_TRACE("Creating new LicensePreFetchObject, id:%d", mId);
 	}
@@ -94,6 +100,24 @@ struct LicensePreFetchObject
 
 using LicensePreFetchObjectPtr = std::shared_ptr<LicensePreFetchObject>;
 
+/**
+ * @brief License pre-fetch statistics of a player
+ */
+struct LicensePreFetchStats
+{
+	unsigned int requests;          /** Requests processed*/
+	unsigned int failures;          /** Requests which did not get a license*/
+	unsigned int deduplicated;      /** Requests served by the request of another track for the same key ID*/
+	unsigned int missedDeadlines;   /** Requests of upcoming content completed after the content was due to play*/
+	long long totalLatencyMs;       /** Sum of queued to completed times*/
+	long long maxLatencyMs;         /** Longest queued to completed time*/
+	long long maxWaitMs;            /** Longest queued to started time*/
+
+	LicensePreFetchStats() : requests(0), failures(0), deduplicated(0), missedDeadlines(0), totalLatencyMs(0), maxLatencyMs(0), maxWaitMs(0)
+	{
+	}
+};
+
 /**
  * @brief Class for License PreFetcher module.
  * Handles the license pre-fetching responsibilities in a playback for faster tune times
@@ -157,10 +181,11 @@ public:
 	 * @param adapId Index of the adaptation to which CP belongs to
 	 * @param type media type
 	 * @param isVssPeriod flag denotes if this is for a VSS period
+	 * @param timeToPlay seconds until the content is expected to play, 0 if playing now
 	 * @return true if successfully queued
 	 * @return false if error occurred
 	 */
-	bool QueueContentProtection(DrmHelperPtr drmHelper, std::string periodId, uint32_t adapIdx, AampMediaType type, bool isVssPeriod = false);
+	bool QueueContentProtection(DrmHelperPtr drmHelper, std::string periodId, uint32_t adapIdx, AampMediaType type, bool isVssPeriod = false, double timeToPlay = 0);
 
 	/**
 	 * @brief De-initialize/free resources
@@ -186,11 +211,19 @@ public:
 
 	/**
 	 * @brief Thread for processing content protection queued using QueueContentProtection
-	 * Thread will be joined when Term is called
+	 * Several threads take requests concurrently, the one of the content to play soonest first
+	 * Threads will be joined when the pre-fetcher is destroyed
 	 *
 	 */
 	void PreFetchThread();
 
+	/**
+	 * @brief Get the pre-fetch statistics
+	 *
+	 * @return statistics since Init
+	 */
+	LicensePreFetchStats GetStats();
+
 	/**
 	 * @brief Set to true if error event to be sent to application if any license request fails
 	 *  Otherwise, error event will be sent if a track doesn't have a successful or pending license request
@@ -225,11 +258,30 @@ private:
 	 */
 	bool CreateDRMSession(LicensePreFetchObjectPtr fetchObj);
 
-	std::thread mPreFetchThread;                        /** Thread for pre-fetching license*/
+	/**
+	 * @brief Find a queued or in progress request of another track for the same key ID; caller holds mQMutex
+	 *
+	 * @param fetchObject object to be queued
+	 * @return request serving the same key ID, nullptr if none
+	 */
+	LicensePreFetchObjectPtr FindRequestForKey(LicensePreFetchObjectPtr &fetchObject);
+
+	/**
+	 * @brief Update statistics and track status for a processed request, unless Term dropped it; caller holds mQMutex
+	 *
+	 * @param obj processed object
+	 * @param startTimeMs steady clock time at which processing started
+	 * @param keyStatus true if the license is available
+	 */
+	void CompleteRequest(LicensePreFetchObjectPtr obj, long long startTimeMs, bool keyStatus);
+
+	std::vector<std::thread> mPreFetchThreads;          /** Threads for pre-fetching licenses*/
 	std::deque<LicensePreFetchObjectPtr> mFetchQueue;   /** Queue for storing content protection objects*/
-	std::mutex mQMutex;                                 /** Mutex for accessing the mFetchQueue*/
+	std::vector<LicensePreFetchObjectPtr> mInFlight;    /** Objects being processed by mPreFetchThreads*/
+	LicensePreFetchStats mStats;                        /** Pre-fetch statistics*/
+	std::mutex mQMutex;                                 /** Mutex for accessing the mFetchQueue, mInFlight, mStats and mTrackStatus*/
 	std::condition_variable mQCond;                     /** Conditional variable to notify addition of an obj to mFetchQueue*/
-	bool mPreFetchThreadStarted;                        /** Flag denotes if thread started*/
+	bool mPreFetchThreadStarted;                        /** Flag denotes if threads started*/
 	bool mExitLoop;                                     /** Flag denotes if pre-fetch thread has to be exited*/
 	int mCommonKeyDuration;                             /** Common key duration for deferred license acquisition*/
 	std::array<bool, AAMP_TRACK_COUNT> mTrackStatus;    /** To mark the status of license acquisition for tracks*/
@@ -243,6 +295,7 @@ private:
 	std::condition_variable mQVssCond;                  /** Conditional variable to notify addition of an obj to mVssFetchQueue*/
 	bool mVssPreFetchThreadStarted;                     /** Flag denotes if Vss thread started*/
 	bool mIsSecClientError;
+	std::mutex mPlayerStateMutex;                       /** Serializes the player profiling and fake tune completion done by the pre-fetch threads*/
 };
 
 #endif /* _AAMP_LICENSE_PREFETCHER_HPP */
@@ -66,6 +66,8 @@
 #define MIN_LICENSE_KEY_ACQUIRE_WAIT_TIME 500			/**<minimum wait time in milliseconds for DRM license to ACQUIRE */
 #define DEFAULT_LICENSE_KEY_ACQUIRE_WAIT_TIME 5000		/**< Wait time in milliseconds for DRM license to ACQUIRE  */
 #define MAX_LICENSE_ACQ_WAIT_TIME 12000  			/**< 12 secs Increase from 10 to 12 sec */
+#define DEFAULT_LICENSE_PREFETCH_WORKERS 2			/**< License requests prefetched concurrently per player */
+#define MAX_LICENSE_PREFETCH_WORKERS 8				/**< Upper limit of concurrent license prefetch requests per player */
 #define DEFAULT_INIT_BITRATE     2500000            		/**< Initial bitrate: 2.5 mb - for non-4k playback */
 #define DEFAULT_BITRATE_OFFSET_FOR_DOWNLOAD 500000		/**< Offset in bandwidth window for checking buffer download expiry */
 #define DEFAULT_INIT_BITRATE_4K 13000000            		/**< Initial bitrate for 4K playback: 13mb ie, 3/4 profile */
@@ -108,6 +110,9 @@
 #define MAX_ANOMALY_BUFF_SIZE   256
 #define MAX_WAIT_TIMEOUT_MS	200				/**< Max Timeout duration for wait until cache is available to inject next*/
 #define MAX_INIT_FRAGMENT_CACHE_PER_TRACK  5       		/**< Max No Of cached Init fragments per track */
+#define DEFAULT_DISK_CACHE_MAX_SIZE (10*1024)			/**< Default on-disk cache size in KB */
+#define DEFAULT_DISK_CACHE_TTL (24*60*60)			/**< Default on-disk cache entry lifetime in seconds */
+#define DEFAULT_DISK_CACHE_LOCATION ""		/**< Default on-disk cache directory; empty selects a directory private to the user, see AampDiskCache::GetDefaultDirectory */
 #define MIN_SEG_DURATION_THRESHOLD	(0.25)			/**< Min Segment Duration threshold for pushing to pipeline at period End*/
 #define MAX_CURL_SOCK_STORE		10			/**< Maximum no of host to be maintained in curl store*/
 #define DEFAULT_AD_FULFILLMENT_TIMEOUT 2000	/**< Default Ad fulfillment timeout in milliseconds */
@@ -223,6 +228,9 @@
 // LLD TSB Defaults
 #define DEFAULT_MIN_TSB_STORAGE_FREE_PERCENTAGE 10	// Percentage of free space in TSB 
 #define DEFAULT_MAX_TSB_STORAGE_MB				10*1024	// 10 GiB 
+#define DEFAULT_TSB_DIRECT_IO_THRESHOLD_KB		0	// Direct I/O disabled
+#define DEFAULT_TSB_PACK_FILE_SIZE_MB			32	// TSB pack file size
+#define DEFAULT_TSB_WRITE_QUEUE_DEPTH			32	// Max TSB fragments queued for writing per track
 #ifdef USE_TSBCONFIG_FOR_HYBRID		// for devices with more generous storage mounted at /opt/data 
 #define DEFAULT_TSB_DURATION 3600
 #define DEFAULT_TSB_LOCATION "/opt/data/fog/aamp"
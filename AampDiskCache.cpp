@@ -0,0 +1,596 @@
+/*
+ * If not stated otherwise in this file or this component's license file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2024 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/**
+ * @file AampDiskCache.cpp
+ * @brief Persistent on-disk cache for initialization fragments and playlists
+ */
+
+#include "AampDiskCache.h"
+#include "AampLogManager.h"
+#include "AampUtils.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <errno.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <utime.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <vector>
+#include <algorithm>
+
+/**
+ * @brief AampDiskCache Constructor
+ */
+AampDiskCache::AampDiskCache() : mMutex(), mEnabled(false), mDirectory(), mMaxBytes(0), mTtlSeconds(0), mTotalBytes(0), mIndex(), mLru(), mGeneration(0), mTmpSequence(0)
+{
+}
+
+/**
+ * @brief AampDiskCache Destructor
+ */
+AampDiskCache::~AampDiskCache()
+{
+}
+
+/**
+ * @brief Get the singleton instance of the cache
+ */
+AampDiskCache& AampDiskCache::GetInstance()
+{
+	static AampDiskCache instance;
+	return instance;
+}
+
+/**
+ * @brief Hash of a url (64 bit FNV-1a), used as the entry file name
+ */
+uint64_t AampDiskCache::HashUrl(const std::string &url)
+{
+	uint64_t hash = 0xcbf29ce484222325ULL;
+	for( unsigned char c : url )
+	{
+		hash ^= c;
+		hash *= 0x100000001b3ULL;
+	}
+	return hash;
+}
+
+/**
+ * @brief Get the path of the entry file for a hash
+ */
+std::string AampDiskCache::GetFilePath(const std::string &directory, uint64_t hash)
+{
+	char name[32];
+	snprintf(name, sizeof(name), "%016llx" AAMP_DISK_CACHE_FILE_EXT, (unsigned long long)hash);
+	return directory + "/" + name;
+}
+
+/**
+ * @brief Get the default cache directory, in the cache area of the user running the player
+ */
+std::string AampDiskCache::GetDefaultDirectory()
+{
+	std::string directory;
+	const char *base = getenv("XDG_CACHE_HOME");
+	if( base && *base )
+	{
+		directory = std::string(base) + "/aamp";
+	}
+	else if( (base = getenv("HOME")) != NULL && *base )
+	{
+		directory = std::string(base) + "/.cache/aamp";
+	}
+	else
+	{ // shared location; PrepareDirectory refuses it if another user got there first
+		directory = "/tmp/aamp_cache_" + std::to_string(geteuid());
+	}
+	return directory;
+}
+
+/**
+ * @brief Create the cache directory if missing and check it is private to the current user
+ */
+bool AampDiskCache::PrepareDirectory(const std::string &directory)
+{
+	size_t pos = 0;
+	do
+	{ // create missing parents as well
+		pos = directory.find('/', pos + 1);
+		std::string part = directory.substr(0, pos);
+		if( mkdir(part.c_str(), 0700) != 0 && errno != EEXIST )
+		{
+			AAMPLOG_ERR("Failed to create disk cache directory %s errno %d", part.c_str(), errno);
+			return false;
+		}
+	} while( pos != std::string::npos );
+	// entries are trusted when loaded, so nobody else may be able to plant or replace them
+	struct stat st;
+	if( lstat(directory.c_str(), &st) != 0 || !S_ISDIR(st.st_mode) || st.st_uid != geteuid() )
+	{
+		AAMPLOG_ERR("Disk cache directory %s is not a directory owned by this user", directory.c_str());
+		return false;
+	}
+	if( (st.st_mode & 077) && chmod(directory.c_str(), 0700) != 0 )
+	{
+		AAMPLOG_ERR("Failed to restrict disk cache directory %s errno %d", directory.c_str(), errno);
+		return false;
+	}
+	return true;
+}
+
+/**
+ * @brief Apply configuration; (re)builds the index when the directory changes
+ */
+void AampDiskCache::Configure(bool enable, const std::string &directory, size_t maxBytes, int ttlSeconds)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	mMaxBytes = maxBytes;
+	mTtlSeconds = ttlSeconds;
+	mEnabled = false;
+	if( enable && maxBytes > 0 && ttlSeconds > 0 )
+	{
+		std::string cacheDirectory = directory.empty() ? GetDefaultDirectory() : directory;
+		if( cacheDirectory != mDirectory )
+		{
+			mIndex.clear();
+			mLru.clear();
+			mTotalBytes = 0;
+			mDirectory = cacheDirectory;
+			if( PrepareDirectory(mDirectory) )
+			{
+				ScanDirectory();
+			}
+			else
+			{
+				mDirectory.clear();
+			}
+		}
+		if( !mDirectory.empty() )
+		{
+			Evict(0);
+			mEnabled = true;
+		}
+	}
+}
+
+/**
+ * @brief Check if the cache is enabled and usable
+ */
+bool AampDiskCache::IsEnabled()
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	return mEnabled;
+}
+
+/**
+ * @brief Rebuild the index from the entry files in mDirectory
+ */
+void AampDiskCache::ScanDirectory()
+{
+	struct ScannedEntry
+	{
+		uint64_t hash;
+		size_t size;
+		int64_t expiry;
+		time_t lastAccess;
+	};
+	std::vector<ScannedEntry> scanned;
+	int64_t now = NOW_SYSTEM_TS_SECS;
+	DIR *dir = opendir(mDirectory.c_str());
+	if( dir )
+	{
+		struct dirent *dirEntry;
+		while( (dirEntry = readdir(dir)) != NULL )
+		{
+			const char *name = dirEntry->d_name;
+			const char *ext = strchr(name, '.');
+			if( ext == NULL || strcmp(ext, AAMP_DISK_CACHE_FILE_EXT) != 0 || (ext - name) != 16 )
+			{ // not an entry file; temporary files of an interrupted Store are left for their owner
+				continue;
+			}
+			std::string path = mDirectory + "/" + name;
+			char *end = NULL;
+			uint64_t hash = strtoull(name, &end, 16);
+			bool valid = (end == ext);
+			struct stat st;
+			AampDiskCacheFileHeader header;
+			if( valid )
+			{
+				valid = false;
+				FILE *fp = fopen(path.c_str(), "rb");
+				if( fp )
+				{
+					if( fstat(fileno(fp), &st) == 0 &&
+						fread(&header, sizeof(header), 1, fp) == 1 &&
+						header.magic == AAMP_DISK_CACHE_MAGIC &&
+						header.version == AAMP_DISK_CACHE_VERSION &&
+						(uint64_t)st.st_size == sizeof(header) + header.urlLength + header.effectiveUrlLength + header.dataLength )
+					{
+						valid = true;
+					}
+					fclose(fp);
+				}
+			}
+			if( valid && header.expiry > now )
+			{
+				scanned.push_back({hash, (size_t)st.st_size, header.expiry, st.st_mtime});
+			}
+			else
+			{
+				unlink(path.c_str());
+			}
+		}
+		closedir(dir);
+	}
+	else
+	{
+		AAMPLOG_ERR("Failed to open disk cache directory %s errno %d", mDirectory.c_str(), errno);
+	}
+	// entry files are touched on every hit, so modification time gives the recency order across restarts
+	std::sort(scanned.begin(), scanned.end(), [](const ScannedEntry &a, const ScannedEntry &b) { return a.lastAccess < b.lastAccess; });
+	for( auto &entry : scanned )
+	{
+		AddEntry(entry.hash, entry.size, entry.expiry);
+	}
+	AAMPLOG_MIL("Disk cache %s entries=%zu size=%zu", mDirectory.c_str(), mIndex.size(), mTotalBytes);
+}
+
+/**
+ * @brief Add an entry to the index as most recently used
+ */
+void AampDiskCache::AddEntry(uint64_t hash, size_t size, int64_t expiry)
+{
+	auto iter = mIndex.find(hash);
+	if( iter != mIndex.end() )
+	{
+		mTotalBytes -= iter->second.size;
+		mLru.erase(iter->second.lruPos);
+		mIndex.erase(iter);
+	}
+	Entry &entry = mIndex[hash];
+	entry.size = size;
+	entry.expiry = expiry;
+	entry.generation = ++mGeneration;
+	entry.lruPos = mLru.insert(mLru.end(), hash);
+	mTotalBytes += size;
+}
+
+/**
+ * @brief Drop an entry from the index and delete its file
+ */
+void AampDiskCache::RemoveEntry(uint64_t hash)
+{
+	auto iter = mIndex.find(hash);
+	if( iter != mIndex.end() )
+	{
+		mTotalBytes -= iter->second.size;
+		mLru.erase(iter->second.lruPos);
+		mIndex.erase(iter);
+	}
+	unlink(GetFilePath(mDirectory, hash).c_str());
+}
+
+/**
+ * @brief Evict least recently used entries until bytesNeeded more fit the size cap
+ */
+void AampDiskCache::Evict(size_t bytesNeeded)
+{
+	while( !mLru.empty() && mTotalBytes + bytesNeeded > mMaxBytes )
+	{
+		uint64_t hash = mLru.front(); // copy, as RemoveEntry releases the list node
+		RemoveEntry(hash);
+	}
+}
+
+/**
+ * @brief Persist an entry, replacing any previous entry for the same url
+ */
+bool AampDiskCache::Store(const std::string &url, const AampGrowableBuffer *buffer, const std::string &effectiveUrl, AampMediaType mediaType, int maxAgeSeconds)
+{
+	bool ret = false;
+	std::string directory;
+	size_t maxBytes = 0;
+	int ttl = 0;
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		if( mEnabled )
+		{
+			directory = mDirectory;
+			maxBytes = mMaxBytes;
+			ttl = mTtlSeconds;
+		}
+	}
+	if( !directory.empty() && maxAgeSeconds != 0 && buffer->GetLen() > 0 )
+	{
+		AampDiskCacheFileHeader header;
+		memset(&header, 0, sizeof(header));
+		header.magic = AAMP_DISK_CACHE_MAGIC;
+		header.version = AAMP_DISK_CACHE_VERSION;
+		if( maxAgeSeconds > 0 && maxAgeSeconds < ttl )
+		{
+			ttl = maxAgeSeconds;
+		}
+		header.expiry = NOW_SYSTEM_TS_SECS + ttl;
+		header.mediaType = (uint32_t)mediaType;
+		header.urlLength = (uint32_t)url.size();
+		header.effectiveUrlLength = (uint32_t)effectiveUrl.size();
+		header.dataLength = buffer->GetLen();
+		size_t size = sizeof(header) + header.urlLength + header.effectiveUrlLength + header.dataLength;
+		if( size <= maxBytes )
+		{
+			uint64_t hash = HashUrl(url);
+			std::string path = GetFilePath(directory, hash);
+			// unique temporary name, so that concurrent writers sharing the directory never see partial files
+			std::string tmpPath = path + ".tmp" + std::to_string(getpid()) + "." + std::to_string(mTmpSequence++);
+			FILE *fp = fopen(tmpPath.c_str(), "wb");
+			if( fp )
+			{
+				bool ok = (fwrite(&header, sizeof(header), 1, fp) == 1) &&
+						(fwrite(url.data(), 1, url.size(), fp) == url.size()) &&
+						(fwrite(effectiveUrl.data(), 1, effectiveUrl.size(), fp) == effectiveUrl.size()) &&
+						(fwrite(buffer->GetPtr(), 1, buffer->GetLen(), fp) == buffer->GetLen());
+				ok = (fclose(fp) == 0) && ok;
+				if( ok )
+				{ // publish under the lock, so that the index and the directory agree
+					std::lock_guard<std::mutex> lock(mMutex);
+					ok = mEnabled && (mDirectory == directory);
+					if( ok )
+					{
+						Evict(size);
+						ok = (rename(tmpPath.c_str(), path.c_str()) == 0);
+					}
+					if( ok )
+					{
+						AddEntry(hash, size, header.expiry);
+					}
+				}
+				if( ok )
+				{
+					AAMPLOG_INFO("stored %s %s ttl %d", GetMediaTypeName(mediaType), url.c_str(), ttl);
+					ret = true;
+				}
+				else
+				{
+					AAMPLOG_WARN("Failed to write disk cache entry %s errno %d", path.c_str(), errno);
+					unlink(tmpPath.c_str());
+				}
+			}
+			else
+			{
+				AAMPLOG_WARN("Failed to create disk cache entry %s errno %d", tmpPath.c_str(), errno);
+			}
+		}
+	}
+	return ret;
+}
+
+/**
+ * @brief Read a fresh entry
+ */
+bool AampDiskCache::Load(const std::string &url, AampGrowableBuffer *buffer, std::string &effectiveUrl, AampMediaType &mediaType)
+{
+	bool ret = false;
+	uint64_t hash = HashUrl(url);
+	uint64_t generation = 0;
+	std::string path;
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		if( mEnabled )
+		{
+			auto iter = mIndex.find(hash);
+			if( iter != mIndex.end() )
+			{
+				if( iter->second.expiry <= NOW_SYSTEM_TS_SECS )
+				{
+					AAMPLOG_INFO("expired %s", url.c_str());
+					RemoveEntry(hash);
+				}
+				else
+				{
+					path = GetFilePath(mDirectory, hash);
+					generation = iter->second.generation;
+				}
+			}
+		}
+	}
+	if( !path.empty() )
+	{
+		// read without the lock; a concurrent Store replaces the file by rename, so this sees either complete version
+		bool remove = true;
+		FILE *fp = fopen(path.c_str(), "rb");
+		if( fp )
+		{
+			AampDiskCacheFileHeader header;
+			struct stat st;
+			// the lengths must account for the whole file, so a corrupt header can't size the buffer
+			if( fstat(fileno(fp), &st) == 0 &&
+				fread(&header, sizeof(header), 1, fp) == 1 &&
+				header.magic == AAMP_DISK_CACHE_MAGIC &&
+				header.version == AAMP_DISK_CACHE_VERSION &&
+				header.urlLength <= AAMP_DISK_CACHE_MAX_URL_LEN &&
+				header.effectiveUrlLength <= AAMP_DISK_CACHE_MAX_URL_LEN &&
+				header.mediaType < eMEDIATYPE_DEFAULT &&
+				header.dataLength <= (uint64_t)st.st_size &&
+				(uint64_t)st.st_size == sizeof(header) + header.urlLength + header.effectiveUrlLength + header.dataLength )
+			{
+				std::string storedUrl(header.urlLength, '\0');
+				std::string storedEffectiveUrl(header.effectiveUrlLength, '\0');
+				if( fread(&storedUrl[0], 1, header.urlLength, fp) == header.urlLength &&
+					fread(&storedEffectiveUrl[0], 1, header.effectiveUrlLength, fp) == header.effectiveUrlLength )
+				{
+					if( storedUrl != url )
+					{ // hash collision; keep the other url's entry
+						remove = false;
+					}
+					else
+					{
+						buffer->Free();
+						buffer->ReserveBytes(header.dataLength);
+						if( buffer->GetPtr() && fread(buffer->GetPtr(), 1, header.dataLength, fp) == header.dataLength )
+						{
+							buffer->SetLen(header.dataLength);
+							effectiveUrl = storedEffectiveUrl;
+							mediaType = (AampMediaType)header.mediaType;
+							remove = false;
+							ret = true;
+						}
+						else
+						{
+							buffer->Free();
+						}
+					}
+				}
+			}
+			fclose(fp);
+		}
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			auto iter = mIndex.find(hash);
+			// leave the index alone if the entry was replaced or removed meanwhile
+			if( iter != mIndex.end() && iter->second.generation == generation )
+			{
+				if( ret )
+				{
+					mLru.splice(mLru.end(), mLru, iter->second.lruPos);
+				}
+				else if( remove )
+				{
+					AAMPLOG_WARN("dropping unreadable disk cache entry %s", path.c_str());
+					RemoveEntry(hash);
+				}
+			}
+		}
+		if( ret )
+		{
+			// persist recency, so LRU order survives a restart
+			utime(path.c_str(), NULL);
+			AAMPLOG_INFO("%s %s found", GetMediaTypeName(mediaType), url.c_str());
+		}
+	}
+	return ret;
+}
+
+/**
+ * @brief Remove an entry, if present
+ */
+void AampDiskCache::Remove(const std::string &url)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	uint64_t hash = HashUrl(url);
+	if( mIndex.find(hash) != mIndex.end() )
+	{
+		RemoveEntry(hash);
+	}
+}
+
+/**
+ * @brief Remove all entries from disk
+ */
+void AampDiskCache::Clear()
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	while( !mLru.empty() )
+	{
+		uint64_t hash = mLru.front();
+		RemoveEntry(hash);
+	}
+}
+
+/**
+ * @brief Get the total size of all entry files
+ */
+size_t AampDiskCache::GetSize()
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	return mTotalBytes;
+}
+
+/**
+ * @brief Get the number of entries in the index
+ */
+size_t AampDiskCache::GetEntryCount()
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	return mIndex.size();
+}
+
+/**
+ * @brief Get max-age from a Cache-Control header value
+ */
+int AampDiskCache::ParseCacheControl(const std::string &value)
+{
+	int maxAge = AAMP_DISK_CACHE_MAX_AGE_UNSPECIFIED;
+	size_t pos = 0;
+	while( pos < value.size() )
+	{
+		size_t next = value.find(',', pos);
+		if( next == std::string::npos )
+		{
+			next = value.size();
+		}
+		size_t start = value.find_first_not_of(" \t", pos);
+		if( start != std::string::npos && start < next )
+		{
+			const char *directive = value.c_str() + start;
+			if( strncasecmp(directive, "no-store", 8) == 0 || strncasecmp(directive, "no-cache", 8) == 0 )
+			{ // strongest directive wins
+				maxAge = 0;
+				break;
+			}
+			else if( strncasecmp(directive, "max-age=", 8) == 0 )
+			{
+				maxAge = atoi(directive + 8);
+				if( maxAge < 0 )
+				{
+					maxAge = 0;
+				}
+			}
+		}
+		pos = next + 1;
+	}
+	return maxAge;
+}
+
+/**
+ * @brief Check if a media type is eligible for the disk cache
+ */
+bool AampDiskCache::IsCacheableMediaType(AampMediaType mediaType)
+{
+	switch( mediaType )
+	{
+		case eMEDIATYPE_MANIFEST:
+		case eMEDIATYPE_INIT_VIDEO:
+		case eMEDIATYPE_INIT_AUDIO:
+		case eMEDIATYPE_INIT_SUBTITLE:
+		case eMEDIATYPE_INIT_AUX_AUDIO:
+		case eMEDIATYPE_INIT_IFRAME:
+		case eMEDIATYPE_PLAYLIST_VIDEO:
+		case eMEDIATYPE_PLAYLIST_AUDIO:
+		case eMEDIATYPE_PLAYLIST_SUBTITLE:
+		case eMEDIATYPE_PLAYLIST_AUX_AUDIO:
+		case eMEDIATYPE_PLAYLIST_IFRAME:
+			return true;
+		default:
+			return false;
+	}
+}
@@ -0,0 +1,237 @@
+/*
+ * If not stated otherwise in this file or this component's license file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2024 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/**
+ * @file AampDiskCache.h
+ * @brief Persistent on-disk cache for initialization fragments and playlists
+ */
+
+#ifndef __AAMP_DISK_CACHE_H__
+#define __AAMP_DISK_CACHE_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+#include <list>
+#include <unordered_map>
+#include <mutex>
+#include <atomic>
+#include "AampMediaType.h"
+#include "AampGrowableBuffer.h"
+
+#define AAMP_DISK_CACHE_MAGIC			0x31434441	/**< "ADC1" */
+#define AAMP_DISK_CACHE_VERSION			1
+#define AAMP_DISK_CACHE_FILE_EXT		".adc"		/**< extension of cache entry files */
+#define AAMP_DISK_CACHE_MAX_URL_LEN		(16*1024)	/**< sanity limit applied when reading entry files */
+#define AAMP_DISK_CACHE_MAX_AGE_UNSPECIFIED	(-1)	/**< no Cache-Control freshness directive in the response */
+
+/**
+ * @struct AampDiskCacheFileHeader
+ * @brief Fixed size header at the start of every cache entry file, followed by url, effectiveUrl and payload
+ */
+struct AampDiskCacheFileHeader
+{
+	uint32_t magic;				/**< AAMP_DISK_CACHE_MAGIC */
+	uint32_t version;			/**< AAMP_DISK_CACHE_VERSION */
+	int64_t expiry;				/**< expiry time, seconds since epoch */
+	uint32_t mediaType;			/**< AampMediaType of the entry */
+	uint32_t urlLength;			/**< length of url, without NUL */
+	uint32_t effectiveUrlLength;	/**< length of effectiveUrl, without NUL */
+	uint32_t reserved;
+	uint64_t dataLength;		/**< payload length */
+};
+
+/**
+ * @class AampDiskCache
+ * @brief Process wide persistent cache tier behind AampCacheHandler
+ *
+ * Each entry is stored in its own file, named after a hash of the url, so that entries
+ * can be replaced atomically (write to a temporary file, then rename) and survive player
+ * teardown and process restarts. The in-memory index (size, expiry and recency of every
+ * entry) is rebuilt from the directory when the cache is configured; it is used to enforce
+ * the size cap without touching the file system, evicting least recently used entries first.
+ * The index lock is not held while entry files are read or written, so players loading
+ * and storing different entries do not wait on each other's disk I/O.
+ *
+ * The directory is private to the user running the player: it is created with mode 0700,
+ * and an existing directory owned by another user (or a symbolic link) is refused.
+ *
+ * Freshness is the minimum of the configured TTL and any Cache-Control max-age received
+ * with the response; responses marked no-store or no-cache are never persisted.
+ */
+class AampDiskCache
+{
+public:
+	/**
+	 * @brief Get the singleton instance of the cache
+	 * @return AampDiskCache instance
+	 */
+	static AampDiskCache& GetInstance();
+
+	/**
+	 * @brief Apply configuration; (re)builds the index when the directory changes
+	 * @param[in] enable - false disables Store and Load, leaving files on disk untouched
+	 * @param[in] directory - directory holding the entry files; created if missing, GetDefaultDirectory() if empty
+	 * @param[in] maxBytes - size cap of all entry files
+	 * @param[in] ttlSeconds - max time an entry is considered fresh
+	 */
+	void Configure(bool enable, const std::string &directory, size_t maxBytes, int ttlSeconds);
+
+	/**
+	 * @brief Check if the cache is enabled and usable
+	 * @return true if enabled
+	 */
+	bool IsEnabled();
+
+	/**
+	 * @brief Persist an entry, replacing any previous entry for the same url
+	 * @param[in] url - primary key
+	 * @param[in] buffer - payload
+	 * @param[in] effectiveUrl - final url after redirects
+	 * @param[in] mediaType - type of the entry
+	 * @param[in] maxAgeSeconds - Cache-Control max-age of the response, 0 if it must not be stored, AAMP_DISK_CACHE_MAX_AGE_UNSPECIFIED if absent
+	 * @return true if stored
+	 */
+	bool Store(const std::string &url, const AampGrowableBuffer *buffer, const std::string &effectiveUrl, AampMediaType mediaType, int maxAgeSeconds);
+
+	/**
+	 * @brief Read a fresh entry
+	 * @param[in] url - primary key
+	 * @param[out] buffer - payload
+	 * @param[out] effectiveUrl - final url recorded with the entry
+	 * @param[out] mediaType - type recorded with the entry
+	 * @return true if found and fresh
+	 */
+	bool Load(const std::string &url, AampGrowableBuffer *buffer, std::string &effectiveUrl, AampMediaType &mediaType);
+
+	/**
+	 * @brief Remove an entry, if present
+	 * @param[in] url - primary key
+	 */
+	void Remove(const std::string &url);
+
+	/**
+	 * @brief Remove all entries from disk
+	 */
+	void Clear();
+
+	/**
+	 * @brief Get the total size of all entry files
+	 * @return size in bytes
+	 */
+	size_t GetSize();
+
+	/**
+	 * @brief Get the number of entries in the index
+	 * @return entry count
+	 */
+	size_t GetEntryCount();
+
+	/**
+	 * @brief Get max-age from a Cache-Control header value
+	 * @param[in] value - header value, e.g. "public, max-age=600"
+	 * @return max-age in seconds, 0 for no-store or no-cache, AAMP_DISK_CACHE_MAX_AGE_UNSPECIFIED if neither present
+	 */
+	static int ParseCacheControl(const std::string &value);
+
+	/**
+	 * @brief Check if a media type is eligible for the disk cache
+	 * @param[in] mediaType - media type
+	 * @return true for the main manifest, playlists and initialization fragments
+	 */
+	static bool IsCacheableMediaType(AampMediaType mediaType);
+
+	/**
+	 * @brief Get the default cache directory, in the cache area of the user running the player
+	 * @return $XDG_CACHE_HOME/aamp or $HOME/.cache/aamp, /tmp/aamp_cache_<uid> if neither is set
+	 */
+	static std::string GetDefaultDirectory();
+
+	AampDiskCache(const AampDiskCache&) = delete;
+	AampDiskCache& operator=(const AampDiskCache&) = delete;
+
+private:
+	/**
+	 * @struct Entry
+	 * @brief Index record of an entry file
+	 */
+	struct Entry
+	{
+		size_t size;							/**< file size */
+		int64_t expiry;							/**< expiry time, seconds since epoch */
+		uint64_t generation;					/**< distinguishes an entry from a later replacement for the same url */
+		std::list<uint64_t>::iterator lruPos;	/**< position in mLru */
+
+		Entry() : size(0), expiry(0), generation(0), lruPos()
+		{
+		}
+	};
+
+	AampDiskCache();
+	~AampDiskCache();
+
+	/**
+	 * @brief Hash of a url, used as the entry file name
+	 */
+	static uint64_t HashUrl(const std::string &url);
+
+	/**
+	 * @brief Get the path of the entry file for a hash
+	 */
+	static std::string GetFilePath(const std::string &directory, uint64_t hash);
+
+	/**
+	 * @brief Create the cache directory if missing and check it is private to the current user
+	 * @return true if usable
+	 */
+	static bool PrepareDirectory(const std::string &directory);
+
+	/**
+	 * @brief Rebuild the index from the entry files in mDirectory; called with mMutex held
+	 */
+	void ScanDirectory();
+
+	/**
+	 * @brief Add an entry to the index as most recently used; called with mMutex held
+	 */
+	void AddEntry(uint64_t hash, size_t size, int64_t expiry);
+
+	/**
+	 * @brief Drop an entry from the index and delete its file; called with mMutex held
+	 */
+	void RemoveEntry(uint64_t hash);
+
+	/**
+	 * @brief Evict least recently used entries until bytesNeeded more fit the size cap; called with mMutex held
+	 */
+	void Evict(size_t bytesNeeded);
+
+	std::mutex mMutex;	/**< guards the configuration and the index, not the entry files */
+	bool mEnabled;
+	std::string mDirectory;
+	size_t mMaxBytes;
+	int mTtlSeconds;
+	size_t mTotalBytes;
+	std::unordered_map<uint64_t, Entry> mIndex;
+	std::list<uint64_t> mLru;	/**< entry hashes, least recently used first */
+	uint64_t mGeneration;		/**< last generation handed to an entry */
+	std::atomic<uint32_t> mTmpSequence;	/**< makes temporary file names of concurrent Store calls unique */
+};
+
+#endif /* __AAMP_DISK_CACHE_H__ */
@@ -48,12 +48,14 @@ guint AampEventManager::GetSourceID()
  */
 AampEventManager::AampEventManager(int playerId): mIsFakeTune(false),
 					mAsyncTuneEnabled(false),mEventPriority(G_PRIORITY_DEFAULT_IDLE),mMutexVar(),
-					mPlayerState(eSTATE_IDLE),mEventWorkerDataQue(),mPendingAsyncEvents(),mPlayerId(playerId)
+					mPlayerState(eSTATE_IDLE),mEventWorkerDataQue(),mPendingAsyncEvents(),
+					mEventBatching(false),mBatchScheduled(false),mEventBatch(),mBatchStats(),mPlayerId(playerId)
 {
 	for (int i = 0; i < AAMP_MAX_NUM_EVENTS; i++)
 	{
 		mEventListeners[i]	= NULL;
 		mEventStats[i]		=	 0;
+		mBatchPosition[i]	=	 0;
 	}
 }
 
@@ -82,12 +84,15 @@ AampEventManager::~AampEventManager()
  */
 void AampEventManager::FlushPendingEvents()
 {
+	LogEventStats();
 	std::lock_guard<std::mutex> guard(mMutexVar);
 	while(!mEventWorkerDataQue.empty())
 	{
 		// Remove each AampEventPtr from the queue , not deleting the Shard_ptr
 		mEventWorkerDataQue.pop();
 	}
+	mEventBatch.clear();
+	mBatchScheduled = false;
 
 	if (mPendingAsyncEvents.size() > 0)
 	{
@@ -103,9 +108,16 @@ void AampEventManager::FlushPendingEvents()
 		}
 		mPendingAsyncEvents.clear();
 	}
+	for (auto &stats : mBatchStats)
+	{
+		stats = AampEventStats();
+	}
 
 	for (int i = 0; i < AAMP_MAX_NUM_EVENTS; i++)
+	{
 		mEventStats[i] = 0;
+		mBatchPosition[i] = 0;
+	}
 #ifdef EVENT_DEBUGGING
 	for (int i = 0; i < AAMP_MAX_NUM_EVENTS; i++)
 	{
@@ -246,6 +258,56 @@ void AampEventManager::SetAsyncTuneState(bool isAsyncTuneSetting)
 	}
 }
 
+/**
+ * @brief SetEventBatching - Flag for batched async event dispatch
+ */
+void AampEventManager::SetEventBatching(bool enable)
+{
+	std::lock_guard<std::mutex> guard(mMutexVar);
+	mEventBatching = enable;
+}
+
+/**
+ * @brief GetEventStats - Get batched dispatch stats of one event type
+ */
+bool AampEventManager::GetEventStats(AAMPEventType eventType, AampEventStats &stats)
+{
+	bool retVal = false;
+	if ((eventType >= AAMP_EVENT_ALL_EVENTS) && (eventType < AAMP_MAX_NUM_EVENTS))
+	{
+		std::lock_guard<std::mutex> guard(mMutexVar);
+		stats = mBatchStats[eventType];
+		retVal = true;
+	}
+	return retVal;
+}
+
+/**
+ * @brief LogEventStats - Log batched dispatch stats of all event types seen since the last flush
+ */
+void AampEventManager::LogEventStats()
+{
+	std::lock_guard<std::mutex> guard(mMutexVar);
+	for (int i = 0; i < AAMP_MAX_NUM_EVENTS; i++)
+	{
+		const AampEventStats &stats = mBatchStats[i];
+		if (stats.dispatched || stats.coalesced)
+		{
+			AAMPLOG_MIL("EventType[%d] dispatched=%u coalesced=%u avgLatencyMs=%lld maxLatencyMs=%lld maxQueueDepth=%zu",
+						i, stats.dispatched, stats.coalesced, stats.dispatched ? (stats.totalLatencyMs / stats.dispatched) : 0LL,
+						stats.maxLatencyMs, stats.maxQueueDepth);
+		}
+	}
+}
+
+/**
+ * @brief IsCoalescableEvent - Events carrying only the latest state, where listeners need not see every update
+ */
+bool AampEventManager::IsCoalescableEvent(AAMPEventType eventType)
+{
+	return (eventType == AAMP_EVENT_PROGRESS) || (eventType == AAMP_EVENT_SPEEDS_CHANGED);
+}
+
 /**
  * @brief SetPlayerState - Flag to update player state
  */
@@ -325,6 +387,44 @@ void AampEventManager::AsyncEvent()
 	}
 }
 
+/**
+ * @brief AsyncEventBatch - Task function for IdleEvent in batch mode, dispatches every event queued so far
+ */
+void AampEventManager::AsyncEventBatch()
+{
+	std::vector<BatchedEvent> batch;
+	{
+		std::lock_guard<std::mutex> guard(mMutexVar);
+		batch.swap(mEventBatch);
+		mBatchScheduled = false;
+		for (const auto &pending : batch)
+		{
+			if (pending.event)
+			{
+				mBatchPosition[pending.event->getType()] = 0;
+			}
+		}
+	}
+	for (const auto &pending : batch)
+	{
+		if (pending.event && (mPlayerState != eSTATE_RELEASED) && IsEventListenerAvailable(pending.event->getType()))
+		{
+			long long latency = NOW_STEADY_TS_MS - pending.queuedTime;
+			{
+				std::lock_guard<std::mutex> guard(mMutexVar);
+				AampEventStats &stats = mBatchStats[pending.event->getType()];
+				stats.dispatched++;
+				stats.totalLatencyMs += latency;
+				if (latency > stats.maxLatencyMs)
+				{
+					stats.maxLatencyMs = latency;
+				}
+			}
+			SendEventSync(pending.event);
+		}
+	}
+}
+
 /**
  * @brief SendEventAsync - Function to send events Async
  */ 
@@ -333,7 +433,36 @@ void AampEventManager::SendEventAsync(const AAMPEventPtr &eventData)
 	AAMPEventType eventType = eventData->getType();
 	std::unique_lock<std::mutex> lock(mMutexVar);
 	// Check if already player in release state , then no need to send any events
-	if(mPlayerState != eSTATE_RELEASED)
+	if(mPlayerState != eSTATE_RELEASED && mEventBatching)
+	{
+		if (IsCoalescableEvent(eventType) && mBatchPosition[eventType])
+		{ // drop the superseded event but queue the new one at the end, preserving order relative to other events
+			mEventBatch[mBatchPosition[eventType] - 1].event.reset();
+			mBatchStats[eventType].coalesced++;
+		}
+		mEventBatch.push_back({eventData, NOW_STEADY_TS_MS});
+		if (IsCoalescableEvent(eventType))
+		{
+			mBatchPosition[eventType] = mEventBatch.size();
+		}
+		AampEventStats &stats = mBatchStats[eventType];
+		if (mEventBatch.size() > stats.maxQueueDepth)
+		{
+			stats.maxQueueDepth = mEventBatch.size();
+		}
+		// One idle task drains everything queued until it runs
+		if (!mBatchScheduled)
+		{
+			mBatchScheduled = true;
+			lock.unlock();
+			guint callbackID = g_idle_add_full(mEventPriority, EventBatchThreadFunction, this, NULL);
+			if(callbackID != 0)
+			{
+				SetCallbackAsPending(callbackID);
+			}
+		}
+	}
+	else if(mPlayerState != eSTATE_RELEASED)
 	{
 		AAMPLOG_INFO("Sending event %d to AsyncQ", eventType);
 		mEventWorkerDataQue.push(eventData);
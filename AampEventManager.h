@@ -34,6 +34,7 @@
 #include <signal.h>
 #include <mutex>
 #include <queue>
+#include <vector>
 #include <glib.h>
 
 
@@ -46,6 +47,23 @@ struct ListenerData {
 	ListenerData* pNext;            /**< Next listener */
 };
 
+/**
+ * @struct AampEventStats
+ * @brief Per event type statistics of batched async dispatch
+ */
+struct AampEventStats
+{
+	unsigned int dispatched;	/**< events delivered to listeners */
+	unsigned int coalesced;		/**< events dropped because a newer event of the same type superseded them */
+	long long totalLatencyMs;	/**< sum of queued to dispatched time of delivered events */
+	long long maxLatencyMs;		/**< worst queued to dispatched time */
+	size_t maxQueueDepth;		/**< most events pending, of any type, when an event of this type was queued */
+
+	AampEventStats() : dispatched(0), coalesced(0), totalLatencyMs(0), maxLatencyMs(0), maxQueueDepth(0)
+	{
+	}
+};
+
 /**
  * @class AampEventManager
  * @brief Class to Handle Aamp Events
@@ -68,6 +86,20 @@ private:
 	typedef std::map<guint, bool> AsyncEventList;		  /**< Collection of Async tasks pending */
 	typedef std::map<guint, bool>::iterator AsyncEventListIter;
 	AsyncEventList	mPendingAsyncEvents;
+	/**
+	 * @struct BatchedEvent
+	 * @brief Async event queued for batched dispatch
+	 */
+	struct BatchedEvent
+	{
+		AAMPEventPtr event;		/**< NULL once superseded by a newer event of the same type */
+		long long queuedTime;	/**< steady clock ms when queued */
+	};
+	bool mEventBatching;						/**< Flag indicating if async events are dispatched in batches */
+	bool mBatchScheduled;						/**< An idle task is pending to dispatch mEventBatch */
+	std::vector<BatchedEvent> mEventBatch;		/**< Events waiting for the next batch dispatch, in order */
+	size_t mBatchPosition[AAMP_MAX_NUM_EVENTS];	/**< 1 + index in mEventBatch of the latest event of each coalescable type, 0 if none */
+	AampEventStats mBatchStats[AAMP_MAX_NUM_EVENTS];	/**< Batched dispatch stats */
 
 protected:
 	int mPlayerId;
@@ -77,6 +109,11 @@ protected:
 	 * @return void
 	 */
 	void AsyncEvent();
+	/**
+	 * @fn AsyncEventBatch
+	 * @return void
+	 */
+	void AsyncEventBatch();
 	/**
 	 * @fn GetSourceID
 	 */
@@ -105,6 +142,24 @@ protected:
 		evtMgr->AsyncEvent();
 		return G_SOURCE_REMOVE ;
 	}
+	/**
+	 * @brief Idle task entry function dispatching all pending events in batch mode
+	 */
+	static gboolean EventBatchThreadFunction(gpointer This)
+	{
+		guint callbackId =	g_source_get_id(g_main_current_source());
+		AampEventManager *evtMgr = (AampEventManager *)This;
+		UsingPlayerId playerId( evtMgr->mPlayerId );
+		evtMgr->SetCallbackAsDispatched(callbackId);
+		evtMgr->AsyncEventBatch();
+		return G_SOURCE_REMOVE ;
+	}
+	/**
+	 * @fn IsCoalescableEvent
+	 * @param eventType - Aamp Event type
+	 * @return True if a newer event of this type makes pending ones obsolete
+	 */
+	static bool IsCoalescableEvent(AAMPEventType eventType);
 	/**
 	 * @fn SendEventAsync
 	 * @param eventData - Event data
@@ -141,6 +196,24 @@ public:
 	 * @return void
 	 */
 	void SetAsyncTuneState(bool isAsyncTuneSetting);
+	/**
+	 * @fn SetEventBatching
+	 * @param enable - True to dispatch all pending async events from a single idle task, coalescing superseded ones
+	 * @return void
+	 */
+	void SetEventBatching(bool enable);
+	/**
+	 * @fn GetEventStats
+	 * @param eventType - Aamp Event type
+	 * @param[out] stats - batched dispatch stats of the event type
+	 * @return True if eventType is valid
+	 */
+	bool GetEventStats(AAMPEventType eventType, AampEventStats &stats);
+	/**
+	 * @fn LogEventStats
+	 * @return void
+	 */
+	void LogEventStats();
 	/**
 	 * @fn SetPlayerState
 	 * @param state - Aamp Player state
@@ -23,6 +23,7 @@
  */
 
 #include "AampGrowableBuffer.h"
+#include "AampBufferPool.h"
 #include "AampConfig.h"
 #include <assert.h>
 #include <glib.h>
@@ -52,22 +53,42 @@ void AampGrowableBuffer::Free( void )
 	{
 		NETMEMORY_MINUS();
 		AAMPGROWABLEBUF_LOG();
-		g_free( ptr );
+		if( pooled )
+		{
+			AampBufferPool::GetInstance().Release( ptr, avail );
+		}
+		else
+		{
+			g_free( ptr );
+		}
 		ptr = NULL;
 	}
 	len = 0;
 	avail = 0;
+	pooled = false;
 }
 
 void AampGrowableBuffer::ReserveBytes( size_t numBytes )
 {
 	assert( ptr==NULL && avail == 0 );
-	ptr = (char *)g_malloc( numBytes );
+	if( AampBufferPool::IsEnabled() )
+	{ // pooled block may be bigger than requested; avail reflects the usable size
+		ptr = AampBufferPool::GetInstance().Allocate( numBytes, avail );
+		pooled = true;
+	}
+	else
+	{
+		ptr = (char *)g_malloc( numBytes );
+		avail = ptr ? numBytes : 0;
+	}
 	if( ptr )
 	{
 		NETMEMORY_PLUS();
 		AAMPGROWABLEBUF_LOG();
-		avail = numBytes;
+	}
+	else
+	{
+		pooled = false;
 	}
 }
 
@@ -81,7 +102,17 @@ void AampGrowableBuffer::AppendBytes( const void *srcPtr, size_t srcLen )
 		{ // if still not enough, reallocate based on required
 			numBytes = required*2;
 		}
-		gpointer mem = g_realloc(ptr, numBytes );
+		gpointer mem = NULL;
+		size_t allocated = numBytes;
+		bool usePool = ptr ? pooled : AampBufferPool::IsEnabled();
+		if( usePool )
+		{
+			mem = AampBufferPool::GetInstance().Reallocate( ptr, len, avail, numBytes, allocated );
+		}
+		else
+		{
+			mem = g_realloc(ptr, numBytes );
+		}
 		if( mem )
 		{
 			if( !ptr )
@@ -90,7 +121,8 @@ void AampGrowableBuffer::AppendBytes( const void *srcPtr, size_t srcLen )
 				AAMPGROWABLEBUF_LOG();
 			}
 			ptr = mem;
-			avail = numBytes;
+			avail = allocated;
+			pooled = usePool;
 		}
 		else if (numBytes != 0)
 		{
@@ -143,10 +175,12 @@ void AampGrowableBuffer::Replace( AampGrowableBuffer *src )
 	ptr = src->GetPtr();
 	len = src->GetLen();
 	avail = src->GetAvail();
+	pooled = src->pooled;
 	
 	src->ptr = NULL;
 	src->len = 0;
 	src->avail = 0;
+	src->pooled = false;
 }
 
 /**
@@ -159,8 +193,13 @@ void AampGrowableBuffer::Transfer( void )
 	{
 		NETMEMORY_MINUS();
 		AAMPGROWABLEBUF_LOG();
+		if( pooled )
+		{ // new owner releases the memory with g_free
+			AampBufferPool::GetInstance().Detach( avail );
+		}
 	}
 	ptr = NULL;
 	len = 0;
 	avail = 0;
+	pooled = false;
 }
@@ -34,7 +34,7 @@
 class AampGrowableBuffer
 {
 public:
-	AampGrowableBuffer( const char *name="?" ):ptr(NULL),len(0),avail(0),name(name){}
+	AampGrowableBuffer( const char *name="?" ):ptr(NULL),len(0),avail(0),name(name),pooled(false){}
 	~AampGrowableBuffer();
 	/*
 	 AampGrowableBuffer converted to class
@@ -52,7 +52,7 @@ public:
 	AampGrowableBuffer(const AampGrowableBuffer & other)
 	 : ptr(nullptr),
 	len{other.len},
-	avail(0),name{other.name}
+	avail(0),name{other.name},pooled(false)
 	{ // never reached/used?
 		ReserveBytes(len); // allocate the pointer and set avail
 		std::memcpy(ptr, other.ptr, len); // populate
@@ -72,11 +72,13 @@ public:
 		: ptr {other.ptr},
 		len {other.len},
 		avail{other.avail},
-		name{other.name}
+		name{other.name},
+		pooled{other.pooled}
 	{ // never reached/used
 		other.ptr = nullptr;
 		other.len = 0;
 		other.avail = 0;
+		other.pooled = false;
 	}
 	// Move assignment
 	AampGrowableBuffer& operator=(AampGrowableBuffer && other) noexcept
@@ -85,6 +87,7 @@ public:
 		std::swap(ptr, other.ptr);
 		std::swap(len, other.len);
 		std::swap(avail, other.avail);
+		std::swap(pooled, other.pooled);
 		return *this;
 	}
 
@@ -108,6 +111,7 @@ private:
 	void *ptr;      /**< Pointer to buffer's memory location (gpointer) */
 	size_t len;     /**< Subset of allocated buffer that is populated and in use */
 	size_t avail;   /**< Available buffer size */
+	bool pooled;    /**< Memory was allocated from AampBufferPool */
 	
 	static int gNetMemoryCount;
 	static int gNetMemoryHighWatermark;
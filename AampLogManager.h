@@ -33,12 +33,23 @@
 #include <iomanip> // std::setfill
 #include <sstream> // std::ostringstream
 #include <algorithm> // std::foreach
+#include <atomic>
 
 extern const char* GetMediaTypeName( AampMediaType mediaType ); // from AampUtils.h; including that directly brings too many other dependencies
 
 #define AAMPCLI_TIMESTAMP_PREFIX_MAX_CHARS 20
 #define AAMPCLI_TIMESTAMP_PREFIX_FORMAT "%u.%03u: "
 
+/**
+ * @brief lowest log level compiled in, 0 (eLOGLEVEL_TRACE) to 5 (eLOGLEVEL_ERROR)
+ *
+ * Call sites below this level are removed at compile time and cannot be enabled at runtime,
+ * e.g. build with -DAAMP_MIN_LOG_LEVEL=2 to drop TRACE and DEBUG logging from release builds.
+ */
+#ifndef AAMP_MIN_LOG_LEVEL
+#define AAMP_MIN_LOG_LEVEL 0
+#endif
+
 /**
  * @brief convenience macro for logging framework
  *
@@ -49,10 +60,14 @@ extern const char* GetMediaTypeName( AampMediaType mediaType ); // from AampUtil
  */
 #define AAMPLOG( LEVEL, FORMAT, ... ) \
 do { \
-if( (LEVEL) >= AampLogManager::aampLoglevel ) \
+if( (LEVEL) >= AAMP_MIN_LOG_LEVEL ) \
+{ \
+static AampLogSite aampLogSite(__FILE__); \
+if( aampLogSite.IsEnabled(LEVEL) ) \
 { \
 logprintf( LEVEL, __FUNCTION__, __LINE__, FORMAT, ##__VA_ARGS__); \
 } \
+} \
 } while(0)
 
 /**
@@ -130,6 +145,29 @@ extern void logprintf(AAMP_LogLevel level, const char* file, int line,const char
 
 extern thread_local int gPlayerId;
 
+/**
+ * @class AampLogSite
+ * @brief Log call site; caches the log level set for its module, so that module log levels cost no lookup per message
+ */
+class AampLogSite
+{
+public:
+	constexpr explicit AampLogSite(const char *file) : mFile(file), mCache(0)
+	{
+	}
+
+	/**
+	 * @brief Check if a message of this call site is to be logged
+	 * @param[in] level - log level of the message
+	 * @return true if level is at or above the log level of the module, or the global log level if none set for the module
+	 */
+	inline bool IsEnabled(AAMP_LogLevel level);
+
+private:
+	const char *mFile;				/**< __FILE__ of the call site */
+	std::atomic<uint32_t> mCache;	/**< (module log level generation << 8) | (module log level + 1); low byte 0 if none set */
+};
+
 class UsingPlayerId
 {
 private:
@@ -156,6 +194,54 @@ public:
 	static AAMP_LogLevel aampLoglevel;
 	static bool locked;
 	static bool enableEthanLogRedirection;  /**<  Enables Ethan log redirection which uses Ethan lib for logging */
+	static std::atomic<bool> asyncLogging;	/**<  logprintf queues messages for a background writer thread instead of writing them */
+	static std::atomic<uint32_t> moduleLogLevelGeneration;	/**<  0 if no module log levels are set, changed whenever they are changed */
+
+	/**
+	 * @fn setModuleLogLevels
+	 * @brief Set the log levels of modules, overriding the global log level for them
+	 *
+	 * A module is a source file name without extension (e.g. fragmentcollector_mpd) or a source directory (e.g. drm).
+	 *
+	 * @param[in] moduleLevels - comma separated module:level pairs, level being trace, debug, info, warn, mil, error or 0-5,
+	 * e.g. "fragmentcollector_mpd:debug,drm:info"; empty to clear all module log levels
+	 * @return void
+	 */
+	static void setModuleLogLevels(const std::string &moduleLevels);
+
+	/**
+	 * @fn getModuleLogLevel
+	 * @param[in] file - source file path, as given by __FILE__
+	 * @return log level set for the module of file, -1 if none
+	 */
+	static int getModuleLogLevel(const char *file);
+
+	/**
+	 * @fn setAsyncLogging
+	 * @brief Enable or disable asynchronous logging
+	 *
+	 * When enabled, logprintf formats the message into a lock-free queue owned by the calling
+	 * thread and returns; a background thread adds the prefix and writes the messages of all
+	 * threads to the log sink, oldest first. When a thread's queue is full, its messages are
+	 * dropped and counted.
+	 *
+	 * @param[in] enable - true to enable, false to write all queued messages and log synchronously
+	 * @return void
+	 */
+	static void setAsyncLogging(bool enable);
+
+	/**
+	 * @fn flushAsyncLog
+	 * @brief Wait until all messages logged asynchronously before the call have been written
+	 * @return void
+	 */
+	static void flushAsyncLog();
+
+	/**
+	 * @fn getDroppedLogCount
+	 * @return number of messages dropped by asynchronous logging because a queue was full
+	 */
+	static uint64_t getDroppedLogCount();
 	
 	/**
 	 * @fn aampLogger
@@ -430,6 +516,25 @@ public:
 	}
 };
 
+inline bool AampLogSite::IsEnabled(AAMP_LogLevel level)
+{
+	uint32_t generation = AampLogManager::moduleLogLevelGeneration.load(std::memory_order_relaxed);
+	if( generation )
+	{
+		uint32_t cache = mCache.load(std::memory_order_relaxed);
+		if( (cache >> 8) != generation )
+		{
+			cache = (generation << 8) | (uint32_t)(AampLogManager::getModuleLogLevel(mFile) + 1);
+			mCache.store(cache, std::memory_order_relaxed);
+		}
+		if( cache & 0xff )
+		{
+			return (int)level >= (int)(cache & 0xff) - 1;
+		}
+	}
+	return level >= AampLogManager::aampLoglevel;
+}
+
 /* Context-free utility function */
 
 /**
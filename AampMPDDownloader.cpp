@@ -94,9 +94,11 @@ std::shared_ptr<_manifestDownloadResponse> _manifestDownloadResponse::clone()
 *   @fn parseMPD
 *   @brief parseMPD function to parse the downloaded MPD file
 */
-void _manifestDownloadResponse::parseMPD()
+void _manifestDownloadResponse::parseMPD(MPDNodeCache *nodeCache, bool streamingParser)
 {
-	std::string manifestStr;	
+	std::string manifestStr;
+	std::string preparedStr;
+	Node *parsedRoot = NULL;
 	xmlTextReaderPtr mXMLReader =   NULL; // Initialize to nullptr
 
 	if(this->mMPDDownloadResponse)
@@ -109,42 +111,65 @@ void _manifestDownloadResponse::parseMPD()
 		// Parse the MPD and create mpd object ;
 		uint32_t fetchTime = Time::GetCurrentUTCTimeInSec();
 
-		mXMLReader = xmlReaderForMemory( (char *)manifestStr.c_str(), (int) manifestStr.length(), NULL, NULL, 0);
-		if (mXMLReader != NULL)
+		// With a node cache, Periods/AdaptationSets unchanged since the previous refresh are
+		// replaced by placeholders and their cached subtrees are copied in by the parser
+		const std::string *parseStr = &manifestStr;
+		if(nodeCache && nodeCache->Prepare(manifestStr, preparedStr))
 		{
-			int retStatus = xmlTextReaderRead(mXMLReader);
-			if (retStatus == 1)
-			{
-				if (mRootNode)
-				{
-					SAFE_DELETE(mRootNode);
-				}
+			parseStr = &preparedStr;
+		}
 
-				mRootNode = MPDProcessNode(&mXMLReader, mMPDDownloadResponse->sEffectiveUrl);
-				if(mRootNode != NULL)
+		if(streamingParser)
+		{
+			SAFE_DELETE(mRootNode);
+			mRootNode = MPDParseDocument(*parseStr, mMPDDownloadResponse->sEffectiveUrl, false, nodeCache);
+			parsedRoot = mRootNode;
+			if(mRootNode == NULL)
+			{
+				mMPDStatus = AAMPStatusType::eAAMPSTATUS_MANIFEST_PARSE_ERROR;
+			}
+		}
+		else
+		{
+			mXMLReader = xmlReaderForMemory( (char *)parseStr->c_str(), (int) parseStr->length(), NULL, NULL, 0);
+			if (mXMLReader != NULL)
+			{
+				int retStatus = xmlTextReaderRead(mXMLReader);
+				if (retStatus == 1)
 				{
-					MPD *mpd = mRootNode->ToMPD();
-					if (mpd)
+					if (mRootNode)
 					{
-						mpd->SetFetchTime(fetchTime);
-						std::shared_ptr<dash::mpd::IMPD> tmp_ptr(mpd);
-						mMPDInstance		=	tmp_ptr;
-						mMPDStatus 		= 	AAMPStatusType::eAAMPSTATUS_OK;
-						mMPDParseHelper->Initialize(mpd);
+						SAFE_DELETE(mRootNode);
 					}
-					else
+
+					mRootNode = MPDProcessNode(&mXMLReader, mMPDDownloadResponse->sEffectiveUrl, false, nodeCache);
+					parsedRoot = mRootNode;
+					if (mRootNode == NULL)
 					{
-						mMPDStatus = AAMPStatusType::eAAMPSTATUS_MANIFEST_CONTENT_ERROR;
+						mMPDStatus = AAMPStatusType::eAAMPSTATUS_MANIFEST_PARSE_ERROR;
 					}
 				}
-				else if (mRootNode == NULL)
+				else if (retStatus == -1)
 				{
 					mMPDStatus = AAMPStatusType::eAAMPSTATUS_MANIFEST_PARSE_ERROR;
 				}
 			}
-			else if (retStatus == -1)
+		}
+
+		if(parsedRoot != NULL)
+		{
+			MPD *mpd = mRootNode->ToMPD();
+			if (mpd)
 			{
-				mMPDStatus = AAMPStatusType::eAAMPSTATUS_MANIFEST_PARSE_ERROR;
+				mpd->SetFetchTime(fetchTime);
+				std::shared_ptr<dash::mpd::IMPD> tmp_ptr(mpd);
+				mMPDInstance		=	tmp_ptr;
+				mMPDStatus 		= 	AAMPStatusType::eAAMPSTATUS_OK;
+				mMPDParseHelper->Initialize(mpd);
+			}
+			else
+			{
+				mMPDStatus = AAMPStatusType::eAAMPSTATUS_MANIFEST_CONTENT_ERROR;
 			}
 		}
 	}
@@ -153,6 +178,11 @@ void _manifestDownloadResponse::parseMPD()
 		xmlFreeTextReader(mXMLReader);
 		mXMLReader = NULL;
 	}
+	if(nodeCache)
+	{
+		AAMPLOG_INFO("Reused %zu unchanged Period/AdaptationSet elements", nodeCache->GetReusedCount());
+		nodeCache->Commit(parsedRoot);
+	}
 
 	AAMPLOG_INFO("Parse MPD Completed ...");
 }
@@ -164,7 +194,7 @@ void _manifestDownloadResponse::parseMPD()
 AampMPDDownloader::AampMPDDownloader() :  mMPDBufferQ(),mMPDBufferSize(1),mMPDBufferMutex(),mRefreshMtx(),mRefreshCondVar(),
 	mMPDDnldMutex(),mRefreshInterval(DEFAULT_INTERVAL_BETWEEN_PLAYLIST_UPDATES_MS),mLatencyValue(-1),mReleaseCalled(true),
 	mMPDDnldCfg(NULL),mDownloaderThread_t1(),mDownloaderThread_t2(),mDownloader1(),mDownloader2(),mMPDData(nullptr),mAppName(""),
-	mManifestUpdateCb(NULL),mManifestUpdateCbArg(NULL),mDownloadNotifierThread(),mCachedMPDData(nullptr),
+	mManifestUpdateCb(NULL),mManifestUpdateCbArg(NULL),mDownloadNotifierThread(),mCachedMPDData(nullptr),mNodeCache(),
 	mCheckedLLDData(false),mMPDNotifierMtx(),mMPDNotifierCondVar(),mManifestRefreshCount(0),mIsLowLatency(false),
 	mMPDDnldDataMtx(),mMPDDnldDataCondVar()
 	,mLLDashData(),mCurrentposDeltaToManifestEnd(-1),mPublishTime(0),mMinimalRefreshRetryCount(0),mMPDNotifyPending(false)
@@ -207,6 +237,7 @@ void AampMPDDownloader::Initialize(ManifestDownloadConfigPtr mpdDnldCfg, std::st
 
 	std::lock_guard<std::recursive_mutex> lock(mMPDDnldMutex);
 	mMPDDnldCfg = mpdDnldCfg;
+	mNodeCache.Clear();
 
 	if(mpdPreProcessFuncptr)
 	{
@@ -406,7 +437,7 @@ void AampMPDDownloader::downloadMPDThread1()
 				//mMPDData->show();
 				// store the last manifestdownloadTime
 				mMPDData->mLastPlaylistDownloadTimeMs	=	aamp_GetCurrentTimeMS();
-				mMPDData->parseMPD();
+				mMPDData->parseMPD(mMPDDnldCfg->mIncrementalRefresh ? &mNodeCache : NULL, mMPDDnldCfg->mStreamingParser);
 				if(firstDownload)
 				{
 					// Check for LLD Manifest for first manifest download only . This is needed to determine the refresh parameters
@@ -572,7 +603,7 @@ void AampMPDDownloader::stichToCachedManifest(ManifestDownloadResponsePtr mpdToA
 			std::string manifestData = mCachedMPDData->mDashMpdDoc->toString();
 			mCachedMPDData->mMPDDownloadResponse->mDownloadData.clear();
 			mCachedMPDData->mMPDDownloadResponse->mDownloadData = std::vector<uint8_t>(manifestData.begin(), manifestData.end());
-			mCachedMPDData->parseMPD();
+			mCachedMPDData->parseMPD(NULL, mMPDDnldCfg->mStreamingParser);
 		}
 	}
 }
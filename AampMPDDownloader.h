@@ -87,19 +87,23 @@ typedef struct _manifestDownloadConfig
 	AampCMCDCollector* mCMCDCollector; // new variable for cmcd header collector
 	std::string mPreProcessedManifest; // provided pre-processed manifest file
 	int mPlayerId;
+	bool mIncrementalRefresh;	// reuse Periods/AdaptationSets unchanged since the previous refresh when parsing
+	bool mStreamingParser;		// build the node tree with the SAX based MPDParseDocument
 
 
 	_manifestDownloadConfig( int playerId ) :mDnldConfig(std::make_shared<DownloadConfig> ()),mTuneUrl(),mStichUrl(),
 									mIsLLDConfigEnabled(false),	mCullManifestAtTuneStart(false),mTSBDuration(-1),
 									mStartPosnToTSB(-1),mCMCDCollector(nullptr),mMPDStichOption(OPT_1_FULL_MANIFEST_TUNE),
-									mHarvestCountLimit(0),mHarvestConfig(0),mHarvestPathConfigured(),mPreProcessedManifest(),mPlayerId(playerId) {}
+									mHarvestCountLimit(0),mHarvestConfig(0),mHarvestPathConfigured(),mPreProcessedManifest(),mPlayerId(playerId),
+									mIncrementalRefresh(false),mStreamingParser(false) {}
 
 	_manifestDownloadConfig(const _manifestDownloadConfig& other): mDnldConfig(other.mDnldConfig),mTuneUrl(other.mTuneUrl),
 								mStichUrl(other.mStichUrl),mIsLLDConfigEnabled(other.mIsLLDConfigEnabled),
 								mCullManifestAtTuneStart(other.mCullManifestAtTuneStart), mTSBDuration(other.mTSBDuration),
 								mStartPosnToTSB(other.mStartPosnToTSB),mCMCDCollector(other.mCMCDCollector),
 								mMPDStichOption(other.mMPDStichOption),mHarvestCountLimit(other.mHarvestCountLimit),
-								mHarvestConfig(other.mHarvestConfig),mHarvestPathConfigured(other.mHarvestPathConfigured),mPreProcessedManifest(other.mPreProcessedManifest),mPlayerId(other.mPlayerId) {}
+								mHarvestConfig(other.mHarvestConfig),mHarvestPathConfigured(other.mHarvestPathConfigured),mPreProcessedManifest(other.mPreProcessedManifest),mPlayerId(other.mPlayerId),
+								mIncrementalRefresh(other.mIncrementalRefresh),mStreamingParser(other.mStreamingParser) {}
 
 
 	_manifestDownloadConfig& operator=(const _manifestDownloadConfig& other)
@@ -174,8 +178,10 @@ public:
 	/**
 	 *   @fn parseMPD
 	 *   @brief parseMPD function to parse the downloaded MPD file
+	 *   @param[in] nodeCache - subtrees of the previous refresh to reuse, NULL for a full parse
+	 *   @param[in] streamingParser - true to build the node tree with MPDParseDocument instead of xmlTextReader
 	 */
-	void parseMPD();
+	void parseMPD(MPDNodeCache *nodeCache = NULL, bool streamingParser = false);
 	/**
 	 * @brief Creates a clone of the manifest download response.
 	 *
@@ -404,6 +410,8 @@ private:
 	// Download data
 	ManifestDownloadResponsePtr mMPDData;
 	ManifestDownloadResponsePtr mCachedMPDData;
+	// Parsed Periods/AdaptationSets of the previous refresh, used by download thread only
+	MPDNodeCache mNodeCache;
 
 	uint32_t mRefreshInterval ; 		// refresh interval in mSec
 	int mLatencyValue;			// buffer value to be considered for manifest refresh
@@ -1719,3 +1719,304 @@ void AampMPDParseHelper::GetStartAndDurationFromTimeline(IPeriod * period, int r
 	}
 
 }
+
+/**
+ * @brief SegmentTimelineIndex Constructor
+ */
+SegmentTimelineIndex::SegmentTimelineIndex() : mRuns(), mValid(false), mImplicitStartRuns(0), mDiscontinuousRuns(0), mReusedRuns(0),
+	mSource(NULL), mSourceSize(0), mSourceFront(NULL), mSourceBack(NULL)
+{
+}
+
+/**
+ * @brief Drop all runs
+ */
+void SegmentTimelineIndex::Clear()
+{
+	mRuns.clear();
+	mValid = false;
+	mImplicitStartRuns = 0;
+	mDiscontinuousRuns = 0;
+	mReusedRuns = 0;
+	mSource = NULL;
+	mSourceSize = 0;
+	mSourceFront = NULL;
+	mSourceBack = NULL;
+}
+
+/**
+ * @brief Bring the index in line with a timeline
+ */
+bool SegmentTimelineIndex::Update(const std::vector<ITimeline *> &timelines)
+{
+	if( mValid && &timelines == mSource && timelines.size() == mSourceSize &&
+		timelines.front() == mSourceFront && timelines.back() == mSourceBack &&
+		IsSameRun(timelines.front(), mRuns.front()) && IsSameRun(timelines.back(), mRuns.back()) )
+	{ // same timeline as last time; the first and last S elements are also compared by value, as a freed and reallocated timeline can reuse the addresses
+		mReusedRuns = mRuns.size();
+	}
+	else
+	{
+		size_t kept = mValid ? Reuse(timelines) : 0;
+		if( !kept )
+		{
+			Clear();
+		}
+		mValid = !timelines.empty();
+		Append(timelines, kept);
+		mReusedRuns = kept;
+		mSource = &timelines;
+		mSourceSize = timelines.size();
+		mSourceFront = mSourceSize ? timelines.front() : NULL;
+		mSourceBack = mSourceSize ? timelines.back() : NULL;
+		if( !mValid )
+		{
+			AAMPLOG_INFO("SegmentTimeline not indexable, %zu S elements", timelines.size());
+		}
+	}
+	return mValid;
+}
+
+/**
+ * @brief Check if an S element has the values an indexed run was built from
+ */
+bool SegmentTimelineIndex::IsSameRun(const ITimeline *timeline, const Run &run)
+{
+	uint64_t time = timeline->GetStartTime();
+	return run.duration == timeline->GetDuration() && run.repeatCount == timeline->GetRepeatCount() &&
+		(time ? (time == run.startTime && !(run.flags & eRUN_IMPLICIT_START)) : (run.flags & eRUN_IMPLICIT_START) != 0);
+}
+
+/**
+ * @brief Keep the runs that the new timeline continues, dropping the ones removed from its front
+ */
+size_t SegmentTimelineIndex::Reuse(const std::vector<ITimeline *> &timelines)
+{
+	size_t kept = 0;
+	uint64_t startTime = timelines.empty() ? 0 : timelines.front()->GetStartTime();
+	if( startTime && mRuns.size() > 1 )
+	{ // the new timeline has to start with an S element already indexed, located by its t
+		auto it = std::lower_bound(mRuns.begin(), mRuns.end(), startTime,
+								   [](const Run &run, uint64_t time) { return run.startTime < time; });
+		if( it != mRuns.end() && it->startTime == startTime )
+		{
+			size_t first = it - mRuns.begin();
+			// the last indexed run is always read again, its repeat count grows while the segments are being produced
+			size_t count = std::min(mRuns.size() - 1 - first, timelines.size());
+			while( kept < count )
+			{
+				const Run &run = mRuns[first + kept];
+				ITimeline *timeline = timelines[kept];
+				uint64_t time = timeline->GetStartTime();
+				if( run.duration != timeline->GetDuration() || run.repeatCount != timeline->GetRepeatCount() )
+				{
+					break;
+				}
+				if( kept && (time ? (time != run.startTime || (run.flags & eRUN_IMPLICIT_START)) : !(run.flags & eRUN_IMPLICIT_START)) )
+				{
+					break;
+				}
+				kept++;
+			}
+			if( kept )
+			{
+				RemoveRuns(first + kept, mRuns.size());
+				RemoveRuns(0, first);
+				Run &front = mRuns.front();
+				mImplicitStartRuns -= (front.flags & eRUN_IMPLICIT_START) ? 1 : 0;
+				mDiscontinuousRuns -= (front.flags & eRUN_DISCONTINUOUS) ? 1 : 0;
+				front.flags = 0;
+			}
+		}
+	}
+	return kept;
+}
+
+/**
+ * @brief Erase runs [from, to), keeping the flag counters in line
+ */
+void SegmentTimelineIndex::RemoveRuns(size_t from, size_t to)
+{
+	for( size_t i = from; i < to; i++ )
+	{
+		mImplicitStartRuns -= (mRuns[i].flags & eRUN_IMPLICIT_START) ? 1 : 0;
+		mDiscontinuousRuns -= (mRuns[i].flags & eRUN_DISCONTINUOUS) ? 1 : 0;
+	}
+	mRuns.erase(mRuns.begin() + from, mRuns.begin() + to);
+}
+
+/**
+ * @brief Index the S elements from position start onwards
+ */
+void SegmentTimelineIndex::Append(const std::vector<ITimeline *> &timelines, size_t start)
+{
+	mRuns.reserve(mRuns.size() + timelines.size() - start);
+	for( size_t i = start; i < timelines.size(); i++ )
+	{
+		ITimeline *timeline = timelines[i];
+		Run run;
+		uint64_t time = timeline->GetStartTime();
+		run.duration = timeline->GetDuration();
+		run.repeatCount = timeline->GetRepeatCount();
+		run.flags = 0;
+		if( mRuns.empty() )
+		{
+			run.startTime = time;
+			run.firstSegment = 0;
+			run.mediaOffset = 0;
+			if( !time )
+			{
+				run.flags |= eRUN_IMPLICIT_START;
+			}
+		}
+		else
+		{
+			const Run &prev = mRuns.back();
+			uint64_t prevEnd = prev.GetEndTime();
+			run.firstSegment = prev.firstSegment + prev.repeatCount + 1;
+			run.mediaOffset = prev.mediaOffset + (uint64_t)prev.duration * ((uint64_t)prev.repeatCount + 1);
+			if( !time )
+			{
+				run.startTime = prevEnd;
+				run.flags |= eRUN_IMPLICIT_START;
+			}
+			else
+			{
+				run.startTime = time;
+				if( time != prevEnd )
+				{
+					run.flags |= eRUN_DISCONTINUOUS;
+				}
+				if( time < prevEnd )
+				{ // overlapping S elements, lookups would not be monotonic
+					mValid = false;
+				}
+			}
+		}
+		if( run.repeatCount >= INT32_MAX )
+		{ // negative r (repeat until the next S element) is left to the timeline walk
+			mValid = false;
+		}
+		mImplicitStartRuns += (run.flags & eRUN_IMPLICIT_START) ? 1 : 0;
+		mDiscontinuousRuns += (run.flags & eRUN_DISCONTINUOUS) ? 1 : 0;
+		mRuns.push_back(run);
+	}
+}
+
+/**
+ * @brief Get the total number of segments in the timeline
+ */
+uint64_t SegmentTimelineIndex::GetSegmentCount() const
+{
+	uint64_t count = 0;
+	if( !mRuns.empty() )
+	{
+		count = mRuns.back().firstSegment + mRuns.back().repeatCount + 1 - mRuns.front().firstSegment;
+	}
+	return count;
+}
+
+/**
+ * @brief Get the 0 based segment number of a timeline position
+ */
+uint64_t SegmentTimelineIndex::GetSegmentIndex(int timeLineIndex, uint32_t repeatIndex) const
+{
+	uint64_t segmentIndex;
+	if( timeLineIndex >= (int)mRuns.size() )
+	{
+		segmentIndex = GetSegmentCount();
+	}
+	else
+	{
+		segmentIndex = mRuns[timeLineIndex].firstSegment - mRuns.front().firstSegment + repeatIndex;
+	}
+	return segmentIndex;
+}
+
+/**
+ * @brief Get the start time of a timeline position
+ */
+uint64_t SegmentTimelineIndex::GetSegmentTime(int timeLineIndex, uint32_t repeatIndex) const
+{
+	const Run &run = mRuns[timeLineIndex];
+	return run.startTime + (uint64_t)run.duration * repeatIndex;
+}
+
+/**
+ * @brief Get the sum of the durations of all segments before a timeline position
+ */
+uint64_t SegmentTimelineIndex::GetMediaOffset(int timeLineIndex, uint32_t repeatIndex) const
+{
+	const Run &run = mRuns[timeLineIndex];
+	return run.mediaOffset - mRuns.front().mediaOffset + (uint64_t)run.duration * repeatIndex;
+}
+
+/**
+ * @brief Map a 0 based segment number to its timeline position
+ */
+bool SegmentTimelineIndex::FindSegment(uint64_t segmentIndex, int &timeLineIndex, uint32_t &repeatIndex) const
+{
+	bool found = false;
+	if( segmentIndex < GetSegmentCount() )
+	{
+		uint64_t segment = segmentIndex + mRuns.front().firstSegment;
+		auto it = std::upper_bound(mRuns.begin(), mRuns.end(), segment,
+								   [](uint64_t value, const Run &run) { return value < run.firstSegment; });
+		--it;
+		timeLineIndex = (int)(it - mRuns.begin());
+		repeatIndex = (uint32_t)(segment - it->firstSegment);
+		found = true;
+	}
+	return found;
+}
+
+/**
+ * @brief Find the last segment starting at or before a time
+ */
+bool SegmentTimelineIndex::FindTime(uint64_t time, int &timeLineIndex, uint32_t &repeatIndex) const
+{
+	bool found = false;
+	if( !mRuns.empty() && time >= mRuns.front().startTime )
+	{
+		auto it = std::upper_bound(mRuns.begin(), mRuns.end(), time,
+								   [](uint64_t value, const Run &run) { return value < run.startTime; });
+		--it;
+		timeLineIndex = (int)(it - mRuns.begin());
+		repeatIndex = it->duration ? (uint32_t)std::min<uint64_t>((time - it->startTime) / it->duration, it->repeatCount) : 0;
+		found = true;
+	}
+	return found;
+}
+
+/**
+ * @brief Find the segment in which the summed segment durations reach an offset
+ */
+void SegmentTimelineIndex::FindMediaOffset(uint64_t mediaOffset, int &timeLineIndex, uint32_t &repeatIndex) const
+{
+	timeLineIndex = 0;
+	repeatIndex = 0;
+	if( !mRuns.empty() )
+	{
+		uint64_t offset = mediaOffset + mRuns.front().mediaOffset;
+		auto it = std::upper_bound(mRuns.begin(), mRuns.end(), offset,
+								   [](uint64_t value, const Run &run) { return value < run.mediaOffset; });
+		--it;
+		timeLineIndex = (int)(it - mRuns.begin());
+		repeatIndex = it->duration ? (uint32_t)std::min<uint64_t>((offset - it->mediaOffset) / it->duration, it->repeatCount) : 0;
+	}
+}
+
+/**
+ * @brief Find the first run at or after fromIndex that ends after a time
+ */
+int SegmentTimelineIndex::FindRunEndingAfter(uint64_t time, int fromIndex) const
+{
+	int timeLineIndex = (int)mRuns.size();
+	if( fromIndex >= 0 && fromIndex < timeLineIndex )
+	{
+		auto it = std::partition_point(mRuns.begin() + fromIndex, mRuns.end(),
+									   [time](const Run &run) { return run.GetEndTime() <= time; });
+		timeLineIndex = (int)(it - mRuns.begin());
+	}
+	return timeLineIndex;
+}
@@ -186,6 +186,176 @@ public:
 	}
 }; // SegmentTemplates
 
+/**
+ * @class SegmentTimelineIndex
+ * @brief Packed index of a SegmentTimeline for logarithmic time and segment lookups
+ *
+ * Every S element is kept as one run, without expanding its repeats, in a contiguous
+ * array together with the number of segments and the media duration preceding it, so
+ * that time -> segment and segment -> time are answered by binary search. An S element
+ * without t (or with t="0") starts where the previous one ended.
+ *
+ * On a live refresh the runs already indexed are kept when the new timeline continues
+ * the indexed one: runs dropped from the front are released, the overlapping runs are
+ * only compared, and the last (possibly grown) run and any new runs are appended.
+ */
+class SegmentTimelineIndex
+{
+public:
+	enum RunFlags
+	{
+		eRUN_IMPLICIT_START = 0x01,	/**< S element has no (or a zero) t attribute */
+		eRUN_DISCONTINUOUS = 0x02	/**< start differs from the end of the previous run */
+	};
+
+	/**
+	 * @struct Run
+	 * @brief One S element of the timeline
+	 */
+	struct Run
+	{
+		uint64_t startTime;		/**< start of the first segment, timescale units */
+		uint64_t firstSegment;	/**< number of segments before this run, since the index was created */
+		uint64_t mediaOffset;	/**< sum of segment durations before this run, since the index was created */
+		uint32_t duration;		/**< duration of each segment */
+		uint32_t repeatCount;	/**< number of repeats, segments in run = repeatCount + 1 */
+		uint32_t flags;			/**< RunFlags */
+
+		uint64_t GetEndTime() const
+		{
+			return startTime + (uint64_t)duration * ((uint64_t)repeatCount + 1);
+		}
+	};
+
+	SegmentTimelineIndex();
+
+	/**
+	 * @brief Bring the index in line with a timeline; O(1) when the timeline is the one already indexed
+	 * @param[in] timelines - S elements of the SegmentTimeline
+	 * @return true if the index is usable for lookups
+	 */
+	bool Update(const std::vector<ITimeline *> &timelines);
+
+	/**
+	 * @brief Drop all runs
+	 */
+	void Clear();
+
+	/**
+	 * @brief Check if any S element lacks a non zero t attribute
+	 */
+	bool HasImplicitStartTime() const { return mImplicitStartRuns != 0; }
+
+	/**
+	 * @brief Check if any run starts away from the end of its predecessor
+	 */
+	bool HasDiscontinuity() const { return mDiscontinuousRuns != 0; }
+
+	/**
+	 * @brief Get the number of runs (S elements) in the index
+	 */
+	int GetRunCount() const { return (int)mRuns.size(); }
+
+	/**
+	 * @brief Get a run by its position in the timeline
+	 * @param[in] timeLineIndex - 0 based S element position, must be below GetRunCount()
+	 */
+	const Run &GetRun(int timeLineIndex) const { return mRuns[timeLineIndex]; }
+
+	/**
+	 * @brief Get the number of runs kept by the last Update instead of being read from the timeline
+	 */
+	size_t GetReusedRunCount() const { return mReusedRuns; }
+
+	/**
+	 * @brief Get the total number of segments in the timeline
+	 */
+	uint64_t GetSegmentCount() const;
+
+	/**
+	 * @brief Get the 0 based segment number of a timeline position
+	 * @param[in] timeLineIndex - S element position; GetRunCount() gives the segment count
+	 * @param[in] repeatIndex - repeat within the S element
+	 */
+	uint64_t GetSegmentIndex(int timeLineIndex, uint32_t repeatIndex) const;
+
+	/**
+	 * @brief Get the start time of a timeline position, timescale units
+	 */
+	uint64_t GetSegmentTime(int timeLineIndex, uint32_t repeatIndex) const;
+
+	/**
+	 * @brief Get the sum of the durations of all segments before a timeline position
+	 */
+	uint64_t GetMediaOffset(int timeLineIndex, uint32_t repeatIndex) const;
+
+	/**
+	 * @brief Map a 0 based segment number to its timeline position
+	 * @param[in] segmentIndex - segment number
+	 * @param[out] timeLineIndex - S element position
+	 * @param[out] repeatIndex - repeat within the S element
+	 * @return false if segmentIndex is beyond the timeline
+	 */
+	bool FindSegment(uint64_t segmentIndex, int &timeLineIndex, uint32_t &repeatIndex) const;
+
+	/**
+	 * @brief Find the last segment starting at or before a time
+	 * @param[in] time - timescale units
+	 * @param[out] timeLineIndex - S element position
+	 * @param[out] repeatIndex - repeat within the S element
+	 * @return false if time is before the first segment
+	 */
+	bool FindTime(uint64_t time, int &timeLineIndex, uint32_t &repeatIndex) const;
+
+	/**
+	 * @brief Find the segment in which the summed segment durations reach an offset
+	 * @param[in] mediaOffset - offset as returned by GetMediaOffset
+	 * @param[out] timeLineIndex - S element position
+	 * @param[out] repeatIndex - repeat within the S element, last segment if beyond the timeline
+	 */
+	void FindMediaOffset(uint64_t mediaOffset, int &timeLineIndex, uint32_t &repeatIndex) const;
+
+	/**
+	 * @brief Find the first run at or after fromIndex that ends after a time
+	 * @param[in] time - timescale units
+	 * @param[in] fromIndex - first S element position to consider
+	 * @return S element position, GetRunCount() if none
+	 */
+	int FindRunEndingAfter(uint64_t time, int fromIndex) const;
+
+private:
+	/**
+	 * @brief Index the S elements from position start onwards, following the runs already indexed
+	 */
+	void Append(const std::vector<ITimeline *> &timelines, size_t start);
+
+	/**
+	 * @brief Keep the runs that the new timeline continues, dropping the ones removed from its front
+	 * @return number of runs kept
+	 */
+	size_t Reuse(const std::vector<ITimeline *> &timelines);
+
+	/**
+	 * @brief Check if an S element has the start time, duration and repeat count an indexed run was built from
+	 */
+	static bool IsSameRun(const ITimeline *timeline, const Run &run);
+
+	/**
+	 * @brief Erase runs [from, to), keeping the flag counters in line
+	 */
+	void RemoveRuns(size_t from, size_t to);
+
+	std::vector<Run> mRuns;
+	bool mValid;
+	size_t mImplicitStartRuns;
+	size_t mDiscontinuousRuns;
+	size_t mReusedRuns;
+	const std::vector<ITimeline *> *mSource;	/**< last indexed timeline, only compared, never dereferenced */
+	size_t mSourceSize;
+	const ITimeline *mSourceFront;
+	const ITimeline *mSourceBack;
+}; // SegmentTimelineIndex
+
 
 /**
  * @class AampMPDParseHelper
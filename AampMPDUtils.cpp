@@ -18,15 +18,43 @@
 */
 
 #include "AampMPDUtils.h"
+#include <libxml/parser.h>
+#include <libxml/parserInternals.h>
+
+/**
+ * @brief Ensure a Period node has an id
+ * @param node Period node
+ * @param isAd true for ad manifests, whose period ids are made unique
+ */
+static void SetPeriodId(Node *node, bool isAd)
+{
+	static int UNIQ_PID = 0;
+	if(!node->HasAttribute("id"))
+	{
+		// Add a unique period id. AAMP needs these in multi-period
+		// static DASH assets to identify the current period.
+		std::string periodId = std::to_string(UNIQ_PID++) + "-";
+		node->AddAttribute("id", periodId);
+	}
+	else if(isAd)
+	{
+		// Make ad period ids unique. AAMP needs these for playing the same ad back to back.
+		std::string periodId = std::to_string(UNIQ_PID++) + "-" + node->GetAttributeValue("id");
+		node->AddAttribute("id", periodId);
+	}
+	else
+	{
+		// Non-ad period already has an id. Don't change dynamic period ids.
+	}
+}
 
 /**
  * @brief Get xml node form reader
  *
  * @retval xml node
  */
-Node* MPDProcessNode(xmlTextReaderPtr *reader, std::string url, bool isAd)
+Node* MPDProcessNode(xmlTextReaderPtr *reader, std::string url, bool isAd, MPDNodeCache *nodeCache)
 {
-	static int UNIQ_PID = 0;
 	int type = xmlTextReaderNodeType(*reader);
 
 	if (type != WhiteSpace && type != Text && type != XML_CDATA_SECTION_NODE)
@@ -55,25 +83,21 @@ Node* MPDProcessNode(xmlTextReaderPtr *reader, std::string url, bool isAd)
 		node->SetName(name);
 		AddAttributesToNode(reader, node);
 
-		if(!strcmp("Period", name))
+		if(nodeCache && node->HasAttribute(MPD_NODE_REF_ATTRIBUTE))
 		{
-			if(!node->HasAttribute("id"))
-			{
-				// Add a unique period id. AAMP needs these in multi-period
-				// static DASH assets to identify the current period.
-				std::string periodId = std::to_string(UNIQ_PID++) + "-";
-				node->AddAttribute("id", periodId);
-			}
-			else if(isAd)
-			{
-				// Make ad period ids unique. AAMP needs these for playing the same ad back to back.
-				std::string periodId = std::to_string(UNIQ_PID++) + "-" + node->GetAttributeValue("id");
-				node->AddAttribute("id", periodId);
-			}
-			else
+			// Placeholder of an element unchanged since the previous refresh
+			Node *cachedNode = nodeCache->GetNode(node, url);
+			if(cachedNode)
 			{
-				// Non-ad period already has an id. Don't change dynamic period ids.
+				SAFE_DELETE(node);
+				return cachedNode;
 			}
+			AAMPLOG_ERR("Invalid %s reference in %s", MPD_NODE_REF_ATTRIBUTE, name);
+		}
+
+		if(!strcmp("Period", name))
+		{
+			SetPeriodId(node, isAd);
 		}
 
 		if (isEmpty)
@@ -92,7 +116,7 @@ Node* MPDProcessNode(xmlTextReaderPtr *reader, std::string url, bool isAd)
 
 			if(subnodeType != Comment && subnodeType != WhiteSpace)
 			{
-				subnode = MPDProcessNode(reader, url, isAd);
+				subnode = MPDProcessNode(reader, url, isAd, nodeCache);
 				if (subnode != NULL)
 					node->AddSubNode(subnode);
 			}
@@ -127,6 +151,658 @@ Node* MPDProcessNode(xmlTextReaderPtr *reader, std::string url, bool isAd)
 }
 
 
+/**
+ * @struct MPDSaxContext
+ * @brief State of MPDParseDocument() between libxml SAX callbacks
+ */
+struct MPDSaxContext
+{
+	const std::string &url;
+	std::string mpdPath;		/**< directory of url, shared by all element nodes */
+	bool isAd;
+	MPDNodeCache *nodeCache;
+	Node *root;
+	std::vector<Node*> openNodes;	/**< elements started but not yet ended, innermost last */
+	std::string text;				/**< character data not yet added to the tree */
+
+	MPDSaxContext(const std::string &manifestUrl, bool ad, MPDNodeCache *cache) : url(manifestUrl),
+		mpdPath(Path::GetDirectoryPath(manifestUrl)), isAd(ad), nodeCache(cache), root(NULL), openNodes(), text()
+	{
+	}
+};
+
+/**
+ * @brief Add pending character data to the current element, as xmlTextReader would report it
+ */
+static void MPDSaxFlushText(MPDSaxContext *context)
+{
+	if (!context->text.empty())
+	{
+		// whitespace only runs are reported as whitespace by xmlTextReader, and skipped by MPDProcessNode
+		bool blank = true;
+		for (char c : context->text)
+		{
+			if (c != ' ' && c != '\t' && c != '\n' && c != '\r')
+			{
+				blank = false;
+				break;
+			}
+		}
+		if (!blank && !context->openNodes.empty())
+		{
+			Node *node = new Node();
+			node->SetType(Text);
+			node->SetText(context->text);
+			context->openNodes.back()->AddSubNode(node);
+		}
+		context->text.clear();
+	}
+}
+
+/**
+ * @brief Decode the character references libxml leaves in SAX2 attribute values
+ */
+static std::string MPDSaxDecodeValue(const char *value, size_t length)
+{
+	std::string decoded;
+	decoded.reserve(length);
+	for (size_t i = 0; i < length; i++)
+	{
+		if (value[i] == '&')
+		{
+			const char *end = (const char *)memchr(value + i, ';', length - i);
+			if (end)
+			{
+				std::string ref(value + i + 1, end - value - i - 1);
+				long code = -1;
+				if (ref.size() > 2 && ref[0] == '#' && (ref[1] == 'x' || ref[1] == 'X'))
+				{
+					code = strtol(ref.c_str() + 2, NULL, 16);
+				}
+				else if (ref.size() > 1 && ref[0] == '#')
+				{
+					code = strtol(ref.c_str() + 1, NULL, 10);
+				}
+				else if (ref == "amp") code = '&';
+				else if (ref == "lt") code = '<';
+				else if (ref == "gt") code = '>';
+				else if (ref == "quot") code = '"';
+				else if (ref == "apos") code = '\'';
+
+				if (code > 0 && code < 0x80)
+				{
+					decoded.push_back((char)code);
+					i = end - value;
+					continue;
+				}
+				else if (code >= 0x80 && code <= 0x10FFFF)
+				{
+					// UTF-8 encode, as libxml does for the tree
+					unsigned char buffer[4];
+					int count = xmlCopyCharMultiByte(buffer, (int)code);
+					decoded.append((const char *)buffer, count);
+					i = end - value;
+					continue;
+				}
+			}
+		}
+		decoded.push_back(value[i]);
+	}
+	return decoded;
+}
+
+/**
+ * @brief SAX2 start of element, creates the Node and attaches it to its parent
+ */
+static void MPDSaxStartElement(void *ctx, const xmlChar *localname, const xmlChar *prefix, const xmlChar *URI,
+							   int nb_namespaces, const xmlChar **namespaces, int nb_attributes, int nb_defaulted,
+							   const xmlChar **attributes)
+{
+	MPDSaxContext *context = (MPDSaxContext *)ctx;
+	MPDSaxFlushText(context);
+
+	std::string name = (const char *)localname;
+	if (prefix)
+	{
+		name = std::string((const char *)prefix) + ":" + name;
+	}
+	Node *node = new Node();
+	node->SetType(XML_READER_TYPE_ELEMENT);
+	node->SetMPDPath(context->mpdPath);
+	node->SetName(name);
+	// namespace declarations are attributes for xmlTextReader, keep them for parity with MPDProcessNode
+	for (int i = 0; i < nb_namespaces; i++)
+	{
+		const char *nsPrefix = (const char *)namespaces[i * 2];
+		const char *nsUri = (const char *)namespaces[i * 2 + 1];
+		node->AddAttribute(nsPrefix ? (std::string("xmlns:") + nsPrefix) : std::string("xmlns"), nsUri ? nsUri : "");
+	}
+	// attributes are (localname, prefix, URI, value, end) tuples; value is not NUL terminated
+	for (int i = 0; i < nb_attributes; i++)
+	{
+		const xmlChar **attribute = attributes + i * 5;
+		std::string key = (const char *)attribute[0];
+		if (attribute[1])
+		{
+			key = std::string((const char *)attribute[1]) + ":" + key;
+		}
+		const char *value = (const char *)attribute[3];
+		size_t length = attribute[4] - attribute[3];
+		if (memchr(value, '&', length))
+		{
+			node->AddAttribute(key, MPDSaxDecodeValue(value, length));
+		}
+		else
+		{
+			node->AddAttribute(key, std::string(value, length));
+		}
+	}
+
+	if (context->nodeCache && node->HasAttribute(MPD_NODE_REF_ATTRIBUTE))
+	{
+		// Placeholder of an element unchanged since the previous refresh
+		Node *cachedNode = context->nodeCache->GetNode(node, context->url);
+		if (cachedNode)
+		{
+			SAFE_DELETE(node);
+			node = cachedNode;
+		}
+		else
+		{
+			AAMPLOG_ERR("Invalid %s reference in %s", MPD_NODE_REF_ATTRIBUTE, name.c_str());
+		}
+	}
+	else if (name == "Period")
+	{
+		SetPeriodId(node, context->isAd);
+	}
+
+	if (!context->openNodes.empty())
+	{
+		context->openNodes.back()->AddSubNode(node);
+	}
+	else if (context->root == NULL)
+	{
+		context->root = node;
+	}
+	else
+	{
+		SAFE_DELETE(node);
+		return;
+	}
+	context->openNodes.push_back(node);
+}
+
+/**
+ * @brief SAX2 end of element
+ */
+static void MPDSaxEndElement(void *ctx, const xmlChar *localname, const xmlChar *prefix, const xmlChar *URI)
+{
+	MPDSaxContext *context = (MPDSaxContext *)ctx;
+	MPDSaxFlushText(context);
+	if (!context->openNodes.empty())
+	{
+		context->openNodes.pop_back();
+	}
+}
+
+/**
+ * @brief SAX2 character data; may be delivered in several chunks
+ */
+static void MPDSaxCharacters(void *ctx, const xmlChar *ch, int len)
+{
+	MPDSaxContext *context = (MPDSaxContext *)ctx;
+	if (!context->openNodes.empty())
+	{
+		context->text.append((const char *)ch, len);
+	}
+}
+
+/**
+ * @brief SAX2 CDATA section
+ */
+static void MPDSaxCData(void *ctx, const xmlChar *value, int len)
+{
+	MPDSaxContext *context = (MPDSaxContext *)ctx;
+	MPDSaxFlushText(context);
+	if (!context->openNodes.empty())
+	{
+		Node *node = new Node();
+		node->SetType(XML_CDATA_SECTION_NODE);
+		node->SetText(std::string((const char *)value, len));
+		context->openNodes.back()->AddSubNode(node);
+	}
+}
+
+/**
+ * @brief SAX2 comment; ends a text run, as in the tree xmlTextReader works on
+ */
+static void MPDSaxComment(void *ctx, const xmlChar *value)
+{
+	MPDSaxFlushText((MPDSaxContext *)ctx);
+}
+
+/**
+ * @brief Build the node tree of a manifest in a single streaming pass
+ */
+Node *MPDParseDocument(const std::string &manifest, const std::string &url, bool isAd, MPDNodeCache *nodeCache)
+{
+	MPDSaxContext context(url, isAd, nodeCache);
+	xmlSAXHandler handler;
+	memset(&handler, 0, sizeof(handler));
+	handler.initialized = XML_SAX2_MAGIC;
+	handler.startElementNs = MPDSaxStartElement;
+	handler.endElementNs = MPDSaxEndElement;
+	handler.characters = MPDSaxCharacters;
+	handler.ignorableWhitespace = MPDSaxCharacters;
+	handler.cdataBlock = MPDSaxCData;
+	handler.comment = MPDSaxComment;
+
+	int ret = xmlSAXUserParseMemory(&handler, &context, manifest.c_str(), (int)manifest.length());
+	if (ret != 0)
+	{
+		// like MPDProcessNode, keep what was parsed before the error
+		AAMPLOG_WARN("Manifest parse error %d, root %p", ret, context.root);
+	}
+	return context.root;
+}
+
+/**
+ * @brief Deep copy of a node tree
+ */
+Node *MPDCloneNode(const Node *source, const std::string &mpdPath)
+{
+	Node *node = new Node();
+	int type = source->GetType();
+	node->SetType(type);
+	if (type == Text || type == XML_CDATA_SECTION_NODE)
+	{
+		node->SetText(source->GetText());
+	}
+	else
+	{
+		node->SetMPDPath(mpdPath);
+		node->SetName(source->GetName());
+		for (const auto &attribute : source->GetAttributes())
+		{
+			node->AddAttribute(attribute.first, attribute.second);
+		}
+		for (const Node *subNode : source->GetSubNodes())
+		{
+			node->AddSubNode(MPDCloneNode(subNode, mpdPath));
+		}
+	}
+	return node;
+}
+
+/**
+ * @brief Find the end of a start tag, skipping quoted attribute values
+ * @param text manifest text
+ * @param from offset after the element name
+ * @param limit end of the search range
+ * @retval offset of '>', std::string::npos if not found
+ */
+static size_t FindTagEnd(const std::string &text, size_t from, size_t limit)
+{
+	char quote = 0;
+	for (size_t i = from; i < limit; i++)
+	{
+		char c = text[i];
+		if (quote)
+		{
+			if (c == quote)
+			{
+				quote = 0;
+			}
+		}
+		else if (c == '"' || c == '\'')
+		{
+			quote = c;
+		}
+		else if (c == '>')
+		{
+			return i;
+		}
+	}
+	return std::string::npos;
+}
+
+/**
+ * @brief Find the next element with the given name in manifest text
+ * @param text manifest text
+ * @param name element name, elements of this name must not nest
+ * @param from offset to search from
+ * @param limit end of the search range
+ * @param[out] begin offset of the element '<'
+ * @param[out] tagEnd offset of the '>' of the start tag
+ * @param[out] end offset after the end tag
+ * @retval true if found
+ */
+static bool FindElement(const std::string &text, const std::string &name, size_t from, size_t limit, size_t &begin, size_t &tagEnd, size_t &end)
+{
+	const std::string openTag = "<" + name;
+	const std::string closeTag = "</" + name;
+	while (from < limit)
+	{
+		size_t pos = text.find(openTag, from);
+		if (pos == std::string::npos || pos >= limit)
+		{
+			break;
+		}
+		size_t next = pos + openTag.size();
+		if (next < limit && (isspace((unsigned char)text[next]) || text[next] == '>' || text[next] == '/'))
+		{
+			tagEnd = FindTagEnd(text, next, limit);
+			if (tagEnd == std::string::npos)
+			{
+				break;
+			}
+			if (text[tagEnd - 1] == '/')
+			{
+				begin = pos;
+				end = tagEnd + 1;
+				return true;
+			}
+			size_t close = text.find(closeTag, tagEnd);
+			size_t closeEnd = (close == std::string::npos) ? std::string::npos : text.find('>', close);
+			if (closeEnd == std::string::npos || closeEnd >= limit)
+			{
+				break;
+			}
+			begin = pos;
+			end = closeEnd + 1;
+			return true;
+		}
+		from = next;
+	}
+	return false;
+}
+
+/**
+ * @brief Get the raw value of an attribute from a start tag
+ * @param text manifest text
+ * @param begin offset of the element '<'
+ * @param tagEnd offset of the '>' of the start tag
+ * @param name attribute name
+ * @param[out] value attribute value, entities not decoded
+ * @retval true if found
+ */
+static bool GetTagAttribute(const std::string &text, size_t begin, size_t tagEnd, const std::string &name, std::string &value)
+{
+	char quote = 0;
+	for (size_t i = begin; i < tagEnd; i++)
+	{
+		char c = text[i];
+		if (quote)
+		{
+			if (c == quote)
+			{
+				quote = 0;
+			}
+		}
+		else if (c == '"' || c == '\'')
+		{
+			quote = c;
+		}
+		else if (isspace((unsigned char)c) && text.compare(i + 1, name.size(), name) == 0)
+		{
+			size_t pos = i + 1 + name.size();
+			while (pos < tagEnd && isspace((unsigned char)text[pos]))
+			{
+				pos++;
+			}
+			if (pos < tagEnd && text[pos] == '=')
+			{
+				pos++;
+				while (pos < tagEnd && isspace((unsigned char)text[pos]))
+				{
+					pos++;
+				}
+				if (pos < tagEnd && (text[pos] == '"' || text[pos] == '\''))
+				{
+					size_t valueEnd = text.find(text[pos], pos + 1);
+					if (valueEnd < tagEnd)
+					{
+						value = text.substr(pos + 1, valueEnd - pos - 1);
+						return true;
+					}
+				}
+				return false;
+			}
+		}
+	}
+	return false;
+}
+
+/**
+ * @brief Cache key of an AdaptationSet; NUL cannot occur in XML, so keys of different Periods never collide
+ */
+static std::string GetAdaptationSetKey(const std::string &periodKey, const std::string &adaptationSetId, int index)
+{
+	std::string key = periodKey;
+	key.push_back('\0');
+	key += adaptationSetId.empty() ? ("#" + std::to_string(index)) : adaptationSetId;
+	return key;
+}
+
+/**
+ * @brief MPDNodeCache Constructor
+ */
+MPDNodeCache::MPDNodeCache() : mEntries(), mElements(), mKeys(), mRefs()
+{
+}
+
+/**
+ * @brief MPDNodeCache Destructor
+ */
+MPDNodeCache::~MPDNodeCache()
+{
+	Clear();
+}
+
+/**
+ * @brief Drop all cached subtrees
+ */
+void MPDNodeCache::Clear()
+{
+	for (auto &entry : mEntries)
+	{
+		SAFE_DELETE(entry.second.node);
+	}
+	mEntries.clear();
+	mElements.clear();
+	mKeys.clear();
+	mRefs.clear();
+}
+
+/**
+ * @brief Compare an element with the previous refresh and queue it for Commit
+ */
+MPDNodeCache::ElementState MPDNodeCache::AddElement(const std::string &manifest, const std::string &key, size_t begin, size_t end)
+{
+	ElementState state = eELEMENT_CHANGED;
+	// with duplicate ids only the first element is tracked, the others are always parsed
+	if (mKeys.insert(key).second)
+	{
+		Element element;
+		element.key = key;
+		auto it = mEntries.find(key);
+		if (it != mEntries.end() && it->second.text.size() == (end - begin) &&
+			manifest.compare(begin, end - begin, it->second.text) == 0)
+		{
+			state = it->second.node ? eELEMENT_REUSED : eELEMENT_UNCHANGED;
+		}
+		element.state = state;
+		if (state == eELEMENT_CHANGED)
+		{
+			element.text.assign(manifest, begin, end - begin);
+		}
+		mElements.push_back(element);
+	}
+	return state;
+}
+
+/**
+ * @brief Append the placeholder of a reused element to out
+ */
+void MPDNodeCache::AppendPlaceholder(std::string &out, const std::string &name, const std::string &key)
+{
+	out += "<" + name + " " MPD_NODE_REF_ATTRIBUTE "=\"" + std::to_string(mRefs.size()) + "\"/>";
+	mRefs.push_back(mEntries[key].node);
+}
+
+/**
+ * @brief Replace elements unchanged since the previous refresh by placeholders
+ */
+bool MPDNodeCache::Prepare(const std::string &manifest, std::string &prepared)
+{
+	mElements.clear();
+	mKeys.clear();
+	mRefs.clear();
+	prepared.clear();
+	if (manifest.find("<!--") != std::string::npos || manifest.find("<![CDATA[") != std::string::npos)
+	{
+		// markup in comments and CDATA would confuse the element scan
+		return false;
+	}
+
+	size_t copied = 0;
+	size_t pos = 0;
+	size_t begin, tagEnd, end;
+	while (FindElement(manifest, "Period", pos, manifest.size(), begin, tagEnd, end))
+	{
+		pos = end;
+		std::string periodKey;
+		if (!GetTagAttribute(manifest, begin, tagEnd, "id", periodKey) || periodKey.empty())
+		{
+			// period without id gets a generated one on every parse
+			continue;
+		}
+		if (AddElement(manifest, periodKey, begin, end) == eELEMENT_REUSED)
+		{
+			prepared.append(manifest, copied, begin - copied);
+			AppendPlaceholder(prepared, "Period", periodKey);
+			copied = end;
+			continue;
+		}
+		// changed Period, typically the live edge one; look for unchanged AdaptationSets in it
+		size_t asPos = tagEnd;
+		size_t asBegin, asTagEnd, asEnd;
+		int index = 0;
+		while (FindElement(manifest, "AdaptationSet", asPos, end, asBegin, asTagEnd, asEnd))
+		{
+			asPos = asEnd;
+			std::string adaptationSetId;
+			GetTagAttribute(manifest, asBegin, asTagEnd, "id", adaptationSetId);
+			std::string key = GetAdaptationSetKey(periodKey, adaptationSetId, index++);
+			if (AddElement(manifest, key, asBegin, asEnd) == eELEMENT_REUSED)
+			{
+				prepared.append(manifest, copied, asBegin - copied);
+				AppendPlaceholder(prepared, "AdaptationSet", key);
+				copied = asEnd;
+			}
+		}
+	}
+	if (mRefs.empty())
+	{
+		return false;
+	}
+	prepared.append(manifest, copied, std::string::npos);
+	return true;
+}
+
+/**
+ * @brief Get a copy of the cached subtree a placeholder refers to
+ */
+Node *MPDNodeCache::GetNode(Node *placeholder, const std::string &url)
+{
+	Node *node = NULL;
+	std::string ref = placeholder->GetAttributeValue(MPD_NODE_REF_ATTRIBUTE);
+	char *endPtr = NULL;
+	unsigned long index = strtoul(ref.c_str(), &endPtr, 10);
+	if (endPtr != ref.c_str() && index < mRefs.size() && mRefs[index])
+	{
+		node = MPDCloneNode(mRefs[index], Path::GetDirectoryPath(url));
+	}
+	return node;
+}
+
+/**
+ * @brief Record the subtrees of a parsed document
+ */
+void MPDNodeCache::Commit(const Node *root)
+{
+	if (root == NULL)
+	{
+		Clear();
+		return;
+	}
+
+	// parsed subtrees by key, needed for the elements to be cached now
+	std::map<std::string, const Node*> parsedNodes;
+	for (const Node *period : root->GetSubNodes())
+	{
+		if (period->GetName() == "Period" && period->HasAttribute("id"))
+		{
+			std::string periodKey = period->GetAttributeValue("id");
+			parsedNodes.emplace(periodKey, period);
+			int index = 0;
+			for (const Node *child : period->GetSubNodes())
+			{
+				if (child->GetName() == "AdaptationSet")
+				{
+					std::string adaptationSetId = child->HasAttribute("id") ? child->GetAttributeValue("id") : "";
+					parsedNodes.emplace(GetAdaptationSetKey(periodKey, adaptationSetId, index++), child);
+				}
+			}
+		}
+	}
+
+	std::map<std::string, Entry> entries;
+	for (Element &element : mElements)
+	{
+		Entry &entry = entries[element.key];
+		auto it = mEntries.find(element.key);
+		if (element.state == eELEMENT_CHANGED)
+		{
+			// not cached until it is seen unchanged in the next refresh
+			entry.text.swap(element.text);
+		}
+		else
+		{
+			entry.text.swap(it->second.text);
+			std::swap(entry.node, it->second.node);
+			if (entry.node == NULL)
+			{
+				auto parsed = parsedNodes.find(element.key);
+				if (parsed != parsedNodes.end())
+				{
+					entry.node = MPDCloneNode(parsed->second, "");
+				}
+			}
+			if (element.state == eELEMENT_REUSED)
+			{
+				// AdaptationSets of a reused Period were not scanned; keep them for when the Period changes
+				std::string prefix = element.key;
+				prefix.push_back('\0');
+				for (auto child = mEntries.lower_bound(prefix); child != mEntries.end() && child->first.compare(0, prefix.size(), prefix) == 0; ++child)
+				{
+					Entry &childEntry = entries[child->first];
+					childEntry.text.swap(child->second.text);
+					std::swap(childEntry.node, child->second.node);
+				}
+			}
+		}
+	}
+	for (auto &entry : mEntries)
+	{
+		SAFE_DELETE(entry.second.node);
+	}
+	mEntries.swap(entries);
+	mElements.clear();
+	mKeys.clear();
+}
+
 /**
  * @brief Add attributes to xml node
  * @param reader xmlTextReaderPtr
@@ -29,6 +29,9 @@
 #include "libdash/xml/DOMParser.h"
 #include <libxml/xmlreader.h>
 #include <thread>
+#include <map>
+#include <set>
+#include <vector>
 #include "AampLogManager.h"
 #include "AampUtils.h"
 #include "AampMPDPeriodInfo.h"
@@ -39,15 +42,154 @@ using namespace dash::mpd;
 using namespace dash::xml;
 using namespace dash::helpers;
 
+#define MPD_NODE_REF_ATTRIBUTE "aampNodeRef"	/**< attribute of the placeholder elements inserted by MPDNodeCache::Prepare */
+
+/**
+ * @class MPDNodeCache
+ * @brief Parsed Period and AdaptationSet subtrees kept across refreshes of a live manifest
+ *
+ * Prepare() locates the Period elements of the manifest text, and the AdaptationSet elements
+ * of changed Periods, and compares them with the previous refresh by id and content. Elements
+ * that are unchanged are replaced by an empty placeholder element, so that libxml does not
+ * tokenize them again, and MPDProcessNode() substitutes a copy of the cached subtree for each
+ * placeholder. Commit() then records the subtrees of the new document.
+ *
+ * A subtree is copied into the cache only once its element has been seen unchanged across two
+ * refreshes, so the live edge Period of a single period stream, which changes on every refresh,
+ * costs a comparison and nothing more. Elements without an id, and manifests with comments or
+ * CDATA sections, are always parsed in full.
+ */
+class MPDNodeCache
+{
+public:
+	MPDNodeCache();
+	~MPDNodeCache();
+
+	/**
+	 * @brief Replace elements unchanged since the previous refresh by placeholders
+	 * @param[in] manifest - downloaded manifest text
+	 * @param[out] prepared - text to be parsed with MPDProcessNode() instead of manifest, if any element is reused
+	 * @return true if prepared is to be parsed, false if manifest is to be parsed as is
+	 */
+	bool Prepare(const std::string &manifest, std::string &prepared);
+
+	/**
+	 * @brief Get a copy of the cached subtree a placeholder refers to
+	 * @param[in] placeholder - placeholder node, with MPD_NODE_REF_ATTRIBUTE
+	 * @param[in] url - manifest url, for the MPD path of the copied nodes
+	 * @return new subtree owned by the caller, NULL if the reference is not valid
+	 */
+	Node *GetNode(Node *placeholder, const std::string &url);
+
+	/**
+	 * @brief Record the subtrees of a parsed document; to be called after each Prepare()
+	 * @param[in] root - root node of the document parsed from the text returned by Prepare(), NULL on parse failure
+	 */
+	void Commit(const Node *root);
+
+	/**
+	 * @brief Drop all cached subtrees
+	 */
+	void Clear();
+
+	/**
+	 * @brief Get the number of elements reused by the last Prepare()
+	 */
+	size_t GetReusedCount() const { return mRefs.size(); }
+
+	/**
+	 * @brief Get the number of cached elements
+	 */
+	size_t GetEntryCount() const { return mEntries.size(); }
+
+	MPDNodeCache(const MPDNodeCache&) = delete;
+	MPDNodeCache& operator=(const MPDNodeCache&) = delete;
+
+private:
+	/**
+	 * @struct Entry
+	 * @brief Element text of the previous refresh and, once stable, its parsed subtree
+	 */
+	struct Entry
+	{
+		std::string text;
+		Node *node;
+
+		Entry() : text(), node(NULL)
+		{
+		}
+	};
+
+	/**
+	 * @enum ElementState
+	 * @brief Result of comparing an element with the previous refresh
+	 */
+	enum ElementState
+	{
+		eELEMENT_CHANGED,	/**< new or modified, parsed from text */
+		eELEMENT_UNCHANGED,	/**< same as previous refresh but not cached yet, parsed from text and cached by Commit */
+		eELEMENT_REUSED		/**< replaced by a placeholder for the cached subtree */
+	};
+
+	/**
+	 * @struct Element
+	 * @brief Element located by Prepare()
+	 */
+	struct Element
+	{
+		std::string key;
+		ElementState state;
+		std::string text;	/**< element text, for changed elements only */
+	};
+
+	/**
+	 * @brief Compare an element with the previous refresh and queue it for Commit
+	 */
+	ElementState AddElement(const std::string &manifest, const std::string &key, size_t begin, size_t end);
+
+	/**
+	 * @brief Append the placeholder of a reused element to out
+	 */
+	void AppendPlaceholder(std::string &out, const std::string &name, const std::string &key);
+
+	std::map<std::string, Entry> mEntries;	/**< keyed by period id, and period id/adaptation set id for AdaptationSets */
+	std::vector<Element> mElements;			/**< elements located by the last Prepare() */
+	std::set<std::string> mKeys;			/**< keys of mElements, to detect duplicate ids */
+	std::vector<const Node*> mRefs;			/**< cached subtrees referenced by placeholders, by reference index */
+};
+
+/**
+ * @brief Deep copy of a node tree
+ * @param[in] source - node to copy
+ * @param[in] mpdPath - MPD path set on the copied element nodes
+ * @return new node tree owned by the caller
+ */
+Node *MPDCloneNode(const Node *source, const std::string &mpdPath);
+
 
 /**
  * @brief Get xml node form reader
  *
  * @retval xml node
  */
-Node* MPDProcessNode(xmlTextReaderPtr *reader, std::string url, bool isAd=false);
+Node* MPDProcessNode(xmlTextReaderPtr *reader, std::string url, bool isAd=false, MPDNodeCache *nodeCache=NULL);
 
 
+/**
+ * @brief Build the node tree of a manifest in a single streaming pass
+ *
+ * Equivalent to MPDProcessNode() on an xmlTextReader positioned at the first node, but
+ * driven by libxml SAX2 callbacks, so that no intermediate libxml tree is built and
+ * freed for every element, and the MPD path is computed once instead of per node.
+ *
+ * @param manifest manifest text
+ * @param url manifest url
+ * @param isAd true for ad manifests, whose period ids are made unique
+ * @param nodeCache subtrees to substitute for placeholders, NULL if none
+ * @retval root node, NULL if the manifest has no root element
+ */
+Node *MPDParseDocument(const std::string &manifest, const std::string &url, bool isAd=false, MPDNodeCache *nodeCache=NULL);
+
 /**
  * @brief Add attributes to xml node
  * @param reader xmlTextReaderPtr
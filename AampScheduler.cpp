@@ -31,7 +31,8 @@
 AampScheduler::AampScheduler() : mTaskQueue(), mQMutex(), mQCond(),
 	mSchedulerRunning(false), mSchedulerThread(), mExMutex(),
 	mExLock(mExMutex, std::defer_lock), mNextTaskId(AAMP_SCHEDULER_ID_DEFAULT),
-	mCurrentTaskId(AAMP_TASK_ID_INVALID), mLockOut(false), mState(eSTATE_IDLE),mPlayerId(-1)
+	mCurrentTaskId(AAMP_TASK_ID_INVALID), mLockOut(false), mState(eSTATE_IDLE),mPlayerId(-1),
+	mLatencyStats()
 {
 }
 
@@ -81,6 +82,7 @@ int AampScheduler::ScheduleTask(AsyncTaskObj obj)
 				mNextTaskId = AAMP_SCHEDULER_ID_DEFAULT;
 			}
 			obj.mId = id;
+			obj.mQueuedTimeMs = NOW_STEADY_TS_MS;
 			if (obj.mTaskName == "SetRate")
 			{
 				// Remove any existing SetRate task from the queue
@@ -132,10 +134,16 @@ void AampScheduler::ExecuteAsyncTask()
 			queueLock.lock();
 
 			//mTaskQueue could have been modified while waiting for execute permission
+			auto next = mTaskQueue.end();
+			long long startTime = NOW_STEADY_TS_MS;
 			if (!mTaskQueue.empty())
 			{
-				AsyncTaskObj obj = mTaskQueue.front();
-				mTaskQueue.pop_front();
+				next = SelectNextTask();
+			}
+			if (next != mTaskQueue.end())
+			{
+				AsyncTaskObj obj = *next;
+				mTaskQueue.erase(next);
 				if (obj.mId != AAMP_TASK_ID_INVALID)
 				{
 					mCurrentTaskId = obj.mId;
@@ -148,8 +156,10 @@ void AampScheduler::ExecuteAsyncTask()
 						AAMPLOG_WARN("SchedulerTask Execution:%s taskId:%d",obj.mTaskName.c_str(),obj.mId);
 						//Execute function
 						obj.mTask(obj.mData);
+						long long endTime = NOW_STEADY_TS_MS;
 						//May be used in a wait() in future loops, it needs to be locked
 						queueLock.lock();
+						RecordLatency(obj, startTime - obj.mQueuedTimeMs, endTime - startTime);
 					}
 				}
 				else
@@ -162,6 +172,86 @@ void AampScheduler::ExecuteAsyncTask()
 	AAMPLOG_INFO("Exited Async Worker Thread");
 }
 
+/**
+ * @brief To pick the task to run next, the first queued task that was not cancelled
+ */
+std::deque<AsyncTaskObj>::iterator AampScheduler::SelectNextTask()
+{
+	auto it = mTaskQueue.begin();
+	while (it != mTaskQueue.end() && it->IsCancelled())
+	{
+		AAMPLOG_INFO("Skipping cancelled task:%s taskId:%d", it->mTaskName.c_str(), it->mId);
+		mLatencyStats[it->mTaskName].cancelled++;
+		it = mTaskQueue.erase(it);
+	}
+	return it;
+}
+
+/**
+ * @brief To update latency statistics of an executed task
+ */
+void AampScheduler::RecordLatency(const AsyncTaskObj &obj, long long waitMs, long long runMs)
+{
+	AsyncTaskLatencyStats &stats = mLatencyStats[obj.mTaskName];
+	stats.executed++;
+	if (waitMs > stats.maxWaitMs)
+	{
+		stats.maxWaitMs = waitMs;
+	}
+	if (runMs > stats.maxRunMs)
+	{
+		stats.maxRunMs = runMs;
+	}
+	int bucket = 0;
+	long long limit = 1;
+	while (bucket < AAMP_SCHEDULER_LATENCY_BUCKETS - 1 && waitMs >= limit)
+	{
+		bucket++;
+		limit *= 4;
+	}
+	stats.waitHistogram[bucket]++;
+}
+
+/**
+ * @brief To create a cancellation token for scheduled tasks
+ */
+AsyncTaskCancelToken AampScheduler::CreateCancelToken()
+{
+	return std::make_shared<std::atomic<bool>>(false);
+}
+
+/**
+ * @brief To get latency statistics of a task name
+ */
+bool AampScheduler::GetLatencyStats(const std::string &taskName, AsyncTaskLatencyStats &stats)
+{
+	bool ret = false;
+	std::lock_guard<std::mutex>lock(mQMutex);
+	auto it = mLatencyStats.find(taskName);
+	if (it != mLatencyStats.end())
+	{
+		stats = it->second;
+		ret = true;
+	}
+	return ret;
+}
+
+/**
+ * @brief To log latency statistics of all task names
+ */
+void AampScheduler::LogLatencyStats()
+{
+	std::lock_guard<std::mutex>lock(mQMutex);
+	for (const auto &entry : mLatencyStats)
+	{
+		const AsyncTaskLatencyStats &stats = entry.second;
+		const unsigned int *hist = stats.waitHistogram;
+		AAMPLOG_MIL("task:%s executed=%u cancelled=%u maxWaitMs=%lld maxRunMs=%lld waitMs[<1:%u <4:%u <16:%u <64:%u <256:%u <1024:%u >=1024:%u]",
+					entry.first.c_str(), stats.executed, stats.cancelled, stats.maxWaitMs, stats.maxRunMs,
+					hist[0], hist[1], hist[2], hist[3], hist[4], hist[5], hist[6]);
+	}
+}
+
 /**
  * @brief To remove all scheduled tasks and prevent further tasks from scheduling
  */
@@ -185,6 +275,7 @@ void AampScheduler::RemoveAllTasks()
 void AampScheduler::StopScheduler()
 {
 	AAMPLOG_WARN("Stopping Async Worker Thread");
+	LogLatencyStats();
 	// Clean up things in queue
 	mSchedulerRunning = false;
 
@@ -31,6 +31,9 @@
 #include <deque>
 #include <thread>
 #include <utility>
+#include <map>
+#include <memory>
+#include <atomic>
 #include "AampDefine.h"
 #include "AampEvent.h"
 
@@ -38,10 +41,16 @@
 #include "AampLogManager.h"
 #define AAMP_SCHEDULER_ID_MAX_VALUE INT_MAX  // 10000
 #define AAMP_SCHEDULER_ID_DEFAULT 1		//ID ranges from DEFAULT to MAX
+#define AAMP_SCHEDULER_LATENCY_BUCKETS 7		/**< Wait time histogram buckets: <1, <4, <16, <64, <256, <1024 and >=1024 ms */
 
 
 typedef std::function<void (void *)> AsyncTask;
 
+/**
+ * @brief Set to true to cancel all queued tasks created with the token
+ */
+typedef std::shared_ptr<std::atomic<bool>> AsyncTaskCancelToken;
+
 /**
  * @brief Async task operations
  */
@@ -51,13 +60,23 @@ struct AsyncTaskObj
 	void * mData;
 	int mId;
 	std::string mTaskName;
+	AsyncTaskCancelToken mCancelToken;		/**< Task is skipped if set to true before it starts; may be NULL */
+	long long mQueuedTimeMs;				/**< Steady clock time when queued, set by ScheduleTask */
 
 	AsyncTaskObj(AsyncTask task, void *data, std::string tskName="", int id = AAMP_TASK_ID_INVALID) :
-				mTask(task), mData(data), mId(id),mTaskName(tskName)
+				mTask(task), mData(data), mId(id),mTaskName(tskName),
+				mCancelToken(), mQueuedTimeMs(0)
+	{
+	}
+
+	AsyncTaskObj(AsyncTask task, void *data, std::string tskName, AsyncTaskCancelToken cancelToken) :
+				mTask(task), mData(data), mId(AAMP_TASK_ID_INVALID),mTaskName(tskName),
+				mCancelToken(cancelToken), mQueuedTimeMs(0)
 	{
 	}
 
-	AsyncTaskObj(const AsyncTaskObj &other) : mTask(other.mTask), mData(other.mData), mId(other.mId),mTaskName(other.mTaskName)
+	AsyncTaskObj(const AsyncTaskObj &other) : mTask(other.mTask), mData(other.mData), mId(other.mId),mTaskName(other.mTaskName),
+				mCancelToken(other.mCancelToken), mQueuedTimeMs(other.mQueuedTimeMs)
 	{
 	}
 
@@ -67,8 +86,34 @@ struct AsyncTaskObj
 		mData = other.mData;
 		mId = other.mId;
 		mTaskName = other.mTaskName;
+		mCancelToken = other.mCancelToken;
+		mQueuedTimeMs = other.mQueuedTimeMs;
 		return *this;
 	}
+
+	/**
+	 * @brief Check if the task was cancelled through its token
+	 */
+	bool IsCancelled() const
+	{
+		return mCancelToken && *mCancelToken;
+	}
+};
+
+/**
+ * @brief Latency statistics of one scheduled task name
+ */
+struct AsyncTaskLatencyStats
+{
+	unsigned int executed;			/**< Tasks run */
+	unsigned int cancelled;			/**< Tasks skipped because their token was cancelled */
+	long long maxWaitMs;			/**< Longest queued to started time */
+	long long maxRunMs;				/**< Longest execution time */
+	unsigned int waitHistogram[AAMP_SCHEDULER_LATENCY_BUCKETS];	/**< Count of queued to started times per bucket */
+
+	AsyncTaskLatencyStats() : executed(0), cancelled(0), maxWaitMs(0), maxRunMs(0), waitHistogram()
+	{
+	}
 };
 
 /**
@@ -155,6 +200,29 @@ public:
 	 */
 	void SetState(AAMPPlayerState state);
 
+	/**
+	 * @fn CreateCancelToken
+	 *
+	 * @return AsyncTaskCancelToken - token, not cancelled, to pass to AsyncTaskObj
+	 */
+	static AsyncTaskCancelToken CreateCancelToken();
+
+	/**
+	 * @fn GetLatencyStats
+	 *
+	 * @param[in] taskName - name of the scheduled task
+	 * @param[out] stats - latency statistics of the task name
+	 * @return bool true if any task of that name was run or cancelled
+	 */
+	bool GetLatencyStats(const std::string &taskName, AsyncTaskLatencyStats &stats);
+
+	/**
+	 * @fn LogLatencyStats
+	 *
+	 * @return void
+	 */
+	void LogLatencyStats();
+
 protected:
 	/**
 	 * @fn ExecuteAsyncTask
@@ -163,6 +231,22 @@ protected:
 	 */
 	void ExecuteAsyncTask();
 
+	/**
+	 * @fn SelectNextTask
+	 *
+	 * All tasks change player state, so they run in queue order; cancelled tasks are dropped.
+	 *
+	 * @return iterator of the task to run next, mTaskQueue.end() if none; called with mQMutex held
+	 */
+	std::deque<AsyncTaskObj>::iterator SelectNextTask();
+
+	/**
+	 * @fn RecordLatency
+	 *
+	 * @return void; called with mQMutex held
+	 */
+	void RecordLatency(const AsyncTaskObj &obj, long long waitMs, long long runMs);
+
 	std::deque<AsyncTaskObj> mTaskQueue;	/**< Queue for storing scheduled tasks */
 	std::mutex mQMutex;			/**< Mutex for accessing mTaskQueue */
 	std::condition_variable mQCond;		/**< To notify when a task is queued in mTaskQueue */
@@ -174,6 +258,7 @@ protected:
 	int mCurrentTaskId;			/**< ID of current executed task */
 	bool mLockOut;				/**< flag indicates if the queue is locked out or not */
 	AAMPPlayerState mState;		        /**< Player State */
+	std::map<std::string, AsyncTaskLatencyStats> mLatencyStats;	/**< Latency statistics by task name, protected by mQMutex */
 };
 
 #endif /* __AAMP_SCHEDULER_H__ */
@@ -32,6 +32,7 @@
 #include <iostream>
 #include <cmath>
 #include <utility>
+#include <algorithm>
 
 #define INIT_CHECK_RETURN_VAL(val) \
 	if(!mInitialized_){ \
@@ -51,7 +52,7 @@
  * @return None
  */
 AampTSBSessionManager::AampTSBSessionManager(PrivateInstanceAAMP *aamp)
-	: mInitialized_(false), mStopThread_(false), mAamp(aamp), mTSBStore(nullptr), mActiveTuneType(eTUNETYPE_NEW_NORMAL), mLastVideoPos(AAMP_PAUSE_POSITION_INVALID_POSITION)
+	: mInitialized_(false), mStopThread_(false), mTsbWriteQueueDepth(DEFAULT_TSB_WRITE_QUEUE_DEPTH), mAamp(aamp), mTSBStore(nullptr), mActiveTuneType(eTUNETYPE_NEW_NORMAL), mLastVideoPos(AAMP_PAUSE_POSITION_INVALID_POSITION)
 		, mCulledDuration(0.0)
 		, mStoreEndPosition(0.0)
 		, mLiveEndPosition(0.0)
@@ -89,6 +90,19 @@ void AampTSBSessionManager::Init()
 		config.location = mTsbLocation;
 		config.minFreePercentage = mTsbMinFreePercentage;
 		config.maxCapacity =  mTsbMaxDiskStorage;
+		if (mAamp->mConfig->IsConfigSet(eAAMPConfig_TsbPackFiles))
+		{
+			config.ioBackend = TSB::IoBackend::PACK;
+			config.packFileSize = static_cast<uint32_t>(mAamp->mConfig->GetConfigValue(eAAMPConfig_TsbPackFileSize));
+		}
+		else if (mAamp->mConfig->IsConfigSet(eAAMPConfig_TsbPosixIo))
+		{
+			config.ioBackend = TSB::IoBackend::POSIX;
+		}
+		if (config.ioBackend != TSB::IoBackend::STREAM)
+		{
+			config.directIoThreshold = static_cast<uint32_t>(mAamp->mConfig->GetConfigValue(eAAMPConfig_TsbDirectIoThreshold)) * 1024;
+		}
 		TSB::LogLevel level = static_cast<TSB::LogLevel>(ConvertTsbLogLevel(mAamp->mConfig->GetConfigValue(eAAMPConfig_TsbLogLevel)));
 		AAMPLOG_INFO("[TSB Store] Initiating with config values { logLevel:%d maxCapacity : %d minFreePercentage : %d location : %s }",  static_cast<int>(level), config.maxCapacity, config.minFreePercentage, config.location.c_str());
 
@@ -104,8 +118,8 @@ void AampTSBSessionManager::Init()
 			// Initialize TSB readers
 			InitializeTsbReaders();
 			mStopThread_.store(false);
-			// Start monitoring the write queue in a separate thread
-			mWriteThread = std::thread(&AampTSBSessionManager::ProcessWriteQueue, this);
+			// Start monitoring the write queue of each track in a separate thread
+			InitializeWriteLanes();
 			mInitialized_ = true;
 		}
 	}
@@ -169,6 +183,30 @@ void AampTSBSessionManager::InitializeTsbReaders()
 	}
 }
 
+/**
+ * @brief Initialize a write lane for each track and start its write thread
+ *
+ * Each track is written by its own thread, so that a slow write of one track does not
+ * hold back the fragments of the other tracks queued behind it.
+ *
+ * @return None
+ */
+void AampTSBSessionManager::InitializeWriteLanes()
+{
+	if (mWriteLanes.empty())
+	{
+		for (auto &it : mDataManagers)
+		{
+			mWriteLanes.emplace(it.first, std::make_shared<TsbWriteLane>());
+		}
+	}
+	// Lanes are all created before any thread starts, as the threads look up their lane in the map
+	for (auto &it : mWriteLanes)
+	{
+		it.second->thread = std::thread(&AampTSBSessionManager::ProcessWriteQueue, this, it.first);
+	}
+}
+
 /**
  * @brief Reads from the TSB library based on the initialization fragment data.
  *
@@ -296,9 +334,6 @@ void AampTSBSessionManager::EnqueueWrite(std::string url, std::shared_ptr<Cached
 {
 	INIT_CHECK_RETURN_VOID();
 
-	// Protect this section with the write queue mutex
-	std::unique_lock<std::mutex> guard(mWriteQueueMutex);
-
 	AampMediaType mediaType = ConvertMediaType(cachedFragment->type);
 	if (!IsTrackStoredInTsb(mediaType))
 	{
@@ -324,12 +359,30 @@ void AampTSBSessionManager::EnqueueWrite(std::string url, std::shared_ptr<Cached
 			TSBWriteData writeData = {url, cachedFragment, pts, std::move(periodId)};
 			AAMPLOG_TRACE("Enqueueing Write Data discontinuity %d for URL: %s",cachedFragment->discontinuity, url.c_str());
 
-			mCurrentWritePosition = cachedFragment->absPosition;
+			{
+				std::lock_guard<std::mutex> guard(mWritePositionMutex);
+				mCurrentWritePosition = cachedFragment->absPosition;
+			}
 			// TODO :Need to add the same data on Addfragment and AddInitfragment of AampTsbDataManager
-			mWriteQueue.push(writeData);
+			std::shared_ptr<TsbWriteLane> lane = mWriteLanes.at(mediaType);
+			std::unique_lock<std::mutex> laneLock(lane->mutex);
+			size_t maxDepth = static_cast<size_t>(mTsbWriteQueueDepth);
+			if (maxDepth > 0 && lane->queue.size() >= maxDepth && !mStopThread_.load())
+			{
+				// Backpressure; hold the fetcher until the write thread has caught up, instead of queuing without bound
+				long long waitStartTime = NOW_STEADY_TS_MS;
+				lane->spaceCV.wait(laneLock, [this, &lane, maxDepth]()
+								   { return lane->queue.size() < maxDepth || mStopThread_.load(); });
+				long long waitTime = NOW_STEADY_TS_MS - waitStartTime;
+				lane->blockedCount++;
+				lane->blockedTimeMs += waitTime;
+				AAMPLOG_WARN("[%s] TSB write queue full (%zu fragments), waited %lldms", GetMediaTypeName(mediaType), maxDepth, waitTime);
+			}
+			lane->queue.push(std::move(writeData));
+			lane->highWatermark = std::max(lane->highWatermark, lane->queue.size());
 			// Notify the monitoring thread that there is data in the queue
-			guard.unlock();
-			mWriteThreadCV.notify_one();
+			laneLock.unlock();
+			lane->dataCV.notify_one();
 		}
 	}
 }
@@ -345,43 +398,49 @@ std::string AampTSBSessionManager::ToUniqueUrl(std::string url, double absPositi
 	return url + "." + std::to_string(idx);
 }
 
-TsbFragmentDataPtr AampTSBSessionManager::RemoveFragmentDeleteInit(AampMediaType mediatype)
+TsbFragmentDataPtr AampTSBSessionManager::RemoveOldestFragment(AampMediaType mediatype, std::string &initUrl)
 {
 	bool deleteInit = false;
+	initUrl.clear();
 	TsbFragmentDataPtr removedFragment = GetTsbDataManager(mediatype)->RemoveFragment(deleteInit);
 	if (removedFragment && deleteInit)
 	{
 		TsbInitDataPtr removedFragmentInit = removedFragment->GetInitFragData();
 		if (removedFragmentInit)
 		{
-			std::string initUrl = ToUniqueUrl(removedFragmentInit->GetUrl(),
-										  	  removedFragmentInit->GetAbsolutePosition().inSeconds());
-			mTSBStore->Delete(initUrl);
+			initUrl = ToUniqueUrl(removedFragmentInit->GetUrl(),
+								  removedFragmentInit->GetAbsolutePosition().inSeconds());
 		}
 	}
 	return removedFragment;
 }
 
 /**
- * @brief Monitors the write queue and writes any pending data to AAMP TSB
+ * @brief Monitors the write queue of a track and writes any pending data to AAMP TSB
+ *
+ * The fragment is written to the store without holding the read mutex; the read mutex is only
+ * taken to publish the written fragment to the data manager, or to remove the oldest fragment
+ * when out of space, so TSB readers never wait for a store write or delete to complete.
  */
-void AampTSBSessionManager::ProcessWriteQueue()
+void AampTSBSessionManager::ProcessWriteQueue(AampMediaType mediatype)
 {
-	std::unique_lock<std::mutex> lock(mWriteQueueMutex);
-	AAMPLOG_INFO("Enter AAMP TSB write thread");
+	std::shared_ptr<TsbWriteLane> lane = mWriteLanes.at(mediatype);
+	std::unique_lock<std::mutex> lock(lane->mutex);
+	AAMPLOG_INFO("[%s] Enter AAMP TSB write thread", GetMediaTypeName(mediatype));
 	while (!mStopThread_.load())
 	{
-		mWriteThreadCV.wait(lock, [this]()
-							{ return !mWriteQueue.empty() || mStopThread_.load(); });
+		lane->dataCV.wait(lock, [this, &lane]()
+						  { return !lane->queue.empty() || mStopThread_.load(); });
 
-		if (!mStopThread_.load() && !mWriteQueue.empty())
+		if (!mStopThread_.load() && !lane->queue.empty())
 		{
-			TSBWriteData writeData = mWriteQueue.front();
-			mWriteQueue.pop();
+			TSBWriteData writeData = std::move(lane->queue.front());
+			lane->queue.pop();
 			lock.unlock(); // Release the lock before writing to AAMP TSB
+			lane->spaceCV.notify_one();
 
 			bool writeSucceeded = false;
-			AampMediaType mediatype = ConvertMediaType(writeData.cachedFragment->type);
+			long long tWriteStartTime = NOW_STEADY_TS_MS;
 			while (!writeSucceeded && !mStopThread_.load())
 			{
 				long long tStartTime = NOW_STEADY_TS_MS;
@@ -457,6 +516,8 @@ void AampTSBSessionManager::ProcessWriteQueue()
 					{
 						AAMPLOG_TRACE("[%s] TSB Write Operation FAILED...time taken (%lldms)...buffer (%zu)....BW(%ld)...disc(%d)...pts(%.02lf)...URL (%s)", GetMediaTypeName(writeData.cachedFragment->type), NOW_STEADY_TS_MS - tStartTime, writeData.cachedFragment->fragment.GetLen(), writeData.cachedFragment->cacheFragStreamInfo.bandwidthBitsPerSecond,  writeData.cachedFragment->discontinuity, writeData.pts, writeData.url.c_str()); // log metrics for failed case also.
 					}
+					TsbFragmentDataPtr removedFragment;
+					std::string removedInitUrl;
 					LockReadMutex();
 					if(writeData.cachedFragment->fragment.GetLen() == 0) //Buffer 0 case ,no need to run this loop untill it get success
 					{
@@ -464,22 +525,32 @@ void AampTSBSessionManager::ProcessWriteQueue()
 					}
 					else
 					{
-						TsbFragmentDataPtr removedFragment = RemoveFragmentDeleteInit(mediatype);
+						removedFragment = RemoveOldestFragment(mediatype, removedInitUrl);
 						if (removedFragment)
 						{
 							UpdateTotalStoreDuration(mediatype, -removedFragment->GetDuration().inSeconds());
-							std::string removedFragmentUrl = ToUniqueUrl(removedFragment->GetUrl(),removedFragment->GetAbsolutePosition().inSeconds());
-							mTSBStore->Delete(removedFragmentUrl);
-							AAMPLOG_INFO("[%s] Removed  %.02lf sec, AbsPosition: %.02lfs ,pts %.02lf, Url : %s", GetMediaTypeName(mediatype), removedFragment->GetDuration().inSeconds(), removedFragment->GetAbsolutePosition().inSeconds(), removedFragment->GetPTS().inSeconds(), removedFragmentUrl.c_str());
 						}
 					}
 					UnlockReadMutex();
+					if (removedFragment)
+					{
+						std::string removedFragmentUrl = ToUniqueUrl(removedFragment->GetUrl(),removedFragment->GetAbsolutePosition().inSeconds());
+						mTSBStore->Delete(removedFragmentUrl);
+						AAMPLOG_INFO("[%s] Removed  %.02lf sec, AbsPosition: %.02lfs ,pts %.02lf, Url : %s", GetMediaTypeName(mediatype), removedFragment->GetDuration().inSeconds(), removedFragment->GetAbsolutePosition().inSeconds(), removedFragment->GetPTS().inSeconds(), removedFragmentUrl.c_str());
+					}
+					if (!removedInitUrl.empty())
+					{
+						mTSBStore->Delete(removedInitUrl);
+					}
 				}
 			}
+			long long writeTime = NOW_STEADY_TS_MS - tWriteStartTime;
 			lock.lock(); // Reacquire the lock for next iter
+			lane->writeCount++;
+			lane->maxWriteTimeMs = std::max(lane->maxWriteTimeMs, writeTime);
 		}
 	}
-	AAMPLOG_INFO("Exit AAMP TSB write thread");
+	AAMPLOG_INFO("[%s] Exit AAMP TSB write thread", GetMediaTypeName(mediatype));
 }
 
 /**
@@ -497,11 +568,28 @@ void AampTSBSessionManager::Flush()
 
 	if (mInitialized_)
 	{
-		// Notify the monitor thread in case it's waiting
-		mWriteThreadCV.notify_one();
-		if (mWriteThread.joinable())
+		for (auto &it : mWriteLanes)
 		{
-			mWriteThread.join();
+			std::shared_ptr<TsbWriteLane> &lane = it.second;
+			{
+				// Notify the monitor thread and any fetcher waiting for space; taking the lock ensures the stop is not missed
+				std::lock_guard<std::mutex> laneLock(lane->mutex);
+				lane->dataCV.notify_all();
+				lane->spaceCV.notify_all();
+			}
+			if (lane->thread.joinable())
+			{
+				lane->thread.join();
+			}
+			std::lock_guard<std::mutex> laneLock(lane->mutex);
+			AAMPLOG_MIL("[%s] TSB write metrics: writes %u maxWriteTime %lldms queueHighWatermark %zu pending %zu blocked %u (%lldms)",
+						GetMediaTypeName(it.first), lane->writeCount, lane->maxWriteTimeMs, lane->highWatermark, lane->queue.size(), lane->blockedCount, lane->blockedTimeMs);
+			lane->queue = std::queue<TSBWriteData>();
+			lane->writeCount = 0;
+			lane->maxWriteTimeMs = 0;
+			lane->highWatermark = 0;
+			lane->blockedCount = 0;
+			lane->blockedTimeMs = 0;
 		}
 		// TODO: Need to take flush performance metrics
 		mTSBStore->Flush();
@@ -581,7 +669,8 @@ double AampTSBSessionManager::CullSegments()
 		if (!skip)
 		{
 			// Remove the oldest segment
-			TsbFragmentDataPtr removedFragment = RemoveFragmentDeleteInit(mediaTypeToRemove);
+			std::string removedInitUrl;
+			TsbFragmentDataPtr removedFragment = RemoveOldestFragment(mediaTypeToRemove, removedInitUrl);
 			if (removedFragment)
 			{
 				double durationInSeconds = removedFragment->GetDuration().inSeconds();
@@ -590,6 +679,10 @@ double AampTSBSessionManager::CullSegments()
 				std::string removedFragmentUrl = ToUniqueUrl(removedFragment->GetUrl(),removedFragment->GetAbsolutePosition().inSeconds());
 				UnlockReadMutex();
 				mTSBStore->Delete(removedFragmentUrl);
+				if (!removedInitUrl.empty())
+				{
+					mTSBStore->Delete(removedInitUrl);
+				}
 				LockReadMutex();
 				AAMPLOG_INFO("[%s] Removed %lf fragment duration seconds, Url: %s, AbsPosition: %lf, pts %lf", GetMediaTypeName(mediaTypeToRemove), durationInSeconds, removedFragmentUrl.c_str(), removedFragment->GetAbsolutePosition().inSeconds(), removedFragment->GetPTS().inSeconds());
 
@@ -889,7 +982,7 @@ bool AampTSBSessionManager::PushNextTsbFragment(MediaStreamContext *pMediaStream
 							AAMPLOG_INFO("[%s] Cache init fragment CurrentBandwidth: %.02lf Previous Bandwidth: %.02lf IsDiscontinuous: %d",
 								GetMediaTypeName(mediaType), bandwidth, reader->mCurrentBandwidth, initFragment->discontinuity);
 
-							if (pMediaStreamContext->CacheTsbFragment(std::move(initFragment)))
+							if (pMediaStreamContext->CacheTsbFragment(std::move(initFragment), true))
 							{
 								AAMPLOG_TRACE("[%s] Successfully cached init fragment", GetMediaTypeName(mediaType));
 								reader->mCurrentBandwidth = bandwidth;
@@ -926,7 +1019,7 @@ bool AampTSBSessionManager::PushNextTsbFragment(MediaStreamContext *pMediaStream
 
 							ProcessAdMetadata(mediaType, nextFragmentData, rate);
 
-							if (pMediaStreamContext->CacheTsbFragment(std::move(nextFragment)))
+							if (pMediaStreamContext->CacheTsbFragment(std::move(nextFragment), true))
 							{
 								AAMPLOG_TRACE("[%s] Successfully cached fragment", GetMediaTypeName(mediaType));
 								if(reader->IsEos())
@@ -1147,8 +1240,8 @@ bool AampTSBSessionManager::EndAdPlacementWithError(const std::string &adId, uin
 // Shifts all current and future positions to the current position.
 void AampTSBSessionManager::ShiftFutureAdEvents()
 {
-	// Protect this section with the write queue mutex
-	std::unique_lock<std::mutex> guard(mWriteQueueMutex);
+	// Protect this section with the write position mutex
+	std::unique_lock<std::mutex> guard(mWritePositionMutex);
 	AampTime currentWritePosition = mCurrentWritePosition;
 	guard.unlock();
 
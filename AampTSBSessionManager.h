@@ -46,6 +46,28 @@ class AampTsbReader;
 
 typedef std::shared_ptr<CachedFragment> CachedFragmentPtr;
 
+/**
+ * @struct TsbWriteLane
+ * @brief Queue of fragments of one track waiting to be written to AAMP TSB, drained by its own thread
+ */
+struct TsbWriteLane
+{
+	std::thread thread;
+	std::mutex mutex;					// Protects the queue and the metrics
+	std::condition_variable dataCV;		// Signalled when data is added to the queue
+	std::condition_variable spaceCV;	// Signalled when data is removed from the queue
+	std::queue<TSBWriteData> queue;
+	unsigned int writeCount;			// Fragments written to the store
+	long long maxWriteTimeMs;			// Longest store write, including retries
+	size_t highWatermark;				// Max queue depth
+	unsigned int blockedCount;			// Times a fetcher had to wait for space in the queue
+	long long blockedTimeMs;			// Total time fetchers waited for space in the queue
+
+	TsbWriteLane() : thread(), mutex(), dataCV(), spaceCV(), queue(), writeCount(0), maxWriteTimeMs(0), highWatermark(0), blockedCount(0), blockedTimeMs(0)
+	{
+	}
+};
+
 /**
  * @class AampTSBSessionManager
  * @brief AampTSBSessionManager Class defn
@@ -85,9 +107,11 @@ public:
 	 */
 	void Flush();
 	/**
-	 * @brief Monitors the write queue and writes any pending data to AAMP TSB
+	 * @brief Monitors the write queue of a track and writes any pending data to AAMP TSB
+	 *
+	 * @param[in] mediaType - track type
 	 */
-	void ProcessWriteQueue();
+	void ProcessWriteQueue(AampMediaType mediaType);
 	/**
 	 * @brief Set TSB length
 	 *
@@ -112,6 +136,12 @@ public:
 	 * @param[in] tsbMaxDiskStorage
 	 */
 	void SetTsbMaxDiskStorage(unsigned int tsbMaxDiskStorage) { mTsbMaxDiskStorage = tsbMaxDiskStorage; }
+	/**
+	 * @brief SetTsbWriteQueueDepth - maximum fragments queued for writing per track
+	 *
+	 * @param[in] tsbWriteQueueDepth - 0 for no limit
+	 */
+	void SetTsbWriteQueueDepth(int tsbWriteQueueDepth) { mTsbWriteQueueDepth = tsbWriteQueueDepth; }
 
 	/**
 	 * @brief ConvertMediaType - Convert to actual AampMediaType
@@ -173,6 +203,12 @@ public:
 	 * @return None
 	 */
 	void InitializeTsbReaders();
+	/**
+	 * @brief Initialize a write lane for each track and start its write thread
+	 *
+	 * @return None
+	 */
+	void InitializeWriteLanes();
 	/**
 	 * @brief Read next fragment and push it to the injector loop
 	 *
@@ -343,11 +379,13 @@ private:
 	std::string ToUniqueUrl(std::string url, double absPosition);
 
 	/**
-	 * @brief Remove fragment from list and delete init fragment from TSB store if no longer referenced
+	 * @brief Remove the oldest fragment from the list, and its init fragment if no longer referenced.
+	 *        Called with the read mutex held; TSB store files are deleted by the caller after releasing it.
 	 * @param[in] mediaType - track type
+	 * @param[out] initUrl - unique url of the init fragment to delete from TSB store, empty if still referenced
 	 * @return shared ptr to fragment removed is any
 	 */
-	TsbFragmentDataPtr RemoveFragmentDeleteInit(AampMediaType mediatype);
+	TsbFragmentDataPtr RemoveOldestFragment(AampMediaType mediatype, std::string &initUrl);
 
 	/**
 	 * @brief Check if a track for the given media type is stored in TSB
@@ -358,6 +396,7 @@ private:
 
 	bool mInitialized_;
 	std::atomic_bool mStopThread_;			// This variable is atomic because it can be accessed from multiple threads
+	int mTsbWriteQueueDepth;				// Max fragments queued for writing per track, 0 for no limit
 
 	int mTsbLength; // duration in seconds , default of 1500
 	int mTsbMinFreePercentage;
@@ -365,16 +404,14 @@ private:
 	std::string mTsbLocation;
 	std::shared_ptr<TSB::Store> mTSBStore;
 	std::string mTsbSessionId;
-	std::thread mWriteThread;
+	std::unordered_map<AampMediaType, std::shared_ptr<TsbWriteLane>> mWriteLanes; // AampMediaType -> write queue and thread of the track
 	std::unordered_map<AampMediaType, std::pair<std::shared_ptr<AampTsbDataManager>, double>> mDataManagers; // AampMediaType -> {AampTsbDataManager, totalStoreDuration in seconds}
 	std::unordered_map<AampMediaType, std::shared_ptr<AampTsbReader>> mTsbReaders;
 	AampTsbMetaDataManager mMetaDataManager;
 	double mCulledDuration;
 	TuneType mActiveTuneType;
-	std::mutex mWriteQueueMutex;			// Mutex to synchronize access to the write queue.
+	std::mutex mWritePositionMutex;			// Mutex to synchronize access to mCurrentWritePosition.
 	std::mutex mReadMutex;					// Mutex to synchronize access to the data manager from reader and writer.
-	std::condition_variable mWriteThreadCV; // Condition variable to signal when data is available in the write queue
-	std::queue<TSBWriteData> mWriteQueue;	// Queue to store write data.
 	double mLastVideoPos;
 	double mStoreEndPosition; 		/**< Last reported TSB Store end position*/
 	double mLiveEndPosition;		/**< Last reported Live end position*/
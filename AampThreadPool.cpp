@@ -0,0 +1,265 @@
+/*
+ * If not stated otherwise in this file or this component's license file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2024 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/**
+ * @file AampThreadPool.cpp
+ * @brief Process wide work stealing executor shared by all player instances
+ */
+
+#include "AampThreadPool.h"
+#include "AampLogManager.h"
+#include <algorithm>
+#include <exception>
+
+std::atomic<bool> AampThreadPool::sEnabled(false);
+
+static thread_local size_t tWorkerIndex = (size_t)-1;	/**< Index of the pool worker running on this thread, -1 for other threads */
+
+/**
+ * @brief AampThreadPool Constructor
+ */
+AampThreadPool::AampThreadPool() : mWorkers(), mWorkerCount(0), mBaseWorkers(0), mReserveMutex(), mReserved(0), mWakeMutex(), mWakeCond(), mPending(0), mNextWorker(0), mSteals(0), mStop(false)
+{
+	mBaseWorkers = std::min(std::max((size_t)std::thread::hardware_concurrency(), (size_t)AAMP_THREAD_POOL_MIN_WORKERS), (size_t)AAMP_THREAD_POOL_MAX_WORKERS);
+	std::lock_guard<std::mutex> lock(mReserveMutex);
+	while( mWorkerCount < mBaseWorkers && AddWorker() )
+	{
+	}
+	AAMPLOG_MIL("Started %zu workers", mWorkerCount.load());
+}
+
+/**
+ * @brief AampThreadPool Destructor; runs the tasks still queued, then joins the workers
+ */
+AampThreadPool::~AampThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(mWakeMutex);
+		mStop = true;
+	}
+	mWakeCond.notify_all();
+	std::lock_guard<std::mutex> lock(mReserveMutex);
+	for( size_t i = 0; i < mWorkerCount; i++ )
+	{
+		if( mWorkers[i]->thread.joinable() )
+		{
+			mWorkers[i]->thread.join();
+		}
+	}
+}
+
+/**
+ * @brief Start a worker thread; caller holds mReserveMutex
+ */
+bool AampThreadPool::AddWorker()
+{
+	size_t index = mWorkerCount;
+	if( index >= AAMP_THREAD_POOL_CAPACITY )
+	{
+		return false;
+	}
+	try
+	{
+		mWorkers[index].reset(new Worker());
+		mWorkers[index]->thread = std::thread(&AampThreadPool::WorkerLoop, this, index);
+	}
+	catch (const std::exception &e)
+	{
+		AAMPLOG_ERR("Exception caught starting worker: %s", e.what());
+		mWorkers[index].reset();
+		return false;
+	}
+	mWorkerCount = index + 1; // publish only once the worker is complete
+	return true;
+}
+
+/**
+ * @brief Get the singleton instance of the pool
+ */
+AampThreadPool& AampThreadPool::GetInstance()
+{
+	static AampThreadPool instance;
+	return instance;
+}
+
+/**
+ * @brief Enable or disable the pool for subsystems created from now on
+ */
+void AampThreadPool::SetEnabled(bool enable)
+{
+	sEnabled = enable;
+}
+
+/**
+ * @brief Check if subsystems should schedule work on the pool
+ */
+bool AampThreadPool::IsEnabled()
+{
+	return sEnabled;
+}
+
+/**
+ * @brief Reserve a worker for a task that may block, adding a worker if needed
+ */
+bool AampThreadPool::ReserveWorker()
+{
+	std::lock_guard<std::mutex> lock(mReserveMutex);
+	while( mWorkerCount < mBaseWorkers + mReserved + 1 )
+	{
+		if( !AddWorker() )
+		{
+			AAMPLOG_WARN("Pool at capacity, %zu workers reserved", mReserved);
+			return false;
+		}
+	}
+	mReserved++;
+	return true;
+}
+
+/**
+ * @brief Release a worker reserved with ReserveWorker
+ */
+void AampThreadPool::ReleaseWorker()
+{
+	std::lock_guard<std::mutex> lock(mReserveMutex);
+	if( mReserved > 0 )
+	{
+		mReserved--;
+	}
+}
+
+/**
+ * @brief Get the number of worker threads
+ */
+size_t AampThreadPool::GetWorkerCount() const
+{
+	return mWorkerCount;
+}
+
+/**
+ * @brief Get the number of reserved workers
+ */
+size_t AampThreadPool::GetReservedCount() const
+{
+	std::lock_guard<std::mutex> lock(mReserveMutex);
+	return mReserved;
+}
+
+/**
+ * @brief Get the number of tasks taken from another worker's queue
+ */
+size_t AampThreadPool::GetStealCount() const
+{
+	return mSteals;
+}
+
+/**
+ * @brief Queue a task for execution on a worker thread
+ */
+void AampThreadPool::Submit(std::function<void()> task, AampTaskPriority priority)
+{
+	if( priority < eAAMP_TASK_PRIORITY_INJECTION || priority >= eAAMP_TASK_PRIORITY_COUNT )
+	{
+		priority = eAAMP_TASK_PRIORITY_HOUSEKEEPING;
+	}
+	size_t count = mWorkerCount;
+	size_t index = tWorkerIndex;
+	if( index >= count )
+	{
+		index = mNextWorker++ % count;
+	}
+	{
+		Worker &worker = *mWorkers[index];
+		std::lock_guard<std::mutex> lock(worker.mutex);
+		worker.queues[priority].push_back(std::move(task));
+	}
+	{
+		std::lock_guard<std::mutex> lock(mWakeMutex);
+		mPending++;
+	}
+	mWakeCond.notify_one();
+}
+
+/**
+ * @brief Take the most urgent task available to a worker, stealing if its own queues are empty
+ */
+bool AampThreadPool::GetTask(size_t index, std::function<void()> &task)
+{
+	size_t count = std::max(mWorkerCount.load(), index + 1); // a worker may start before it is published
+	for( int priority = 0; priority < eAAMP_TASK_PRIORITY_COUNT; priority++ )
+	{
+		for( size_t i = 0; i < count; i++ )
+		{
+			Worker &worker = *mWorkers[(index + i) % count];
+			std::lock_guard<std::mutex> lock(worker.mutex);
+			auto &queue = worker.queues[priority];
+			if( !queue.empty() )
+			{
+				if( i == 0 )
+				{ // own queue, newest first
+					task = std::move(queue.back());
+					queue.pop_back();
+				}
+				else
+				{ // steal the oldest, which the owner would get to last
+					task = std::move(queue.front());
+					queue.pop_front();
+					mSteals++;
+				}
+				mPending--;
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+/**
+ * @brief Main loop of a worker thread
+ */
+void AampThreadPool::WorkerLoop(size_t index)
+{
+	tWorkerIndex = index;
+	while( true )
+	{
+		std::function<void()> task;
+		if( GetTask(index, task) )
+		{
+			try
+			{
+				task();
+			}
+			catch (const std::exception &e)
+			{
+				AAMPLOG_ERR("Exception caught in pool task: %s", e.what());
+			}
+			catch (...)
+			{
+				AAMPLOG_ERR("Unknown exception caught in pool task");
+			}
+			continue;
+		}
+		std::unique_lock<std::mutex> lock(mWakeMutex);
+		mWakeCond.wait(lock, [this]() { return mStop || mPending > 0; });
+		if( mStop && mPending == 0 )
+		{
+			break;
+		}
+	}
+}
@@ -0,0 +1,174 @@
+/*
+ * If not stated otherwise in this file or this component's license file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2024 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/**
+ * @file AampThreadPool.h
+ * @brief Process wide work stealing executor shared by all player instances
+ */
+
+#ifndef __AAMP_THREAD_POOL_H__
+#define __AAMP_THREAD_POOL_H__
+
+#include <stddef.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#define AAMP_THREAD_POOL_MIN_WORKERS	4	/**< Tasks may block on network or disk I/O, so keep some headroom even on single core devices */
+#define AAMP_THREAD_POOL_MAX_WORKERS	8
+#define AAMP_THREAD_POOL_CAPACITY		64	/**< Upper bound on workers, including those added for reservations */
+
+/**
+ * @enum AampTaskPriority
+ * @brief Priority classes of pool tasks, most urgent first
+ */
+enum AampTaskPriority
+{
+	eAAMP_TASK_PRIORITY_INJECTION,		/**< Feeding the pipeline; delays cause underflow */
+	eAAMP_TASK_PRIORITY_DOWNLOAD,		/**< Fragment and playlist downloads */
+	eAAMP_TASK_PRIORITY_PREFETCH,		/**< Speculative work such as license prefetch */
+	eAAMP_TASK_PRIORITY_HOUSEKEEPING,	/**< Cleanup, stats and other deferrable work */
+	eAAMP_TASK_PRIORITY_COUNT
+};
+
+/**
+ * @class AampThreadPool
+ * @brief Fixed set of worker threads executing short tasks for all players in the process
+ *
+ * Each worker owns one deque per priority. Tasks submitted from a worker go to its own deques
+ * and are taken newest first, keeping related work on a warm cache; tasks submitted from any
+ * other thread are spread round robin. An idle worker takes the most urgent task available,
+ * its own before stealing the oldest one of another worker, so a busy worker cannot hold up
+ * work of higher priority queued behind it.
+ *
+ * Tasks must not wait for other pool tasks, and long running loops belong on dedicated threads.
+ * A subsystem whose tasks block on I/O reserves a worker for each task it may have in flight,
+ * and the pool grows to keep that many workers on top of its base size, so blocking work of
+ * one player cannot hold up the tasks of another. Added workers are kept for later reservations.
+ */
+class AampThreadPool
+{
+public:
+	/**
+	 * @brief Get the singleton instance of the pool; workers are started on first use
+	 * @return AampThreadPool instance
+	 */
+	static AampThreadPool& GetInstance();
+
+	/**
+	 * @brief Enable or disable the pool for subsystems created from now on
+	 * @param[in] enable - true to schedule work on the pool instead of dedicated threads
+	 */
+	static void SetEnabled(bool enable);
+
+	/**
+	 * @brief Check if subsystems should schedule work on the pool
+	 * @return true if enabled
+	 */
+	static bool IsEnabled();
+
+	/**
+	 * @brief Reserve a worker for a task that may block, adding a worker if needed
+	 * @return true if reserved; false if the pool is at capacity and the caller must use its own thread
+	 */
+	bool ReserveWorker();
+
+	/**
+	 * @brief Release a worker reserved with ReserveWorker
+	 */
+	void ReleaseWorker();
+
+	/**
+	 * @brief Queue a task for execution on a worker thread
+	 * @param[in] task - work to run; exceptions are caught and logged
+	 * @param[in] priority - priority class of the task
+	 */
+	void Submit(std::function<void()> task, AampTaskPriority priority);
+
+	/**
+	 * @brief Get the number of worker threads
+	 * @return worker count
+	 */
+	size_t GetWorkerCount() const;
+
+	/**
+	 * @brief Get the number of reserved workers
+	 * @return reservation count
+	 */
+	size_t GetReservedCount() const;
+
+	/**
+	 * @brief Get the number of tasks taken from another worker's queue
+	 * @return steal count since start
+	 */
+	size_t GetStealCount() const;
+
+	AampThreadPool(const AampThreadPool&) = delete;
+	AampThreadPool& operator=(const AampThreadPool&) = delete;
+
+private:
+	/**
+	 * @struct Worker
+	 * @brief Worker thread and its task queues
+	 */
+	struct Worker
+	{
+		std::mutex mutex;												/**< Protects queues */
+		std::deque<std::function<void()>> queues[eAAMP_TASK_PRIORITY_COUNT];	/**< Pending tasks by priority */
+		std::thread thread;
+	};
+
+	AampThreadPool();
+	~AampThreadPool();
+
+	/**
+	 * @brief Take the most urgent task available to a worker, stealing if its own queues are empty
+	 */
+	bool GetTask(size_t index, std::function<void()> &task);
+
+	/**
+	 * @brief Main loop of a worker thread
+	 */
+	void WorkerLoop(size_t index);
+
+	/**
+	 * @brief Start a worker thread; caller holds mReserveMutex
+	 */
+	bool AddWorker();
+
+	std::unique_ptr<Worker> mWorkers[AAMP_THREAD_POOL_CAPACITY];	/**< Entries below mWorkerCount are set and never change */
+	std::atomic<size_t> mWorkerCount;
+	size_t mBaseWorkers;				/**< Workers kept for short tasks */
+	mutable std::mutex mReserveMutex;		/**< Protects mReserved and serializes AddWorker */
+	size_t mReserved;
+	std::mutex mWakeMutex;				/**< Protects mStop and increments of mPending, so wakeups are not lost */
+	std::condition_variable mWakeCond;
+	std::atomic<size_t> mPending;		/**< Tasks queued and not yet taken */
+	std::atomic<size_t> mNextWorker;	/**< Round robin position for submissions from outside the pool */
+	std::atomic<size_t> mSteals;
+	bool mStop;
+
+	static std::atomic<bool> sEnabled;
+};
+
+#endif /* __AAMP_THREAD_POOL_H__ */
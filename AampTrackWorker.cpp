@@ -33,7 +33,7 @@ namespace aamp
 	 *
 	 */
 	AampTrackWorker::AampTrackWorker(PrivateInstanceAAMP *_aamp, AampMediaType _mediaType)
-		: aamp(_aamp), mMediaType(_mediaType), mJobAvailable(false), mStop(false), mWorkerThread(), mJob(), mMutex(), mCondVar(), mCompletionVar()
+		: aamp(_aamp), mMediaType(_mediaType), mJobAvailable(false), mStop(false), mUseThreadPool(false), mWorkerThread(), mJob(), mMutex(), mCondVar(), mCompletionVar()
 	{
 		if (_aamp == nullptr)
 		{
@@ -42,6 +42,12 @@ namespace aamp
 			return;
 		}
 
+		if (AampThreadPool::IsEnabled() && AampThreadPool::GetInstance().ReserveWorker())
+		{ // jobs block on downloads, so the pool keeps a worker for each track worker
+			mUseThreadPool = true;
+			return;
+		}
+
 		try
 		{
 			mWorkerThread = std::thread(&AampTrackWorker::ProcessJob, this);
@@ -67,6 +73,14 @@ namespace aamp
 	 */
 	AampTrackWorker::~AampTrackWorker()
 	{
+		if (mUseThreadPool)
+		{ // a queued or running job refers to this worker
+			std::unique_lock<std::mutex> lock(mMutex);
+			mStop = true;
+			mCompletionVar.wait(lock, [this]() { return !mJobAvailable; });
+			AampThreadPool::GetInstance().ReleaseWorker();
+			return;
+		}
 		{
 			std::lock_guard<std::mutex> lock(mMutex);
 			mStop = true;
@@ -97,7 +111,14 @@ namespace aamp
 			mJobAvailable = true;
 		}
 		AAMPLOG_DEBUG("Job submitted for media type %s", GetMediaTypeName(mMediaType));
-		mCondVar.notify_one();
+		if (mUseThreadPool)
+		{
+			AampThreadPool::GetInstance().Submit([this]() { RunPooledJob(); }, eAAMP_TASK_PRIORITY_DOWNLOAD);
+		}
+		else
+		{
+			mCondVar.notify_one();
+		}
 	}
 
 	/**
@@ -168,4 +189,41 @@ namespace aamp
 
 		AAMPLOG_INFO("Exiting Process Job for media type %s", GetMediaTypeName(mMediaType));
 	}
+
+	/**
+	 * @brief Executes the current job on a thread pool worker.
+	 *
+	 * Pool counterpart of one iteration of ProcessJob; signals completion when done.
+	 *
+	 * @return void
+	 */
+	void AampTrackWorker::RunPooledJob()
+	{
+		UsingPlayerId playerId(aamp->mPlayerId);
+		std::function<void()> currentJob;
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			currentJob = mJob;
+		}
+		if (currentJob)
+		{
+			AAMPLOG_DEBUG("Executing pooled Job for media type %s", GetMediaTypeName(mMediaType));
+			try
+			{
+				currentJob();
+			}
+			catch (const std::exception &e)
+			{
+				AAMPLOG_ERR("Exception caught while executing job for media type %s: %s", GetMediaTypeName(mMediaType), e.what());
+			}
+			catch (...)
+			{
+				AAMPLOG_ERR("Unknown exception caught while executing job for media type %s", GetMediaTypeName(mMediaType));
+			}
+		}
+		std::lock_guard<std::mutex> lock(mMutex);
+		AAMPLOG_DEBUG("Job completed for media type %s", GetMediaTypeName(mMediaType));
+		mJobAvailable = false;
+		mCompletionVar.notify_all();
+	}
 } // namespace aamp
@@ -26,7 +26,9 @@
  *
  * This file contains the implementation of the AampTrackWorker class, which is responsible for
  * managing a worker thread that processes jobs submitted to it. The worker thread waits for jobs
- * to be submitted, processes them, and signals their completion.
+ * to be submitted, processes them, and signals their completion. When the shared AampThreadPool
+ * is enabled, jobs run on the pool instead of a dedicated thread, with a pool worker reserved
+ * for the lifetime of the track worker since jobs block on downloads.
  */
 
 #include <thread>
@@ -38,6 +40,7 @@
 #include "AampLogManager.h"
 #include "AampConfig.h"
 #include "priv_aamp.h"
+#include "AampThreadPool.h"
 
 namespace aamp
 {
@@ -70,9 +73,11 @@ namespace aamp
 		PrivateInstanceAAMP *aamp;
 		bool mJobAvailable;
 		bool mStop;
+		bool mUseThreadPool; /**< jobs run on AampThreadPool on a reserved worker, no dedicated thread */
 
 	private:
 		void ProcessJob();
+		void RunPooledJob();
 	};
 
 } // namespace aamp
@@ -24,6 +24,7 @@
 #include "AampTsbDataManager.h"
 #include <mutex>
 #include <chrono>
+#include <algorithm>
 /**
  * Debug class to find time taken by each API; Enable only with debug flag
  */
@@ -52,6 +53,167 @@ public:
 #define TSB_DM_TIME_DATA()
 #endif
 
+#define TSB_FRAGMENT_INDEX_MIN_CAPACITY 64
+
+/**
+ *   @fn Insert
+ *   @brief Add a fragment, replacing any fragment at the same position
+ */
+void TsbFragmentIndex::Insert(AampTime position, TsbFragmentDataPtr fragment)
+{
+	if (mCount && position <= (*this)[mCount - 1].position)
+	{
+		size_t index = LowerBound(position);
+		if ((*this)[index].position == position)
+		{
+			(*this)[index].fragment = std::move(fragment);
+			return;
+		}
+		if (mCount == mEntries.size())
+		{
+			Grow();
+		}
+		// Out of order insertion; shift newer entries up by one
+		for (size_t i = mCount; i > index; i--)
+		{
+			(*this)[i] = std::move((*this)[i - 1]);
+		}
+		(*this)[index] = Entry{position, std::move(fragment)};
+		mCount++;
+	}
+	else
+	{
+		if (mCount == mEntries.size())
+		{
+			Grow();
+		}
+		(*this)[mCount] = Entry{position, std::move(fragment)};
+		mCount++;
+	}
+}
+
+/**
+ *   @fn PopFront
+ *   @brief Remove the oldest fragment
+ */
+void TsbFragmentIndex::PopFront()
+{
+	if (mCount)
+	{
+		(*this)[0].fragment = nullptr;
+		mHead = (mHead + 1) & (mEntries.size() - 1);
+		mCount--;
+	}
+}
+
+/**
+ *   @fn LowerBound
+ *   @return index of the first fragment at or after position, Size() if none
+ */
+size_t TsbFragmentIndex::LowerBound(AampTime position) const
+{
+	if (mCount == 0 || position <= (*this)[0].position)
+	{
+		return 0;
+	}
+	if (position > (*this)[mCount - 1].position)
+	{
+		return mCount;
+	}
+	// Here front < position <= back, so the result is in [1, mCount - 1].
+	// Guess the index assuming evenly spaced fragments, then gallop from the guess
+	// to bracket the result in [low, high) and binary search within the bracket
+	double first = (*this)[0].position.inSeconds();
+	double span = (*this)[mCount - 1].position.inSeconds() - first;
+	size_t guess = 1;
+	if (span > 0)
+	{
+		guess = (size_t)(((position.inSeconds() - first) / span) * (double)(mCount - 1));
+		guess = std::min(std::max(guess, (size_t)1), mCount - 1);
+	}
+	size_t low;
+	size_t high;
+	size_t step = 1;
+	if ((*this)[guess].position < position)
+	{
+		low = guess + 1;
+		high = low;
+		while (high < mCount && (*this)[high].position < position)
+		{
+			low = high + 1;
+			high = std::min(high + step, mCount);
+			step <<= 1;
+		}
+	}
+	else
+	{
+		high = guess;
+		low = guess;
+		while (low > 0 && !((*this)[low - 1].position < position))
+		{
+			high = low - 1;
+			low = (high > step) ? (high - step) : 0;
+			step <<= 1;
+		}
+	}
+	while (low < high)
+	{
+		size_t mid = low + (high - low) / 2;
+		if ((*this)[mid].position < position)
+		{
+			low = mid + 1;
+		}
+		else
+		{
+			high = mid;
+		}
+	}
+	return low;
+}
+
+/**
+ *   @fn Find
+ *   @return index of the fragment at exactly position, Size() if none
+ */
+size_t TsbFragmentIndex::Find(AampTime position) const
+{
+	size_t index = LowerBound(position);
+	if (index < mCount && (*this)[index].position != position)
+	{
+		index = mCount;
+	}
+	return index;
+}
+
+/**
+ *   @fn Clear
+ *   @brief Remove all fragments, keeping the allocated capacity
+ */
+void TsbFragmentIndex::Clear()
+{
+	for (size_t i = 0; i < mCount; i++)
+	{
+		(*this)[i].fragment = nullptr;
+	}
+	mHead = 0;
+	mCount = 0;
+}
+
+/**
+ *   @fn Grow
+ *   @brief Double the capacity, unwrapping the ring so the oldest entry is at index 0
+ */
+void TsbFragmentIndex::Grow()
+{
+	std::vector<Entry> entries(mEntries.empty() ? TSB_FRAGMENT_INDEX_MIN_CAPACITY : mEntries.size() * 2);
+	for (size_t i = 0; i < mCount; i++)
+	{
+		entries[i] = std::move((*this)[i]);
+	}
+	mEntries.swap(entries);
+	mHead = 0;
+}
+
 /**
  *   @fn GetNearestFragment
  *   @brief Get the nearest fragment for the position
@@ -65,33 +227,35 @@ TsbFragmentDataPtr AampTsbDataManager::GetNearestFragment(double position)
 	try
 	{
 		std::lock_guard<std::mutex> lock(mTsbDataMutex);
-		if(!mTsbFragmentData.empty())
+		if(!mTsbFragmentData.Empty())
 		{
 			do
 			{
-				auto lower = mTsbFragmentData.lower_bound(position); // Find the first element not less than position
-				if (lower == mTsbFragmentData.begin())				 // If target is less than the first key
+				AampTime target(position);
+				size_t lower = mTsbFragmentData.LowerBound(target); // Find the first element not less than position
+				if (lower == 0)										// If target is less than the first key
 				{
-					fragmentData = lower->second;
+					fragmentData = mTsbFragmentData[lower].fragment;
 					break;
 				}
 
-				auto prev = std::prev(lower);		 // Get the previous element
-				if (lower == mTsbFragmentData.end()) // If position is greater than the last key
+				const TsbFragmentIndex::Entry &prev = mTsbFragmentData[lower - 1]; // Get the previous element
+				if (lower == mTsbFragmentData.Size())								// If position is greater than the last key
 				{
-					fragmentData = prev->second;
+					fragmentData = prev.fragment;
 					break;
 				}
 
 				// Determine which key is closer to the position
-				if (lower->first - position < position - prev->first)
+				const TsbFragmentIndex::Entry &next = mTsbFragmentData[lower];
+				if (next.position - target < target - prev.position)
 				{
-					fragmentData = lower->second;
+					fragmentData = next.fragment;
 					break;
 				}
 				else
 				{
-					fragmentData = prev->second;
+					fragmentData = prev.fragment;
 					break;
 				}
 			} while (0);
@@ -115,10 +279,9 @@ TsbFragmentDataPtr AampTsbDataManager::RemoveFragment(bool &deleteInit)
 	try
 	{
 		std::lock_guard<std::mutex> lock(mTsbDataMutex);
-		if (!mTsbFragmentData.empty())
+		if (!mTsbFragmentData.Empty())
 		{
-			auto it = mTsbFragmentData.begin();
-			deletedFragment = it->second;
+			deletedFragment = mTsbFragmentData[0].fragment;
 			TsbInitDataPtr initData = deletedFragment->GetInitFragData();
 			initData->decrementUser();
 			if (initData->GetUsers() <= 0)
@@ -132,7 +295,7 @@ TsbFragmentDataPtr AampTsbDataManager::RemoveFragment(bool &deleteInit)
 				deletedFragment->next->prev = nullptr;
 			}
 			AAMPLOG_INFO("Remove fragment");
-			mTsbFragmentData.erase(it);
+			mTsbFragmentData.PopFront();
 		}
 	}
 	catch (const std::exception &e)
@@ -156,27 +319,27 @@ std::list<TsbFragmentDataPtr> AampTsbDataManager::RemoveFragments(double positio
 	try
 	{
 		std::lock_guard<std::mutex> lock(mTsbDataMutex);
-		if (!mTsbFragmentData.empty())
+		if (!mTsbFragmentData.Empty())
 		{
 			AAMPLOG_INFO("Remove fragments");
-			auto it = mTsbFragmentData.begin();
-			while (it != mTsbFragmentData.end())
+			AampTime limit(position);
+			while (!mTsbFragmentData.Empty())
 			{
-				if (it->first < position)
+				if (mTsbFragmentData[0].position < limit)
 				{
-					TsbInitDataPtr initData = it->second->GetInitFragData();
+					TsbInitDataPtr initData = mTsbFragmentData[0].fragment->GetInitFragData();
 					initData->decrementUser();
 					if (initData->GetUsers() <= 0)
 					{
 						AAMPLOG_INFO("Removing Init fragment of BW( %" BITSPERSECOND_FORMAT ") since no more cached fragment using it", initData->GetBandWidth());
 						mTsbInitData.remove(initData);
 					}
-					deletedFragments.push_back(it->second);
-					it = mTsbFragmentData.erase(it);
+					deletedFragments.push_back(mTsbFragmentData[0].fragment);
+					mTsbFragmentData.PopFront();
 				}
 				else
 				{
-					/** Sorted Map; so can break here*/
+					/** Sorted index; so can break here*/
 					break;
 				}
 			}
@@ -203,11 +366,10 @@ bool AampTsbDataManager::IsFragmentPresent(double position)
 	try
 	{
 		std::lock_guard<std::mutex> lock(mTsbDataMutex);
-		if (!mTsbFragmentData.empty())
+		if (!mTsbFragmentData.Empty())
 		{
-			auto fst = mTsbFragmentData.begin();
-			auto lst = --mTsbFragmentData.end();
-			if ((fst->first <= position) && (lst->first >= position))
+			AampTime target(position);
+			if ((mTsbFragmentData[0].position <= target) && (mTsbFragmentData[mTsbFragmentData.Size() - 1].position >= target))
 			{
 				present = true;
 			}
@@ -233,17 +395,17 @@ TsbFragmentDataPtr AampTsbDataManager::GetFragment(double position, bool &eos)
 	eos = false;
 	TsbFragmentDataPtr fragment = nullptr;
 	std::lock_guard<std::mutex> lock(mTsbDataMutex);
-	if (!mTsbFragmentData.empty())
+	if (!mTsbFragmentData.Empty())
 	{
-		auto segment = mTsbFragmentData.find(position);
-		if (segment != mTsbFragmentData.end())
+		size_t segment = mTsbFragmentData.Find(AampTime(position));
+		if (segment != mTsbFragmentData.Size())
 		{ /** Check whether it is last fragment or not */
-			if (segment == (std::prev(mTsbFragmentData.end())))
+			if (segment == mTsbFragmentData.Size() - 1)
 			{
 				/** Mark EOS*/
 				eos = true;
 			}
-			fragment = segment->second;
+			fragment = mTsbFragmentData[segment].fragment;
 		}
 	}
 	return fragment;
@@ -258,9 +420,9 @@ double AampTsbDataManager::GetFirstFragmentPosition()
 	TSB_DM_TIME_DATA();
 	double pos = 0.0;
 	std::lock_guard<std::mutex> lock(mTsbDataMutex);
-	if (!mTsbFragmentData.empty())
+	if (!mTsbFragmentData.Empty())
 	{
-		pos = mTsbFragmentData.begin()->second->GetAbsolutePosition().inSeconds();
+		pos = mTsbFragmentData[0].fragment->GetAbsolutePosition().inSeconds();
 	}
 	return pos;
 }
@@ -274,9 +436,9 @@ TsbFragmentDataPtr AampTsbDataManager::GetFirstFragment()
 	TSB_DM_TIME_DATA();
 	TsbFragmentDataPtr ret = nullptr;
 	std::lock_guard<std::mutex> lock(mTsbDataMutex);
-	if (!mTsbFragmentData.empty())
+	if (!mTsbFragmentData.Empty())
 	{
-		ret = mTsbFragmentData.begin()->second;
+		ret = mTsbFragmentData[0].fragment;
 	}
 	return ret;
 }
@@ -290,9 +452,9 @@ TsbFragmentDataPtr AampTsbDataManager::GetLastFragment()
 	TSB_DM_TIME_DATA();
 	TsbFragmentDataPtr ret = nullptr;
 	std::lock_guard<std::mutex> lock(mTsbDataMutex);
-	if (!mTsbFragmentData.empty())
+	if (!mTsbFragmentData.Empty())
 	{
-		ret = (std::prev(mTsbFragmentData.end()))->second;
+		ret = mTsbFragmentData[mTsbFragmentData.Size() - 1].fragment;
 	}
 	return ret;
 }
@@ -306,9 +468,9 @@ double AampTsbDataManager::GetLastFragmentPosition()
 	TSB_DM_TIME_DATA();
 	double pos = 0.0;
 	std::lock_guard<std::mutex> lock(mTsbDataMutex);
-	if (!mTsbFragmentData.empty())
+	if (!mTsbFragmentData.Empty())
 	{
-		pos = (std::prev(mTsbFragmentData.end()))->second->GetAbsolutePosition().inSeconds();
+		pos = mTsbFragmentData[mTsbFragmentData.Size() - 1].fragment->GetAbsolutePosition().inSeconds();
 	}
 	return pos;
 }
@@ -373,7 +535,7 @@ bool AampTsbDataManager::AddFragment(TSBWriteData &writeData, AampMediaType medi
 			mCurrHead->next = fragmentData;
 		}
 		mCurrHead = std::move(fragmentData);
-		mTsbFragmentData[position] = mCurrHead;
+		mTsbFragmentData.Insert(AampTime(position), mCurrHead);
 		ret = true;
 	}
 	catch (const std::exception &e)
@@ -394,12 +556,11 @@ bool AampTsbDataManager::DumpData()
 	try
 	{
 		std::lock_guard<std::mutex> lock(mTsbDataMutex);
-		if (!mTsbFragmentData.empty())
+		if (!mTsbFragmentData.Empty())
 		{
-			auto it = mTsbFragmentData.begin();
-			while (it != mTsbFragmentData.end())
+			for (size_t i = 0; i < mTsbFragmentData.Size(); i++)
 			{
-				TsbFragmentDataPtr fragmentData = it->second;
+				TsbFragmentDataPtr fragmentData = mTsbFragmentData[i].fragment;
 				TsbInitDataPtr initdata = fragmentData->GetInitFragData();
 				AAMPLOG_INFO("Fragment Meta Data: { Media [%d] absPosition : %.02lf duration: %.02lf PTS : %.02lf bandwidth: %" BITSPERSECOND_FORMAT " discontinuous: %d fragmentUrl: '%s' initHeaderUrl: '%s' }",
 							 fragmentData->GetMediaType(), fragmentData->GetAbsolutePosition().inSeconds(), fragmentData->GetDuration().inSeconds(), fragmentData->GetPTS().inSeconds(),
@@ -426,9 +587,9 @@ void AampTsbDataManager::Flush()
 	try
 	{
 		std::lock_guard<std::mutex> lock(mTsbDataMutex);
-		if (!mTsbFragmentData.empty())
+		if (!mTsbFragmentData.Empty())
 		{
-			mTsbFragmentData.clear();
+			mTsbFragmentData.Clear();
 		}
 		if (!mTsbInitData.empty())
 		{
@@ -455,14 +616,14 @@ TsbFragmentDataPtr AampTsbDataManager::GetNextDiscFragment(double position, bool
 	try
 	{
 		std::lock_guard<std::mutex> lock(mTsbDataMutex);
-		auto segment = mTsbFragmentData.lower_bound(position);
+		size_t segment = mTsbFragmentData.LowerBound(AampTime(position));
 		if (!backwardSearch)
 		{
-			while( segment != mTsbFragmentData.end())
+			while( segment < mTsbFragmentData.Size())
 			{
-				if (segment->second->IsDiscontinuous())
+				if (mTsbFragmentData[segment].fragment->IsDiscontinuous())
 				{
-					fragment =  segment->second;
+					fragment =  mTsbFragmentData[segment].fragment;
 					break;
 				}
 				++segment;
@@ -470,11 +631,16 @@ TsbFragmentDataPtr AampTsbDataManager::GetNextDiscFragment(double position, bool
 		}
 		else
 		{
-			while (segment != mTsbFragmentData.begin())
+			if (segment == mTsbFragmentData.Size() && segment > 0)
+			{
+				/** Position is after the last fragment; start from the last one */
+				--segment;
+			}
+			while (segment != 0)
 			{
-				if (segment->second->IsDiscontinuous())
+				if (mTsbFragmentData[segment].fragment->IsDiscontinuous())
 				{
-					fragment =  segment->second;
+					fragment =  mTsbFragmentData[segment].fragment;
 					break;
 				}
 				--segment;
@@ -29,6 +29,7 @@
 #include <cmath>
 #include <memory>
 #include <map>
+#include <vector>
 #include <exception>
 #include <mutex>
 #include <utility>
@@ -254,25 +255,99 @@ typedef std::shared_ptr<TsbFragmentData> TsbFragmentDataPtr;
 typedef std::shared_ptr<TsbInitData> TsbInitDataPtr;
 
 /**
- * @class AampTsbDataManager
- * @brief Handle the TSB meta Data informations;
+ * @class TsbFragmentIndex
+ * @brief Time ordered index of TSB fragments, held in a contiguous ring buffer
+ *
+ * Fragments are appended at the live edge and culled from the oldest end, both in O(1)
+ * (amortized, for append). Positions are stored as fixed point AampTime keys next to the
+ * fragment pointers, so a lookup is an interpolated guess refined by an exponential search
+ * over contiguous memory, without touching the fragments themselves. With regular fragment
+ * durations the guess is usually exact, whatever the depth of the TSB.
  */
-class AampTsbDataManager
+class TsbFragmentIndex
 {
+public:
+	struct Entry
+	{
+		AampTime position;				/**< Absolute position of the fragment, in seconds since 1970 */
+		TsbFragmentDataPtr fragment;
+	};
+
+	TsbFragmentIndex() : mEntries(), mHead(0), mCount(0)
+	{
+	}
+
+	/**
+	 *   @fn Size
+	 *   @return number of fragments in the index
+	 */
+	size_t Size() const { return mCount; }
+
+	/**
+	 *   @fn Empty
+	 *   @return true if there are no fragments in the index
+	 */
+	bool Empty() const { return (mCount == 0); }
+
+	/**
+	 *   @brief Access an entry by its order in time
+	 *   @param[in] index - 0 for the oldest fragment, Size() - 1 for the newest
+	 */
+	Entry& operator[](size_t index) { return mEntries[(mHead + index) & (mEntries.size() - 1)]; }
+	const Entry& operator[](size_t index) const { return mEntries[(mHead + index) & (mEntries.size() - 1)]; }
+
+	/**
+	 *   @fn Insert
+	 *   @brief Add a fragment, replacing any fragment at the same position. Appending after
+	 *          the newest fragment is O(1), any other position shifts the newer entries.
+	 */
+	void Insert(AampTime position, TsbFragmentDataPtr fragment);
+
+	/**
+	 *   @fn PopFront
+	 *   @brief Remove the oldest fragment
+	 */
+	void PopFront();
+
+	/**
+	 *   @fn LowerBound
+	 *   @return index of the first fragment at or after position, Size() if none
+	 */
+	size_t LowerBound(AampTime position) const;
+
+	/**
+	 *   @fn Find
+	 *   @return index of the fragment at exactly position, Size() if none
+	 */
+	size_t Find(AampTime position) const;
+
+	/**
+	 *   @fn Clear
+	 *   @brief Remove all fragments, keeping the allocated capacity
+	 */
+	void Clear();
+
 private:
 	/**
-	 *  @brief Internal API to compare data in the sorted Map
+	 *   @fn Grow
+	 *   @brief Double the capacity, unwrapping the ring so the oldest entry is at index 0
 	 */
-	struct PositionComparator
-	{
-		bool operator()(const double &a, const double &b) const
-		{
-			return a < b;
-		}
-	};
+	void Grow();
+
+	std::vector<Entry> mEntries;	/**< Ring storage, capacity is 0 or a power of two */
+	size_t mHead;					/**< Storage index of the oldest entry */
+	size_t mCount;					/**< Number of entries in use */
+};
 
+/**
+ * @class AampTsbDataManager
+ * @brief Handle the TSB meta Data informations;
+ */
+class AampTsbDataManager
+{
+private:
 	std::mutex mTsbDataMutex;
-	std::map<double, std::shared_ptr<TsbFragmentData>, PositionComparator> mTsbFragmentData;
+	TsbFragmentIndex mTsbFragmentData;
 	std::list<std::shared_ptr<TsbInitData>> mTsbInitData;
 	std::shared_ptr<TsbInitData> mCurrentInitData;
 	std::shared_ptr<TsbFragmentData> mCurrHead;
@@ -274,6 +274,22 @@ bool aamp_StartsWith( const char *inputStr, const char *prefix )
 	return rc;
 }
 
+/**
+ * @brief Get the size of a closed HTTP byte range
+ *
+ * @retval number of bytes covered by the range, 0 if unknown
+ */
+size_t aamp_GetByteRangeLength( const char *range )
+{
+	size_t length = 0;
+	size_t rangeStart = 0, rangeEnd = 0;
+	if( range && 2 == sscanf(range, "%zu-%zu", &rangeStart, &rangeEnd) && rangeEnd >= rangeStart )
+	{
+		length = rangeEnd - rangeStart + 1;
+	}
+	return length;
+}
+
 /**
  * @brief convert blob of binary data to ascii base64-URL-encoded equivalent
  * @retval pointer to malloc'd cstring containing base64 URL encoded version of string
@@ -145,6 +145,14 @@ void aamp_ResolveURL(std::string& dst, std::string base, const char *uri , bool
  */
 bool aamp_StartsWith( const char *inputStr, const char *prefix);
 
+/**
+ * @fn aamp_GetByteRangeLength
+ *
+ * @param[in] range - HTTP byte range in "start-end" form, may be NULL
+ * @retval number of bytes covered by the range, 0 if the range is missing, open ended or invalid
+ */
+size_t aamp_GetByteRangeLength( const char *range );
+
 /**
  * @fn aamp_Base64_URL_Encode
  * @param src pointer to first byte of binary data to be encoded
@@ -141,8 +141,9 @@ bool MediaStreamContext::CacheFragment(std::string fragmentUrl, unsigned int cur
 			}
 			if (ret)
 			{
-				cachedFragment->fragment = *mTempFragment;
-				mTempFragment->Free();
+				// take over the downloaded data instead of copying it; the init fragment cache keeps its own copy
+				cachedFragment->fragment.Free();
+				cachedFragment->fragment.Replace(mTempFragment.get());
 			}
 		}
 
@@ -395,7 +396,7 @@ bool MediaStreamContext::CacheFragment(std::string fragmentUrl, unsigned int cur
 				// If reader is at EOS, inject the last data in AAMP TSB
 				if (aamp->GetLLDashChunkMode())
 				{
-					CacheTsbFragment(fragmentToTsbSessionMgr);
+					CacheTsbFragment(fragmentToTsbSessionMgr, false);
 				}
 				SetLocalTSBInjection(false);
 				// If all of the active media contexts are no longer injecting from TSB, update the AAMP flag
@@ -406,7 +407,7 @@ bool MediaStreamContext::CacheFragment(std::string fragmentUrl, unsigned int cur
 				// In chunk mode, media segments are added to the chunk cache in the SSL callback, but init segments are added here
 				if (aamp->GetLLDashChunkMode())
 				{
-					CacheTsbFragment(fragmentToTsbSessionMgr);
+					CacheTsbFragment(fragmentToTsbSessionMgr, false);
 				}
 			}
 			tsbSessionManager->EnqueueWrite(fragmentUrl, fragmentToTsbSessionMgr, context->GetPeriod()->GetId());
@@ -426,7 +427,7 @@ bool MediaStreamContext::CacheFragment(std::string fragmentUrl, unsigned int cur
 				GetContext()->UpdateStreamInfoBitrateData(fragmentToTsbSessionMgr->profileIndex, fragmentToTsbSessionMgr->cacheFragStreamInfo);
 			}
 			fragmentToTsbSessionMgr->cacheFragStreamInfo.bandwidthBitsPerSecond = fragmentDescriptor.Bandwidth;
-			CacheTsbFragment(fragmentToTsbSessionMgr);
+			CacheTsbFragment(std::move(fragmentToTsbSessionMgr), true);
 		}
 
 		// If playing back from local TSB, or pending playing back from local TSB as paused, but not paused due to underflow
@@ -446,9 +447,11 @@ bool MediaStreamContext::CacheFragment(std::string fragmentUrl, unsigned int cur
 			// When playing live SLD content, the fragment is written to the regular cache and to the chunk cache
 			if(tsbSessionManager && !IsLocalTSBInjection() && !aamp->GetLLDashChunkMode())
 			{
+				// Injection is from the chunk cache, so the fetched data is only freed by UpdateTSAfterInject below;
+				// hand it over instead of copying it
 				std::shared_ptr<CachedFragment> fragmentToCache = std::make_shared<CachedFragment>();
-				fragmentToCache->Copy(cachedFragment, cachedFragment->fragment.GetLen());
-				CacheTsbFragment(fragmentToCache);
+				fragmentToCache->Move(cachedFragment);
+				CacheTsbFragment(std::move(fragmentToCache), true);
 			}
 
 			// If injection is from chunk buffer, remove the fragment for injection
@@ -726,9 +729,10 @@ int MediaStreamContext::GetDefaultDurationBetweenPlaylistUpdates()
 /**
  * @fn CacheTsbFragment
  * @param fragment TSB fragment pointer
+ * @param takeOwnership true if the caller hands over the fragment data, false if it is still shared
  * @retval true on success
  */
-bool MediaStreamContext::CacheTsbFragment(std::shared_ptr<CachedFragment> fragment)
+bool MediaStreamContext::CacheTsbFragment(std::shared_ptr<CachedFragment> fragment, bool takeOwnership)
 {
 	// FN_TRACE_F_MPD( __FUNCTION__ );
 	std::lock_guard<std::mutex> lock(fetchChunkBufferMutex);
@@ -737,13 +741,27 @@ bool MediaStreamContext::CacheTsbFragment(std::shared_ptr<CachedFragment> fragme
 	{
 		AAMPLOG_TRACE("Type[%s] fragmentTime %f discontinuity %d duration %f initFragment:%d", name, fragment->position, fragment->discontinuity, fragment->duration, fragment->initFragment);
 		CachedFragment* cachedFragment = GetFetchChunkBuffer(true);
+		if(!cachedFragment)
+		{
+			AAMPLOG_WARN("[%s] No fetch chunk buffer available", name);
+			return ret;
+		}
 		if(cachedFragment->fragment.GetPtr())
 		{
 			// If following log is coming, possible memory leak. Need to clear the data first before slot reuse.
 			AAMPLOG_WARN("Fetch buffer has junk data, Need to free this up");
 		}
-		cachedFragment->fragment.Clear();
-		cachedFragment->Copy(fragment.get(), fragment->fragment.GetLen());
+		if(takeOwnership)
+		{
+			// Caller handed over the fragment (TSB reader, live cache), take the data without copying
+			cachedFragment->Move(fragment.get());
+		}
+		else
+		{
+			// Fragment is still used by the caller (e.g. queued for TSB write), copy into the reused slot
+			cachedFragment->fragment.Clear();
+			cachedFragment->Copy(fragment.get(), fragment->fragment.GetLen());
+		}
 		if(cachedFragment->fragment.GetPtr() && cachedFragment->fragment.GetLen() > 0)
 		{
 			ret = true;
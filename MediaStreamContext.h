@@ -45,7 +45,7 @@ public:
     MediaStreamContext(TrackType type, StreamAbstractionAAMP_MPD* ctx, PrivateInstanceAAMP* aamp, const char* name) :
             MediaTrack(type, aamp, name),
             mediaType((AampMediaType)type), adaptationSet(NULL), representation(NULL),
-            fragmentIndex(0), timeLineIndex(0), fragmentRepeatCount(0), fragmentOffset(0),
+            fragmentIndex(0), timeLineIndex(0), fragmentRepeatCount(0), segmentTimelineIndex(), fragmentOffset(0),
             eos(false), fragmentTime(0), periodStartOffset(0), timeStampOffset(0), IDX("fragment-IDX"),
 	        lastSegmentTime(0), lastSegmentNumber(0), lastSegmentDuration(0), adaptationSetIdx(0), representationIndex(0), profileChanged(true),
             adaptationSetId(0), fragmentDescriptor(), context(ctx), initialization(""),
@@ -119,9 +119,11 @@ public:
     /**
      * @fn CacheTsbFragment
      * @param[in] fragment TSB fragment pointer
+     * @param[in] takeOwnership true to move the fragment data into the chunk cache, false to copy it
+     *            because the caller still uses the fragment
      * @retval true on success
      */
-    bool CacheTsbFragment(std::shared_ptr<CachedFragment> fragment);
+    bool CacheTsbFragment(std::shared_ptr<CachedFragment> fragment, bool takeOwnership);
 
     /**
      * @fn CacheFragmentChunk
@@ -251,6 +253,7 @@ public:
     int fragmentIndex;
     int timeLineIndex;
     int fragmentRepeatCount;
+    SegmentTimelineIndex segmentTimelineIndex; // packed index of the SegmentTimeline of the current representation
     uint64_t fragmentOffset;
     bool eos;
     bool profileChanged;
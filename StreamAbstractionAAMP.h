@@ -163,6 +163,17 @@ public:
 		this->absPosition =  other->absPosition;
 		this->isDummy = other->isDummy;
 	}
+	/**
+	 * @brief Take over the contents of another cached fragment
+	 *        Fragment data is handed over without copying; other's fragment buffer is left empty
+	 * @param[in] other - cached fragment to take over; must not be referenced elsewhere
+	 */
+	void Move(CachedFragment* other)
+	{
+		this->fragment.Free();
+		Copy(other, 0);
+		this->fragment.Replace(&other->fragment);
+	}
 	void Clear()
 	{
 		fragment.Free();
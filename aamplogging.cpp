@@ -26,6 +26,12 @@
 #include <algorithm>
 #include <thread>
 #include <sstream>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
+#include <inttypes.h>
+#include <strings.h>
 #include "priv_aamp.h"
 using namespace std;
 
@@ -76,14 +82,592 @@ bool AampLogManager::disableLogRedirection = false;
 bool AampLogManager::enableEthanLogRedirection = false;
 AAMP_LogLevel AampLogManager::aampLoglevel = eLOGLEVEL_WARN;
 bool AampLogManager::locked = false;
+std::atomic<bool> AampLogManager::asyncLogging(false);
+std::atomic<uint32_t> AampLogManager::moduleLogLevelGeneration(0);
+
+static std::mutex gModuleLogLevelMutex;
+static std::vector<std::pair<std::string, AAMP_LogLevel>> gModuleLogLevels;	/**< protected by gModuleLogLevelMutex */
+static std::string gModuleLogLevelsString;	/**< last setModuleLogLevels argument, protected by gModuleLogLevelMutex */
+static uint32_t gModuleLogLevelSerial = 0;	/**< last non-zero generation published, never reset so call site caches cannot match stale levels; protected by gModuleLogLevelMutex */
 
 thread_local int gPlayerId = -1;
 
+#define AAMP_LOG_FORMAT_STACK_BYTES 256			/**< prefixed format strings up to this size are built without alloca */
+#define AAMP_ASYNC_LOG_RING_BYTES (64*1024)		/**< per thread queue size for asynchronous logging */
+#define AAMP_ASYNC_LOG_MAX_MESSAGE 4096			/**< longer messages are truncated; sd_journal truncates at 2040 anyway */
+#define AAMP_ASYNC_LOG_IDLE_MS 10				/**< poll interval of the asynchronous log writer */
+
+/**
+ * @brief Write to the configured log sink
+ * @param[in] logLevelIndex - log level
+ * @param[in] format_ptr - complete format string, with trailing newline
+ * @param[in] format_bytes - length of format_ptr, excluding nul terminator
+ * @param[in] args - arguments of format_ptr
+ */
+static void WriteLog(AAMP_LogLevel logLevelIndex, char *format_ptr, int format_bytes, va_list args)
+{
+	if( AampLogManager::disableLogRedirection )
+	{ // aampcli
+		vprintf( format_ptr, args );
+	}
+	else if ( AampLogManager::enableEthanLogRedirection )
+	{ // remap AAMP log levels to Ethan log levels
+		int ethanLogLevel;
+		// Important: in production builds, Ethan logger filters out everything
+		// except ETHAN_LOG_MILESTONE and ETHAN_LOG_FATAL
+		switch (logLevelIndex)
+		{
+			case eLOGLEVEL_TRACE:
+			case eLOGLEVEL_DEBUG:
+				ethanLogLevel = ETHAN_LOG_DEBUG;
+				break;
+
+			case eLOGLEVEL_ERROR:
+				ethanLogLevel = ETHAN_LOG_FATAL;
+				break;
+
+			case eLOGLEVEL_INFO: // note: we rely on eLOGLEVEL_INFO at tune time for triage
+			case eLOGLEVEL_WARN:
+			case eLOGLEVEL_MIL:
+			default:
+				ethanLogLevel = ETHAN_LOG_MILESTONE;
+				break;
+		}
+		vethanlog(ethanLogLevel,NULL,NULL,-1,format_ptr, args);
+	}
+	else
+	{
+		format_ptr[format_bytes-1] = 0x00; // strip not-needed newline (good for Ethan Logger, too?)
+		sd_journal_printv(LOG_NOTICE,format_ptr,args); // note: truncates to 2040 characters
+	}
+}
+
+/**
+ * @brief Variadic wrapper of WriteLog
+ */
+static void WriteLogf(AAMP_LogLevel logLevelIndex, char *format_ptr, int format_bytes, ...)
+{
+	va_list args;
+	va_start(args, format_bytes);
+	WriteLog(logLevelIndex, format_ptr, format_bytes, args);
+	va_end(args);
+}
+
+/**
+ * @brief Write a line that is already formatted to the configured log sink
+ */
+static void WriteLogLine(AAMP_LogLevel logLevelIndex, const char *line)
+{
+	char format[] = "%s\n";
+	WriteLogf(logLevelIndex, format, (int)strlen(format), line);
+}
+
+namespace
+{
+/**
+ * @struct AsyncLogRecord
+ * @brief Message queued for the asynchronous log writer, followed by the nul terminated message text and file name
+ */
+struct AsyncLogRecord
+{
+	uint32_t size;				/**< record size, including header and padding; 0 marks unused space up to the end of the ring */
+	uint32_t fileOffset;		/**< offset of the nul terminated file (function) name from the message text */
+	int line;					/**< source line */
+	AAMP_LogLevel level;		/**< log level */
+	int playerId;				/**< gPlayerId of the logging thread */
+	size_t threadId;			/**< printable thread id of the logging thread */
+	struct timeval time;		/**< time the message was logged */
+
+	const char *GetMessage() const
+	{
+		return reinterpret_cast<const char *>(this + 1);
+	}
+
+	const char *GetFile() const
+	{
+		return GetMessage() + fileOffset;
+	}
+};
+
+/**
+ * @class AsyncLogRing
+ * @brief Lock-free single producer (the logging thread), single consumer (the writer thread) queue of AsyncLogRecord
+ */
+class AsyncLogRing
+{
+public:
+	AsyncLogRing() : mHead(0), mTail(0), mDropped(0), mOrphaned(false)
+	{
+	}
+
+	/**
+	 * @brief Queue a message; called by the owning thread only
+	 * @param[out] wake - set if the ring just became half full and the writer should not wait for its next poll
+	 * @return false if the ring is full and the message was dropped
+	 */
+	bool Push(const AsyncLogRecord &header, const char *message, size_t len, const char *file, bool &wake)
+	{
+		size_t fileLen = strlen(file);
+		size_t size = (sizeof(AsyncLogRecord) + len + 1 + fileLen + 1 + 7) & ~(size_t)7;
+		uint64_t head = mHead.load(std::memory_order_relaxed);
+		uint64_t tail = mTail.load(std::memory_order_acquire);
+		size_t offset = head % AAMP_ASYNC_LOG_RING_BYTES;
+		size_t contiguous = AAMP_ASYNC_LOG_RING_BYTES - offset;
+		size_t needed = (size > contiguous) ? (contiguous + size) : size;
+		if( head + needed - tail > AAMP_ASYNC_LOG_RING_BYTES )
+		{
+			mDropped.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+		if( size > contiguous )
+		{ // records are never split; mark the rest of the ring unused and start over
+			if( contiguous >= sizeof(AsyncLogRecord) )
+			{
+				reinterpret_cast<AsyncLogRecord *>(&mBuffer[offset])->size = 0;
+			}
+			head += contiguous;
+			offset = 0;
+		}
+		AsyncLogRecord *record = reinterpret_cast<AsyncLogRecord *>(&mBuffer[offset]);
+		*record = header;
+		record->size = (uint32_t)size;
+		record->fileOffset = (uint32_t)(len + 1);
+		char *text = reinterpret_cast<char *>(record + 1);
+		memcpy(text, message, len);
+		text[len] = 0x00;
+		memcpy(text + len + 1, file, fileLen + 1);
+		mHead.store(head + size, std::memory_order_release);
+		wake = (head - tail < AAMP_ASYNC_LOG_RING_BYTES/2 && head + size - tail >= AAMP_ASYNC_LOG_RING_BYTES/2);
+		return true;
+	}
+
+	/**
+	 * @brief Get the oldest queued message; called by the writer thread only
+	 * @return record, NULL if empty
+	 */
+	const AsyncLogRecord *Front()
+	{
+		uint64_t tail = mTail.load(std::memory_order_relaxed);
+		uint64_t head = mHead.load(std::memory_order_acquire);
+		while( tail != head )
+		{
+			size_t offset = tail % AAMP_ASYNC_LOG_RING_BYTES;
+			size_t contiguous = AAMP_ASYNC_LOG_RING_BYTES - offset;
+			if( contiguous >= sizeof(AsyncLogRecord) )
+			{
+				const AsyncLogRecord *record = reinterpret_cast<const AsyncLogRecord *>(&mBuffer[offset]);
+				if( record->size )
+				{
+					return record;
+				}
+			}
+			tail += contiguous;
+			mTail.store(tail, std::memory_order_release);
+		}
+		return NULL;
+	}
+
+	/**
+	 * @brief Release the record returned by Front; called by the writer thread only
+	 */
+	void Pop(const AsyncLogRecord *record)
+	{
+		mTail.store(mTail.load(std::memory_order_relaxed) + record->size, std::memory_order_release);
+	}
+
+	std::atomic<uint64_t> mHead;		/**< bytes ever queued */
+	std::atomic<uint64_t> mTail;		/**< bytes ever released */
+	std::atomic<uint64_t> mDropped;		/**< messages dropped because the ring was full */
+	std::atomic<bool> mOrphaned;		/**< set when the owning thread exits */
+	alignas(8) char mBuffer[AAMP_ASYNC_LOG_RING_BYTES];
+};
+
+/**
+ * @class AsyncLogWriter
+ * @brief Background thread that formats and writes the messages queued by all threads, oldest first
+ */
+class AsyncLogWriter
+{
+public:
+	static AsyncLogWriter &GetInstance()
+	{
+		static AsyncLogWriter instance;
+		return instance;
+	}
+
+	/**
+	 * @brief Start the writer thread, if not running
+	 */
+	void Start()
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		if( !mThread.joinable() )
+		{
+			mThread = std::thread(&AsyncLogWriter::Run, this);
+		}
+	}
+
+	/**
+	 * @brief Create the ring of the calling thread
+	 */
+	AsyncLogRing *AddRing()
+	{
+		AsyncLogRing *ring = new AsyncLogRing();
+		std::lock_guard<std::mutex> lock(mMutex);
+		mRings.push_back(ring);
+		return ring;
+	}
+
+	/**
+	 * @brief Have the writer thread write queued messages now; lock-free, so the wake up may be missed, delaying writing until the next poll
+	 */
+	void Wake()
+	{
+		mWakeRequested.store(true, std::memory_order_release);
+		mCond.notify_all();
+	}
+
+	/**
+	 * @brief Wait until all messages queued before the call have been written
+	 */
+	void Flush()
+	{
+		std::unique_lock<std::mutex> lock(mMutex);
+		if( mThread.joinable() )
+		{
+			uint64_t request = ++mFlushRequested;
+			mCond.notify_all();
+			mCond.wait(lock, [this, request]{ return mFlushDone >= request; });
+		}
+	}
+
+	/**
+	 * @brief Get the number of messages dropped by all threads so far
+	 */
+	uint64_t GetDroppedCount()
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		uint64_t dropped = mDroppedByExitedThreads;
+		for( auto ring : mRings )
+		{
+			dropped += ring->mDropped.load(std::memory_order_relaxed);
+		}
+		return dropped;
+	}
+
+	AsyncLogWriter(const AsyncLogWriter&) = delete;
+	AsyncLogWriter& operator=(const AsyncLogWriter&) = delete;
+
+private:
+	AsyncLogWriter() : mMutex(), mCond(), mRings(), mThread(), mStop(false), mWakeRequested(false), mFlushRequested(0), mFlushDone(0),
+		mDroppedByExitedThreads(0), mDroppedReported(0)
+	{
+	}
+
+	~AsyncLogWriter()
+	{
+		AampLogManager::asyncLogging = false;
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mStop = true;
+			mCond.notify_all();
+		}
+		if( mThread.joinable() )
+		{
+			mThread.join();
+		}
+		// rings are not freed; threads that are still running may yet touch them
+	}
+
+	void Run()
+	{
+		std::unique_lock<std::mutex> lock(mMutex);
+		while( true )
+		{
+			bool stop = mStop;
+			uint64_t flushRequested = mFlushRequested;
+			std::vector<AsyncLogRing *> rings(mRings);
+			mWakeRequested.store(false, std::memory_order_relaxed);
+			lock.unlock();
+			WriteQueued(rings);
+			lock.lock();
+			RemoveExitedThreads();
+			if( flushRequested != mFlushDone )
+			{
+				mFlushDone = flushRequested;
+				mCond.notify_all();
+			}
+			if( stop )
+			{
+				break;
+			}
+			mCond.wait_for(lock, std::chrono::milliseconds(AAMP_ASYNC_LOG_IDLE_MS), [this, flushRequested]{ return mStop || mFlushRequested != flushRequested || mWakeRequested.load(std::memory_order_acquire); });
+		}
+	}
+
+	/**
+	 * @brief Write all queued messages, merging the rings by time
+	 */
+	void WriteQueued(const std::vector<AsyncLogRing *> &rings)
+	{
+		while( true )
+		{
+			AsyncLogRing *oldest = NULL;
+			const AsyncLogRecord *oldestRecord = NULL;
+			for( auto ring : rings )
+			{
+				const AsyncLogRecord *record = ring->Front();
+				if( record && (!oldestRecord || timercmp(&record->time, &oldestRecord->time, <)) )
+				{
+					oldest = ring;
+					oldestRecord = record;
+				}
+			}
+			if( !oldestRecord )
+			{
+				break;
+			}
+			Write(oldestRecord);
+			oldest->Pop(oldestRecord);
+		}
+		uint64_t dropped = mDroppedByExitedThreads;
+		for( auto ring : rings )
+		{
+			dropped += ring->mDropped.load(std::memory_order_relaxed);
+		}
+		if( dropped > mDroppedReported )
+		{
+			char line[64];
+			snprintf(line, sizeof(line), "[AAMP-PLAYER] async logging dropped %" PRIu64 " messages", dropped - mDroppedReported);
+			WriteLogLine(eLOGLEVEL_WARN, line);
+			mDroppedReported = dropped;
+		}
+	}
+
+	/**
+	 * @brief Add the prefix to a queued message and write it
+	 */
+	void Write(const AsyncLogRecord *record)
+	{
+		char timestamp[AAMPCLI_TIMESTAMP_PREFIX_MAX_CHARS];
+		timestamp[0] = 0x00;
+		if( AampLogManager::disableLogRedirection )
+		{
+			snprintf(timestamp, sizeof(timestamp), AAMPCLI_TIMESTAMP_PREFIX_FORMAT, (unsigned int)record->time.tv_sec, (unsigned int)record->time.tv_usec / 1000 );
+		}
+		char line[AAMP_ASYNC_LOG_MAX_MESSAGE + 256];
+		snprintf(line, sizeof(line), "%s[AAMP-PLAYER][%d][%s][%zx][%s][%d]%s",
+				 timestamp,
+				 record->playerId,
+				 mLogLevelStr[record->level],
+				 record->threadId,
+				 record->GetFile(), record->line,
+				 record->GetMessage() );
+		WriteLogLine(record->level, line);
+	}
+
+	/**
+	 * @brief Free the drained rings of exited threads; called with mMutex held
+	 */
+	void RemoveExitedThreads()
+	{
+		for( auto iter = mRings.begin(); iter != mRings.end(); )
+		{
+			AsyncLogRing *ring = *iter;
+			if( ring->mOrphaned.load(std::memory_order_acquire) && !ring->Front() )
+			{
+				mDroppedByExitedThreads += ring->mDropped.load(std::memory_order_relaxed);
+				delete ring;
+				iter = mRings.erase(iter);
+			}
+			else
+			{
+				++iter;
+			}
+		}
+	}
+
+	std::mutex mMutex;
+	std::condition_variable mCond;
+	std::vector<AsyncLogRing *> mRings;		/**< one per thread that logged while asynchronous logging was enabled */
+	std::thread mThread;
+	bool mStop;
+	std::atomic<bool> mWakeRequested;
+	uint64_t mFlushRequested;
+	uint64_t mFlushDone;
+	uint64_t mDroppedByExitedThreads;
+	uint64_t mDroppedReported;
+};
+
+/**
+ * @brief Owner of the ring of a thread; marks it orphaned on thread exit, the writer frees it once drained
+ */
+struct AsyncLogRingHolder
+{
+	AsyncLogRing *ring;
+
+	AsyncLogRingHolder() : ring(NULL)
+	{
+	}
+
+	~AsyncLogRingHolder()
+	{
+		if( ring )
+		{
+			ring->mOrphaned.store(true, std::memory_order_release);
+		}
+	}
+};
+
+thread_local AsyncLogRingHolder gAsyncLogRing;
+} // namespace
+
+/**
+ * @brief Enable or disable asynchronous logging
+ */
+void AampLogManager::setAsyncLogging(bool enable)
+{
+	if( enable )
+	{
+		AsyncLogWriter::GetInstance().Start();
+	}
+	else if( asyncLogging )
+	{
+		asyncLogging = false;
+		AsyncLogWriter::GetInstance().Flush();
+	}
+	asyncLogging = enable;
+}
+
+/**
+ * @brief Wait until all asynchronously logged messages have been written
+ */
+void AampLogManager::flushAsyncLog()
+{
+	AsyncLogWriter::GetInstance().Flush();
+}
+
+/**
+ * @brief Get the number of messages dropped by asynchronous logging
+ */
+uint64_t AampLogManager::getDroppedLogCount()
+{
+	return AsyncLogWriter::GetInstance().GetDroppedCount();
+}
+
+/**
+ * @brief Set the log levels of modules, overriding the global log level for them
+ */
+void AampLogManager::setModuleLogLevels(const std::string &moduleLevels)
+{
+	std::lock_guard<std::mutex> lock(gModuleLogLevelMutex);
+	if( moduleLevels == gModuleLogLevelsString )
+	{ // unchanged; keep call site caches valid
+		return;
+	}
+	gModuleLogLevelsString = moduleLevels;
+	gModuleLogLevels.clear();
+	std::istringstream iss(moduleLevels);
+	std::string item;
+	while( std::getline(iss, item, ',') )
+	{
+		size_t delim = item.find(':');
+		if( delim == std::string::npos || delim == 0 )
+		{
+			continue;
+		}
+		std::string module = item.substr(0, delim);
+		std::string levelName = item.substr(delim + 1);
+		int level = -1;
+		for( int i = eLOGLEVEL_TRACE; i <= eLOGLEVEL_ERROR; i++ )
+		{
+			if( strcasecmp(levelName.c_str(), mLogLevelStr[i]) == 0 || levelName == std::to_string(i) )
+			{
+				level = i;
+				break;
+			}
+		}
+		if( level < 0 && strcasecmp(levelName.c_str(), "warning") == 0 )
+		{
+			level = eLOGLEVEL_WARN;
+		}
+		if( level >= 0 )
+		{
+			gModuleLogLevels.push_back(std::make_pair(module, (AAMP_LogLevel)level));
+		}
+	}
+	uint32_t generation = 0;
+	if( !gModuleLogLevels.empty() )
+	{ // 24 bit, never 0; see AampLogSite::IsEnabled
+		gModuleLogLevelSerial = (gModuleLogLevelSerial + 1) & 0xffffff;
+		if( gModuleLogLevelSerial == 0 )
+		{
+			gModuleLogLevelSerial = 1;
+		}
+		generation = gModuleLogLevelSerial;
+	}
+	moduleLogLevelGeneration = generation;
+}
+
+/**
+ * @brief Get the log level set for the module of a source file
+ */
+int AampLogManager::getModuleLogLevel(const char *file)
+{
+	int level = -1;
+	std::string path(file ? file : "");
+	size_t slash = path.rfind('/');
+	std::string name = path.substr(slash == std::string::npos ? 0 : slash + 1);
+	name = name.substr(0, name.find('.'));
+	std::lock_guard<std::mutex> lock(gModuleLogLevelMutex);
+	for( auto &moduleLevel : gModuleLogLevels )
+	{
+		const std::string &module = moduleLevel.first;
+		if( name == module || path.compare(0, module.size() + 1, module + "/") == 0 || path.find("/" + module + "/") != std::string::npos )
+		{
+			level = moduleLevel.second;
+			break;
+		}
+	}
+	return level;
+}
+
 /**
  * @brief Print logs to console / log file
  */
 void logprintf(AAMP_LogLevel logLevelIndex, const char* file, int line, const char *format, ...)
 {
+	if( AampLogManager::asyncLogging.load(std::memory_order_relaxed) )
+	{ // format the message only; prefix and sink write are done by the writer thread
+		char message[AAMP_ASYNC_LOG_MAX_MESSAGE];
+		va_list args;
+		va_start(args, format);
+		int len = vsnprintf(message, sizeof(message), format, args);
+		va_end(args);
+		if( len >= 0 )
+		{
+			if( !gAsyncLogRing.ring )
+			{
+				gAsyncLogRing.ring = AsyncLogWriter::GetInstance().AddRing();
+			}
+			AsyncLogRecord record;
+			record.size = 0;
+			record.fileOffset = 0;
+			record.line = line;
+			record.level = logLevelIndex;
+			record.playerId = gPlayerId;
+			record.threadId = GetPrintableThreadID();
+			gettimeofday(&record.time, NULL);
+			bool wake = false;
+			gAsyncLogRing.ring->Push(record, message, std::min((size_t)len, sizeof(message) - 1), file, wake);
+			if( wake )
+			{
+				AsyncLogWriter::GetInstance().Wake();
+			}
+			return;
+		}
+	}
+
 	char timestamp[AAMPCLI_TIMESTAMP_PREFIX_MAX_CHARS];
 	timestamp[0] = 0x00;
 	if( AampLogManager::disableLogRedirection )
@@ -92,12 +676,13 @@ void logprintf(AAMP_LogLevel logLevelIndex, const char* file, int line, const ch
 		gettimeofday(&t, NULL);
 		snprintf(timestamp, sizeof(timestamp), AAMPCLI_TIMESTAMP_PREFIX_FORMAT, (unsigned int)t.tv_sec, (unsigned int)t.tv_usec / 1000 );
 	}
-	
-	char *format_ptr = NULL;
-	int format_bytes = 0;
+
+	char format_buf[AAMP_LOG_FORMAT_STACK_BYTES];
+	char *format_ptr = format_buf;
+	int format_bytes = sizeof(format_buf);
 	for( int pass=0; pass<2; pass++ )
-	{ // two pass: measure required bytes then populate format string
-		format_bytes = snprintf(format_ptr, format_bytes,
+	{ // single pass unless the prefixed format string does not fit format_buf
+		int required = snprintf(format_ptr, format_bytes,
 							   "%s[AAMP-PLAYER][%d][%s][%zx][%s][%d]%s\n",
 							   timestamp,
 							   gPlayerId,
@@ -105,55 +690,20 @@ void logprintf(AAMP_LogLevel logLevelIndex, const char* file, int line, const ch
 							   GetPrintableThreadID(),
 							   file, line,
 							   format );
-		if( format_bytes<=0 )
+		if( required<=0 )
 		{ // should never happen!
 			break;
 		}
-		if( pass==0 )
-		{
-			format_bytes++; // include nul terminator
-			format_ptr = (char *)alloca(format_bytes); // allocate on stack
-		}
-		else
+		if( required < format_bytes )
 		{
 			va_list args;
 			va_start(args, format);
-			if( AampLogManager::disableLogRedirection )
-			{ // aampcli
-				vprintf( format_ptr, args );
-			}
-			else if ( AampLogManager::enableEthanLogRedirection )
-			{ // remap AAMP log levels to Ethan log levels
-				int ethanLogLevel;
-				// Important: in production builds, Ethan logger filters out everything
-				// except ETHAN_LOG_MILESTONE and ETHAN_LOG_FATAL
-				switch (logLevelIndex)
-				{
-					case eLOGLEVEL_TRACE:
-					case eLOGLEVEL_DEBUG:
-						ethanLogLevel = ETHAN_LOG_DEBUG;
-						break;
-						
-					case eLOGLEVEL_ERROR:
-						ethanLogLevel = ETHAN_LOG_FATAL;
-						break;
-						
-					case eLOGLEVEL_INFO: // note: we rely on eLOGLEVEL_INFO at tune time for triage
-					case eLOGLEVEL_WARN:
-					case eLOGLEVEL_MIL:
-					default:
-						ethanLogLevel = ETHAN_LOG_MILESTONE;
-						break;
-				}
-				vethanlog(ethanLogLevel,NULL,NULL,-1,format_ptr, args);
-			}
-			else
-			{
-				format_ptr[format_bytes-1] = 0x00; // strip not-needed newline (good for Ethan Logger, too?)
-				sd_journal_printv(LOG_NOTICE,format_ptr,args); // note: truncates to 2040 characters
-			}
+			WriteLog(logLevelIndex, format_ptr, required, args);
 			va_end(args);
+			break;
 		}
+		format_bytes = required + 1; // include nul terminator
+		format_ptr = (char *)alloca(format_bytes); // allocate on stack
 	}
 }
 
@@ -140,6 +140,7 @@ char *aamp_CurlEasyGetinfoString( CURL *handle, CURLINFO info );
 #define FOG_RECORDING_ID_STRING		"Fog-Recording-Id:"
 #define CAPPED_PROFILE_STRING		"Profile-Capped:"
 #define TRANSFER_ENCODING_STRING	"Transfer-Encoding:"
+#define CACHE_CONTROL_STRING		"Cache-Control:"
 
 
 #endif  //__AAMP_CURL_DEFINE_H__
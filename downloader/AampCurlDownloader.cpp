@@ -23,6 +23,7 @@
 **************************************/
 
 #include "AampCurlDownloader.h"
+#include "AampCurlMultiEngine.h"
 #include "AampUtils.h"
 #include <vector>
 #include "AampLogManager.h"
@@ -38,6 +39,7 @@ void _downloadConfig::show()
 	AAMPLOG_INFO("bSSLVerifyPeer : %d", bSSLVerifyPeer);
 	AAMPLOG_INFO("curl : %p", pCurl);
 	AAMPLOG_INFO("userAgentString :%s",userAgentString.c_str());
+	AAMPLOG_INFO("pCurlMultiEngine : %p", pCurlMultiEngine.get());
 	AAMPLOG_INFO("proxyName :%s",proxyName.c_str());
 	AAMPLOG_INFO("iDnsCacheTimeOut :%ld",iDnsCacheTimeOut);
 
@@ -179,11 +181,19 @@ int AampCurlDownloader::Download(const std::string &urlStr, std::shared_ptr<Down
 			bool loopAgain = false;
 			do{
 				mDownloadStartTime = mDownloadUpdatedTime = NOW_STEADY_TS_MS;
+				contentLength = 0;
 				if( mDnldCfg && mDnldCfg->bCurlThroughput )
 				{
 					AAMPLOG_MIL( "curl-begin type=%d", eMEDIATYPE_MANIFEST);
 				}
-				curlRetVal = curl_easy_perform(mCurl);
+				if( mDnldCfg && mDnldCfg->pCurlMultiEngine )
+				{
+					curlRetVal = mDnldCfg->pCurlMultiEngine->Perform(mCurl);
+				}
+				else
+				{
+					curlRetVal = curl_easy_perform(mCurl);
+				}
 				loopAgain = false;
 				numDownloadAttempts++;
 				if(curlRetVal == CURLE_OK)
@@ -514,10 +524,14 @@ size_t AampCurlDownloader::write_callback(void *buffer, size_t sz, size_t nmemb)
 	if(retSize)
 	{
 		std::lock_guard<std::mutex> lock(mCurlMutex);
-		std::vector<std::uint8_t> op1;
+		std::vector<std::uint8_t> &downloadData = this->mDownloadResponse->mDownloadData;
 		std::uint8_t *bufferS = static_cast<std::uint8_t*>( buffer );
 		std::uint8_t *bufferE = bufferS + retSize;
-		std::copy(bufferS, bufferE, std::back_inserter(this->mDownloadResponse->mDownloadData));
+		if( contentLength > downloadData.capacity() )
+		{ // size known from Content-Length; allocate once instead of growing on every callback
+			downloadData.reserve(contentLength);
+		}
+		downloadData.insert(downloadData.end(), bufferS, bufferE);
 		mDownloadUpdatedTime = NOW_STEADY_TS_MS;
 		mWriteCallbackBufferSize += retSize;
 	}
@@ -42,6 +42,7 @@
 #include <memory>
 #include "AampCurlDefine.h"
 
+class AampCurlMultiEngine;
 
 
 typedef std::map<int,std::string> RespHeader;
@@ -70,6 +71,7 @@ typedef struct _downloadConfig
 	bool	bNeedDownloadMetrics;
 	long 	iDnsCacheTimeOut;
 	bool 	bCurlThroughput;
+	std::shared_ptr<AampCurlMultiEngine> pCurlMultiEngine;	/**< Reactor of the owning player to perform downloads on; curl_easy_perform if null */
 
 	//AampMediaType mediaType;
 	std::unordered_map<std::string, std::vector<std::string>> sCustomHeaders;
@@ -81,7 +83,7 @@ typedef struct _downloadConfig
 	_downloadConfig() : pCurl(nullptr),iDownloadTimeout(DEFAULT_CURL_TIMEOUT),iLowBWTimeout(0),iCurlConnectionTimeout(DEFAULT_CURL_CONNECTTIMEOUT),
 			iStallTimeout(0),iStartTimeout(0),bSSLVerifyPeer(false),lSupportedTLSVersion(CURL_SSLVERSION_TLSv1_2),proxyName(""),userAgentString(""),sCustomHeaders(),
 			bVerbose(false),bIgnoreResponseHeader(false),bNeedDownloadMetrics(false),eRequestType(eCURL_GET),postData(""),iDownloadRetryCount(0),iDownload502RetryCount(0),
-			iDownloadRetryWaitMs(50),iDnsCacheTimeOut(DEFAULT_DNS_CACHE_TIMEOUT), bCurlThroughput(false)
+			iDownloadRetryWaitMs(50),iDnsCacheTimeOut(DEFAULT_DNS_CACHE_TIMEOUT), bCurlThroughput(false), pCurlMultiEngine()
 	{
 	}
 	
@@ -94,7 +96,8 @@ typedef struct _downloadConfig
 			sCustomHeaders(),bVerbose(),
 			bIgnoreResponseHeader(),bNeedDownloadMetrics(),
 			eRequestType(),postData(),iDnsCacheTimeOut(),
-			iDownloadRetryCount(),iDownloadRetryWaitMs()
+			iDownloadRetryCount(),iDownloadRetryWaitMs(),
+			pCurlMultiEngine()
     	{
 			*this=other;
     	}
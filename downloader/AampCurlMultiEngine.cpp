@@ -0,0 +1,274 @@
+/*
+ * If not stated otherwise in this file or this component's license file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2024 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/**
+ * @file AampCurlMultiEngine.cpp
+ * @brief curl_multi based download engine for Aamp
+ */
+
+#include "AampCurlMultiEngine.h"
+#include "AampLogManager.h"
+#include "AampUtils.h"
+#include <vector>
+
+#define CURL_MULTI_SETOPT( MH, OPT, PARAM ) \
+	{ \
+		CURLMcode rc = curl_multi_setopt( MH, OPT, PARAM ); \
+		if( rc != CURLM_OK ) \
+		{ \
+			AAMPLOG_WARN( "curl_multi_setopt fail %d", rc ); \
+		} \
+	}
+
+/**
+ * @brief AampCurlMultiEngine Constructor
+ */
+AampCurlMultiEngine::AampCurlMultiEngine() : mMulti(NULL), mReactorThread(), mMutex(), mWorkCond(), mDoneCond(),
+	mPending(), mActive(), mReactorRunning(false), mExit(false)
+{
+	mMulti = curl_multi_init();
+	if( mMulti )
+	{
+		CURL_MULTI_SETOPT(mMulti, CURLMOPT_MAXCONNECTS, (long)AAMP_CURL_MULTI_MAX_CONNECTS);
+#if LIBCURL_VERSION_NUM >= 0x071e00 // CURL version >= 7.30.0
+		CURL_MULTI_SETOPT(mMulti, CURLMOPT_MAX_HOST_CONNECTIONS, (long)AAMP_CURL_MULTI_MAX_HOST_CONNECTIONS);
+#endif
+#if LIBCURL_VERSION_NUM >= 0x072b00 // CURL version >= 7.43.0
+		CURL_MULTI_SETOPT(mMulti, CURLMOPT_PIPELINING, (long)CURLPIPE_MULTIPLEX);
+#endif
+	}
+	else
+	{
+		AAMPLOG_ERR("curl_multi_init failed");
+	}
+}
+
+/**
+ * @brief AampCurlMultiEngine Destructor
+ */
+AampCurlMultiEngine::~AampCurlMultiEngine()
+{
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mExit = true;
+		mWorkCond.notify_one();
+#if LIBCURL_VERSION_NUM >= 0x074400 // CURL version >= 7.68.0
+		if( mMulti )
+		{
+			curl_multi_wakeup(mMulti);
+		}
+#endif
+	}
+	if( mReactorThread.joinable() )
+	{
+		mReactorThread.join();
+	}
+	if( mMulti )
+	{
+		curl_multi_cleanup(mMulti);
+		mMulti = NULL;
+	}
+}
+
+/**
+ * @brief Start the reactor thread if not running; called with mMutex held
+ */
+void AampCurlMultiEngine::StartReactor()
+{
+	if( !mReactorRunning )
+	{
+		try
+		{
+			mReactorThread = std::thread(&AampCurlMultiEngine::ReactorLoop, this);
+			mReactorRunning = true;
+			AAMPLOG_INFO("Thread created for CurlMultiReactor [%zx]", GetPrintableThreadID(mReactorThread));
+		}
+		catch(const std::exception& e)
+		{
+			AAMPLOG_ERR("Failed to create CurlMultiReactor thread : %s", e.what());
+		}
+	}
+}
+
+/**
+ * @brief Perform a transfer on the reactor, blocking until it completes
+ */
+CURLcode AampCurlMultiEngine::Perform(CURL *curl)
+{
+	CURLcode res;
+	std::unique_lock<std::mutex> lock(mMutex);
+	StartReactor();
+	if( !mMulti || !mReactorRunning || mExit )
+	{
+		lock.unlock();
+		// engine not usable, keep the download going on the calling thread
+		res = curl_easy_perform(curl);
+	}
+	else
+	{
+		Transfer transfer(curl);
+#if LIBCURL_VERSION_NUM >= 0x072b00 // CURL version >= 7.43.0
+		// prefer waiting for a multiplexed HTTP/2 stream over opening a new connection
+		curl_easy_setopt(curl, CURLOPT_PIPEWAIT, 1L);
+#endif
+		mPending.push_back(&transfer);
+		mWorkCond.notify_one();
+#if LIBCURL_VERSION_NUM >= 0x074400 // CURL version >= 7.68.0
+		curl_multi_wakeup(mMulti);
+#endif
+		mDoneCond.wait(lock, [&transfer]{ return transfer.done; });
+		res = transfer.result;
+		lock.unlock();
+#if LIBCURL_VERSION_NUM >= 0x072b00 // CURL version >= 7.43.0
+		// handles are reused by the callers, possibly with curl_easy_perform
+		curl_easy_setopt(curl, CURLOPT_PIPEWAIT, 0L);
+#endif
+	}
+	return res;
+}
+
+/**
+ * @brief Get the number of transfers currently submitted or in progress
+ */
+size_t AampCurlMultiEngine::GetActiveTransferCount()
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	return mPending.size() + mActive.size();
+}
+
+/**
+ * @brief Read completion messages from the multi handle and wake the owners
+ */
+void AampCurlMultiEngine::ProcessCompletedTransfers()
+{
+	CURLMsg *msg = NULL;
+	int msgsInQueue = 0;
+	bool completed = false;
+	while( (msg = curl_multi_info_read(mMulti, &msgsInQueue)) != NULL )
+	{
+		if( msg->msg == CURLMSG_DONE )
+		{
+			CURL *curl = msg->easy_handle;
+			CURLcode result = msg->data.result;
+			curl_multi_remove_handle(mMulti, curl);
+
+			std::lock_guard<std::mutex> lock(mMutex);
+			auto it = mActive.find(curl);
+			if( it != mActive.end() )
+			{
+				it->second->result = result;
+				it->second->done = true;
+				mActive.erase(it);
+				completed = true;
+			}
+			else
+			{
+				AAMPLOG_WARN("Completion for unknown curl handle %p", curl);
+			}
+		}
+	}
+	if( completed )
+	{
+		mDoneCond.notify_all();
+	}
+}
+
+/**
+ * @brief Reactor thread: adds submitted handles, drives the multi handle and reports completions
+ */
+void AampCurlMultiEngine::ReactorLoop()
+{
+	aamp_setThreadName("aampCurlMulti");
+	std::vector<Transfer*> submitted;
+	int stillRunning = 0;
+	while( true )
+	{
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+			if( mPending.empty() && mActive.empty() && !mExit )
+			{
+				mWorkCond.wait(lock, [this]{ return mExit || !mPending.empty(); });
+			}
+			if( mExit )
+			{
+				break;
+			}
+			submitted.assign(mPending.begin(), mPending.end());
+			mPending.clear();
+			for( auto transfer : submitted )
+			{
+				mActive[transfer->curl] = transfer;
+			}
+		}
+
+		for( auto transfer : submitted )
+		{
+			CURLMcode rc = curl_multi_add_handle(mMulti, transfer->curl);
+			if( rc != CURLM_OK )
+			{
+				AAMPLOG_ERR("curl_multi_add_handle failed %d for handle %p", rc, transfer->curl);
+				std::lock_guard<std::mutex> lock(mMutex);
+				mActive.erase(transfer->curl);
+				transfer->result = CURLE_FAILED_INIT;
+				transfer->done = true;
+				mDoneCond.notify_all();
+			}
+		}
+		submitted.clear();
+
+		CURLMcode rc = curl_multi_perform(mMulti, &stillRunning);
+		if( rc != CURLM_OK )
+		{
+			AAMPLOG_ERR("curl_multi_perform failed %d", rc);
+		}
+		ProcessCompletedTransfers();
+
+		if( stillRunning )
+		{
+#if LIBCURL_VERSION_NUM >= 0x074200 // CURL version >= 7.66.0
+			rc = curl_multi_poll(mMulti, NULL, 0, AAMP_CURL_MULTI_POLL_TIMEOUT_MS, NULL);
+#else
+			// without curl_multi_wakeup, keep the timeout short so new submissions are not delayed
+			rc = curl_multi_wait(mMulti, NULL, 0, AAMP_CURL_MULTI_POLL_TIMEOUT_MS / 10, NULL);
+#endif
+			if( rc != CURLM_OK )
+			{
+				AAMPLOG_ERR("curl_multi_poll failed %d", rc);
+			}
+		}
+	}
+
+	// abort whatever is still owned by the reactor so that no caller keeps waiting
+	std::lock_guard<std::mutex> lock(mMutex);
+	for( auto &entry : mActive )
+	{
+		curl_multi_remove_handle(mMulti, entry.first);
+		entry.second->result = CURLE_ABORTED_BY_CALLBACK;
+		entry.second->done = true;
+	}
+	mActive.clear();
+	for( auto transfer : mPending )
+	{
+		transfer->result = CURLE_ABORTED_BY_CALLBACK;
+		transfer->done = true;
+	}
+	mPending.clear();
+	mDoneCond.notify_all();
+	AAMPLOG_INFO("Exited CurlMultiReactor thread");
+}
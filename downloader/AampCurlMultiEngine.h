@@ -0,0 +1,126 @@
+/*
+ * If not stated otherwise in this file or this component's license file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2024 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/**
+ * @file AampCurlMultiEngine.h
+ * @brief curl_multi based download engine for Aamp
+ */
+
+#ifndef __AAMP_CURL_MULTI_ENGINE_H__
+#define __AAMP_CURL_MULTI_ENGINE_H__
+
+#include <curl/curl.h>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <unordered_map>
+
+#define AAMP_CURL_MULTI_MAX_CONNECTS		32		/**< Size of the connection cache shared by the transfers of a player */
+#define AAMP_CURL_MULTI_MAX_HOST_CONNECTIONS	8		/**< Max parallel connections to a single host */
+#define AAMP_CURL_MULTI_POLL_TIMEOUT_MS		100		/**< Reactor poll timeout when no socket activity */
+
+/**
+ * @class AampCurlMultiEngine
+ * @brief curl_multi reactor owned by one player instance
+ *
+ * Easy handles configured by the callers (GetFile, AampCurlDownloader) are submitted
+ * to the reactor thread of the player, which drives all its transfers with curl_multi.
+ * The caller waits for completion and gets back the CURLcode as if curl_easy_perform was
+ * used, so response code, effective url and timing info remain available on the easy handle.
+ * The tracks of the player share one connection cache, which allows connection reuse and
+ * HTTP/2 stream multiplexing to the same CDN host. Players do not share a reactor, so a
+ * slow callback of one player never delays the transfers of another.
+ *
+ * Curl callbacks of submitted handles are invoked on the reactor thread; they must not
+ * block for long, and must not take locks the submitting thread may hold while waiting
+ * in Perform, as the transfer cannot progress until the callback returns.
+ */
+class AampCurlMultiEngine
+{
+public:
+	/**
+	 * @brief AampCurlMultiEngine Constructor; the reactor thread is started on first use
+	 */
+	AampCurlMultiEngine();
+
+	/**
+	 * @brief AampCurlMultiEngine Destructor; aborts transfers still in progress
+	 */
+	~AampCurlMultiEngine();
+
+	/**
+	 * @brief Perform a transfer on the reactor, blocking until it completes
+	 * @param[in] curl - configured easy handle
+	 * @return CURLcode result of the transfer
+	 */
+	CURLcode Perform(CURL *curl);
+
+	/**
+	 * @brief Get the number of transfers currently submitted or in progress
+	 * @return transfer count
+	 */
+	size_t GetActiveTransferCount();
+
+	AampCurlMultiEngine(const AampCurlMultiEngine&) = delete;
+	AampCurlMultiEngine& operator=(const AampCurlMultiEngine&) = delete;
+
+private:
+	/**
+	 * @struct Transfer
+	 * @brief Book keeping for a transfer owned by a waiting caller
+	 */
+	struct Transfer
+	{
+		CURL *curl;
+		CURLcode result;
+		bool done;
+
+		Transfer(CURL *handle) : curl(handle), result(CURLE_OK), done(false)
+		{
+		}
+	};
+
+	/**
+	 * @brief Start the reactor thread if not running; called with mMutex held
+	 */
+	void StartReactor();
+
+	/**
+	 * @brief Reactor thread: adds submitted handles, drives the multi handle and reports completions
+	 */
+	void ReactorLoop();
+
+	/**
+	 * @brief Read completion messages from the multi handle and wake the owners
+	 */
+	void ProcessCompletedTransfers();
+
+	CURLM *mMulti;
+	std::thread mReactorThread;
+	std::mutex mMutex;
+	std::condition_variable mWorkCond;	/**< signalled when work is submitted to an idle reactor */
+	std::condition_variable mDoneCond;	/**< signalled when a transfer completes */
+	std::deque<Transfer*> mPending;		/**< submitted, not yet added to the multi handle */
+	std::unordered_map<CURL*, Transfer*> mActive;	/**< added to the multi handle */
+	bool mReactorRunning;
+	bool mExit;
+};
+
+#endif // __AAMP_CURL_MULTI_ENGINE_H__
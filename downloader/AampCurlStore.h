@@ -245,14 +245,17 @@ struct CurlCallbackContext
 	bool chunkedDownload;
 	std::string remoteUrl;
 	size_t contentLength;
+	size_t expectedLength; /**< Size hint used to pre-size the buffer when there is no Content-Length (byte range or learned size) */
+	int cacheMaxAge; /**< Cache-Control max-age of the response, 0 for no-store/no-cache, -1 if absent */
 	long long downloadStartTime;
 	long long processDelay; /**< Indicate the external process delay in curl operation; especially for lld*/
+	DownloadWriteObserver writeObserver; /**< Optional observer of bytes appended to buffer */
 
-	CurlCallbackContext() : aamp(NULL), buffer(NULL), responseHeaderData(NULL),bitrate(0),downloadIsEncoded(false), chunkedDownload(false),  mediaType(eMEDIATYPE_DEFAULT), remoteUrl(""), allResponseHeaders{""}, contentLength(0),downloadStartTime(-1), processDelay(0)
+	CurlCallbackContext() : aamp(NULL), buffer(NULL), responseHeaderData(NULL),bitrate(0),downloadIsEncoded(false), chunkedDownload(false),  mediaType(eMEDIATYPE_DEFAULT), remoteUrl(""), allResponseHeaders{""}, contentLength(0),expectedLength(0),cacheMaxAge(-1),downloadStartTime(-1), processDelay(0)
 	{
 
 	}
-	CurlCallbackContext(PrivateInstanceAAMP *_aamp, AampGrowableBuffer *_buffer) : aamp(_aamp), buffer(_buffer), responseHeaderData(NULL),bitrate(0),downloadIsEncoded(false),  chunkedDownload(false), mediaType(eMEDIATYPE_DEFAULT), remoteUrl(""), allResponseHeaders{""},  contentLength(0),downloadStartTime(-1){}
+	CurlCallbackContext(PrivateInstanceAAMP *_aamp, AampGrowableBuffer *_buffer) : aamp(_aamp), buffer(_buffer), responseHeaderData(NULL),bitrate(0),downloadIsEncoded(false),  chunkedDownload(false), mediaType(eMEDIATYPE_DEFAULT), remoteUrl(""), allResponseHeaders{""},  contentLength(0),expectedLength(0),cacheMaxAge(-1),downloadStartTime(-1){}
 
 	~CurlCallbackContext() {}
 
@@ -137,7 +137,11 @@ void AampDRMLicenseManager::licenseRenewalThread(std::shared_ptr<DrmHelper> drmH
 	//isSecClientError = true; //for secmanager
 	DrmMetaDataEventPtr e = std::make_shared<DrmMetaDataEvent>(AAMP_TUNE_FAILURE_UNKNOWN, "", 0, 0, isSecClientError, aampInstance->GetSessionId());
 	int cdmError = -1;
-	KeyState code = acquireLicense(drmHelper, sessionSlot, cdmError,  eMEDIATYPE_LICENCE,(void*)e.get() ,true);
+	KeyState code;
+	{
+		std::lock_guard<std::mutex> guard(mDrmSessionManager->drmSessionContexts[sessionSlot].sessionMutex);
+		code = acquireLicense(drmHelper, sessionSlot, cdmError,  eMEDIATYPE_LICENCE,(void*)e.get() ,true);
+	}
 	if (code != KEY_READY)
 	{
 		aampInstance->SendAnomalyEvent(ANOMALY_WARNING, "License Renewal failed due to Key State %d", code);
@@ -207,7 +211,6 @@ KeyState AampDRMLicenseManager::acquireLicense(std::shared_ptr<DrmHelper> drmHel
 	}
 	else
 	{
-                std::lock_guard<std::mutex> guard(mDrmSessionManager->drmSessionContexts[sessionSlot].sessionMutex);
 		/**
 		 * Generate a License challenge from the CDM
 		 */
@@ -318,6 +321,8 @@ KeyState AampDRMLicenseManager::acquireLicense(std::shared_ptr<DrmHelper> drmHel
 					if (((412 == httpResponseCode && 401 == httpExtendedStatusCode) || sec_accessTokenExpired) && !usingAppDefinedAuthToken)
 					{
 						AAMPLOG_INFO("License Req failure by Expired access token httpResCode %d statusCode %d", httpResponseCode, httpExtendedStatusCode);
+						// licenses of other slots may be acquired concurrently
+						std::unique_lock<std::mutex> tokenLock(accessTokenMutex);
 						if(accessToken)
 						{
 							free(accessToken);
@@ -331,6 +336,7 @@ KeyState AampDRMLicenseManager::acquireLicense(std::shared_ptr<DrmHelper> drmHel
 						{
 							AAMPLOG_INFO("Requesting License with new access token");
 							challengeInfo.accessToken = std::string(sessionToken, tokenLen);
+							tokenLock.unlock();
 							httpResponseCode = httpExtendedStatusCode = -1;
 
                                                          licenseResponse.reset(getLicenseSec(licenseRequest, drmHelper, challengeInfo, aampInstance, &httpResponseCode, &httpExtendedStatusCode, eventHandle));
@@ -881,12 +887,13 @@ void AampDRMLicenseManager::SetSendErrorOnFailure(bool sendErrorOnFailure)
  * @param adapId Index of the adaptation to which CP belongs to
  * @param type media type
  * @param isVssPeriod flag denotes if this is for a VSS period
+ * @param timeToPlay seconds until the content is expected to play, 0 if playing now
  * @return true if successfully queued
  * @return false if error occurred
  */
-bool AampDRMLicenseManager::QueueContentProtection(std::shared_ptr<DrmHelper> drmHelper, std::string periodId, uint32_t adapIdx, AampMediaType type, bool isVssPeriod)
+bool AampDRMLicenseManager::QueueContentProtection(std::shared_ptr<DrmHelper> drmHelper, std::string periodId, uint32_t adapIdx, AampMediaType type, bool isVssPeriod, double timeToPlay)
 {
-	return mLicensePrefetcher->QueueContentProtection(drmHelper, periodId, adapIdx, type, isVssPeriod);
+	return mLicensePrefetcher->QueueContentProtection(drmHelper, periodId, adapIdx, type, isVssPeriod, timeToPlay);
 }
 
 /**
@@ -1155,6 +1162,8 @@ DrmData * AampDRMLicenseManager::getLicenseSec(const LicenseRequest &licenseRequ
 		int32_t statusCode;
 		int32_t reasonCode;
 		int32_t businessStatus;
+		// licenses of other slots may be acquired concurrently
+		std::lock_guard<std::mutex> sessionGuard(mContentSecurityManagerMutex);
 
 		if (!mDrmSessionManager->mContentSecurityManagerSession.isSessionValid())
 		{
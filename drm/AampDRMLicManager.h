@@ -50,6 +50,7 @@ public:
 	int accessTokenLen;
 	std::mutex accessTokenMutex;
 	std::mutex cachedKeyMutex;
+	std::mutex mContentSecurityManagerMutex; /**< Serializes license requests through the content security manager, which share its session */
 	bool licenseRequestAbort;
 	int mMaxDRMSessions;
 	std::vector<std::thread> mLicenseRenewalThreads;
@@ -76,6 +77,7 @@ public:
 	const char* getAccessToken(int &tokenLength, int &error_code ,bool bSslPeerVerify);
 	/**
 	 * @fn acquireLicense
+	 * @brief Acquire the license of a session slot; caller holds the sessionMutex of the slot
 	 */
 	KeyState acquireLicense(std::shared_ptr<DrmHelper> drmHelper, int sessionSlot, int &cdmError,  
 					AampMediaType streamType, void *metaDataPtr,  bool isLicenseRenewal = false);
@@ -222,10 +224,11 @@ public:
 	 * @param adapId Index of the adaptation to which CP belongs to
 	 * @param type media type
 	 * @param isVssPeriod flag denotes if this is for a VSS period
+	 * @param timeToPlay seconds until the content is expected to play, 0 if playing now
 	 * @return true if successfully queued
 	 * @return false if error occurred
 	 */
-	bool QueueContentProtection(std::shared_ptr<DrmHelper> drmHelper, std::string periodId, uint32_t adapIdx, AampMediaType type, bool isVssPeriod = false);
+	bool QueueContentProtection(std::shared_ptr<DrmHelper> drmHelper, std::string periodId, uint32_t adapIdx, AampMediaType type, bool isVssPeriod = false, double timeToPlay = 0);
 
 	/**
 	 * @brief Queue a content protection event to the pipeline
@@ -1347,8 +1347,13 @@ bool TrackState::FetchFragmentHelper(int &http_error, bool &decryption_error, bo
 				}
 			}
 			
+			StartDecryptStream(mediaTrackDecryptBucketTypes[type]);
 			bool fetched = aamp->GetFile(fragmentUrl, (AampMediaType)(type), &cachedFragment->fragment,
 			 tempEffectiveUrl, &http_error, &downloadTime, range, type, false, NULL, NULL, fragmentDurationSeconds);
+			if (mDecryptStream)
+			{
+				aamp->SetDownloadWriteObserver((AampMediaType)(type), nullptr);
+			}
 			//Workaround for 404 of subtitle fragments
 			//TODO: This needs to be handled at server side and this workaround has to be removed
 			if (!fetched && http_error == 404 && type == eTRACK_SUBTITLE)
@@ -1861,6 +1866,98 @@ void TrackState::FlushIndex()
 		mDrmMetaDataIndexPosition = 0;
 	}
 	mInitFragmentInfo.clear();
+	mFirstDiscontinuitySequence = 0;
+	mProgramDateTimeIndexed = false;
+}
+
+/**
+ * @brief Take over the index entries of fragments that a refreshed playlist repeats unchanged
+ */
+bool TrackState::ReusePreviousIndex(const AampGrowableBuffer &previousPlaylist, const std::vector<IndexNode> &previousIndex,
+				const std::vector<DiscontinuityIndexNode> &previousDiscontinuityIndex, uint64_t previousFirstDiscontinuitySequence,
+				lstring &iter, IndexNode &node, AampTime &totalDuration, lstring &initFragmentPtr, uint64_t &discontinuitySequenceIndex)
+{
+	size_t count = previousIndex.size();
+	if( node.mediaSequenceNumber == -1 || count < 3 || previousIndex[0].mediaSequenceNumber == -1 )
+	{
+		return false;
+	}
+	long long matchIdx = node.mediaSequenceNumber - previousIndex[0].mediaSequenceNumber;
+	// need at least one fragment between the match and the last fragment, which is always parsed again
+	if( matchIdx < 0 || matchIdx + 2 >= (long long)count )
+	{
+		return false;
+	}
+	const IndexNode &match = previousIndex[matchIdx];
+	// previous text from the matched #EXTINF up to the #EXTINF of the last fragment must be repeated as is
+	const char *previousStart = match.pFragmentInfo.getPtr();
+	const char *previousLast = previousIndex[count - 1].pFragmentInfo.getPtr();
+	const char *previousBegin = previousPlaylist.GetPtr();
+	if( !previousBegin || previousStart < previousBegin || previousLast < previousStart ||
+		previousLast >= previousBegin + previousPlaylist.GetLen() )
+	{ // index does not point into the previous playlist text, so it can neither be compared nor rebased
+		AAMPLOG_WARN("%s previous index does not match previous playlist", name);
+		return false;
+	}
+	size_t length = previousLast - previousStart;
+	const char *start = node.pFragmentInfo.getPtr();
+	const char *end = playlist.GetPtr() + playlist.GetLen();
+	if( start + length > end || memcmp(previousStart, start, length) != 0 )
+	{
+		return false;
+	}
+	ptrdiff_t rebase = start - previousStart;
+	AampTime timeOffset = node.completionTimeSecondsFromStart - match.completionTimeSecondsFromStart;
+	int idxOffset = (int)(index.size() - 1 - matchIdx);
+
+	for( size_t idx = matchIdx + 1; idx < count - 1; idx++ )
+	{
+		IndexNode reused = previousIndex[idx];
+		reused.completionTimeSecondsFromStart += timeOffset;
+		reused.pFragmentInfo = lstring(reused.pFragmentInfo.getPtr() + rebase, reused.pFragmentInfo.getLen());
+		if( reused.initFragmentPtr.getPtr() >= previousStart )
+		{ // EXT-X-MAP inside the repeated text
+			reused.initFragmentPtr = lstring(reused.initFragmentPtr.getPtr() + rebase, reused.initFragmentPtr.getLen());
+		}
+		else
+		{ // EXT-X-MAP preceding the matched fragment, already parsed from the new text
+			reused.initFragmentPtr = node.initFragmentPtr;
+		}
+		index.push_back(reused);
+	}
+
+	// discontinuity sequence of the matched fragment in the previous playlist
+	uint64_t previousSequence = previousFirstDiscontinuitySequence;
+	uint64_t sequence = discontinuitySequenceIndex;
+	for( auto &discontinuityIndexNode : previousDiscontinuityIndex )
+	{
+		if( discontinuityIndexNode.fragmentIdx > matchIdx )
+		{
+			if( discontinuityIndexNode.fragmentIdx >= (int)count - 1 )
+			{
+				break;
+			}
+			DiscontinuityIndexNode reused = discontinuityIndexNode;
+			reused.discontinuitySequenceIndex = sequence + (discontinuityIndexNode.discontinuitySequenceIndex - previousSequence);
+			reused.fragmentIdx += idxOffset;
+			reused.position += timeOffset;
+			mDiscontinuityIndex.push_back(reused);
+			discontinuitySequenceIndex = reused.discontinuitySequenceIndex;
+		}
+		else
+		{
+			previousSequence = discontinuityIndexNode.discontinuitySequenceIndex;
+		}
+	}
+
+	node = index.back();
+	totalDuration = node.completionTimeSecondsFromStart;
+	initFragmentPtr = node.initFragmentPtr;
+	// resume parsing after the #EXTINF line of the last reused fragment
+	iter = lstring(node.pFragmentInfo.getPtr(), end - node.pFragmentInfo.getPtr());
+	iter.mystrpbrk();
+	AAMPLOG_INFO("%s reused %lld of %zu index entries", name, (long long)count - 2 - matchIdx, count);
+	return true;
 }
 
 /**
@@ -1911,7 +2008,7 @@ void TrackState::SetDrmContext()
 /**
  * @brief Function to to handle parse and indexing of individual tracks
  */
-void TrackState::IndexPlaylist(bool IsRefresh, AampTime &culledSec)
+void TrackState::IndexPlaylist(bool IsRefresh, AampTime &culledSec, const AampGrowableBuffer *previousPlaylist)
 {
 	AampTime totalDuration{};
 	AampTime prevProgramDateTime{mProgramDateTime};
@@ -1925,7 +2022,24 @@ void TrackState::IndexPlaylist(bool IsRefresh, AampTime &culledSec)
 		prevSecondsBeforePlayPoint = GetCompletionTimeForFragment(this, commonPlayPosition);
 	}
 
+	// index of the previous playlist, for taking over the entries of fragments that are still listed unchanged
+	std::vector<IndexNode> previousIndex;
+	std::vector<DiscontinuityIndexNode> previousDiscontinuityIndex;
+	uint64_t previousFirstDiscontinuitySequence = mFirstDiscontinuitySequence;
+	bool previousProgramDateTime = mProgramDateTimeIndexed;
+	bool reuseIndex = (previousPlaylist && previousPlaylist->GetPtr() && mDrmKeyTagCount == 0 && ISCONFIGSET(eAAMPConfig_HLSIncrementalIndex));
+	if( reuseIndex && !index.empty() && index[0].mediaSequenceNumber != -1 )
+	{
+		previousIndex.swap(index);
+		previousDiscontinuityIndex.swap(mDiscontinuityIndex);
+	}
+	else
+	{
+		reuseIndex = false;
+	}
+
 	FlushIndex();
+	index.reserve(previousIndex.size() + 1);
 	mIndexingInProgress = true;
 	lstring iter = lstring(playlist.GetPtr(),playlist.GetLen());
 	if( !iter.empty() ){
@@ -1990,6 +2104,15 @@ void TrackState::IndexPlaylist(bool IsRefresh, AampTime &culledSec)
 						node.mediaSequenceNumber++;
 					}
 					index.push_back(node);
+					if (reuseIndex && node.mediaSequenceNumber >= previousIndex[0].mediaSequenceNumber)
+					{ // single attempt, at the first fragment also listed in the previous playlist
+						reuseIndex = false;
+						if (mDrmKeyTagCount == 0 && (pdtAtTopAvailable || !previousProgramDateTime))
+						{
+							ReusePreviousIndex(*previousPlaylist, previousIndex, previousDiscontinuityIndex, previousFirstDiscontinuitySequence,
+									iter, node, totalDuration, initFragmentPtr, discontinuitySequenceIndex);
+						}
+					}
 				}
 				else if(ptr.removePrefix("-X-MEDIA-SEQUENCE:"))
 				{
@@ -2033,6 +2156,7 @@ void TrackState::IndexPlaylist(bool IsRefresh, AampTime &culledSec)
 				else if(ptr.removePrefix("-X-DISCONTINUITY-SEQUENCE:"))
 				{
 					discontinuitySequenceIndex = ptr.atoll();
+					mFirstDiscontinuitySequence = discontinuitySequenceIndex;
 				}
 				else if( ptr.removePrefix("-X-DISCONTINUITY"))
 				{
@@ -2193,6 +2317,7 @@ void TrackState::IndexPlaylist(bool IsRefresh, AampTime &culledSec)
 			//ptr = iter.mystrpbrk();
 		}
 
+		mProgramDateTimeIndexed = pdtAtTopAvailable;
 		if(mediaSequence==false)
 		{
 			AAMPLOG_INFO("warning: no EXT-X-MEDIA-SEQUENCE tag");
@@ -2331,13 +2456,15 @@ void TrackState::ProcessPlaylist(AampGrowableBuffer& newPlaylist, int http_error
 		}
 
 		AcquirePlaylistLock();
-		// Free previous playlist buffer and load with new one
-		playlist.Free();
+		// Keep previous playlist buffer until indexed, as the index still points into it, and load with new one
+		AampGrowableBuffer previousPlaylist("previousPlaylist");
+		previousPlaylist.Replace( &playlist );
 		playlist.Replace( &newPlaylist );
 		playlist.AppendNulTerminator(); // make safe for cstring operations
 
 		AampTime culled{};
-		IndexPlaylist(true, culled);
+		IndexPlaylist(true, culled, &previousPlaylist);
+		previousPlaylist.Free();
 		// Update culled seconds if playlist download was successful
 		// We need culledSeconds to find the timedMetadata position in playlist
 		// culledSeconds and FindTimedMetadata have been moved up here, because FindMediaForSequenceNumber
@@ -4963,9 +5090,9 @@ TrackState::TrackState(TrackType type, StreamAbstractionAAMP_HLS* parent, Privat
 		discontinuity(false),
 		refreshPlaylist(false), fragmentCollectorThreadID(), isFirstFragmentAfterABR(false),
 		manifestDLFailCount(0),
-		mCMSha1Hash(), mDrmTimeStamp(0), firstIndexDone(false), mDrm(NULL), mDrmLicenseRequestPending(false),
+		mCMSha1Hash(), mDrmTimeStamp(0), firstIndexDone(false), mDrm(NULL), mDecryptStream(), mDrmLicenseRequestPending(false),
 		mInjectInitFragment(false), mInitFragmentInfo(), mDrmKeyTagCount(0), mIndexingInProgress(false), mForceProcessDrmMetadata(false),
-		mDuration(0), mLastMatchedDiscontPosition(-1), mCulledSeconds(0),mCulledSecondsOld(0),
+		mDuration(0), mLastMatchedDiscontPosition(-1), mFirstDiscontinuitySequence(0), mProgramDateTimeIndexed(false), mCulledSeconds(0),mCulledSecondsOld(0),
 		mEffectiveUrl(""), mPlaylistUrl(""), mFragmentURIFromIndex(),
 		mSyncAfterDiscontinuityInProgress(false), playlist("playlist"),
 		index(), targetDurationSeconds(1), mDeferredDrmKeyMaxTime(0), startTimeForPlaylistSync(0.0),
@@ -5570,13 +5697,18 @@ DrmReturn TrackState::DrmDecrypt( CachedFragment * cachedFragment, ProfilerBucke
 				mKeyTagChanged = false;
 				mIVKeyChanged = false;
 			}
-			if(mDrm)
+			if(mDecryptStream)
+			{
+				drmReturn = mDecryptStream->Finish(cachedFragment->fragment.GetPtr(), cachedFragment->fragment.GetLen());
+			}
+			else if(mDrm)
 			{
 				drmReturn = mDrm->Decrypt(bucketTypeFragmentDecrypt, cachedFragment->fragment.GetPtr(),
 										  cachedFragment->fragment.GetLen(), MAX_LICENSE_ACQ_WAIT_TIME);
 
 			}
 		}
+		mDecryptStream.reset();
 	}
 	if (drmReturn != eDRM_SUCCESS)
 	{
@@ -5585,6 +5717,41 @@ DrmReturn TrackState::DrmDecrypt( CachedFragment * cachedFragment, ProfilerBucke
 	return drmReturn;
 }
 
+/**
+ * @brief Start decrypting the next AES-128 fragment in place while it is downloaded
+ *
+ * Only done when the key of the fragment is already acquired; otherwise, or if the
+ * key changes, DrmDecrypt decrypts the whole fragment after the download.
+ * The observer runs on the thread writing the download. With useCurlMulti that is the
+ * reactor thread of this player's engine, so the in-place decrypts of its tracks are
+ * serialized with each other and with its other transfers, not with other players.
+ */
+void TrackState::StartDecryptStream(ProfilerBucketType bucketType)
+{
+	HlsDrmDecryptStream *stream = NULL;
+	{
+		std::lock_guard<std::mutex> guard(mTrackDrmMutex);
+		mDecryptStream.reset();
+		if (ISCONFIGSET(eAAMPConfig_StreamingDecrypt) && fragmentEncrypted && mDrmMethod == eDRM_KEY_METHOD_AES_128 &&
+			mDrm && !mKeyTagChanged && !mIVKeyChanged)
+		{
+			if ( eMETHOD_AES_128 == mDrmInfo.method && true == mDrmInfo.bUseMediaSequenceIV )
+			{
+				// same IV as created again by FetchFragmentHelper once the fragment is downloaded
+				CreateInitVectorByMediaSeqNo( nextMediaSequenceNumber-1 );
+			}
+			mDecryptStream = mDrm->CreateDecryptStream(bucketType, mDrmInfo.iv);
+			stream = mDecryptStream.get();
+		}
+	}
+	if (stream)
+	{
+		aamp->SetDownloadWriteObserver((AampMediaType)(type), [stream](AampGrowableBuffer *buffer, size_t offset) {
+			stream->Update(buffer->GetPtr(), offset, buffer->GetLen());
+		});
+	}
+}
+
 /**
  * @brief Function to create init vector using current media sequence number
  */
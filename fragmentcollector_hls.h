@@ -258,8 +258,9 @@ class TrackState : public MediaTrack
 		 * @brief Function to parse playlist
 		 *
 		 * @param AampTime total duration from playlist
+		 * @param previousPlaylist previously indexed playlist, still holding the text referenced by index; NULL for a full parse
 		 ***************************************************************************/
-		void IndexPlaylist(bool IsRefresh, AampTime &culledSec);
+		void IndexPlaylist(bool IsRefresh, AampTime &culledSec, const AampGrowableBuffer *previousPlaylist = NULL);
 		/***************************************************************************
 		 * @fn ABRProfileChanged
 		 *
@@ -314,6 +315,13 @@ class TrackState : public MediaTrack
 		 * @return bool true if successfully decrypted
 		 ***************************************************************************/
 		DrmReturn DrmDecrypt(CachedFragment* cachedFragment, ProfilerBucketType bucketType);
+		/***************************************************************************
+		 * @fn StartDecryptStream
+		 *
+		 * @param[in] bucketType ProfilerBucketType enum
+		 * @return void
+		 ***************************************************************************/
+		void StartDecryptStream(ProfilerBucketType bucketType);
 		/***************************************************************************
 		 * @fn CreateInitVectorByMediaSeqNo
 		 *
@@ -509,6 +517,29 @@ class TrackState : public MediaTrack
 		 * @return void
 		 ***************************************************************************/
 		void FlushIndex();
+		/***************************************************************************
+		 * @fn ReusePreviousIndex
+		 * @brief Take over the index entries of fragments that a refreshed playlist repeats unchanged
+		 *
+		 * Called by IndexPlaylist right after indexing the fragment matching previousIndex by
+		 * media sequence number. If the previous playlist text from that fragment on is repeated
+		 * byte for byte, the following entries (except the last one, which is always parsed again)
+		 * are appended to index rebased to the new playlist text, and iter is moved past them.
+		 *
+		 * @param[in] previousPlaylist previous playlist text; previousIndex must point into it
+		 * @param[in] previousIndex index of previousPlaylist
+		 * @param[in] previousDiscontinuityIndex discontinuity index of previousPlaylist
+		 * @param[in] previousFirstDiscontinuitySequence EXT-X-DISCONTINUITY-SEQUENCE of previousPlaylist
+		 * @param[in,out] iter parse position in playlist, just after the last indexed #EXTINF line
+		 * @param[in,out] node last indexed node
+		 * @param[in,out] totalDuration duration of indexed fragments
+		 * @param[in,out] initFragmentPtr current EXT-X-MAP
+		 * @param[in,out] discontinuitySequenceIndex current discontinuity sequence
+		 * @return true if entries were taken over
+		 ***************************************************************************/
+		bool ReusePreviousIndex(const AampGrowableBuffer &previousPlaylist, const std::vector<IndexNode> &previousIndex,
+					const std::vector<DiscontinuityIndexNode> &previousDiscontinuityIndex, uint64_t previousFirstDiscontinuitySequence,
+					lstring &iter, IndexNode &node, AampTime &totalDuration, lstring &initFragmentPtr, uint64_t &discontinuitySequenceIndex);
 		/***************************************************************************
 		 * @fn FetchFragment
 		 *
@@ -649,6 +680,7 @@ class TrackState : public MediaTrack
 		int manifestDLFailCount;		/**< Manifest Download fail count for retry*/
 		bool firstIndexDone;					/**< Indicates if first indexing is done*/
 		std::shared_ptr<HlsDrmBase> mDrm;		/**< DRM decrypt context*/
+		std::unique_ptr<HlsDrmDecryptStream> mDecryptStream;	/**< Decrypts the fragment being downloaded, if key was ready at start*/
 		std::shared_ptr<DrmInterface> mDrmInterface;		/**< Interface bw drm and application */
 		bool mDrmLicenseRequestPending;			/**< Indicates if DRM License Request is Pending*/
 		bool mInjectInitFragment;				/**< Indicates if init fragment injection is required*/
@@ -658,6 +690,8 @@ class TrackState : public MediaTrack
 		std::condition_variable mPlaylistIndexed;		/**< Notifies after a playlist indexing operation */
 		std::mutex mTrackDrmMutex;			/**< protect DRM Interactions for the track */
 		AampTime mLastMatchedDiscontPosition;		/**< Holds discontinuity position last matched	by other track */
+		uint64_t mFirstDiscontinuitySequence;		/**< EXT-X-DISCONTINUITY-SEQUENCE of the indexed playlist */
+		bool mProgramDateTimeIndexed;			/**< Indicates if the indexed playlist has a EXT-X-PROGRAM-DATE-TIME tag */
 		AampTime mCulledSeconds;					/**< Total culled duration in this streamer instance*/
 		AampTime mCulledSecondsOld;				/**< Total culled duration in this streamer instance*/
 		bool mSyncAfterDiscontinuityInProgress; /**< Indicates if a synchronization after discontinuity tag is in progress*/
@@ -1030,53 +1030,74 @@ uint64_t StreamAbstractionAAMP_MPD::FindPositionInTimeline(class MediaStreamCont
 	pMediaStreamContext->lastSegmentTime, pMediaStreamContext->lastSegmentDuration);
 #endif
 
-	for(;index<timelines.size();index++)
+	SegmentTimelineIndex &segmentTimelineIndex = pMediaStreamContext->segmentTimelineIndex;
+	// The index resolves S elements without t the same way as the walk below only when walking from the start of the timeline;
+	// with lastSegmentTime zero the walk also has to apply the first segment rule, so both cases are left to it
+	if(pMediaStreamContext->lastSegmentTime != 0 && index >= 0 && index < timelines.size() && segmentTimelineIndex.Update(timelines) &&
+		(!segmentTimelineIndex.HasImplicitStartTime() || (index == 0 && pMediaStreamContext->fragmentDescriptor.Time == 0)))
 	{
-		timeline = timelines.at(index);
-		map<string, string> attributeMap = timeline->GetRawAttributes();
-		if(attributeMap.find("t") != attributeMap.end())
+		int row = segmentTimelineIndex.FindRunEndingAfter(pMediaStreamContext->lastSegmentTime, index);
+		if(row > index)
 		{
-			startTime = timeline->GetStartTime();
+			pMediaStreamContext->fragmentDescriptor.Number += segmentTimelineIndex.GetSegmentIndex(row, 0) - segmentTimelineIndex.GetSegmentIndex(index, 0);
+			pMediaStreamContext->fragmentDescriptor.nextfragmentNum = pMediaStreamContext->fragmentDescriptor.Number+(segmentTimelineIndex.GetRun(row-1).repeatCount+1);
 		}
-		else
+		const SegmentTimelineIndex::Run &run = segmentTimelineIndex.GetRun((row < timelines.size()) ? row : row-1);
+		startTime = run.startTime;
+		duration = run.duration;
+		repeatCount = run.repeatCount;
+		index = row;
+	}
+	else
+	{
+		for(;index<timelines.size();index++)
 		{
-			startTime = pMediaStreamContext->fragmentDescriptor.Time;
-		}
+			timeline = timelines.at(index);
+			map<string, string> attributeMap = timeline->GetRawAttributes();
+			if(attributeMap.find("t") != attributeMap.end())
+			{
+				startTime = timeline->GetStartTime();
+			}
+			else
+			{
+				startTime = pMediaStreamContext->fragmentDescriptor.Time;
+			}
 
-		duration = timeline->GetDuration();
-		// For Dynamic segment timeline content
-		if (0 == startTime && 0 != duration)
-		{
-			startTime = nextStartTime;
-		}
-		repeatCount = timeline->GetRepeatCount();
+			duration = timeline->GetDuration();
+			// For Dynamic segment timeline content
+			if (0 == startTime && 0 != duration)
+			{
+				startTime = nextStartTime;
+			}
+			repeatCount = timeline->GetRepeatCount();
 
-		nextStartTime = startTime+((uint64_t)(repeatCount+1)*duration);  //CID:98056 - Resolve overflow Before Widen
+			nextStartTime = startTime+((uint64_t)(repeatCount+1)*duration);  //CID:98056 - Resolve overflow Before Widen
 
-		/* For a timeline
-		* <SegmentTimeline>
-		*  <S d="109568" t="0"/>
-		*  <S d="107520" r="4" t="109568"/>
-		* and a manifest update after segment 1 has been sent. Ensure one cycle of the for loop so
-		* timeLineIndex gets incremented.
-		* Without this we get a segment dropped and another repeated in server side ads
-		*/
+			/* For a timeline
+			* <SegmentTimeline>
+			*  <S d="109568" t="0"/>
+			*  <S d="107520" r="4" t="109568"/>
+			* and a manifest update after segment 1 has been sent. Ensure one cycle of the for loop so
+			* timeLineIndex gets incremented.
+			* Without this we get a segment dropped and another repeated in server side ads
+			*/
 
-		bool isFirstSegment = pMediaStreamContext->lastSegmentTime == 0 && startTime == 0
-									&& pMediaStreamContext->lastSegmentDuration != 0
-									&& repeatCount == 0 && pMediaStreamContext->timeLineIndex == 0;
+			bool isFirstSegment = pMediaStreamContext->lastSegmentTime == 0 && startTime == 0
+										&& pMediaStreamContext->lastSegmentDuration != 0
+										&& repeatCount == 0 && pMediaStreamContext->timeLineIndex == 0;
 
 #if defined(DEBUG_TIMELINE) || defined(AAMP_SIMULATOR_BUILD)
-		AAMPLOG_INFO("Type[%d] nextStartTime=%" PRIu64 " startTime=%" PRIu64 " repeatCount=%u", pMediaStreamContext->type,
-			nextStartTime,startTime,repeatCount);
+			AAMPLOG_INFO("Type[%d] nextStartTime=%" PRIu64 " startTime=%" PRIu64 " repeatCount=%u", pMediaStreamContext->type,
+				nextStartTime,startTime,repeatCount);
 #endif
-		if(pMediaStreamContext->lastSegmentTime < nextStartTime && !isFirstSegment)
-		{
-			break;
-		}
-		pMediaStreamContext->fragmentDescriptor.Number += (repeatCount+1);
-		pMediaStreamContext->fragmentDescriptor.nextfragmentNum = pMediaStreamContext->fragmentDescriptor.Number+(repeatCount+1);
-	}// end of for
+			if(pMediaStreamContext->lastSegmentTime < nextStartTime && !isFirstSegment)
+			{
+				break;
+			}
+			pMediaStreamContext->fragmentDescriptor.Number += (repeatCount+1);
+			pMediaStreamContext->fragmentDescriptor.nextfragmentNum = pMediaStreamContext->fragmentDescriptor.Number+(repeatCount+1);
+		}// end of for
+	}
 
 	/*
 	*  Boundary check added to handle the edge case leading to crash,
@@ -1094,8 +1115,19 @@ uint64_t StreamAbstractionAAMP_MPD::FindPositionInTimeline(class MediaStreamCont
 	// Now we reached the right row , need to traverse the repeat index to reach right node
 	// Whenever new fragments arrive inside the same timeline update fragment number,repeat count and startNumber.
 	// If first fragment start Number is zero, check lastSegmentDuration of period timeline for update.
-	while((pMediaStreamContext->fragmentRepeatCount < repeatCount && startTime < pMediaStreamContext->lastSegmentTime) ||
-		(startTime == 0 && pMediaStreamContext->lastSegmentTime == 0 && pMediaStreamContext->lastSegmentDuration != 0))
+	if(pMediaStreamContext->fragmentRepeatCount < repeatCount && startTime < pMediaStreamContext->lastSegmentTime)
+	{ // step over the whole repeats at once
+		uint32_t steps = repeatCount - pMediaStreamContext->fragmentRepeatCount;
+		if(duration)
+		{
+			steps = std::min<uint64_t>(steps, (pMediaStreamContext->lastSegmentTime - startTime + duration - 1) / duration);
+		}
+		startTime += (uint64_t)steps * duration;
+		pMediaStreamContext->fragmentDescriptor.Number += steps;
+		pMediaStreamContext->fragmentRepeatCount += steps;
+		pMediaStreamContext->fragmentDescriptor.nextfragmentNum = pMediaStreamContext->fragmentDescriptor.Number+1;
+	}
+	while(startTime == 0 && pMediaStreamContext->lastSegmentTime == 0 && pMediaStreamContext->lastSegmentDuration != 0)
 	{
 		startTime += duration;
 		pMediaStreamContext->fragmentDescriptor.Number++;
@@ -2501,6 +2533,56 @@ double StreamAbstractionAAMP_MPD::SkipFragments( MediaStreamContext *pMediaStrea
 						}
 					}
 
+					if (!skipToEnd && skipTime >= 2 * fragmentDuration && timeScale &&
+						pMediaStreamContext->fragmentRepeatCount >= 0 && pMediaStreamContext->fragmentRepeatCount <= repeatCount &&
+						pMediaStreamContext->segmentTimelineIndex.Update(timelines))
+					{ // Seeking forward over many segments: jump to the one before the target using the packed index, the loop takes the final steps
+						SegmentTimelineIndex &segmentTimelineIndex = pMediaStreamContext->segmentTimelineIndex;
+						int row = pMediaStreamContext->timeLineIndex;
+						uint32_t repeatIndex = pMediaStreamContext->fragmentRepeatCount;
+						uint64_t mediaOffset = segmentTimelineIndex.GetMediaOffset(row, repeatIndex);
+						uint64_t segmentIndex = segmentTimelineIndex.GetSegmentIndex(row, repeatIndex);
+						int targetRow;
+						uint32_t targetRepeat;
+						segmentTimelineIndex.FindMediaOffset(mediaOffset + (uint64_t)(skipTime * timeScale), targetRow, targetRepeat);
+						uint64_t targetIndex = segmentTimelineIndex.GetSegmentIndex(targetRow, targetRepeat);
+						if (targetIndex > segmentIndex + 1)
+						{
+							// As in the steps below, Time restarts at the t of each S element crossed and otherwise keeps counting from its current value
+							auto segmentTime = [&](int toRow, uint32_t toRepeat) -> double
+							{
+								int startRow = toRow;
+								while (startRow > row && (segmentTimelineIndex.GetRun(startRow).flags & SegmentTimelineIndex::eRUN_IMPLICIT_START))
+								{
+									startRow--;
+								}
+								uint64_t time = segmentTimelineIndex.GetSegmentTime(toRow, toRepeat);
+								if (startRow == row)
+								{
+									return pMediaStreamContext->fragmentDescriptor.Time + (double)(time - segmentTimelineIndex.GetSegmentTime(row, repeatIndex));
+								}
+								return (double)time;
+							};
+							int lastRow, nextRow;
+							uint32_t lastRepeat, nextRepeat;
+							segmentTimelineIndex.FindSegment(targetIndex - 2, lastRow, lastRepeat);
+							segmentTimelineIndex.FindSegment(targetIndex - 1, nextRow, nextRepeat);
+							if (updateFirstPTS)
+							{
+								pMediaStreamContext->lastSegmentTime = segmentTime(lastRow, lastRepeat);
+								pMediaStreamContext->lastSegmentDuration = pMediaStreamContext->lastSegmentTime + segmentTimelineIndex.GetRun(lastRow).duration;
+							}
+							double skippedDuration = (double)(segmentTimelineIndex.GetMediaOffset(nextRow, nextRepeat) - mediaOffset) / timeScale;
+							skipTime -= skippedDuration;
+							pMediaStreamContext->fragmentTime += skippedDuration;
+							pMediaStreamContext->fragmentDescriptor.Time = segmentTime(nextRow, nextRepeat);
+							pMediaStreamContext->fragmentDescriptor.Number += (targetIndex - 1 - segmentIndex);
+							pMediaStreamContext->timeLineIndex = nextRow;
+							pMediaStreamContext->fragmentRepeatCount = nextRepeat;
+							continue;  /* continue from the segment before the target */
+						}
+					}
+
 					if (skipToEnd)
 					{
 						if ((pMediaStreamContext->fragmentRepeatCount == repeatCount) &&
@@ -3403,8 +3485,20 @@ void StreamAbstractionAAMP_MPD::QueueContentProtection(IPeriod* period, uint32_t
 							/** Queue protection event to the pipeline **/
 							licenseMgr->QueueProtectionEvent(drmHelper, period->GetId(), adaptationSetIdx, mediaType);
 						}
-						/** Queue content protection in DRM license fetcher **/
-						licenseMgr->QueueContentProtection(drmHelper, period->GetId(), adaptationSetIdx, mediaType, isVssPeriod);
+						/** Queue content protection in DRM license fetcher, with the time until the period plays for prioritization **/
+						double timeToPlay = 0;
+						if (period != mCurrentPeriod && mpd && mMPDParseHelper)
+						{
+							const auto &periods = mpd->GetPeriods();
+							auto iter = std::find(periods.begin(), periods.end(), period);
+							if (iter != periods.end())
+							{
+								// Period start and player position share the MPD timeline; a period already reached plays now
+								double periodStart = mMPDParseHelper->GetPeriodStartTime((int)(iter - periods.begin()), mLastPlaylistDownloadTimeMs);
+								timeToPlay = std::max(0.0, periodStart - aamp->GetPositionSeconds());
+							}
+						}
+						licenseMgr->QueueContentProtection(drmHelper, period->GetId(), adaptationSetIdx, mediaType, isVssPeriod, timeToPlay);
 					}
 					hasDrm = true;
 					aamp->licenceFromManifest = true;
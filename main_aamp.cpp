@@ -26,6 +26,9 @@
 #include "main_aamp.h"
 #include "AampConfig.h"
 #include "AampCacheHandler.h"
+#include "AampBufferPool.h"
+#include "AampThreadPool.h"
+#include "AampDiskCache.h"
 #include "AampUtils.h"
 #include "PlayerCCManager.h"
 #include "DrmHelper.h"
@@ -93,6 +96,12 @@ PlayerInstanceAAMP::PlayerInstanceAAMP(StreamSink* streamSink
 		gpGlobalConfig->ReadOperatorConfiguration();
 		gpGlobalConfig->ShowDevCfgConfiguration();
 		gpGlobalConfig->ShowOperatorSetConfiguration();
+
+		// The buffer pool, thread pool and disk cache are shared by all players in the process, so they follow the process config only
+		AampBufferPool::SetEnabled(gpGlobalConfig->IsConfigSet(eAAMPConfig_UseBufferPool));
+		AampThreadPool::SetEnabled(gpGlobalConfig->IsConfigSet(eAAMPConfig_UseThreadPool));
+		AampDiskCache::GetInstance().Configure(gpGlobalConfig->IsConfigSet(eAAMPConfig_EnableDiskCache), gpGlobalConfig->GetConfigValue(eAAMPConfig_DiskCacheLocation),
+			(size_t)gpGlobalConfig->GetConfigValue(eAAMPConfig_DiskCacheMaxSize) * 1024, gpGlobalConfig->GetConfigValue(eAAMPConfig_DiskCacheTTL)); // max size configured in KB
 	}
 
 #ifdef SUPPORT_JS_EVENTS
@@ -115,6 +124,7 @@ PlayerInstanceAAMP::PlayerInstanceAAMP(StreamSink* streamSink
 
 	// sd_journal logging doesn't work with AAMP/Rialto running in Container, so route to Ethan Logger instead
 	AampLogManager::enableEthanLogRedirection = mConfig.IsConfigSet(eAAMPConfig_useRialtoSink);
+	AampLogManager::setAsyncLogging(mConfig.IsConfigSet(eAAMPConfig_AsyncLogging));
 
 	PlayerLogManager::SetLoggerInfo(AampLogManager::disableLogRedirection, AampLogManager::enableEthanLogRedirection, AampLogManager::aampLoglevel, AampLogManager::locked);
 	
@@ -3217,6 +3227,7 @@ bool PlayerInstanceAAMP::InitAAMPConfig(const char *jsonStr)
 
 	// also enable Ethan log redirection if useRialtoSink enabled using initconfig option.
 	AampLogManager::enableEthanLogRedirection = ISCONFIGSET(eAAMPConfig_useRialtoSink);
+	AampLogManager::setAsyncLogging(ISCONFIGSET(eAAMPConfig_AsyncLogging));
 	PlayerLogManager::SetLoggerInfo(AampLogManager::disableLogRedirection, AampLogManager::enableEthanLogRedirection, AampLogManager::aampLoglevel, AampLogManager::locked);
 	return retVal;
 }
@@ -1257,6 +1257,7 @@ void InterfacePlayerRDK::TearDownStream(GstMediaType mediaType)
 		stream->format = GST_FORMAT_INVALID;
 		g_clear_object(&stream->sinkbin);
 		g_clear_object(&stream->source);
+		stream->ReleaseBufferPool();
 		stream->sourceConfigured = false;
 		pthread_mutex_unlock(&stream->sourceLock);
 	}
@@ -2776,6 +2777,133 @@ void InterfacePlayerRDK::SetPlayerName(std::string name)
 	mPlayerName = name;
 }
 
+#ifdef SUPPORTS_MP4DEMUX
+#define GST_BUFFER_LIST_POOL_MIN_SIZE (64*1024)	/**< smallest buffer size of a stream's fragment pool */
+#define GST_BUFFER_LIST_POOL_MAX_BUFFERS 16		/**< fragments retained by a stream's pool; beyond that fragments fall back to plain allocation */
+
+/**
+ * @struct FragmentView
+ * @brief Keeps a fragment buffer mapped while the sample buffers of a GstBufferList point into its memory
+ */
+struct FragmentView
+{
+	GstBuffer *buffer;	/**< fragment buffer, returned to its pool (if any) when the last sample is freed */
+	GstMapInfo map;		/**< read mapping of buffer */
+	gint refCount;		/**< one per sample, plus one while the list is being built */
+};
+
+/**
+ * @brief GDestroyNotify of sample buffers; unmaps and releases the fragment with the last sample
+ */
+static void ReleaseFragmentView(gpointer data)
+{
+	FragmentView *view = (FragmentView *)data;
+	if (g_atomic_int_dec_and_test(&view->refCount))
+	{
+		gst_buffer_unmap(view->buffer, &view->map);
+		gst_buffer_unref(view->buffer);
+		g_free(view);
+	}
+}
+
+/**
+ * @brief Get a buffer for a fragment copy from the stream's pool, (re)creating the pool when the fragment does not fit
+ * @param[in] stream - stream the fragment is injected to; called with stream->sourceLock held
+ * @param[in] len - fragment size
+ * @return buffer of size len
+ */
+static GstBuffer *AcquireFragmentBuffer(gst_media_stream *stream, size_t len)
+{
+	GstBuffer *buffer = NULL;
+	if (len > stream->bufferPoolSize)
+	{ // only ever grow; rounding up keeps small variations in fragment size from churning the pool
+		gsize size = GST_BUFFER_LIST_POOL_MIN_SIZE;
+		while (size < len)
+		{
+			size *= 2;
+		}
+		stream->ReleaseBufferPool();
+		GstBufferPool *pool = gst_buffer_pool_new();
+		GstStructure *config = gst_buffer_pool_get_config(pool);
+		gst_buffer_pool_config_set_params(config, NULL, (guint)size, 0, GST_BUFFER_LIST_POOL_MAX_BUFFERS);
+		if (gst_buffer_pool_set_config(pool, config) && gst_buffer_pool_set_active(pool, TRUE))
+		{
+			stream->bufferPool = pool;
+			stream->bufferPoolSize = size;
+		}
+		else
+		{
+			MW_LOG_WARN("Failed to configure fragment buffer pool of size %" G_GSIZE_FORMAT, size);
+			gst_object_unref(pool);
+		}
+	}
+	if (stream->bufferPool)
+	{
+		GstBufferPoolAcquireParams params = {};
+		params.flags = GST_BUFFER_POOL_ACQUIRE_FLAG_DONTWAIT;
+		if (gst_buffer_pool_acquire_buffer(stream->bufferPool, &buffer, &params) == GST_FLOW_OK)
+		{
+			gst_buffer_set_size(buffer, (gssize)len);
+		}
+		else
+		{ // all pooled buffers still in flight
+			buffer = NULL;
+		}
+	}
+	if (!buffer)
+	{
+		buffer = gst_buffer_new_and_alloc((guint)len);
+	}
+	return buffer;
+}
+
+/**
+ * @brief Push the samples of a media fragment as one GstBufferList, each sample a view of the fragment memory
+ * @param[in] appsrc - source to push to
+ * @param[in] buffer - fragment buffer; a reference is taken for as long as any sample is alive
+ * @param[in] ptr - fragment data parsed by mp4Demux, content identical to buffer
+ * @param[in] mp4Demux - parsed fragment
+ * @return result of gst_app_src_push_buffer_list
+ */
+static GstFlowReturn PushSampleBufferList(GstAppSrc *appsrc, GstBuffer *buffer, const void *ptr, Mp4Demux *mp4Demux)
+{
+	GstFlowReturn ret = GST_FLOW_ERROR;
+	FragmentView *view = g_new(FragmentView, 1);
+	if (gst_buffer_map(buffer, &view->map, GST_MAP_READ))
+	{
+		view->buffer = gst_buffer_ref(buffer);
+		view->refCount = 1;
+		int count = mp4Demux->count();
+		GstBufferList *bufferList = gst_buffer_list_new_sized(count);
+		for( int i=0; i<count; i++ )
+		{
+			size_t offset = (size_t)(mp4Demux->getPtr(i) - (const uint8_t *)ptr);
+			size_t len = mp4Demux->getLen(i);
+			if( offset + len <= view->map.size )
+			{
+				g_atomic_int_inc(&view->refCount);
+				GstBuffer *sample = gst_buffer_new_wrapped_full(GST_MEMORY_FLAG_READONLY, view->map.data + offset, len, 0, len, view, ReleaseFragmentView);
+				GST_BUFFER_PTS(sample) = (GstClockTime)(mp4Demux->getPts(i) * GST_SECOND);
+				GST_BUFFER_DTS(sample) = (GstClockTime)(mp4Demux->getDts(i) * GST_SECOND);
+				GST_BUFFER_DURATION(sample) = (GstClockTime)(mp4Demux->getDuration(i) * 1000000000LL);
+				gst_buffer_list_add(bufferList, sample);
+			}
+			else
+			{
+				MW_LOG_WARN("sample %d [%zu+%zu] exceeds fragment size %" G_GSIZE_FORMAT, i, offset, len, view->map.size);
+			}
+		}
+		ReleaseFragmentView(view);
+		ret = gst_app_src_push_buffer_list(appsrc, bufferList);
+	}
+	else
+	{
+		g_free(view);
+	}
+	return ret;
+}
+#endif // SUPPORTS_MP4DEMUX
+
 /**
  *  @brief Inject stream buffer to gstreamer pipeline
  */
@@ -2856,7 +2984,16 @@ bool InterfacePlayerRDK::SendHelper(int type, const void *ptr, size_t len, doubl
 
 		if(copy)
 		{
-			buffer = gst_buffer_new_and_alloc((guint)len);
+#ifdef SUPPORTS_MP4DEMUX
+			if (m_gstConfigParam->useMp4Demux && m_gstConfigParam->useBufferList)
+			{
+				buffer = AcquireFragmentBuffer(stream, len);
+			}
+			else
+#endif // SUPPORTS_MP4DEMUX
+			{
+				buffer = gst_buffer_new_and_alloc((guint)len);
+			}
 
 			if (buffer)
 			{
@@ -2913,7 +3050,24 @@ bool InterfacePlayerRDK::SendHelper(int type, const void *ptr, size_t len, doubl
 				// some lldash streams don't have timescale in media segments
 				Mp4Demux *mp4Demux = new Mp4Demux(ptr,len,timescale[mediaType]);
 				int count = mp4Demux->count();
-				if( count>0 )
+				if( count>0 && m_gstConfigParam->useBufferList )
+				{ // media segment, all samples in one push
+					GstFlowReturn ret = PushSampleBufferList(GST_APP_SRC(stream->source), buffer, ptr, mp4Demux);
+					if( ret == GST_FLOW_OK )
+					{
+						stream->bufferUnderrun = false;
+						if( isFirstBuffer )
+						{
+							firstBufferPushed = true;
+							stream->firstBufferProcessed = true;
+						}
+					}
+					else
+					{
+						MW_LOG_ERR("gst_app_src_push_buffer_list error: %d[%s] mediaType %d", ret, gst_flow_get_name (ret), (int)mediaType);
+					}
+				}
+				else if( count>0 )
 				{ // media segment
 					for( int i=0; i<count; i++ )
 					{
@@ -2948,10 +3102,8 @@ bool InterfacePlayerRDK::SendHelper(int type, const void *ptr, size_t len, doubl
 					mp4Demux->setCaps( GST_APP_SRC(stream->source) );
 				}
 				delete mp4Demux;
-				if( !copy )
-				{
-					g_free((gpointer)ptr);
-				}
+				// fragment memory (ptr itself, if transferred) is owned by buffer and, in list mode, by the pushed samples
+				gst_buffer_unref(buffer);
 			}
 			else
 #endif // SUPPORTS_MP4DEMUX
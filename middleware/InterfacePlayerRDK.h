@@ -121,6 +121,7 @@ struct Configs
 	int monitorAvsyncThresholdNegativeMs;
 	int monitorAvJumpThresholdMs;
 	bool useMp4Demux;
+	bool useBufferList; /**< with useMp4Demux, push each fragment as a GstBufferList of sample views */
 };
 
 typedef enum
@@ -220,10 +221,13 @@ struct gst_media_stream
 	bool firstBufferProcessed; /**< Indicates if the first buffer is processed in this stream */
 	GstPad *demuxPad;		   /**< Demux src pad >*/
 	gulong demuxProbeId;	   /**< Demux pad probe ID >*/
+	GstBufferPool *bufferPool; /**< recycles fragment memory when injecting buffer lists */
+	gsize bufferPoolSize;	   /**< size of the buffers in bufferPool */
 
 	gst_media_stream() : sinkbin(NULL), source(NULL), format(GST_FORMAT_INVALID),
 						 pendingSeek(false), resetPosition(false),
-						 bufferUnderrun(false), eosReached(false), sourceConfigured(false), sourceLock(PTHREAD_MUTEX_INITIALIZER), timeScale(1), trackId(-1), firstBufferProcessed(false), demuxPad(NULL), demuxProbeId(0)
+						 bufferUnderrun(false), eosReached(false), sourceConfigured(false), sourceLock(PTHREAD_MUTEX_INITIALIZER), timeScale(1), trackId(-1), firstBufferProcessed(false), demuxPad(NULL), demuxProbeId(0),
+						 bufferPool(NULL), bufferPoolSize(0)
 	{
 	}
 
@@ -231,6 +235,21 @@ struct gst_media_stream
 	{
 		g_clear_object(&sinkbin);
 		g_clear_object(&source);
+		ReleaseBufferPool();
+	}
+
+	/**
+	 * @brief Deactivate and drop bufferPool; buffers still in flight are freed when returned
+	 */
+	void ReleaseBufferPool()
+	{
+		if (bufferPool)
+		{
+			gst_buffer_pool_set_active(bufferPool, FALSE);
+			gst_object_unref(bufferPool);
+			bufferPool = NULL;
+			bufferPoolSize = 0;
+		}
 	}
 
 	gst_media_stream(const gst_media_stream &) = delete;
@@ -34,16 +34,20 @@
 
 #include <openssl/err.h>
 #include <sys/time.h>
-#include <gst/base/gstbytereader.h>
+#include <algorithm>
 
 #define AES_CTR_KID_LEN 16
 #define AES_CTR_IV_LEN 16
 #define AES_CTR_KEY_LEN 16
+#define AES_BLOCK_LEN 16
+#define SUBSAMPLE_ENTRY_LEN 6
 
 #if OPENSSL_VERSION_NUMBER >= 0x10100000L
 #define OPEN_SSL_CONTEXT mOpensslCtx
+#define OPEN_SSL_CBC_CONTEXT mOpensslCbcCtx
 #else
 #define OPEN_SSL_CONTEXT &mOpensslCtx
+#define OPEN_SSL_CBC_CONTEXT &mOpensslCbcCtx
 #endif
 
 
@@ -57,9 +61,11 @@ ClearKeySession::ClearKeySession() :
 		decryptMutex(),
 		m_keyId(NULL),
 		mOpensslCtx(),
+		mOpensslCbcCtx(),
 		m_keyStr(NULL),
 		m_keyLen(0),
-		m_keyIdLen(0)
+		m_keyIdLen(0),
+		m_cipherReady(false)
 {
 	initDRMSession();
 }
@@ -72,12 +78,53 @@ void ClearKeySession::initDRMSession()
 {
 #if OPENSSL_VERSION_NUMBER >= 0x10100000L
 	OPEN_SSL_CONTEXT = EVP_CIPHER_CTX_new();
+	OPEN_SSL_CBC_CONTEXT = EVP_CIPHER_CTX_new();
 #else
 	EVP_CIPHER_CTX_init(OPEN_SSL_CONTEXT);
+	EVP_CIPHER_CTX_init(OPEN_SSL_CBC_CONTEXT);
 #endif
 	MW_LOG_ERR("ClearKeySession: enter ");
 }
 
+/**
+ * @brief Key the cipher contexts once per key; each decrypt then only sets the IV
+ */
+bool ClearKeySession::initCipherContexts()
+{
+	m_cipherReady = false;
+#if OPENSSL_VERSION_NUMBER >= 0x10100000L
+	if (!OPEN_SSL_CONTEXT)
+	{
+		OPEN_SSL_CONTEXT = EVP_CIPHER_CTX_new();
+	}
+	if (!OPEN_SSL_CBC_CONTEXT)
+	{
+		OPEN_SSL_CBC_CONTEXT = EVP_CIPHER_CTX_new();
+	}
+	if (!OPEN_SSL_CONTEXT || !OPEN_SSL_CBC_CONTEXT)
+	{
+		MW_LOG_ERR("ClearKeySession: EVP_CIPHER_CTX_new failed");
+		return false;
+	}
+#endif
+	if (!m_keyStr)
+	{
+		MW_LOG_ERR("ClearKeySession: no key");
+	}
+	else if (!EVP_DecryptInit_ex(OPEN_SSL_CONTEXT, EVP_aes_128_ctr(), NULL, m_keyStr, NULL) ||
+			 !EVP_DecryptInit_ex(OPEN_SSL_CBC_CONTEXT, EVP_aes_128_cbc(), NULL, m_keyStr, NULL))
+	{
+		MW_LOG_ERR("ClearKeySession: EVP_DecryptInit_ex failed");
+	}
+	else
+	{
+		// subsample ranges are whole blocks in 'cbcs', there is no padding to remove
+		EVP_CIPHER_CTX_set_padding(OPEN_SSL_CBC_CONTEXT, 0);
+		m_cipherReady = true;
+	}
+	return m_cipherReady;
+}
+
 /**
  * @brief SetKid for this session.
  */
@@ -180,8 +227,14 @@ ClearKeySession::~ClearKeySession()
 		EVP_CIPHER_CTX_free(OPEN_SSL_CONTEXT);
 		OPEN_SSL_CONTEXT = NULL;
 	}
+	if( OPEN_SSL_CBC_CONTEXT )
+	{
+		EVP_CIPHER_CTX_free(OPEN_SSL_CBC_CONTEXT);
+		OPEN_SSL_CBC_CONTEXT = NULL;
+	}
 #else
 	EVP_CIPHER_CTX_cleanup(OPEN_SSL_CONTEXT);
+	EVP_CIPHER_CTX_cleanup(OPEN_SSL_CBC_CONTEXT);
 #endif
     if(m_keyId != NULL)
     {
@@ -284,6 +337,8 @@ int ClearKeySession::processDRMKey(DrmData* key, uint32_t timeout)
 					unsigned char * resKeyId = base64_URL_Decode(keyIdStr,	&resKeyIdLen, strlen(keyIdStr));
 					if (resKeyIdLen == m_keyIdLen && 0 == memcmp(m_keyId, resKeyId, m_keyIdLen))
 					{
+						std::lock_guard<std::mutex> guard(decryptMutex);
+						m_cipherReady = false;
 						if (m_keyStr != NULL)
 						{
 							free (m_keyStr);
@@ -344,27 +399,20 @@ int ClearKeySession::processDRMKey(DrmData* key, uint32_t timeout)
 int ClearKeySession::decrypt(GstBuffer* keyIDBuffer, GstBuffer* ivBuffer, GstBuffer* buffer, unsigned subSampleCount,
                 GstBuffer* subSamplesBuffer, GstCaps* caps)
 {
-#if 0
-	GstBuffer* KeyIdBuffer = (GstBuffer*)keyIDBufferIn;
-	GstBuffer* ivBuffer = (GstBuffer*)ivBufferIn;
-	GstBuffer* buffer = (GstBuffer*)bufferIn;
-	GstCaps* caps = (GstCaps*)capsIn;
-#endif
 	int retVal = 1;
-	uint8_t *pbData = NULL;
-	uint32_t cbData = 0;
-	uint16_t nBytesClear = 0;
-	uint32_t nBytesEncrypted = 0;
 
 	GstMapInfo ivMap;
 	GstMapInfo subsampleMap = GST_MAP_INFO_INIT;
 	GstMapInfo bufferMap;
-	GstByteReader* reader = NULL;
 
 	bool ivMapped = false;
 	bool subSampleMapped = false;
 	bool bufferMapped = false;
 
+	bool cbcs = false;
+	guint cryptByteBlock = 0;
+	guint skipByteBlock = 0;
+
 	if(!(ivBuffer && buffer && (subSampleCount == 0 || subSamplesBuffer)))
 	{
 		MW_LOG_ERR(
@@ -393,100 +441,38 @@ int ClearKeySession::decrypt(GstBuffer* keyIDBuffer, GstBuffer* ivBuffer, GstBuf
 				MW_LOG_ERR("ClearKeySession: ERROR : Failed to map subSamplesBuffer");
 			}
 		}
-	}
 
-	if(bufferMapped && ivMapped && (subSampleCount ==0 || subSampleMapped))
-	{
-		reader = gst_byte_reader_new(subsampleMap.data, (guint)subsampleMap.size);
-		if(reader)
+		// 'cbcs' scheme and pattern are signalled in the protection meta, as documented for opencdm_gstreamer_session_decrypt
+		GstProtectionMeta* protectionMeta = reinterpret_cast<GstProtectionMeta*>(gst_buffer_get_protection_meta(buffer));
+		if (protectionMeta && protectionMeta->info)
 		{
-			// collect all the encrypted bytes into one contiguous buffer
-			// we need to call decrypt once for all encrypted bytes.
-			if (subSampleCount > 0)
-			{
-				pbData = (uint8_t *) malloc(sizeof(uint8_t) * bufferMap.size);
-				uint8_t *pbCurrTarget = (uint8_t *) pbData;
-				uint32_t iCurrSource = 0;
-
-		        for (int i = 0; i < subSampleCount; i++)
-		        {
-					if (!gst_byte_reader_get_uint16_be(reader, &nBytesClear)
-							|| !gst_byte_reader_get_uint32_be(reader, &nBytesEncrypted))
-					{
-						MW_LOG_ERR("ClearKeySession: ERROR : Failed to read from subsamples reader");
-						cbData = 0;
-						break;
-					}
-					// Skip the clear byte range from source buffer.
-					iCurrSource += nBytesClear;
-
-					// Copy cipher bytes from f_pbData to target buffer.
-					memcpy(pbCurrTarget, (uint8_t*) bufferMap.data + iCurrSource, nBytesEncrypted);
-
-					// Adjust current pointer of target buffer.
-					pbCurrTarget += nBytesEncrypted;
-
-					// Adjust current offset of source buffer.
-					iCurrSource += nBytesEncrypted;
-					cbData += nBytesEncrypted;
-				}
-			}
-	        else
-	        {
-				pbData = bufferMap.data;
-				cbData = (uint32_t)bufferMap.size;
-	        }
-
-			if(cbData != 0)
+			const gchar *cipherMode = gst_structure_get_string(protectionMeta->info, "cipher-mode");
+			if (cipherMode && 0 == strcmp(cipherMode, "cbcs"))
 			{
-				retVal = decrypt(static_cast<uint8_t *>(ivMap.data), static_cast<uint32_t>(ivMap.size),
-			            pbData, cbData, NULL);
+				cbcs = true;
+				gst_structure_get_uint(protectionMeta->info, "crypt_byte_block", &cryptByteBlock);
+				gst_structure_get_uint(protectionMeta->info, "skip_byte_block", &skipByteBlock);
 			}
+		}
+	}
 
-			if(retVal == 0)
-			{
-				if(subSampleCount > 0)
-				{
-					// If subsample mapping is used, copy decrypted bytes back
-					// to the original buffer.
-					gst_byte_reader_set_pos(reader, 0);
-					uint8_t *pbCurrTarget = bufferMap.data;
-					uint32_t iCurrSource = 0;
-
-			        for (int i = 0; i < subSampleCount; i++)
-			        {
-						if (!gst_byte_reader_get_uint16_be(reader, &nBytesClear)
-								|| !gst_byte_reader_get_uint32_be(reader, &nBytesEncrypted))
-						{
-							MW_LOG_ERR("ClearKeySession: ERROR : Failed to read from subsamples reader");
-							retVal = 1;
-							break;
-						}
-						// Skip the clear byte range from target buffer.
-						pbCurrTarget += nBytesClear;
-						memcpy(pbCurrTarget, pbData + iCurrSource, nBytesEncrypted);
-
-						// Adjust current pointer of target buffer.
-						pbCurrTarget += nBytesEncrypted;
-
-						// Adjust current offset of source buffer.
-						iCurrSource += nBytesEncrypted;
-					}
-				}//SubSample end if
-			} //retVal end if
-
-			gst_byte_reader_free(reader);
-		}//reader end if
+	if(bufferMapped && ivMapped && (subSampleCount ==0 || subSampleMapped))
+	{
+		std::lock_guard<std::mutex> guard(decryptMutex);
+		if (m_eKeyState == KEY_READY)
+		{
+			// subsamples are walked in place, encrypted ranges are decrypted where they are
+			retVal = decryptInPlace(static_cast<uint8_t *>(ivMap.data), static_cast<uint32_t>(ivMap.size),
+					bufferMap.data, static_cast<uint32_t>(bufferMap.size),
+					subSampleCount > 0 ? subsampleMap.data : NULL, subsampleMap.size, subSampleCount,
+					cbcs, cryptByteBlock, skipByteBlock);
+		}
 		else
 		{
-			MW_LOG_ERR("ClearKeySession: ERROR : Failed to allocate subsample reader");
+			MW_LOG_ERR( "ClearKeySession: key not ready! mDrmState = %d", m_eKeyState);
 		}
 	}
 
-	if(subSampleCount > 0 && pbData)
-	{
-		free(pbData);
-	}
 	if(bufferMapped)
 	{
 		gst_buffer_unmap(buffer, &bufferMap);
@@ -504,86 +490,116 @@ int ClearKeySession::decrypt(GstBuffer* keyIDBuffer, GstBuffer* ivBuffer, GstBuf
 }
 
 /**
- * @brief Function to decrypt stream  buffer.
+ * @brief Decrypt a range of a sample in place, continuing the cipher state of previous ranges
  */
-int ClearKeySession::decrypt(const uint8_t *f_pbIV, uint32_t f_cbIV,
-		const uint8_t *payloadData, uint32_t payloadDataSize, uint8_t **ppOpaqueData=NULL)
+static bool decryptRange(EVP_CIPHER_CTX *ctx, uint8_t *data, uint32_t size, bool cbcs, uint32_t cryptByteBlock, uint32_t skipByteBlock)
 {
-	int status = 1;
-	std::lock_guard<std::mutex> guard(decryptMutex);
-	if (m_eKeyState == KEY_READY)
+	int decLen = 0;
+	if (!cbcs)
 	{
-		uint8_t *decryptedDataBuf = (uint8_t *)malloc(payloadDataSize);
-		uint32_t decryptedDataLen = 0;
-		uint8_t *ivBuff = NULL;
-		if(decryptedDataBuf)
+		// 'cenc': the CTR key stream runs across all encrypted ranges of the sample
+		return size == 0 || EVP_DecryptUpdate(ctx, data, &decLen, data, (int)size);
+	}
+	// 'cbcs': a trailing partial block is left clear; without a pattern every whole block is encrypted
+	uint32_t cryptLen = (cryptByteBlock == 0) ? size : cryptByteBlock * AES_BLOCK_LEN;
+	uint32_t skipLen = (cryptByteBlock == 0) ? 0 : skipByteBlock * AES_BLOCK_LEN;
+	while (size >= AES_BLOCK_LEN)
+	{
+		uint32_t len = std::min(cryptLen, size - (size % AES_BLOCK_LEN));
+		if (!EVP_DecryptUpdate(ctx, data, &decLen, data, (int)len))
 		{
-			memset(decryptedDataBuf, 0, payloadDataSize);
-			if(f_cbIV == 8)//8 byte IV need to pad with 0 before decrypt
-			{
-				ivBuff = (uint8_t *)malloc(sizeof(uint8_t) * AES_CTR_IV_LEN);
-				if(ivBuff != NULL)
-				{
-					memset(ivBuff + 8, 0, 8);
-					memcpy(ivBuff, f_pbIV, 8);
-				}
-			}
-			else if(f_cbIV == AES_CTR_IV_LEN)
-			{
-				ivBuff = (uint8_t *)malloc(sizeof(uint8_t) * AES_CTR_IV_LEN);
-				memcpy(ivBuff, f_pbIV, AES_CTR_IV_LEN);
-			}
-			else
-			{
-				MW_LOG_TRACE("ClearKeySession: invalid IV size %u", f_cbIV);
-			}
+			return false;
 		}
+		data += len;
+		size -= len;
+		len = std::min(skipLen, size);
+		data += len;
+		size -= len;
+	}
+	return true;
+}
 
-		if (decryptedDataBuf && ivBuff)
+/**
+ * @brief Decrypt a sample in place, walking its subsample map directly
+ */
+int ClearKeySession::decryptInPlace(const uint8_t *f_pbIV, uint32_t f_cbIV, uint8_t *data, uint32_t dataSize,
+		const uint8_t *subSamples, size_t subSamplesSize, unsigned subSampleCount,
+		bool cbcs, uint32_t cryptByteBlock, uint32_t skipByteBlock)
+{
+	uint8_t ivBuff[AES_CTR_IV_LEN] = {0};
+	if(f_cbIV == 8 || f_cbIV == AES_CTR_IV_LEN)//8 byte IV is padded with 0
+	{
+		memcpy(ivBuff, f_pbIV, f_cbIV);
+	}
+	else
+	{
+		MW_LOG_TRACE("ClearKeySession: invalid IV size %u", f_cbIV);
+		return 1;
+	}
+	if (!m_cipherReady && !initCipherContexts())
+	{
+		return 1;
+	}
+	EVP_CIPHER_CTX *ctx = cbcs ? OPEN_SSL_CBC_CONTEXT : OPEN_SSL_CONTEXT;
+	if (!EVP_DecryptInit_ex(ctx, NULL, NULL, NULL, ivBuff))
+	{
+		MW_LOG_TRACE( "ClearKeySession: EVP_DecryptInit_ex failed");
+		return 1;
+	}
+	if (subSampleCount == 0)
+	{
+		if (!decryptRange(ctx, data, dataSize, cbcs, cryptByteBlock, skipByteBlock))
 		{
-			uint32_t decLen = payloadDataSize;
-
-			if(!EVP_DecryptInit_ex(OPEN_SSL_CONTEXT, EVP_aes_128_ctr(), NULL, m_keyStr, ivBuff))
-			{
-				MW_LOG_TRACE( "ClearKeySession: EVP_DecryptInit_ex failed");
-			}
-			else
-			{
-				if (!EVP_DecryptUpdate(OPEN_SSL_CONTEXT,(unsigned char*) decryptedDataBuf, (int*) &decLen, (const unsigned char*) payloadData,
-					payloadDataSize))
-				{
-					MW_LOG_TRACE("ClearKeySession: EVP_DecryptUpdate failed");
-				}
-				else
-				{
-					decryptedDataLen = decLen;
-					decLen = 0;
-					MW_LOG_TRACE("ClearKeySession: EVP_DecryptUpdate success decryptedDataLen = %d payload Data length = %d", (int) decryptedDataLen, (int)payloadDataSize);
-					if (!EVP_DecryptFinal_ex(OPEN_SSL_CONTEXT, (unsigned char*) (decryptedDataBuf + decryptedDataLen), (int*) &decLen))
-					{
-						MW_LOG_TRACE("ClearKeySession: EVP_DecryptFinal_ex failed mDrmState = %d", (int) m_eKeyState);
-					}
-					else
-					{
-						decryptedDataLen += decLen;
-						MW_LOG_TRACE("ClearKeySession: decrypt success");
-						status = 0;
-					}
-				}
-			}
-
-			memcpy((void *)payloadData, decryptedDataBuf, payloadDataSize);
+			MW_LOG_TRACE("ClearKeySession: EVP_DecryptUpdate failed");
+			return 1;
 		}
-		if(ivBuff)
+		return 0;
+	}
+	if (!subSamples || subSamplesSize < (size_t)subSampleCount * SUBSAMPLE_ENTRY_LEN)
+	{
+		MW_LOG_ERR("ClearKeySession: ERROR : subsample map too short, count %u size %zu", subSampleCount, subSamplesSize);
+		return 1;
+	}
+	uint64_t offset = 0;
+	for (unsigned i = 0; i < subSampleCount; i++)
+	{
+		const uint8_t *entry = subSamples + i * SUBSAMPLE_ENTRY_LEN;
+		uint32_t nBytesClear = ((uint32_t)entry[0] << 8) | entry[1];
+		uint32_t nBytesEncrypted = ((uint32_t)entry[2] << 24) | ((uint32_t)entry[3] << 16) | ((uint32_t)entry[4] << 8) | entry[5];
+		offset += nBytesClear;
+		if (offset + nBytesEncrypted > dataSize)
 		{
-			free(ivBuff);  //CID:108053 - Resource leak
-			ivBuff = NULL;
+			MW_LOG_ERR("ClearKeySession: ERROR : subsample %u exceeds sample size %u", i, dataSize);
+			return 1;
 		}
-		if(decryptedDataBuf)
+		// the CBC chain restarts from the constant IV for each subsample
+		if (cbcs && i > 0 && !EVP_DecryptInit_ex(ctx, NULL, NULL, NULL, ivBuff))
 		{
-			free(decryptedDataBuf);
-			decryptedDataBuf = NULL;
+			MW_LOG_TRACE( "ClearKeySession: EVP_DecryptInit_ex failed");
+			return 1;
 		}
+		if (!decryptRange(ctx, data + offset, nBytesEncrypted, cbcs, cryptByteBlock, skipByteBlock))
+		{
+			MW_LOG_TRACE("ClearKeySession: EVP_DecryptUpdate failed");
+			return 1;
+		}
+		offset += nBytesEncrypted;
+	}
+	MW_LOG_TRACE("ClearKeySession: decrypt success");
+	return 0;
+}
+
+/**
+ * @brief Function to decrypt stream  buffer.
+ */
+int ClearKeySession::decrypt(const uint8_t *f_pbIV, uint32_t f_cbIV,
+		const uint8_t *payloadData, uint32_t payloadDataSize, uint8_t **ppOpaqueData=NULL)
+{
+	int status = 1;
+	std::lock_guard<std::mutex> guard(decryptMutex);
+	if (m_eKeyState == KEY_READY)
+	{
+		status = decryptInPlace(f_pbIV, f_cbIV, (uint8_t *)payloadData, payloadDataSize, NULL, 0, 0, false, 0, 0);
 	}
 	else
 	{
@@ -606,6 +622,7 @@ KeyState ClearKeySession::getState()
  */
 void ClearKeySession:: clearDecryptContext()
 {
+	std::lock_guard<std::mutex> guard(decryptMutex);
 	if(m_keyId != NULL)
 	{
 		free(m_keyId);
@@ -624,9 +641,16 @@ void ClearKeySession:: clearDecryptContext()
 		EVP_CIPHER_CTX_free(OPEN_SSL_CONTEXT);
 		OPEN_SSL_CONTEXT = NULL;
 	}
+	if( OPEN_SSL_CBC_CONTEXT )
+	{
+		EVP_CIPHER_CTX_free(OPEN_SSL_CBC_CONTEXT);
+		OPEN_SSL_CBC_CONTEXT = NULL;
+	}
 #else
 	EVP_CIPHER_CTX_cleanup(OPEN_SSL_CONTEXT);
+	EVP_CIPHER_CTX_cleanup(OPEN_SSL_CBC_CONTEXT);
 #endif
+	m_cipherReady = false;
 	m_eKeyState = KEY_INIT;
 }
 
@@ -50,14 +50,39 @@ private:
 	size_t m_keyLen;
 	unsigned char* m_keyId;
 	size_t m_keyIdLen;
+	bool m_cipherReady;
 	/**
 	 * @fn initDRMSession
 	 */
 	void initDRMSession();
+	/**
+	 * @fn initCipherContexts
+	 * @retval true if the cipher contexts are keyed with the current key
+	 */
+	bool initCipherContexts();
+	/**
+	 * @fn decryptInPlace
+	 * @param f_pbIV : Initialization vector, 8 or 16 bytes.
+	 * @param f_cbIV : Initialization vector length.
+	 * @param data : Sample to decrypt in place.
+	 * @param dataSize : Size of sample.
+	 * @param subSamples : Subsample map of 6 byte entries (clear bytes uint16 BE, encrypted bytes uint32 BE), NULL if the whole sample is encrypted.
+	 * @param subSamplesSize : Size of subsample map.
+	 * @param subSampleCount : Count of subsample entries.
+	 * @param cbcs : true for 'cbcs' AES-CBC pattern encryption, false for 'cenc' AES-CTR.
+	 * @param cryptByteBlock : Encrypted 16 byte blocks in each pattern, 'cbcs' only.
+	 * @param skipByteBlock : Clear 16 byte blocks in each pattern, 'cbcs' only.
+	 * @retval Returns 0 on success.
+	 */
+	int decryptInPlace(const uint8_t *f_pbIV, uint32_t f_cbIV, uint8_t *data, uint32_t dataSize,
+			const uint8_t *subSamples, size_t subSamplesSize, unsigned subSampleCount,
+			bool cbcs, uint32_t cryptByteBlock, uint32_t skipByteBlock);
 #if OPENSSL_VERSION_NUMBER >= 0x10100000L
 	EVP_CIPHER_CTX *mOpensslCtx;
+	EVP_CIPHER_CTX *mOpensslCbcCtx;
 #else
 	EVP_CIPHER_CTX mOpensslCtx;
+	EVP_CIPHER_CTX mOpensslCbcCtx;
 #endif
 public:
 
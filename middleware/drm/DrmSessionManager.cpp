@@ -37,7 +37,7 @@
 #define INVALID_SESSION_SLOT -1
 #define DEFAULT_CDM_WAIT_TIMEOUT_MS 2000
 
-KeyID::KeyID() : creationTime(0), isFailedKeyId(false), isPrimaryKeyId(false), data()
+KeyID::KeyID() : creationTime(0), lastAccess(0), isFailedKeyId(false), isPrimaryKeyId(false), data()
 {
 }
 
@@ -51,6 +51,11 @@ DrmSessionManager::DrmSessionManager(int maxDrmSessions, void *player, std::func
 		cachedKeyMutex()
 		,mEnableAccessAttributes(true)
 		,mDrmSessionLock()
+		,mSessionReuseLock()
+		,mKeyIdSlots()
+		,mSessionSlots()
+		,mAccessCounter(0)
+		,mReuseStats()
 		,mMaxDRMSessions(maxDrmSessions)
 		,playerSecInstance(nullptr)
 		,mContentSecurityManagerSession()
@@ -99,6 +104,13 @@ void DrmSessionManager::UpdateDRMConfig(
 void DrmSessionManager::clearSessionData()
 {
 	MW_LOG_WARN(" DrmSessionManager:: Clearing session data");
+	{
+		std::lock_guard<std::mutex> guard(cachedKeyMutex);
+		MW_LOG_INFO("DRM session reuse stats hits:%u readyHits:%u misses:%u evictions:%u", mReuseStats.hits, mReuseStats.readyHits, mReuseStats.misses, mReuseStats.evictions);
+		mKeyIdSlots.clear();
+		mSessionSlots.clear();
+		mReuseStats = DrmSessionReuseStats();
+	}
 	for(int i = 0 ; i < mMaxDRMSessions; i++)
 	{
 		if (drmSessionContexts != NULL && drmSessionContexts[i].drmSession != NULL)
@@ -145,6 +157,7 @@ void DrmSessionManager::clearFailedKeyIds()
 		{
 			if(!cachedKeyIDs[i].data.empty())
 			{
+				unindexKeyIds(i);
 				cachedKeyIDs[i].data.clear();
 			}
 			cachedKeyIDs[i].isFailedKeyId = false;
@@ -182,6 +195,7 @@ void DrmSessionManager::clearDrmSession(bool forceClearSession)
 			{
 				MW_LOG_WARN("DrmSessionManager:: Clearing failed Session Data Slot : %d", i);
 				MW_SAFE_DELETE(drmSessionContexts[i].drmSession);
+				setSlotSession(i, NULL);
 			}
 		}
 	}
@@ -317,39 +331,163 @@ bool DrmSessionManager::IsKeyIdProcessed(std::vector<uint8_t> keyIdArray, bool &
 {
 	bool ret = false;
 	std::lock_guard<std::mutex> guard(cachedKeyMutex);
-	for (int sessionSlot = 0; sessionSlot < mMaxDRMSessions; sessionSlot++)
+	auto it = mKeyIdSlots.find(keyIdArray);
+	if (it != mKeyIdSlots.end())
 	{
-		auto keyIDSlot = cachedKeyIDs[sessionSlot].data;
-		if (!keyIDSlot.empty() && keyIDSlot.end() != std::find(keyIDSlot.begin(), keyIDSlot.end(), keyIdArray))
-		{
-			std::string debugStr = PlayerLogManager::getHexDebugStr(keyIdArray);
-			MW_LOG_INFO("Session created/in progress with same keyID %s at slot %d", debugStr.c_str(), sessionSlot);
-			status = !cachedKeyIDs[sessionSlot].isFailedKeyId;
-			ret = true;
-			break;
-		}
+		int sessionSlot = it->second;
+		std::string debugStr = PlayerLogManager::getHexDebugStr(keyIdArray);
+		MW_LOG_INFO("Session created/in progress with same keyID %s at slot %d", debugStr.c_str(), sessionSlot);
+		status = !cachedKeyIDs[sessionSlot].isFailedKeyId;
+		ret = true;
 	}
 	return ret;
 }
 
-
-int DrmSessionManager::getSlotIdForSession(DrmSession* session)
+/**
+ *  @brief Add the key IDs of a slot to the key ID index; caller holds cachedKeyMutex
+ */
+void DrmSessionManager::indexKeyIds(int sessionSlot)
 {
-	int slot = -1;
-	std::lock_guard<std::mutex> guard(mDrmSessionLock);
+	for (auto &keyId : cachedKeyIDs[sessionSlot].data)
+	{
+		// a key ID shared by two slots stays with the slot which got it first
+		mKeyIdSlots.emplace(keyId, sessionSlot);
+	}
+}
 
-	if (drmSessionContexts != NULL)
+/**
+ *  @brief Remove the key IDs of a slot from the key ID index; caller holds cachedKeyMutex
+ */
+void DrmSessionManager::unindexKeyIds(int sessionSlot)
+{
+	for (auto &keyId : cachedKeyIDs[sessionSlot].data)
 	{
-		for (int i = 0; i < mMaxDRMSessions; i++)
+		auto it = mKeyIdSlots.find(keyId);
+		if (it == mKeyIdSlots.end() || it->second != sessionSlot)
 		{
-			if (drmSessionContexts[i].drmSession == session)
+			continue;
+		}
+		mKeyIdSlots.erase(it);
+		// hand over to another slot holding the same key ID, if any
+		for (int index = 0; index < mMaxDRMSessions; index++)
+		{
+			auto &keyIDSlot = cachedKeyIDs[index].data;
+			if (index != sessionSlot && keyIDSlot.end() != std::find(keyIDSlot.begin(), keyIDSlot.end(), keyId))
 			{
-				MW_LOG_INFO("DRM Session found at slot:%d", i);
-				slot = i;
+				mKeyIdSlots.emplace(keyId, index);
 				break;
 			}
 		}
 	}
+}
+
+/**
+ *  @brief Update the session of a slot along with the session index; caller holds the slot sessionMutex
+ */
+void DrmSessionManager::setSlotSession(int sessionSlot, DrmSession *session)
+{
+	std::lock_guard<std::mutex> guard(cachedKeyMutex);
+	for (auto it = mSessionSlots.begin(); it != mSessionSlots.end(); )
+	{
+		it = (it->second == sessionSlot) ? mSessionSlots.erase(it) : std::next(it);
+	}
+	drmSessionContexts[sessionSlot].drmSession = session;
+	if (session != NULL)
+	{
+		mSessionSlots[session] = sessionSlot;
+	}
+}
+
+/**
+ *  @brief Get the session slot lookup counters
+ */
+DrmSessionReuseStats DrmSessionManager::GetSessionReuseStats()
+{
+	std::lock_guard<std::mutex> guard(cachedKeyMutex);
+	return mReuseStats;
+}
+
+/**
+ *  @brief Activate the secure manager session of a reused session; caller holds the slot sessionMutex
+ */
+void DrmSessionManager::activateReusedSession(int sessionSlot)
+{
+	std::lock_guard<std::mutex> guard(mSessionReuseLock);
+	auto slotSession = drmSessionContexts[sessionSlot].drmSession->getSecManagerSession();
+	if (slotSession.isSessionValid() && (!mContentSecurityManagerSession.isSessionValid()) )
+	{
+		// Set the drmSession's ID as mContentSecurityManagerSession so that this code will not be repeated for multiple calls for createDrmSession
+		mContentSecurityManagerSession = slotSession;
+		bool videoMuteState = mIsVideoOnMute;
+		MW_LOG_WARN("Activating re-used DRM, sessionId[%" PRId64 "], with video mute = %d", slotSession.getSessionID(), videoMuteState);
+		ContentSecurityManager::GetInstance()->UpdateSessionState(slotSession.getSessionID(), true);
+	}
+}
+
+/**
+ *  @brief Return the ready session bound to the key ID of drmHelper, without taking mDrmSessionLock.
+ *         Tracks sharing a key ID, and key rotation back to a cached key ID, then do not wait
+ *         for a license acquisition of another key ID in progress.
+ */
+DrmSession* DrmSessionManager::getReadySession(std::shared_ptr<DrmHelper> drmHelper)
+{
+	std::vector<uint8_t> keyIdArray;
+	drmHelper->getKey(keyIdArray);
+	if (keyIdArray.empty())
+	{
+		return nullptr;
+	}
+
+	int sessionSlot = INVALID_SESSION_SLOT;
+	{
+		std::lock_guard<std::mutex> guard(cachedKeyMutex);
+		auto it = mKeyIdSlots.find(keyIdArray);
+		if (it == mKeyIdSlots.end() || cachedKeyIDs[it->second].isFailedKeyId)
+		{
+			return nullptr;
+		}
+		sessionSlot = it->second;
+	}
+
+	std::lock_guard<std::mutex> guard(drmSessionContexts[sessionSlot].sessionMutex);
+	DrmSession *session = drmSessionContexts[sessionSlot].drmSession;
+	if (session == NULL || session->getKeySystem() != drmHelper->ocdmSystemId() || session->getState() != KEY_READY)
+	{
+		return nullptr;
+	}
+	{
+		// the slot may have been bound to other key IDs while cachedKeyMutex was released
+		std::lock_guard<std::mutex> keyGuard(cachedKeyMutex);
+		auto it = mKeyIdSlots.find(keyIdArray);
+		auto &keyIDSlot = cachedKeyIDs[sessionSlot].data;
+		if (it == mKeyIdSlots.end() || it->second != sessionSlot ||
+			keyIDSlot.end() == std::find(keyIDSlot.begin(), keyIDSlot.end(), drmSessionContexts[sessionSlot].data))
+		{
+			return nullptr;
+		}
+		cachedKeyIDs[sessionSlot].creationTime = GetCurrentTimeMS();
+		cachedKeyIDs[sessionSlot].lastAccess = ++mAccessCounter;
+		cachedKeyIDs[sessionSlot].isPrimaryKeyId = false;
+		mReuseStats.hits++;
+		mReuseStats.readyHits++;
+	}
+	activateReusedSession(sessionSlot);
+	MW_LOG_INFO("Found drm session READY at slot %d - Reusing drm session", sessionSlot);
+	return session;
+}
+
+
+int DrmSessionManager::getSlotIdForSession(DrmSession* session)
+{
+	int slot = -1;
+	std::lock_guard<std::mutex> guard(cachedKeyMutex);
+
+	auto it = mSessionSlots.find(session);
+	if (it != mSessionSlots.end())
+	{
+		slot = it->second;
+		MW_LOG_INFO("DRM Session found at slot:%d", slot);
+	}
 
 	if (slot == -1)
 	{
@@ -422,8 +560,25 @@ DrmSession* DrmSessionManager::createDrmSession(int &err, std::shared_ptr<DrmHel
 		return nullptr;
 	}
 
+	if (SessionMgrState::eSESSIONMGR_INACTIVE == sessionMgrState)
+	{
+		MW_LOG_ERR(" SessionManager state inactive, aborting request");
+		return nullptr;
+	}
+
+	DrmSession *readySession = getReadySession(drmHelper);
+	if (readySession)
+	{
+		std::vector<uint8_t> keyId;
+		drmHelper->getKey(keyId);
+		/* custom data is only used for new sessions, so mCustomData is left alone */
+		std::lock_guard<std::mutex> guard(mSessionReuseLock);
+		(void)ContentUpdateCb(drmHelper, streamType, keyId, 0);
+		return readySession;
+	}
+
 	// protect createDrmSession multi-thread calls; found during PR 4.0 DRM testing
-	std::lock_guard<std::mutex> guard(mDrmSessionLock);
+	std::unique_lock<std::mutex> sessionLock(mDrmSessionLock);
 
 	int cdmError = -1;
 	KeyState code = KEY_ERROR;
@@ -453,7 +608,10 @@ DrmSession* DrmSessionManager::createDrmSession(int &err, std::shared_ptr<DrmHel
 	std::vector<uint8_t> keyId;
 	drmHelper->getKey(keyId);
 	/* callback to initiate content protection data update */
-	mCustomData = ContentUpdateCb(drmHelper, streamType , keyId, isContentProcess);
+	{
+		std::lock_guard<std::mutex> reuseGuard(mSessionReuseLock);
+		mCustomData = ContentUpdateCb(drmHelper, streamType , keyId, isContentProcess);
+	}
 	if (code == KEY_READY)
 	{
 		return drmSessionContexts[selectedSlot].drmSession;
@@ -486,6 +644,12 @@ DrmSession* DrmSessionManager::createDrmSession(int &err, std::shared_ptr<DrmHel
 		}
 		return nullptr;
 	}
+
+	// The slot is bound, so its license is acquired under the slot lock only and other slots can be
+	// created and licensed meanwhile. The slot lock is taken first, so that a request for the same key ID
+	// waits for this license rather than finding the session in its INIT state.
+	std::unique_lock<std::mutex> slotLock(drmSessionContexts[selectedSlot].sessionMutex);
+	sessionLock.unlock();
 	code =this->AcquireLicenseCb(drmHelper, selectedSlot, cdmError,  (GstMediaType)streamType, metaDataPtr, false);
 	if (code != KEY_READY)
 	{
@@ -541,7 +705,7 @@ KeyState DrmSessionManager::getDrmSession(int &err, std::shared_ptr<DrmHelper> d
 	std::string keyIdDebugStr = PlayerLogManager::getHexDebugStr(keyIdArray);
 
 	/* Slot Selection
-	* Find drmSession slot by going through cached keyIds
+	* Find drmSession slot in the key ID index
 	* Check if requested keyId is already cached
 	*/
 	int sessionSlot = 0;
@@ -549,32 +713,29 @@ KeyState DrmSessionManager::getDrmSession(int &err, std::shared_ptr<DrmHelper> d
 	{
 		std::lock_guard<std::mutex> guard(cachedKeyMutex);
 
-		for (; sessionSlot < mMaxDRMSessions; sessionSlot++)
+		auto it = mKeyIdSlots.find(keyIdArray);
+		if (it != mKeyIdSlots.end())
 		{
-			auto keyIDSlot = cachedKeyIDs[sessionSlot].data;
-			if (!keyIDSlot.empty() && keyIDSlot.end() != std::find(keyIDSlot.begin(), keyIDSlot.end(), keyIdArray))
-			{
-				MW_LOG_INFO("Session created/in progress with same keyID %s at slot %d", keyIdDebugStr.c_str(), sessionSlot);
-				keySlotFound = true;
-				isCachedKeyId = true;
-				break;
-			}
+			sessionSlot = it->second;
+			MW_LOG_INFO("Session created/in progress with same keyID %s at slot %d", keyIdDebugStr.c_str(), sessionSlot);
+			keySlotFound = true;
+			isCachedKeyId = true;
+			mReuseStats.hits++;
 		}
 
 		if (!keySlotFound)
 		{
-			/* Key Id not in cached list so we need to find out oldest slot to use;
-			 * Oldest slot may be used by current playback which is marked primary
+			/* Key Id not in cached list so we need to find out least recently used slot;
+			 * That slot may be used by current playback which is marked primary
 			 * Avoid selecting that slot
 			 * */
-			/*select the first slot that is not primary*/
 			for (int index = 0; index < mMaxDRMSessions; index++)
 			{
-				if (!cachedKeyIDs[index].isPrimaryKeyId)
+				if (!cachedKeyIDs[index].isPrimaryKeyId &&
+					(!keySlotFound || cachedKeyIDs[index].lastAccess < cachedKeyIDs[sessionSlot].lastAccess))
 				{
 					keySlotFound = true;
 					sessionSlot = index;
-					break;
 				}
 			}
 
@@ -583,15 +744,7 @@ KeyState DrmSessionManager::getDrmSession(int &err, std::shared_ptr<DrmHelper> d
 				MW_LOG_WARN("  Unable to find keySlot for keyId %s ", keyIdDebugStr.c_str());
 				return KEY_ERROR;
 			}
-
-			/*Check if there's an older slot */
-			for (int index= sessionSlot + 1; index< mMaxDRMSessions; index++)
-			{
-				if (cachedKeyIDs[index].creationTime < cachedKeyIDs[sessionSlot].creationTime)
-				{
-					sessionSlot = index;
-				}
-			}
+			mReuseStats.misses++;
 			MW_LOG_WARN("  Selected slot %d for keyId %s", sessionSlot, keyIdDebugStr.c_str());
 		}
 		else
@@ -609,6 +762,8 @@ KeyState DrmSessionManager::getDrmSession(int &err, std::shared_ptr<DrmHelper> d
 		{
 			if(cachedKeyIDs[sessionSlot].data.size() != 0)
 			{
+				mReuseStats.evictions++;
+				unindexKeyIds(sessionSlot);
 				cachedKeyIDs[sessionSlot].data.clear();
 			}
 
@@ -623,8 +778,10 @@ KeyState DrmSessionManager::getDrmSession(int &err, std::shared_ptr<DrmHelper> d
 			}
 
 			cachedKeyIDs[sessionSlot].data = data;
+			indexKeyIds(sessionSlot);
 		}
 		cachedKeyIDs[sessionSlot].creationTime = GetCurrentTimeMS();
+		cachedKeyIDs[sessionSlot].lastAccess = ++mAccessCounter;
 		cachedKeyIDs[sessionSlot].isPrimaryKeyId = isPrimarySession;
 	}
 
@@ -643,15 +800,7 @@ KeyState DrmSessionManager::getDrmSession(int &err, std::shared_ptr<DrmHelper> d
 			if (existingState == KEY_READY)
 			{
 				MW_LOG_INFO("Found drm session READY with same keyID %s - Reusing drm session", keyIdDebugStr.c_str());
-				auto slotSession = drmSessionContexts[sessionSlot].drmSession->getSecManagerSession();
-				if (slotSession.isSessionValid() && (!mContentSecurityManagerSession.isSessionValid()) )
-				{
-					// Set the drmSession's ID as mContentSecurityManagerSession so that this code will not be repeated for multiple calls for createDrmSession					
-					mContentSecurityManagerSession = slotSession;
- 					bool videoMuteState = mIsVideoOnMute;
-					MW_LOG_WARN("Activating re-used DRM, sessionId[%" PRId64 "], with video mute = %d", slotSession.getSessionID(), videoMuteState);
-					ContentSecurityManager::GetInstance()->UpdateSessionState(slotSession.getSessionID(), true);
-				}
+				activateReusedSession(sessionSlot);
 				return KEY_READY;
 			}
 			if (existingState == KEY_INIT)
@@ -687,10 +836,11 @@ KeyState DrmSessionManager::getDrmSession(int &err, std::shared_ptr<DrmHelper> d
 		}
 		MW_LOG_WARN("deleting existing DRM session for %s ", drmSessionContexts[sessionSlot].drmSession->getKeySystem().c_str());
 		MW_SAFE_DELETE(drmSessionContexts[sessionSlot].drmSession);
+		setSlotSession(sessionSlot, NULL);
 	}
         this->ProfileUpdateCb();
 
-	drmSessionContexts[sessionSlot].drmSession = DrmSessionFactory::GetDrmSession(drmHelper, Instance);
+	setSlotSession(sessionSlot, DrmSessionFactory::GetDrmSession(drmHelper, Instance));
 	if (drmSessionContexts[sessionSlot].drmSession != NULL)
 	{
 		MW_LOG_INFO("Created new DrmSession for DrmSystemId %s", systemId.c_str());
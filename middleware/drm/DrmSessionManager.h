@@ -37,6 +37,7 @@
 #include "ContentSecurityManagerSession.h"
 
 #include <functional>
+#include <unordered_map>
 
 
 #define VIDEO_SESSION 0
@@ -79,12 +80,46 @@ struct KeyID
 {
 	std::vector<std::vector<uint8_t>> data;
 	long long creationTime;
+	unsigned long long lastAccess;	/**< Access sequence number, used for LRU eviction */
 	bool isFailedKeyId;
 	bool isPrimaryKeyId;
 
 	KeyID();
 };
 
+/**
+ *  @struct	KeyIdHash
+ *  @brief	FNV-1a hash of key ID bytes, for the key ID to session slot index
+ */
+struct KeyIdHash
+{
+	size_t operator()(const std::vector<uint8_t> &keyId) const
+	{
+		uint64_t hash = 0xcbf29ce484222325ULL;
+		for (uint8_t byte : keyId)
+		{
+			hash = (hash ^ byte) * 0x100000001b3ULL;
+		}
+		return (size_t)hash;
+	}
+};
+
+/**
+ *  @struct	DrmSessionReuseStats
+ *  @brief	Counters of session slot lookups since the session data was last cleared
+ */
+struct DrmSessionReuseStats
+{
+	unsigned int hits;			/**< Lookups resolved to a slot already bound to the key ID */
+	unsigned int readyHits;		/**< Hits returning a ready session without taking the creation lock */
+	unsigned int misses;		/**< Lookups binding the key ID to a new slot */
+	unsigned int evictions;		/**< Misses which replaced the key IDs of the least recently used slot */
+
+	DrmSessionReuseStats() : hits(0), readyHits(0), misses(0), evictions(0)
+	{
+	}
+};
+
 /**
  *  @brief	Enum to represent session manager state.
  *  		Session manager would abort any createDrmSession
@@ -137,6 +172,11 @@ private:
 	std::mutex accessTokenMutex;
 	std::mutex cachedKeyMutex;
 	std::mutex mDrmSessionLock;
+	std::mutex mSessionReuseLock;	/**< Serializes ContentUpdateCb and secure manager session activation, which may run outside mDrmSessionLock */
+	std::unordered_map<std::vector<uint8_t>, int, KeyIdHash> mKeyIdSlots;	/**< Key ID to cachedKeyIDs slot, protected by cachedKeyMutex */
+	std::unordered_map<DrmSession*, int> mSessionSlots;	/**< DrmSession to slot, protected by cachedKeyMutex */
+	unsigned long long mAccessCounter;	/**< Source of KeyID::lastAccess, protected by cachedKeyMutex */
+	DrmSessionReuseStats mReuseStats;	/**< Protected by cachedKeyMutex */
 	bool mEnableAccessAttributes;
 	int mMaxDRMSessions;
 	std::atomic<bool> mIsVideoOnMute;
@@ -182,6 +222,43 @@ private:
 	 * @retval
 	 */
 	static size_t header_callback(const char *ptr, size_t size, size_t nmemb, void *user_data);
+
+	/**
+	 *  @fn		indexKeyIds
+	 *  @brief	Add the key IDs of a slot to the key ID index; caller holds cachedKeyMutex
+	 *  @param[in]	sessionSlot - slot whose key IDs were updated
+	 */
+	void indexKeyIds(int sessionSlot);
+
+	/**
+	 *  @fn		unindexKeyIds
+	 *  @brief	Remove the key IDs of a slot from the key ID index; caller holds cachedKeyMutex
+	 *  @param[in]	sessionSlot - slot whose key IDs are about to be cleared
+	 */
+	void unindexKeyIds(int sessionSlot);
+
+	/**
+	 *  @fn		setSlotSession
+	 *  @brief	Update the session of a slot along with the session index; caller holds the slot sessionMutex
+	 *  @param[in]	sessionSlot - slot to update
+	 *  @param[in]	session - new session, NULL after deleting the old one
+	 */
+	void setSlotSession(int sessionSlot, DrmSession *session);
+
+	/**
+	 *  @fn		getReadySession
+	 *  @brief	Return the ready session bound to the key ID of drmHelper, without taking mDrmSessionLock
+	 *  @param[in]	drmHelper - helper of the requested content protection
+	 *  @return	ready DrmSession, NULL if session creation or validation is required
+	 */
+	DrmSession* getReadySession(DrmHelperPtr drmHelper);
+
+	/**
+	 *  @fn		activateReusedSession
+	 *  @brief	Activate the secure manager session of a reused session; caller holds the slot sessionMutex
+	 *  @param[in]	sessionSlot - slot of the reused session
+	 */
+	void activateReusedSession(int sessionSlot);
 public:
 	
 	/**
@@ -283,6 +360,11 @@ public:
 	 * 				false if key is not cached
 	 */
 	bool IsKeyIdProcessed(std::vector<uint8_t> keyIdArray, bool &status);
+	/**
+	 *  @fn		GetSessionReuseStats
+	 *  @return	counters of session slot lookups since the session data was last cleared
+	 */
+	DrmSessionReuseStats GetSessionReuseStats();
 	/**
 	 *  @fn         clearSessionData
 	 *
@@ -386,7 +468,7 @@ public:
 	void UpdateMaxDRMSessions(int maxSessions);
 
         /*
-         *@brief Type definition for acquireLicense callback from application 
+         *@brief Type definition for acquireLicense callback from application; called with the sessionMutex of sessionSlot held
          */
         using LicenseCallback = std::function<KeyState(DrmHelperPtr drmHelper, int sessionSlot, int &cdmError,
                         GstMediaType streamType,void *metaDataPtr, bool isLicenseRenewal)>;
@@ -27,6 +27,7 @@
 #define _DRM_HLSDRMBASE_H_
 #include "PlayerUtils.h"
 #include "DrmSession.h"
+#include <memory>
 
 
 #define DECRYPT_WAIT_TIME_MS 3000
@@ -71,6 +72,35 @@ enum DRMState
 	eDRM_KEY_FLUSH		/**< DRM key is flushed */
 };
 
+/**
+ * @class HlsDrmDecryptStream
+ * @brief Decrypts one fragment in place while it is being downloaded
+ */
+class HlsDrmDecryptStream
+{
+public:
+	/**
+	 * @brief Decrypt the complete cipher blocks received so far
+	 * @param dataPtr pointer to the fragment, which may move between calls
+	 * @param offset offset of the bytes received last; a lower offset than before restarts decryption
+	 * @param dataLen length in bytes of data received so far
+	 */
+	virtual void Update(void *dataPtr, size_t offset, size_t dataLen) = 0;
+
+	/**
+	 * @brief Decrypt the remainder of the downloaded fragment
+	 * @param dataPtr pointer to the fragment
+	 * @param dataLen length in bytes of the fragment
+	 * @retval eDRM_SUCCESS on success
+	 */
+	virtual DrmReturn Finish(void *dataPtr, size_t dataLen) = 0;
+
+	/**
+	 * @brief HlsDrmDecryptStream Destructor
+	 */
+	virtual ~HlsDrmDecryptStream(){};
+};
+
 /**
  * @class HlsDrmBase
  * @brief Base class of HLS DRM implementations
@@ -106,6 +136,17 @@ public:
 	 */
 	virtual DrmReturn Decrypt(int bucketType, void *encryptedDataPtr, size_t encryptedDataLen, int timeInMs = 3000) = 0;
 
+	/**
+	 * @brief Start decrypting a fragment while it is downloaded; does not wait for the key
+	 * @param bucketType Type of bucket for profiling
+	 * @param iv initialization vector of the fragment, NULL to use the current one
+	 * @retval stream to feed with the fragment, NULL if not supported or the key is not yet available
+	 */
+	virtual std::unique_ptr<HlsDrmDecryptStream> CreateDecryptStream(int bucketType, const unsigned char *iv)
+	{
+		return nullptr;
+	}
+
 	/**
 	 * @brief Release drm session
 	 */
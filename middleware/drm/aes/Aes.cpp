@@ -39,9 +39,48 @@
 #define OPEN_SSL_CONTEXT &mOpensslCtx
 #endif
 #define AES_128_KEY_LEN_BYTES 16
+#define AES_128_BLOCK_LEN_BYTES 16
 
 static std::mutex instanceLock;
 
+/**
+ * @brief Decrypt whole cipher blocks in place, with padding disabled on the context
+ */
+static bool DecryptBlocksInPlace(EVP_CIPHER_CTX *ctx, unsigned char *dataPtr, size_t dataLen)
+{
+	int decLen = 0;
+	if (dataLen == 0)
+	{
+		return true;
+	}
+	return EVP_DecryptUpdate(ctx, dataPtr, &decLen, dataPtr, (int)dataLen) && ((size_t)decLen == dataLen);
+}
+
+/**
+ * @brief Validate the PKCS#7 padding at the end of a decrypted fragment and zero it, keeping the fragment length
+ */
+static bool ClearPadding(unsigned char *dataPtr, size_t dataLen)
+{
+	if (dataLen == 0 || (dataLen % AES_128_BLOCK_LEN_BYTES) != 0)
+	{
+		return false;
+	}
+	unsigned char padLen = dataPtr[dataLen - 1];
+	if (padLen == 0 || padLen > AES_128_BLOCK_LEN_BYTES)
+	{
+		return false;
+	}
+	for (size_t i = dataLen - padLen; i < dataLen; i++)
+	{
+		if (dataPtr[i] != padLen)
+		{
+			return false;
+		}
+	}
+	memset(dataPtr + dataLen - padLen, 0, padLen);
+	return true;
+}
+
 /**
  * @brief key acquisition thread
  * @retval NULL
@@ -229,47 +268,31 @@ DrmReturn AesDec::Decrypt( int bucketTypeIn, void *encryptedDataPtr, size_t encr
 	if (mDrmState == eDRM_KEY_ACQUIRED)
 	{
 		MW_LOG_INFO("AesDec: Starting decrypt");
-		unsigned char *decryptedDataBuf = (unsigned char *)malloc(encryptedDataLen);
-		int decryptedDataLen = 0;
-		if (decryptedDataBuf)
+		unsigned char *dataPtr = (unsigned char *)encryptedDataPtr;
+		this->ProfileUpdateDrmDecrypt(0, bucketType);
+		if(!EVP_DecryptInit_ex(OPEN_SSL_CONTEXT, EVP_aes_128_cbc(), NULL, (unsigned char*)m_ptr, mDrmInfo.iv))
+		{
+			MW_LOG_ERR( "AesDec::EVP_DecryptInit_ex failed mDrmState = %d",(int)mDrmState);
+		}
+		else
 		{
-			int decLen = (int)encryptedDataLen;
-			memset(decryptedDataBuf, 0, encryptedDataLen);
-	               
-		       this->ProfileUpdateDrmDecrypt(0, bucketType);
-		       if(!EVP_DecryptInit_ex(OPEN_SSL_CONTEXT, EVP_aes_128_cbc(), NULL, (unsigned char*)m_ptr, mDrmInfo.iv))
+			// Decrypt in place; the padding is checked and zeroed here instead of by EVP_DecryptFinal_ex
+			EVP_CIPHER_CTX_set_padding(OPEN_SSL_CONTEXT, 0);
+			if ((encryptedDataLen % AES_128_BLOCK_LEN_BYTES) != 0 || !DecryptBlocksInPlace(OPEN_SSL_CONTEXT, dataPtr, encryptedDataLen))
+			{
+				MW_LOG_ERR("AesDec::EVP_DecryptUpdate failed mDrmState = %d encryptedDataLen %zu",(int) mDrmState, encryptedDataLen);
+			}
+			else if (!ClearPadding(dataPtr, encryptedDataLen))
 			{
-				MW_LOG_ERR( "AesDec::EVP_DecryptInit_ex failed mDrmState = %d",(int)mDrmState);
+				MW_LOG_ERR("AesDec::invalid padding mDrmState = %d", (int) mDrmState);
 			}
 			else
 			{
-				if (!EVP_DecryptUpdate(OPEN_SSL_CONTEXT, decryptedDataBuf, &decLen, (const unsigned char*)encryptedDataPtr, (int)encryptedDataLen))
-				{
-					MW_LOG_ERR("AesDec::EVP_DecryptUpdate failed mDrmState = %d",(int) mDrmState);
-				}
-				else
-				{
-					decryptedDataLen = decLen;
-					decLen = 0;
-					MW_LOG_INFO("AesDec: EVP_DecryptUpdate success decryptedDataLen = %d encryptedDataLen %d", (int) decryptedDataLen, (int)encryptedDataLen);
-					if (!EVP_DecryptFinal_ex(OPEN_SSL_CONTEXT, decryptedDataBuf + decryptedDataLen, &decLen))
-					{
-						MW_LOG_ERR("AesDec::EVP_DecryptFinal_ex failed mDrmState = %d", 
-						        (int) mDrmState);
-					}
-					else
-					{
-						decryptedDataLen += decLen;
-						MW_LOG_INFO("AesDec: decrypt success");
-						err = eDRM_SUCCESS;
-					}
-				}
+				MW_LOG_INFO("AesDec: decrypt success");
+				err = eDRM_SUCCESS;
 			}
-                        this->ProfileUpdateDrmDecrypt(1, bucketType);
-			memcpy(encryptedDataPtr, decryptedDataBuf, encryptedDataLen);
-			free(decryptedDataBuf);
-			(void)decryptedDataLen; // Avoid a warning as this is only used in a log.
 		}
+		this->ProfileUpdateDrmDecrypt(1, bucketType);
 	}
 	else
 	{
@@ -279,6 +302,20 @@ DrmReturn AesDec::Decrypt( int bucketTypeIn, void *encryptedDataPtr, size_t encr
 }
 
 
+/**
+ * @brief Start decrypting a fragment while it is downloaded
+ */
+std::unique_ptr<HlsDrmDecryptStream> AesDec::CreateDecryptStream(int bucketType, const unsigned char *iv)
+{
+	std::lock_guard<std::mutex> guard(mMutex);
+	if (mDrmState != eDRM_KEY_ACQUIRED)
+	{
+		// not waiting here; the fragment is decrypted after download instead
+		return nullptr;
+	}
+	return std::unique_ptr<HlsDrmDecryptStream>(new AesDecryptStream((const unsigned char *)m_ptr, iv ? iv : mDrmInfo.iv, ProfileUpdateDrmDecrypt, bucketType));
+}
+
 /**
  * @brief Release drm session
  */
@@ -385,3 +422,112 @@ AesDec::~AesDec()
 	EVP_CIPHER_CTX_cleanup(OPEN_SSL_CONTEXT);
 #endif
 }
+
+/**
+ * @brief AesDecryptStream Constructor
+ */
+AesDecryptStream::AesDecryptStream(const unsigned char *key, const unsigned char *iv, std::function<void(bool type, int bucketType)> profileUpdate, int bucketType) :
+		mOpensslCtx(), mKey(), mIv(), mDecryptedLen(0), mFailed(false),
+		mProfileUpdate(profileUpdate), mBucketType(bucketType)
+{
+#if OPENSSL_VERSION_NUMBER >= 0x10100000L
+	OPEN_SSL_CONTEXT = EVP_CIPHER_CTX_new();
+#else
+	EVP_CIPHER_CTX_init(OPEN_SSL_CONTEXT);
+#endif
+	memcpy(mKey, key, AES_128_KEY_LEN_BYTES);
+	memcpy(mIv, iv, DRM_IV_LEN);
+	Restart();
+}
+
+/**
+ * @brief AesDecryptStream Destructor
+ */
+AesDecryptStream::~AesDecryptStream()
+{
+#if OPENSSL_VERSION_NUMBER >= 0x10100000L
+	EVP_CIPHER_CTX_free(OPEN_SSL_CONTEXT);
+#else
+	EVP_CIPHER_CTX_cleanup(OPEN_SSL_CONTEXT);
+#endif
+}
+
+/**
+ * @brief Reset the cipher to the start of the fragment
+ */
+bool AesDecryptStream::Restart()
+{
+	mDecryptedLen = 0;
+	mFailed = !EVP_DecryptInit_ex(OPEN_SSL_CONTEXT, EVP_aes_128_cbc(), NULL, mKey, mIv);
+	if (mFailed)
+	{
+		MW_LOG_ERR("AesDecryptStream::EVP_DecryptInit_ex failed");
+	}
+	else
+	{
+		EVP_CIPHER_CTX_set_padding(OPEN_SSL_CONTEXT, 0);
+	}
+	return !mFailed;
+}
+
+/**
+ * @brief Decrypt the complete cipher blocks received so far
+ */
+void AesDecryptStream::Update(void *dataPtr, size_t offset, size_t dataLen)
+{
+	if (offset < mDecryptedLen)
+	{
+		MW_LOG_INFO("AesDecryptStream: download restarted at %zu", offset);
+		Restart();
+	}
+	size_t blocksLen = dataLen - (dataLen % AES_128_BLOCK_LEN_BYTES);
+	if (!mFailed && blocksLen > mDecryptedLen)
+	{
+		if (DecryptBlocksInPlace(OPEN_SSL_CONTEXT, (unsigned char *)dataPtr + mDecryptedLen, blocksLen - mDecryptedLen))
+		{
+			mDecryptedLen = blocksLen;
+		}
+		else
+		{
+			MW_LOG_ERR("AesDecryptStream::EVP_DecryptUpdate failed");
+			mFailed = true;
+		}
+	}
+}
+
+/**
+ * @brief Decrypt the remainder of the downloaded fragment
+ */
+DrmReturn AesDecryptStream::Finish(void *dataPtr, size_t dataLen)
+{
+	DrmReturn err = eDRM_ERROR;
+	unsigned char *ptr = (unsigned char *)dataPtr;
+	if (dataLen < mDecryptedLen)
+	{
+		Restart();
+	}
+	size_t streamedLen = mDecryptedLen;
+	if (mProfileUpdate)
+	{
+		mProfileUpdate(0, mBucketType);
+	}
+	if (mFailed || (dataLen % AES_128_BLOCK_LEN_BYTES) != 0 || !DecryptBlocksInPlace(OPEN_SSL_CONTEXT, ptr + mDecryptedLen, dataLen - mDecryptedLen))
+	{
+		MW_LOG_ERR("AesDecryptStream: decrypt failed dataLen %zu", dataLen);
+	}
+	else if (!ClearPadding(ptr, dataLen))
+	{
+		MW_LOG_ERR("AesDecryptStream: invalid padding");
+	}
+	else
+	{
+		MW_LOG_INFO("AesDecryptStream: decrypt success, %zu of %zu bytes decrypted during download", streamedLen, dataLen);
+		err = eDRM_SUCCESS;
+	}
+	mDecryptedLen = dataLen;
+	if (mProfileUpdate)
+	{
+		mProfileUpdate(1, mBucketType);
+	}
+	return err;
+}
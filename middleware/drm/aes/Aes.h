@@ -41,6 +41,63 @@
 #else
 #define drm_pthread_setname(tid,name) pthread_setname_np(tid,name)
 #endif
+/**
+ * @class AesDecryptStream
+ * @brief AES-128 CBC decryption of one fragment, in place, as its blocks are downloaded
+ */
+class AesDecryptStream : public HlsDrmDecryptStream
+{
+public:
+	/**
+	 * @fn AesDecryptStream
+	 * @param key 16 byte content key
+	 * @param iv 16 byte initialization vector
+	 * @param profileUpdate profiling callback of the owning AesDec
+	 * @param bucketType Type of bucket for profiling
+	 */
+	AesDecryptStream(const unsigned char *key, const unsigned char *iv, std::function<void(bool type, int bucketType)> profileUpdate, int bucketType);
+	/**
+	 * @fn ~AesDecryptStream
+	 */
+	~AesDecryptStream();
+	AesDecryptStream(const AesDecryptStream&) = delete;
+	AesDecryptStream& operator=(const AesDecryptStream&) = delete;
+
+	/**
+	 * @fn Update
+	 * @param dataPtr pointer to the fragment
+	 * @param offset offset of the bytes received last
+	 * @param dataLen length in bytes of data received so far
+	 */
+	void Update(void *dataPtr, size_t offset, size_t dataLen) override;
+	/**
+	 * @fn Finish
+	 * @param dataPtr pointer to the fragment
+	 * @param dataLen length in bytes of the fragment
+	 * @retval eDRM_SUCCESS on success
+	 */
+	DrmReturn Finish(void *dataPtr, size_t dataLen) override;
+
+private:
+	/**
+	 * @fn Restart
+	 * @retval true on success
+	 */
+	bool Restart();
+
+#if OPENSSL_VERSION_NUMBER >= 0x10100000L
+	EVP_CIPHER_CTX *mOpensslCtx;
+#else
+	EVP_CIPHER_CTX mOpensslCtx;
+#endif
+	unsigned char mKey[DRM_IV_LEN];
+	unsigned char mIv[DRM_IV_LEN];
+	size_t mDecryptedLen;		/**< Bytes at the start of the fragment already decrypted in place */
+	bool mFailed;
+	std::function<void(bool type, int bucketType)> mProfileUpdate;
+	int mBucketType;
+};
+
 /**
  * @class AesDec
  * @brief Vanilla AES based DRM management
@@ -95,6 +152,13 @@ public:
 	 */
 	DrmReturn SetIV(unsigned char* iv);
 	DrmReturn Decrypt(int bucketType, void *encryptedDataPtr, size_t encryptedDataLen, int timeInMs);
+	/**
+	 * @fn CreateDecryptStream
+	 * @param bucketType Type of bucket for profiling
+	 * @param iv initialization vector of the fragment, NULL to use the current one
+	 * @retval decrypt stream, NULL if the key is not acquired yet
+	 */
+	std::unique_ptr<HlsDrmDecryptStream> CreateDecryptStream(int bucketType, const unsigned char *iv);
 	/**
 	 * @fn Release
 	 */
@@ -85,6 +85,16 @@ void gst_structure_set (GstStructure * structure, const gchar * field, ...)
 {
 }
 
+const gchar * gst_structure_get_string (const GstStructure * structure, const gchar * fieldname)
+{
+	return NULL;
+}
+
+gboolean gst_structure_get_uint (const GstStructure * structure, const gchar * fieldname, guint * value)
+{
+	return FALSE;
+}
+
 GstProtectionMeta * gst_buffer_add_protection_meta (GstBuffer * buffer, GstStructure * info)
 {
 	return NULL;
@@ -72,6 +72,9 @@
 #include <uuid/uuid.h>
 #include <string.h>
 #include "AampCurlDownloader.h"
+#include "AampCurlMultiEngine.h"
+#include "AampBufferPool.h"
+#include "AampDiskCache.h"
 #include "AampMPDDownloader.h"
 
 #include <sched.h>
@@ -586,8 +589,7 @@ size_t PrivateInstanceAAMP::HandleSSLWriteCallback ( char *ptr, size_t size, siz
 					size*nmemb,
 					context->contentLength );
 	}
-	// There is scope for rework here, mDownloadsEnabled can be queried with a lock, rather than acquiring lock here
-	std::unique_lock<std::recursive_mutex> lock(context->aamp->mLock);
+	// No player lock here; with useCurlMulti this runs on the reactor thread while the requesting thread, which may hold mLock, waits for the transfer
 	if (context->aamp->mDownloadsEnabled && context->aamp->mMediaDownloadsEnabled[context->mediaType])
 	{
 		if ((NULL == context->buffer->GetPtr() ) && (context->contentLength > 0))
@@ -601,10 +603,19 @@ size_t PrivateInstanceAAMP::HandleSSLWriteCallback ( char *ptr, size_t size, siz
 			}
 			context->buffer->ReserveBytes(len);
 		}
+		else if ((NULL == context->buffer->GetPtr()) && (context->expectedLength > 0))
+		{ // no Content-Length (chunked transfer); start with the byte range size or the size learned from previous downloads
+			context->buffer->ReserveBytes(context->expectedLength + 2);
+		}
 		size_t numBytesForBlock = size*nmemb;
 		if(ptr && numBytesForBlock > 0)
 		{
+			size_t offset = context->buffer->GetLen();
 			context->buffer->AppendBytes( ptr, numBytesForBlock );
+			if (context->writeObserver)
+			{
+				context->writeObserver(context->buffer, offset);
+			}
 		}
 		ret = numBytesForBlock;
 		MediaStreamContext *mCtx = context->aamp->GetMediaStreamContext(context->mediaType);
@@ -621,13 +632,10 @@ size_t PrivateInstanceAAMP::HandleSSLWriteCallback ( char *ptr, size_t size, siz
 				context->mediaType ==  eMEDIATYPE_AUDIO ||
 				context->mediaType ==  eMEDIATYPE_SUBTITLE))
 			{
-				// Release PrivateInstanceAAMP mutex to unblock async APIs
-				lock.unlock();
 				AAMPLOG_TRACE("[%d] Caching chunk with size %zu nmemb:%zu size:%zu", context->mediaType, numBytesForBlock, nmemb, size);
 				long long startTime = aamp_GetCurrentTimeMS();
 				mCtx->CacheFragmentChunk(context->mediaType, ptr, numBytesForBlock,context->remoteUrl,context->downloadStartTime);
 				context->processDelay += aamp_GetCurrentTimeMS() - startTime;
-				lock.lock();
 			}
 		}
 	}
@@ -741,6 +749,12 @@ size_t PrivateInstanceAAMP::HandleSSLHeaderCallback ( const char *ptr, size_t si
 		{
 			context->chunkedDownload = true;
 		}
+		else if (STARTS_WITH_IGNORE_CASE(ptr, CACHE_CONTROL_STRING ))
+		{
+			// freshness of manifests and init fragments persisted in the disk cache
+			size_t valueStartPosition = STRLEN_LITERAL(CACHE_CONTROL_STRING);
+			context->cacheMaxAge = AampDiskCache::ParseCacheControl(std::string(ptr + valueStartPosition, endPos - valueStartPosition));
+		}
 		else if (0 == context->buffer->GetAvail() )
 		{
 			if (STARTS_WITH_IGNORE_CASE(ptr, CONTENTLENGTH_STRING))
@@ -939,13 +953,12 @@ int PrivateInstanceAAMP::HandleSSLProgressCallback ( void *clientp, double dltot
 	}
 
 	int rc = 0;
-	context->aamp->SyncBegin();
+	// No player lock here, see HandleSSLWriteCallback
 	if (!context->aamp->mDownloadsEnabled && context->aamp->mMediaDownloadsEnabled[context->mediaType])
 	{
 		rc = -1; // CURLE_ABORTED_BY_CALLBACK
 	}
 
-	context->aamp->SyncEnd();
 	if( rc==0 )
 	{ // only proceed if not an aborted download
 		if (dlnow > 0 && context->stallTimeout > 0)
@@ -1247,6 +1260,7 @@ PrivateInstanceAAMP::PrivateInstanceAAMP(AampConfig *config) : mReportProgressPo
 	, mIsFlushOperationInProgress(false)
 {
 	mAampCacheHandler = new AampCacheHandler(mPlayerId);
+	mCurlMultiEngine = std::make_shared<AampCurlMultiEngine>();
 	// Create the event manager for player instance
 	mEventManager = new AampEventManager(mPlayerId);
 	// Create the CMCD collector
@@ -1343,7 +1357,10 @@ PrivateInstanceAAMP::~PrivateInstanceAAMP()
 			gActivePrivAAMPs.erase(iter);
 		}
 	}
-	mMediaDownloadsEnabled.clear();
+	for (auto &enabled : mMediaDownloadsEnabled)
+	{
+		enabled = false;
+	}
 	{
 		std::lock_guard<std::recursive_mutex> guard(mLock);
 		SAFE_DELETE(mVideoEnd);
@@ -3624,7 +3641,7 @@ void PrivateInstanceAAMP::BlockUntilGstreamerWantsData(void(*cb)(void), int peri
 	{
 		if (!mDownloadsEnabled || mTrackInjectionBlocked[track])
 		{
-			AAMPLOG_WARN("PrivateInstanceAAMP: track:%d interrupted. mDownloadsEnabled:%d mTrackInjectionBlocked:%d", track, mDownloadsEnabled, mTrackInjectionBlocked[track]);
+			AAMPLOG_WARN("PrivateInstanceAAMP: track:%d interrupted. mDownloadsEnabled:%d mTrackInjectionBlocked:%d", track, mDownloadsEnabled.load(), mTrackInjectionBlocked[track]);
 			break;
 		}
 		if (cb && periodMs)
@@ -3950,6 +3967,14 @@ bool PrivateInstanceAAMP::GetFile( std::string remoteUrl, AampMediaType mediaTyp
 			context.buffer = buffer;
 			context.responseHeaderData = &httpRespHeaders[curlInstance];
 			context.mediaType = mediaType;
+			{
+				std::lock_guard<std::recursive_mutex> guard(mLock);
+				auto observer = mDownloadWriteObservers.find(mediaType);
+				if (observer != mDownloadWriteObservers.end())
+				{
+					context.writeObserver = observer->second;
+				}
+			}
 
 			CURL_EASY_SETOPT_POINTER(curl, CURLOPT_WRITEDATA, &context);
 			CURL_EASY_SETOPT_POINTER(curl, CURLOPT_HEADERDATA, &context);
@@ -4016,6 +4041,14 @@ bool PrivateInstanceAAMP::GetFile( std::string remoteUrl, AampMediaType mediaTyp
 			if( range && *range=='\0' ) range = NULL;
 			CURL_EASY_SETOPT_STRING(curl, CURLOPT_RANGE, range);
 
+			// Size hint for pre-allocating the buffer when the response carries no Content-Length
+			// HLS EXT-X-BYTERANGE, DASH SegmentBase index/media ranges: exact size known up front
+			context.expectedLength = aamp_GetByteRangeLength(range);
+			if( 0 == context.expectedLength )
+			{ // running average of previous downloads of this type
+				context.expectedLength = AampBufferPool::GetInstance().GetExpectedSize(mediaType);
+			}
+
 			if ((httpRespHeaders[curlInstance].type == eHTTPHEADERTYPE_COOKIE) && (httpRespHeaders[curlInstance].data.length() > 0))
 			{
 				AAMPLOG_TRACE("Appending cookie headers to HTTP request");
@@ -4069,12 +4102,21 @@ bool PrivateInstanceAAMP::GetFile( std::string remoteUrl, AampMediaType mediaTyp
 				{
 					buffer->Clear();
 				}
+				context.cacheMaxAge = AAMP_DISK_CACHE_MAX_AGE_UNSPECIFIED; // only the response of the final attempt applies
 
 				isDownloadStalled = false;
 				abortReason = eCURL_ABORT_REASON_NONE;
 
 				long long tStartTime = NOW_STEADY_TS_MS;
-				CURLcode res = curl_easy_perform(curl); // synchronous; callbacks allow interruption
+				CURLcode res;
+				if( ISCONFIGSET_PRIV(eAAMPConfig_UseCurlMulti) && !mAampLLDashServiceData.lowLatencyMode )
+				{ // LLD chunk caching can block inside the write callback, so it keeps using the calling thread
+					res = mCurlMultiEngine->Perform(curl); // waits for the reactor of this player; callbacks allow interruption
+				}
+				else
+				{
+					res = curl_easy_perform(curl); // synchronous; callbacks allow interruption
+				}
 				if(!mAampLLDashServiceData.lowLatencyMode)
 				{
 					int insertDownloadDelay = GETCONFIGVALUE_PRIV(eAAMPConfig_DownloadDelay);
@@ -4462,6 +4504,14 @@ bool PrivateInstanceAAMP::GetFile( std::string remoteUrl, AampMediaType mediaTyp
 					buffer->Free();
 				}
 			}
+			if( ret )
+			{
+				AampBufferPool::GetInstance().UpdateExpectedSize(mediaType, buffer->GetLen());
+				if( context.cacheMaxAge != AAMP_DISK_CACHE_MAX_AGE_UNSPECIFIED && AampDiskCache::IsCacheableMediaType(mediaType) && AampDiskCache::GetInstance().IsEnabled() )
+				{ // picked up by the cache handler when the caller inserts this download
+					mAampCacheHandler->SetHttpCachePolicy(remoteUrl, context.cacheMaxAge);
+				}
+			}
 		}
 		else
 		{
@@ -5763,6 +5813,7 @@ void PrivateInstanceAAMP::Tune(const char *mainManifestUrl,
 	// Set the EventManager config
 	// TODO When faketune code is added later , push the faketune status here
 	mEventManager->SetAsyncTuneState(mAsyncTuneEnabled);
+	mEventManager->SetEventBatching(ISCONFIGSET_PRIV(eAAMPConfig_EventBatching));
 	mIsFakeTune = strcasestr(mainManifestUrl, "fakeTune=true");
 	if(mIsFakeTune)
 	{
@@ -5987,7 +6038,7 @@ void PrivateInstanceAAMP::Tune(const char *mainManifestUrl,
 	mIsTrackIdMismatch = false;
 	mCurrentAudioTrackId = -1;
 	mCurrentVideoTrackId = -1;
-	mCurrentDrm = nullptr;
+	setCurrentDrm(nullptr);
 
 
 	// Enable the eAAMPConfig_EnableMediaProcessor if the PTS Restamp set for DASH.
@@ -6757,6 +6808,7 @@ double PrivateInstanceAAMP::GetSeekBase(void)
  */
 DrmHelperPtr PrivateInstanceAAMP::GetCurrentDRM(void)
 {
+	std::lock_guard<std::mutex> lock(mCurrentDrmMutex);
 	return mCurrentDrm;
 }
 
@@ -7626,6 +7678,11 @@ void PrivateInstanceAAMP::Stop()
 	SetFlushFdsNeededInCurlStore(false);
 	EnableDownloads();
 
+	if(AampBufferPool::IsEnabled())
+	{
+		AampBufferPool::GetInstance().LogStats();
+	}
+
 	AampStreamSinkManager::GetInstance().DeactivatePlayer(this, true);
 }
 
@@ -8872,8 +8929,9 @@ int PrivateInstanceAAMP::getStreamType()
 		type = 0;
 	}
 
-	if (mCurrentDrm != nullptr) {
-		type += mCurrentDrm->getDrmCodecType();
+	DrmHelperPtr currentDrm = GetCurrentDRM();
+	if (currentDrm != nullptr) {
+		type += currentDrm->getDrmCodecType();
 	}
 	return type;
 }
@@ -9344,10 +9402,11 @@ std::string PrivateInstanceAAMP::getStreamTypeString()
 {
 	std::string type = mMediaFormatName[mMediaFormat];
 
-	if(mCurrentDrm != nullptr) //Incomplete Init won't be set the DRM
+	DrmHelperPtr currentDrm = GetCurrentDRM();
+	if(currentDrm != nullptr) //Incomplete Init won't be set the DRM
 	{
 		type += "/";
-		type += mCurrentDrm->friendlyName();
+		type += currentDrm->friendlyName();
 	}
 	else
 	{
@@ -12865,6 +12924,22 @@ MediaStreamContext* PrivateInstanceAAMP::GetMediaStreamContext(AampMediaType typ
 	return NULL;
 }
 
+/**
+ *  @brief Set or clear the observer of bytes downloaded for a media type
+ */
+void PrivateInstanceAAMP::SetDownloadWriteObserver(AampMediaType type, DownloadWriteObserver observer)
+{
+	std::lock_guard<std::recursive_mutex> guard(mLock);
+	if (observer)
+	{
+		mDownloadWriteObservers[type] = observer;
+	}
+	else
+	{
+		mDownloadWriteObservers.erase(type);
+	}
+}
+
 /**
  *  @brief GetPeriodDurationTimeValue
  */
@@ -13153,11 +13228,13 @@ void PrivateInstanceAAMP::LoadLocalTSBConfig()
 	auto tsbLocation			=	GETCONFIGVALUE_PRIV(eAAMPConfig_TsbLocation);
 	auto tsbMinFreePercentage	=	GETCONFIGVALUE_PRIV(eAAMPConfig_TsbMinDiskFreePercentage);
 	auto tsbMaxDiskStorage = GETCONFIGVALUE_PRIV(eAAMPConfig_TsbMaxDiskStorage);
+	auto tsbWriteQueueDepth = GETCONFIGVALUE_PRIV(eAAMPConfig_TsbWriteQueueDepth);
 
 	mTSBSessionManager->SetTsbLength(tsbLength);
 	mTSBSessionManager->SetTsbLocation(tsbLocation);
 	mTSBSessionManager->SetTsbMinFreePercentage(tsbMinFreePercentage);
 	mTSBSessionManager->SetTsbMaxDiskStorage(tsbMaxDiskStorage);
+	mTSBSessionManager->SetTsbWriteQueueDepth(tsbWriteQueueDepth);
 	// Initialize TSB session manager with configuration set
 	mTSBSessionManager->Init();
 }
@@ -13290,6 +13367,8 @@ std::shared_ptr<ManifestDownloadConfig> PrivateInstanceAAMP::prepareManifestDown
 	inpData->mHarvestConfig				=	GETCONFIGVALUE_PRIV(eAAMPConfig_HarvestConfig);
 	inpData->mHarvestCountLimit			=	GETCONFIGVALUE_PRIV(eAAMPConfig_HarvestCountLimit);
 	inpData->mHarvestPathConfigured		=	GETCONFIGVALUE_PRIV(eAAMPConfig_HarvestPath);
+	inpData->mIncrementalRefresh		=	ISCONFIGSET_PRIV(eAAMPConfig_MPDIncrementalRefresh);
+	inpData->mStreamingParser			=	ISCONFIGSET_PRIV(eAAMPConfig_MPDStreamingParser);
 	inpData->mDnldConfig->iCurlConnectionTimeout =  GETCONFIGVALUE_PRIV(eAAMPConfig_Curl_ConnectTimeout);
 	inpData->mDnldConfig->iDnsCacheTimeOut =   GETCONFIGVALUE_PRIV(eAAMPConfig_Dns_CacheTimeout);
 
@@ -13312,6 +13391,10 @@ std::shared_ptr<ManifestDownloadConfig> PrivateInstanceAAMP::prepareManifestDown
 	inpData->mDnldConfig->bSSLVerifyPeer = ISCONFIGSET_PRIV(eAAMPConfig_SslVerifyPeer);
 	inpData->mDnldConfig->bVerbose	=      ISCONFIGSET_PRIV(eAAMPConfig_CurlLogging);
 	inpData->mDnldConfig->bCurlThroughput = ISCONFIGSET_PRIV(eAAMPConfig_CurlThroughput);
+	if (ISCONFIGSET_PRIV(eAAMPConfig_UseCurlMulti))
+	{
+		inpData->mDnldConfig->pCurlMultiEngine = mCurlMultiEngine;
+	}
 
 	struct curl_slist* headers = GetCustomHeaders(eMEDIATYPE_MANIFEST);
 	std::unordered_map<std::string, std::vector<std::string>> sCustomHeaders;
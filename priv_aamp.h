@@ -55,6 +55,7 @@
 #include <inttypes.h>
 #include <type_traits>
 #include <chrono>
+#include <functional>
 #include "AampEventManager.h"
 #include <HybridABRManager.h>
 #include "AampCMCDCollector.h"
@@ -343,6 +344,14 @@ typedef int(*IdleTask)(void* arg);
  */
 typedef void(*DestroyTask)(void * arg);
 
+/**
+ * @brief Observer of bytes written to a download buffer, invoked from the curl write callback
+ *
+ * @param[in] buffer - Download buffer, after the new bytes were appended
+ * @param[in] offset - Offset of the first new byte; lower than before when a retry restarted the download
+ */
+typedef std::function<void(AampGrowableBuffer *buffer, size_t offset)> DownloadWriteObserver;
+
 /**
  * @brief To store Set Cookie: headers and X-Reason headers in HTTP Response
  */
@@ -513,6 +522,8 @@ typedef struct BlacklistProfileInfo_t
 
 class AampCacheHandler;
 
+class AampCurlMultiEngine;
+
 class AampDRMLicenseManager;
 /**
  * @brief
@@ -820,8 +831,9 @@ public:
 	StreamOutputFormat mAuxFormat;
 	StreamOutputFormat mSubtitleFormat{FORMAT_UNKNOWN};
 	std::condition_variable_any mDownloadsDisabled;
-	bool mDownloadsEnabled;
-	std::map<AampMediaType, bool> mMediaDownloadsEnabled; /* Used to enable/Disable individual mediaType downloads */
+	std::atomic<bool> mDownloadsEnabled;	/* Read without mLock from curl callbacks */
+	std::atomic<bool> mMediaDownloadsEnabled[eMEDIATYPE_DEFAULT + 1]; /* Used to enable/Disable individual mediaType downloads */
+	std::map<AampMediaType, DownloadWriteObserver> mDownloadWriteObservers; /* Used to process fragment bytes while they are downloaded */
 	HybridABRManager mhAbrManager;                 /**< Pointer to Hybrid abr manager*/
 	ProfileEventAAMP profiler;
 	bool licenceFromManifest;
@@ -2492,7 +2504,11 @@ public:
 	 *   @param[in] drm - New DRM type
 	 *   @return void
 	 */
-	void setCurrentDrm(DrmHelperPtr drm) { mCurrentDrm = drm; }
+	void setCurrentDrm(DrmHelperPtr drm)
+	{
+		std::lock_guard<std::mutex> lock(mCurrentDrmMutex);
+		mCurrentDrm = drm;
+	}
 
 	/**
 	 * @fn GetMoneyTraceString
@@ -3559,6 +3575,15 @@ public:
 	 */
 	class MediaStreamContext* GetMediaStreamContext(AampMediaType type);
 
+	/**
+	 *     @fn SetDownloadWriteObserver
+	 *     @brief Set or clear the observer of bytes downloaded for a media type
+	 *     @param[in] type - media type of the downloads to observe
+	 *     @param[in] observer - called as bytes arrive, on the thread writing the download; with useCurlMulti that is the reactor thread of the player's engine, so it must stay short; empty to clear
+	 *     @return void
+	 */
+	void SetDownloadWriteObserver(AampMediaType type, DownloadWriteObserver observer);
+
 	/**
 	 * @fn Run the thread loop monitoring for requested pause position
 	 */
@@ -4063,6 +4088,7 @@ protected:
 	long long lastUnderFlowTimeMs[AAMP_TRACK_COUNT];
 	bool mbTrackDownloadsBlocked[AAMP_TRACK_COUNT];
 	DrmHelperPtr mCurrentDrm;
+	std::mutex mCurrentDrmMutex;		/**< Guards mCurrentDrm, which the license pre-fetch threads set */
 	int  mPersistedProfileIndex;
 	long mAvailableBandwidth;
 	bool mProcessingDiscontinuity[AAMP_TRACK_COUNT];
@@ -4092,6 +4118,7 @@ protected:
 	bool mProgressReportFromProcessDiscontinuity; /** flag denotes if progress reporting is in execution from ProcessPendingDiscontinuity*/
 	AampEventManager *mEventManager;
 	AampCacheHandler *mAampCacheHandler;
+	std::shared_ptr<AampCurlMultiEngine> mCurlMultiEngine;	/**< Reactor for the downloads of this player when useCurlMulti is set */
 
 	int mMinInitialCacheSeconds; 		/**< Minimum cached duration before playing in seconds*/
 	std::string mDrmInitData; 		/**< DRM init data from main manifest URL (if present) */
@@ -974,7 +974,14 @@ bool MediaTrack::ProcessFragmentChunk()
 	AAMPLOG_DEBUG("[%s] cachedFragment->fragment.len [%zu] to unparsedBufferChunk.len [%zu] Required Len [%zu]", name, cachedFragment->fragment.GetLen(), unparsedBufferChunk.GetLen(), requiredLength);
 
 	//Append Cache buffer to unparsed buffer for processing
-	unparsedBufferChunk.AppendBytes( cachedFragment->fragment.GetPtr(), cachedFragment->fragment.GetLen() );
+	if( unparsedBufferChunk.GetPtr() == NULL )
+	{ // nothing left over from previous chunk; take over the chunk memory, it is freed by UpdateTSAfterChunkInject anyway
+		unparsedBufferChunk.Replace( &cachedFragment->fragment );
+	}
+	else
+	{
+		unparsedBufferChunk.AppendBytes( cachedFragment->fragment.GetPtr(), cachedFragment->fragment.GetLen() );
+	}
 
 	//Parse Chunk Data
 	IsoBmffBuffer isobuf;                   /**< Fragment Chunk buffer box parser*/
@@ -1056,7 +1063,14 @@ bool MediaTrack::ProcessFragmentChunk()
 	if(parsedBufferSize)
 	{
 		//Prepare parsed buffer
-		parsedBufferChunk.AppendBytes( unparsedBufferChunk.GetPtr(), parsedBufferSize);
+		if( unParsedBufferSize == 0 && parsedBufferChunk.GetPtr() == NULL )
+		{ // whole buffer parsed; hand it over for injection instead of copying it
+			parsedBufferChunk.Replace( &unparsedBufferChunk );
+		}
+		else
+		{
+			parsedBufferChunk.AppendBytes( unparsedBufferChunk.GetPtr(), parsedBufferSize);
+		}
 		if (ISCONFIGSET(eAAMPConfig_EnablePTSReStamp))
 		{
 			if (pContext && pContext->trickplayMode)
@@ -1095,11 +1109,7 @@ bool MediaTrack::ProcessFragmentChunk()
 	if(unParsedBufferSize)
 	{
 		AAMPLOG_TRACE("[%s] unparsed[%p] unparsed_size[%zu]", name,unParsedBuffer,unParsedBufferSize);
-		AampGrowableBuffer tempBuffer("tempBuffer");
-		tempBuffer.AppendBytes(unParsedBuffer,unParsedBufferSize);
-		unparsedBufferChunk.Free();
-		unparsedBufferChunk.AppendBytes(tempBuffer.GetPtr(),tempBuffer.GetLen());
-		tempBuffer.Free();
+		unparsedBufferChunk.MoveBytes(unParsedBuffer,unParsedBufferSize);
 	}
 	else
 	{
@@ -180,6 +180,12 @@ bool AampLogManager::disableLogRedirection = false;
 bool AampLogManager::enableEthanLogRedirection = false;
 AAMP_LogLevel AampLogManager::aampLoglevel = eLOGLEVEL_WARN;
 bool AampLogManager::locked = false;
+std::atomic<uint32_t> AampLogManager::moduleLogLevelGeneration(0);
+
+int AampLogManager::getModuleLogLevel(const char *file)
+{
+	return -1;
+}
 
 void logprintf(AAMP_LogLevel level, const char *file, int line, const char *format,
 			   ...)
@@ -49,6 +49,16 @@ const EVP_CIPHER *EVP_aes_128_ctr(void)
 	return NULL;
 }
 
+const EVP_CIPHER *EVP_aes_128_cbc(void)
+{
+	return NULL;
+}
+
+int EVP_CIPHER_CTX_set_padding(EVP_CIPHER_CTX *c, int pad)
+{
+	return 0;
+}
+
 int EVP_DecryptInit(EVP_CIPHER_CTX *ctx, const EVP_CIPHER *cipher, const unsigned char *key,
 					const unsigned char *iv)
 {
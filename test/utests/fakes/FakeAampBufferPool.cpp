@@ -0,0 +1,88 @@
+/*
+ * If not stated otherwise in this file or this component's license file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2024 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "AampBufferPool.h"
+#include <glib.h>
+
+std::atomic<bool> AampBufferPool::sEnabled(false);
+
+AampBufferPool::AampBufferPool() : mClasses(), mBytesInUse(0), mPeakBytesInUse(0), mBytesCached(0), mHits(0), mMisses(0)
+{
+}
+
+AampBufferPool::~AampBufferPool()
+{
+}
+
+AampBufferPool& AampBufferPool::GetInstance()
+{
+	static AampBufferPool instance;
+	return instance;
+}
+
+void AampBufferPool::SetEnabled(bool enable)
+{
+}
+
+bool AampBufferPool::IsEnabled()
+{
+	return false;
+}
+
+void *AampBufferPool::Allocate(size_t size, size_t &allocated)
+{
+	allocated = size;
+	return g_malloc(size);
+}
+
+void *AampBufferPool::Reallocate(void *ptr, size_t len, size_t avail, size_t size, size_t &allocated)
+{
+	allocated = size;
+	return g_realloc(ptr, size);
+}
+
+void AampBufferPool::Release(void *ptr, size_t avail)
+{
+	g_free(ptr);
+}
+
+void AampBufferPool::Detach(size_t avail)
+{
+}
+
+void AampBufferPool::UpdateExpectedSize(AampMediaType mediaType, size_t size)
+{
+}
+
+size_t AampBufferPool::GetExpectedSize(AampMediaType mediaType)
+{
+	return 0;
+}
+
+void AampBufferPool::GetStats(AampBufferPoolStats &stats)
+{
+}
+
+void AampBufferPool::LogStats()
+{
+}
+
+void AampBufferPool::Trim()
+{
+}
@@ -70,3 +70,7 @@ bool AampCacheHandler::RetrieveFromInitFragmentCache(const std::string &url, Aam
     return false;
 }
 
+
+void AampCacheHandler::SetHttpCachePolicy( const std::string &url, int maxAgeSeconds )
+{
+}
@@ -40,7 +40,7 @@ bool KeyIsQueued(LicensePreFetchObjectPtr &fetchObject)
 	return false;
 }
 
-bool AampLicensePreFetcher::QueueContentProtection(DrmHelperPtr drmHelper, std::string periodId, uint32_t adapIdx, AampMediaType type, bool isVssPeriod)
+bool AampLicensePreFetcher::QueueContentProtection(DrmHelperPtr drmHelper, std::string periodId, uint32_t adapIdx, AampMediaType type, bool isVssPeriod, double timeToPlay)
 {
 	return false;
 }
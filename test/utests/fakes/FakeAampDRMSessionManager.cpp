@@ -66,6 +66,16 @@ DrmSession * DrmSessionManager::createDrmSession(int& err,
 			return nullptr;
 		}
 		
+bool DrmSessionManager::IsKeyIdProcessed(std::vector<uint8_t> keyIdArray, bool &status)
+{
+	bool ret = false;
+	if (g_mockDRMSessionManager)
+	{
+		ret = g_mockDRMSessionManager->IsKeyIdProcessed(keyIdArray, status);
+	}
+	return ret;
+}
+
 SessionMgrState DrmSessionManager::getSessionMgrState()
 {
 	return SessionMgrState::eSESSIONMGR_INACTIVE;
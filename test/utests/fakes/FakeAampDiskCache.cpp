@@ -0,0 +1,92 @@
+/*
+ * If not stated otherwise in this file or this component's license file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2024 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "AampDiskCache.h"
+#include "MockAampDiskCache.h"
+
+MockAampDiskCache *g_mockAampDiskCache = nullptr;
+
+AampDiskCache::AampDiskCache() : mMutex(), mEnabled(false), mDirectory(), mMaxBytes(0), mTtlSeconds(0), mTotalBytes(0), mIndex(), mLru(), mGeneration(0), mTmpSequence(0)
+{
+}
+
+AampDiskCache::~AampDiskCache()
+{
+}
+
+AampDiskCache& AampDiskCache::GetInstance()
+{
+	static AampDiskCache instance;
+	return instance;
+}
+
+void AampDiskCache::Configure(bool enable, const std::string &directory, size_t maxBytes, int ttlSeconds)
+{
+}
+
+bool AampDiskCache::IsEnabled()
+{
+	if (g_mockAampDiskCache != nullptr)
+	{
+		return g_mockAampDiskCache->IsEnabled();
+	}
+	return false;
+}
+
+bool AampDiskCache::Store(const std::string &url, const AampGrowableBuffer *buffer, const std::string &effectiveUrl, AampMediaType mediaType, int maxAgeSeconds)
+{
+	if (g_mockAampDiskCache != nullptr)
+	{
+		return g_mockAampDiskCache->Store(url, buffer, effectiveUrl, mediaType, maxAgeSeconds);
+	}
+	return false;
+}
+
+bool AampDiskCache::Load(const std::string &url, AampGrowableBuffer *buffer, std::string &effectiveUrl, AampMediaType &mediaType)
+{
+	return false;
+}
+
+void AampDiskCache::Remove(const std::string &url)
+{
+}
+
+void AampDiskCache::Clear()
+{
+}
+
+size_t AampDiskCache::GetSize()
+{
+	return 0;
+}
+
+size_t AampDiskCache::GetEntryCount()
+{
+	return 0;
+}
+
+int AampDiskCache::ParseCacheControl(const std::string &value)
+{
+	return AAMP_DISK_CACHE_MAX_AGE_UNSPECIFIED;
+}
+
+bool AampDiskCache::IsCacheableMediaType(AampMediaType mediaType)
+{
+	return false;
+}
@@ -78,6 +78,19 @@ void AampEventManager::SetAsyncTuneState(bool isAsyncTuneSetting)
 {
 }
 
+void AampEventManager::SetEventBatching(bool enable)
+{
+}
+
+bool AampEventManager::GetEventStats(AAMPEventType eventType, AampEventStats &stats)
+{
+    return false;
+}
+
+void AampEventManager::LogEventStats()
+{
+}
+
 void AampEventManager::SetPlayerState(AAMPPlayerState state)
 {
 }
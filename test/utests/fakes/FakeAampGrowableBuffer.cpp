@@ -61,6 +61,12 @@ void AampGrowableBuffer::Clear( void )
 
 void AampGrowableBuffer::Replace( AampGrowableBuffer *src )
 {
+	ptr = src->ptr;
+	len = src->len;
+	avail = src->avail;
+	src->ptr = NULL;
+	src->len = 0;
+	src->avail = 0;
 }
 
 void AampGrowableBuffer::Transfer( void )
@@ -99,7 +99,7 @@ void AampDRMLicenseManager::SetLicenseFetcher(AampLicenseFetcher *fetcherInstanc
 {
 }
 
-bool AampDRMLicenseManager::QueueContentProtection(DrmHelperPtr drmHelper, std::string periodId, uint32_t adapIdx, AampMediaType type, bool isVssPeriod)
+bool AampDRMLicenseManager::QueueContentProtection(DrmHelperPtr drmHelper, std::string periodId, uint32_t adapIdx, AampMediaType type, bool isVssPeriod, double timeToPlay)
 {
 	return false;
 }
@@ -131,6 +131,15 @@ void AampDRMLicenseManager::SetCommonKeyDuration(int keyDuration)
 void AampDRMLicenseManager::notifyCleanup()
 {
 }
+DrmSession* AampDRMLicenseManager::createDrmSession(std::shared_ptr<DrmHelper> drmHelper, DrmCallbacks* aampInstance, DrmMetaDataEventPtr eventHandle, int streamTypeIn)
+{
+	DrmSession *session = nullptr;
+	if (g_mockAampLicenseManager)
+	{
+		session = g_mockAampLicenseManager->createDrmSession(drmHelper, aampInstance, eventHandle, streamTypeIn);
+	}
+	return session;
+}
 DrmSession* AampDRMLicenseManager::createDrmSession(char const*, MediaFormat, unsigned char const*, unsigned short, int, DrmCallbacks*, std::shared_ptr<DrmMetaDataEvent>, unsigned char const*, bool)
 {
 	return NULL;
@@ -49,6 +49,8 @@ bool AampLogManager::disableLogRedirection = false;
 bool AampLogManager::enableEthanLogRedirection = false;
 AAMP_LogLevel AampLogManager::aampLoglevel = TEST_LOG_LEVEL;
 bool AampLogManager::locked = true;
+std::atomic<bool> AampLogManager::asyncLogging(false);
+std::atomic<uint32_t> AampLogManager::moduleLogLevelGeneration(0);
 
 thread_local int gPlayerId = -1;
 
@@ -93,3 +95,25 @@ void logprintf(AAMP_LogLevel level, const char* file, int line, const char *form
 void DumpBlob(const unsigned char *ptr, size_t len)
 {
 }
+
+void AampLogManager::setAsyncLogging(bool enable)
+{
+}
+
+void AampLogManager::flushAsyncLog()
+{
+}
+
+uint64_t AampLogManager::getDroppedLogCount()
+{
+	return 0;
+}
+
+void AampLogManager::setModuleLogLevels(const std::string &moduleLevels)
+{
+}
+
+int AampLogManager::getModuleLogLevel(const char *file)
+{
+	return -1;
+}
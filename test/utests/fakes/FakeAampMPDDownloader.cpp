@@ -55,7 +55,7 @@ std::shared_ptr<_manifestDownloadResponse> _manifestDownloadResponse::clone()
  *   @fn parseMPD
  *   @brief parseMPD function to parse the downloaded MPD file
  */
-void _manifestDownloadResponse::parseMPD()
+void _manifestDownloadResponse::parseMPD(MPDNodeCache *nodeCache, bool streamingParser)
 {
 }
 
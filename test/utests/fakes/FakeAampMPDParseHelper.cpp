@@ -242,4 +242,56 @@ double AampMPDParseHelper::GetPeriodNewContentDurationMs(IPeriod * period, uint6
 bool AampMPDParseHelper::aamp_HasSegmentTimeline(IPeriod * period)
 {
 	return false;
-}
\ No newline at end of file
+}
+SegmentTimelineIndex::SegmentTimelineIndex() : mRuns(), mValid(false), mImplicitStartRuns(0), mDiscontinuousRuns(0), mReusedRuns(0),
+	mSource(NULL), mSourceSize(0), mSourceFront(NULL), mSourceBack(NULL)
+{
+}
+
+bool SegmentTimelineIndex::Update(const std::vector<ITimeline *> &timelines)
+{
+	return false;
+}
+
+void SegmentTimelineIndex::Clear()
+{
+}
+
+uint64_t SegmentTimelineIndex::GetSegmentCount() const
+{
+	return 0;
+}
+
+uint64_t SegmentTimelineIndex::GetSegmentIndex(int timeLineIndex, uint32_t repeatIndex) const
+{
+	return 0;
+}
+
+uint64_t SegmentTimelineIndex::GetSegmentTime(int timeLineIndex, uint32_t repeatIndex) const
+{
+	return 0;
+}
+
+uint64_t SegmentTimelineIndex::GetMediaOffset(int timeLineIndex, uint32_t repeatIndex) const
+{
+	return 0;
+}
+
+bool SegmentTimelineIndex::FindSegment(uint64_t segmentIndex, int &timeLineIndex, uint32_t &repeatIndex) const
+{
+	return false;
+}
+
+bool SegmentTimelineIndex::FindTime(uint64_t time, int &timeLineIndex, uint32_t &repeatIndex) const
+{
+	return false;
+}
+
+void SegmentTimelineIndex::FindMediaOffset(uint64_t mediaOffset, int &timeLineIndex, uint32_t &repeatIndex) const
+{
+}
+
+int SegmentTimelineIndex::FindRunEndingAfter(uint64_t time, int fromIndex) const
+{
+	return 0;
+}
@@ -26,4 +26,29 @@ double ComputeFragmentDuration( uint32_t duration, uint32_t timeScale )
 bool IsCompatibleMimeType(const std::string& mimeType, AampMediaType mediaType)
 {
 	return false;
-}
\ No newline at end of file
+}
+MPDNodeCache::MPDNodeCache() : mEntries(), mElements(), mKeys(), mRefs()
+{
+}
+
+MPDNodeCache::~MPDNodeCache()
+{
+}
+
+bool MPDNodeCache::Prepare(const std::string &manifest, std::string &prepared)
+{
+	return false;
+}
+
+Node *MPDNodeCache::GetNode(Node *placeholder, const std::string &url)
+{
+	return NULL;
+}
+
+void MPDNodeCache::Commit(const Node *root)
+{
+}
+
+void MPDNodeCache::Clear()
+{
+}
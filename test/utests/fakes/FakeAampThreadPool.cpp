@@ -0,0 +1,74 @@
+/*
+ * If not stated otherwise in this file or this component's license file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2024 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "AampThreadPool.h"
+
+std::atomic<bool> AampThreadPool::sEnabled(false);
+
+AampThreadPool::AampThreadPool() : mWorkers(), mWorkerCount(0), mBaseWorkers(0), mReserveMutex(), mReserved(0), mWakeMutex(), mWakeCond(), mPending(0), mNextWorker(0), mSteals(0), mStop(false)
+{
+}
+
+AampThreadPool::~AampThreadPool()
+{
+}
+
+AampThreadPool& AampThreadPool::GetInstance()
+{
+	static AampThreadPool instance;
+	return instance;
+}
+
+void AampThreadPool::SetEnabled(bool enable)
+{
+}
+
+bool AampThreadPool::IsEnabled()
+{
+	return false;
+}
+
+bool AampThreadPool::ReserveWorker()
+{
+	return false;
+}
+
+void AampThreadPool::ReleaseWorker()
+{
+}
+
+size_t AampThreadPool::GetWorkerCount() const
+{
+	return 0;
+}
+
+size_t AampThreadPool::GetReservedCount() const
+{
+	return 0;
+}
+
+size_t AampThreadPool::GetStealCount() const
+{
+	return 0;
+}
+
+void AampThreadPool::Submit(std::function<void()> task, AampTaskPriority priority)
+{ // no workers; run inline
+	task();
+}
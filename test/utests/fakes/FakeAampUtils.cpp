@@ -553,6 +553,17 @@ bool aamp_StartsWith(const char *inputStr, const char *prefix)
 	return rc;
 }
 
+size_t aamp_GetByteRangeLength(const char *range)
+{
+	size_t length = 0;
+	size_t rangeStart = 0, rangeEnd = 0;
+	if( range && 2 == sscanf(range, "%zu-%zu", &rangeStart, &rangeEnd) && rangeEnd >= rangeStart )
+	{
+		length = rangeEnd - rangeStart + 1;
+	}
+	return length;
+}
+
 std::string aamp_GetConfigPath(const std::string &filename)
 {
 	if (g_mockAampUtils != nullptr)
@@ -617,5 +628,10 @@ int aamp_SetThreadSchedulingParameters(int policy, int priority)
 	return 0;
 }
 
+int aamp_GetDeferTimeMs(long maxTimeSeconds)
+{
+	return 0;
+}
+
 // aamp_ApplyPageHttpHeaders not actually part of AampUtils.cpp, but fake declared here for convenience
 extern "C" void aamp_ApplyPageHttpHeaders(PlayerInstanceAAMP *aamp){}
@@ -678,6 +678,18 @@ void PrivateInstanceAAMP::SendErrorEvent(AAMPTuneFailure tuneFailure, const char
 	}
 }
 
+void PrivateInstanceAAMP::SendDRMMetaData(DrmMetaDataEventPtr e)
+{
+}
+
+void PrivateInstanceAAMP::SendDrmErrorEvent(DrmMetaDataEventPtr event, bool isRetryEnabled)
+{
+	if (g_mockPrivateInstanceAAMP != nullptr)
+	{
+		g_mockPrivateInstanceAAMP->SendDrmErrorEvent(event, isRetryEnabled);
+	}
+}
+
 void PrivateInstanceAAMP::SetCurlTimeout(long timeoutMS, AampCurlInstance instance)
 {
 }
@@ -1691,3 +1703,7 @@ double PrivateInstanceAAMP::GetFormatPositionOffsetInMSecs()
 {
 	return 0;
 }
+
+void PrivateInstanceAAMP::SetDownloadWriteObserver(AampMediaType type, DownloadWriteObserver observer)
+{
+}
@@ -21,6 +21,7 @@
 #include "MockStreamAbstractionAAMP.h"
 
 MockStreamAbstractionAAMP *g_mockStreamAbstractionAAMP = nullptr;
+MockMediaTrackFetchBuffer *g_mockMediaTrackFetchBuffer = nullptr;
 
 StreamAbstractionAAMP::StreamAbstractionAAMP(PrivateInstanceAAMP* aamp, id3_callback_t mID3Handler) : aamp(nullptr), mAudiostateChangeCount(0), mESChangeStatus(false)
 {
@@ -348,7 +349,11 @@ bool StreamAbstractionAAMP::IsStreamerAtLivePoint(double seekPosition)
 
 CachedFragment* MediaTrack::GetFetchChunkBuffer(bool initialize)
 {
-	 return NULL;
+	if (g_mockMediaTrackFetchBuffer != nullptr)
+	{
+		return g_mockMediaTrackFetchBuffer->GetFetchChunkBuffer(initialize);
+	}
+	return NULL;
 }
 
 void MediaTrack::UpdateTSAfterChunkFetch()
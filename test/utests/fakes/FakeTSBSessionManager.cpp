@@ -108,7 +108,7 @@ std::shared_ptr<AampTsbReader> AampTSBSessionManager::GetTsbReader(AampMediaType
 	return reader;
 }
 
-void AampTSBSessionManager::ProcessWriteQueue()
+void AampTSBSessionManager::ProcessWriteQueue(AampMediaType mediaType)
 {
 }
 
@@ -143,6 +143,10 @@ void AampTSBSessionManager::InitializeDataManagers()
 {
 }
 
+void AampTSBSessionManager::InitializeWriteLanes()
+{
+}
+
 BitsPerSecond AampTSBSessionManager::GetVideoBitrate()
 {
 	return 0;
@@ -242,7 +246,7 @@ std::shared_ptr<CachedFragment> AampTSBSessionManager::Read(TsbFragmentDataPtr f
 	return nullptr;
 }
 
-TsbFragmentDataPtr AampTSBSessionManager::RemoveFragmentDeleteInit(AampMediaType mediatype)
+TsbFragmentDataPtr AampTSBSessionManager::RemoveOldestFragment(AampMediaType mediatype, std::string &initUrl)
 {
 	return nullptr;
 }
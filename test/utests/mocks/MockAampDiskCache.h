@@ -0,0 +1,35 @@
+/*
+* If not stated otherwise in this file or this component's license file the
+* following copyright and licenses apply:
+*
+* Copyright 2025 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#ifndef AAMP_MOCK_DISK_CACHE_H
+#define AAMP_MOCK_DISK_CACHE_H
+
+#include <gmock/gmock.h>
+#include "AampDiskCache.h"
+
+class MockAampDiskCache
+{
+public:
+	MOCK_METHOD(bool, IsEnabled, ());
+	MOCK_METHOD(bool, Store, (const std::string &url, const AampGrowableBuffer *buffer, const std::string &effectiveUrl, AampMediaType mediaType, int maxAgeSeconds));
+};
+
+extern MockAampDiskCache *g_mockAampDiskCache;
+
+#endif /* AAMP_MOCK_DISK_CACHE_H */
@@ -49,6 +49,12 @@ public:
 	MOCK_METHOD(double, GetTotalInjectedDuration, (), (override));
 };
 
+class MockMediaTrackFetchBuffer
+{
+public:
+	MOCK_METHOD(CachedFragment*, GetFetchChunkBuffer, (bool initialize));
+};
+
 class MockStreamAbstractionAAMP : public StreamAbstractionAAMP
 {
 public:
@@ -119,5 +125,6 @@ public:
 };
 
 extern MockStreamAbstractionAAMP *g_mockStreamAbstractionAAMP;
+extern MockMediaTrackFetchBuffer *g_mockMediaTrackFetchBuffer;
 
 #endif /* AAMP_MOCK_STREAM_ABSTRACTION_AAMP_H */
@@ -22,6 +22,7 @@
 #include "AampMediaType.h"
 
 #include "MockAampGrowableBuffer.h"
+#include "MockAampDiskCache.h"
 
 using namespace testing;
 AampConfig *gpGlobalConfig{nullptr};
@@ -348,3 +349,54 @@ TEST_F(AampCacheHandlerTest, InitFragCacheLRU)
 	}
 	EXPECT_TRUE( ret == expected );
 }
+
+TEST_F(AampCacheHandlerTest, HttpCachePolicyEvictsOldest)
+{
+	g_mockAampDiskCache = new NiceMock<MockAampDiskCache>();
+	EXPECT_CALL(*g_mockAampDiskCache, IsEnabled()).WillRepeatedly(Return(true));
+	// one policy more than retained; only the oldest may be dropped
+	for( int i=0; i<=32; i++ )
+	{
+		handler->SetHttpCachePolicy( "url"+std::to_string(i), 100+i );
+	}
+	AampGrowableBuffer buffer("HttpCachePolicy_Data");
+	std::string data = "data";
+	buffer.AppendBytes(data.c_str(), data.size());
+
+	EXPECT_CALL(*g_mockAampDiskCache, Store("url0", _, _, _, AAMP_DISK_CACHE_MAX_AGE_UNSPECIFIED)).WillOnce(Return(true));
+	handler->InsertToInitFragCache( "url0", &buffer, "url0", eMEDIATYPE_INIT_VIDEO );
+	EXPECT_CALL(*g_mockAampDiskCache, Store("url1", _, _, _, 101)).WillOnce(Return(true));
+	handler->InsertToInitFragCache( "url1", &buffer, "url1", eMEDIATYPE_INIT_VIDEO );
+	EXPECT_CALL(*g_mockAampDiskCache, Store("url32", _, _, _, 132)).WillOnce(Return(true));
+	handler->InsertToInitFragCache( "url32", &buffer, "url32", eMEDIATYPE_INIT_VIDEO );
+	// policy is claimed by the insert
+	EXPECT_CALL(*g_mockAampDiskCache, Store("url1", _, _, _, AAMP_DISK_CACHE_MAX_AGE_UNSPECIFIED)).WillOnce(Return(true));
+	handler->InsertToInitFragCache( "url1", &buffer, "url1", eMEDIATYPE_INIT_VIDEO );
+
+	delete g_mockAampDiskCache;
+	g_mockAampDiskCache = nullptr;
+}
+
+TEST_F(AampCacheHandlerTest, HttpCachePolicyRefreshKeepsEntry)
+{
+	g_mockAampDiskCache = new NiceMock<MockAampDiskCache>();
+	EXPECT_CALL(*g_mockAampDiskCache, IsEnabled()).WillRepeatedly(Return(true));
+	for( int i=0; i<32; i++ )
+	{
+		handler->SetHttpCachePolicy( "url"+std::to_string(i), 100+i );
+	}
+	// a repeated download of url0 makes it the newest, so url1 is dropped instead
+	handler->SetHttpCachePolicy( "url0", 50 );
+	handler->SetHttpCachePolicy( "url32", 132 );
+	AampGrowableBuffer buffer("HttpCachePolicy_Data");
+	std::string data = "data";
+	buffer.AppendBytes(data.c_str(), data.size());
+
+	EXPECT_CALL(*g_mockAampDiskCache, Store("url0", _, _, _, 50)).WillOnce(Return(true));
+	handler->InsertToInitFragCache( "url0", &buffer, "url0", eMEDIATYPE_INIT_VIDEO );
+	EXPECT_CALL(*g_mockAampDiskCache, Store("url1", _, _, _, AAMP_DISK_CACHE_MAX_AGE_UNSPECIFIED)).WillOnce(Return(true));
+	handler->InsertToInitFragCache( "url1", &buffer, "url1", eMEDIATYPE_INIT_VIDEO );
+
+	delete g_mockAampDiskCache;
+	g_mockAampDiskCache = nullptr;
+}
@@ -0,0 +1,203 @@
+/*
+* If not stated otherwise in this file or this component's license file the
+* following copyright and licenses apply:
+*
+* Copyright 2024 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <gtest/gtest.h>
+#include "AampCurlMultiEngine.h"
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+#include <stdlib.h>
+#include <unistd.h>
+
+class AampCurlMultiEngineTests : public ::testing::Test
+{
+protected:
+	/**
+	 * @brief Write callback context of a test transfer
+	 */
+	struct Sink
+	{
+		std::string data;
+		std::promise<void> *entered;	/**< set on the first callback, if not null */
+		std::shared_future<void> release;	/**< waited for on the first callback, if valid */
+
+		Sink() : data(), entered(nullptr), release()
+		{
+		}
+	};
+
+	static size_t WriteCallback(char *ptr, size_t size, size_t nmemb, void *userdata)
+	{
+		Sink *sink = (Sink *)userdata;
+		if( sink->data.empty() )
+		{
+			if( sink->entered )
+			{
+				sink->entered->set_value();
+			}
+			if( sink->release.valid() )
+			{
+				sink->release.wait();
+			}
+		}
+		sink->data.append(ptr, size * nmemb);
+		return size * nmemb;
+	}
+
+	void SetUp() override
+	{
+		curl_global_init(CURL_GLOBAL_DEFAULT);
+		char dirTemplate[] = "/tmp/aampCurlMultiXXXXXX";
+		mDirectory = mkdtemp(dirTemplate);
+	}
+
+	void TearDown() override
+	{
+		for( auto &file : mFiles )
+		{
+			unlink(file.c_str());
+		}
+		rmdir(mDirectory.c_str());
+		curl_global_cleanup();
+	}
+
+	/**
+	 * @brief Create a file to download
+	 * @return file:// url of the file
+	 */
+	std::string CreateFile(const std::string &name, const std::string &content)
+	{
+		std::string path = mDirectory + "/" + name;
+		std::ofstream(path, std::ios::binary) << content;
+		mFiles.push_back(path);
+		return "file://" + path;
+	}
+
+	CURL *CreateHandle(const std::string &url, Sink *sink)
+	{
+		CURL *curl = curl_easy_init();
+		curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+		curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
+		curl_easy_setopt(curl, CURLOPT_WRITEDATA, sink);
+		return curl;
+	}
+
+	std::string mDirectory;
+	std::vector<std::string> mFiles;
+};
+
+TEST_F(AampCurlMultiEngineTests, PerformsConcurrentTransfers)
+{
+	AampCurlMultiEngine engine;
+	const int count = 8;
+	std::vector<std::string> urls;
+	std::vector<std::string> contents;
+	for( int i = 0; i < count; i++ )
+	{
+		contents.push_back(std::string(1000 * (i + 1), (char)('a' + i)));
+		urls.push_back(CreateFile("file" + std::to_string(i), contents[i]));
+	}
+
+	std::vector<Sink> sinks(count);
+	std::vector<CURLcode> results(count, CURLE_FAILED_INIT);
+	std::vector<std::thread> threads;
+	for( int i = 0; i < count; i++ )
+	{
+		threads.push_back(std::thread([&, i]() {
+			CURL *curl = CreateHandle(urls[i], &sinks[i]);
+			results[i] = engine.Perform(curl);
+			curl_easy_cleanup(curl);
+		}));
+	}
+	for( auto &thread : threads )
+	{
+		thread.join();
+	}
+	for( int i = 0; i < count; i++ )
+	{
+		EXPECT_EQ(results[i], CURLE_OK);
+		EXPECT_EQ(sinks[i].data, contents[i]);
+	}
+	EXPECT_EQ(engine.GetActiveTransferCount(), 0);
+}
+
+TEST_F(AampCurlMultiEngineTests, ReportsTransferError)
+{
+	AampCurlMultiEngine engine;
+	Sink sink;
+	CURL *curl = CreateHandle("file://" + mDirectory + "/missing", &sink);
+	EXPECT_EQ(engine.Perform(curl), CURLE_FILE_COULDNT_READ_FILE);
+	curl_easy_cleanup(curl);
+}
+
+TEST_F(AampCurlMultiEngineTests, HandleReusableAfterTransfer)
+{
+	AampCurlMultiEngine engine;
+	std::string url = CreateFile("reused", "content");
+	Sink sink;
+	CURL *curl = CreateHandle(url, &sink);
+	EXPECT_EQ(engine.Perform(curl), CURLE_OK);
+	EXPECT_EQ(engine.Perform(curl), CURLE_OK);
+	EXPECT_EQ(curl_easy_perform(curl), CURLE_OK);
+	EXPECT_EQ(sink.data, "contentcontentcontent");
+	long responseCode = -1;
+	curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &responseCode);
+	EXPECT_EQ(responseCode, 0);
+	curl_easy_cleanup(curl);
+}
+
+TEST_F(AampCurlMultiEngineTests, BlockedCallbackDoesNotStallOtherEngine)
+{
+	AampCurlMultiEngine blockedEngine;
+	AampCurlMultiEngine otherEngine;
+	std::string url = CreateFile("data", std::string(4096, 'x'));
+
+	std::promise<void> entered;
+	std::promise<void> release;
+	Sink blockedSink;
+	blockedSink.entered = &entered;
+	blockedSink.release = release.get_future().share();
+	CURL *blockedCurl = CreateHandle(url, &blockedSink);
+	std::future<CURLcode> blockedResult = std::async(std::launch::async, [&]() { return blockedEngine.Perform(blockedCurl); });
+	entered.get_future().wait();
+
+	// the reactor of the other player keeps going while the first one is stuck in a callback
+	Sink otherSink;
+	CURL *otherCurl = CreateHandle(url, &otherSink);
+	EXPECT_EQ(otherEngine.Perform(otherCurl), CURLE_OK);
+	EXPECT_EQ(otherSink.data.size(), 4096);
+	EXPECT_EQ(blockedResult.wait_for(std::chrono::milliseconds(0)), std::future_status::timeout);
+
+	release.set_value();
+	EXPECT_EQ(blockedResult.get(), CURLE_OK);
+	EXPECT_EQ(blockedSink.data.size(), 4096);
+	curl_easy_cleanup(blockedCurl);
+	curl_easy_cleanup(otherCurl);
+}
+
+int main(int argc, char** argv)
+{
+	testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
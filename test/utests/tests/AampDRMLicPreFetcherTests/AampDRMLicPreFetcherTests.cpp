@@ -0,0 +1,334 @@
+/*
+* If not stated otherwise in this file or this component's license file the
+* following copyright and licenses apply:
+*
+* Copyright 2025 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "AampDRMLicPreFetcher.h"
+#include "DrmSessionManager.h"
+#include "priv_aamp.h"
+#include "MockAampConfig.h"
+#include "MockAampLicManager.h"
+#include "MockAampDRMSessionManager.h"
+#include "MockDrmHelper.h"
+#include "MockPrivateInstanceAAMP.h"
+
+using ::testing::_;
+using ::testing::Invoke;
+using ::testing::NiceMock;
+using ::testing::Return;
+using ::testing::ReturnRef;
+using ::testing::SetArgReferee;
+
+AampConfig *gpGlobalConfig{nullptr};
+
+/**
+ * @brief License fetcher recording the requests the pre-fetcher marks as failed
+ */
+class TestLicenseFetcher : public AampLicenseFetcher
+{
+public:
+	MOCK_METHOD(void, UpdateFailedDRMStatus, (LicensePreFetchObject *object), (override));
+};
+
+class AampDRMLicPreFetcherTests : public ::testing::Test
+{
+protected:
+	AampConfig *mConfig;
+	PrivateInstanceAAMP *mPrivateInstanceAAMP;
+	AampDRMLicenseManager *mLicenseManager;
+	DrmSessionManager *mSessionManager;
+	AampLicensePreFetcher *mPreFetcher;
+	std::string mSystemId;
+	char mSessionPlaceholder;
+	DrmSession *mSession;                 /**< Returned for a successful session; only ever checked against null */
+	std::mutex mOrderMutex;
+	std::vector<uint8_t> mSessionOrder;   /**< Key ID byte of each createDrmSession call, in call order */
+	std::promise<void> mRelease;
+	std::shared_future<void> mReleased;
+
+	void SetUp() override
+	{
+		g_mockAampConfig = new NiceMock<MockAampConfig>();
+		g_mockPrivateInstanceAAMP = new NiceMock<MockPrivateInstanceAAMP>();
+		g_mockAampLicenseManager = new NiceMock<MockAampLicenseManager>();
+		g_mockDRMSessionManager = new NiceMock<MockDRMSessionManager>();
+
+		mConfig = new AampConfig();
+		mPrivateInstanceAAMP = new PrivateInstanceAAMP(mConfig);
+		mLicenseManager = new AampDRMLicenseManager(1, mPrivateInstanceAAMP);
+		mSessionManager = new DrmSessionManager(1, mPrivateInstanceAAMP, nullptr);
+		mLicenseManager->mDrmSessionManager = mSessionManager;
+		mPrivateInstanceAAMP->mDRMLicenseManager = mLicenseManager;
+		mPreFetcher = nullptr;
+
+		mSystemId = "edef8ba9-79d6-4ace-a3c8-27dcd51d21ed";
+		mSession = reinterpret_cast<DrmSession *>(&mSessionPlaceholder);
+		mReleased = mRelease.get_future().share();
+
+		ON_CALL(*g_mockDRMSessionManager, IsKeyIdProcessed(_, _)).WillByDefault(Return(false));
+		ON_CALL(*g_mockAampLicenseManager, createDrmSession(_, _, _, _)).WillByDefault(Invoke(
+			[this](std::shared_ptr<DrmHelper> drmHelper, DrmCallbacks *, DrmMetaDataEventPtr, int) -> DrmSession *
+			{
+				std::vector<uint8_t> keyId;
+				drmHelper->getKey(keyId);
+				{
+					std::lock_guard<std::mutex> lock(mOrderMutex);
+					mSessionOrder.push_back(keyId.at(0));
+				}
+				// Key 0 holds its worker until the test has queued everything else
+				if (keyId.at(0) == 0)
+				{
+					mReleased.wait();
+				}
+				// Odd key IDs fail
+				return (keyId.at(0) & 1) ? nullptr : mSession;
+			}));
+	}
+
+	void TearDown() override
+	{
+		ReleaseBlockedRequest();
+		delete mPreFetcher;
+		mPreFetcher = nullptr;
+
+		mPrivateInstanceAAMP->mDRMLicenseManager = nullptr;
+		delete mSessionManager;
+		mSessionManager = nullptr;
+		delete mLicenseManager;
+		mLicenseManager = nullptr;
+		delete mPrivateInstanceAAMP;
+		mPrivateInstanceAAMP = nullptr;
+		delete mConfig;
+		mConfig = nullptr;
+
+		delete g_mockDRMSessionManager;
+		g_mockDRMSessionManager = nullptr;
+		delete g_mockAampLicenseManager;
+		g_mockAampLicenseManager = nullptr;
+		delete g_mockPrivateInstanceAAMP;
+		g_mockPrivateInstanceAAMP = nullptr;
+		delete g_mockAampConfig;
+		g_mockAampConfig = nullptr;
+	}
+
+	void CreatePreFetcher(int workers)
+	{
+		ON_CALL(*g_mockAampConfig, GetConfigValue(eAAMPConfig_LicensePrefetchWorkers)).WillByDefault(Return(workers));
+		mPreFetcher = new AampLicensePreFetcher(mPrivateInstanceAAMP);
+		mPreFetcher->Init();
+	}
+
+	DrmHelperPtr CreateHelper(uint8_t key)
+	{
+		auto helper = std::make_shared<NiceMock<MockDrmHelper>>();
+		ON_CALL(*helper, getKey(_)).WillByDefault(SetArgReferee<0>(std::vector<uint8_t>(16, key)));
+		ON_CALL(*helper, ocdmSystemId()).WillByDefault(ReturnRef(mSystemId));
+		ON_CALL(*helper, getUuid()).WillByDefault(ReturnRef(mSystemId));
+		return helper;
+	}
+
+	void ReleaseBlockedRequest()
+	{
+		if (mReleased.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+		{
+			mRelease.set_value();
+		}
+	}
+
+	/**
+	 * @brief Wait for the pre-fetcher to process a number of requests
+	 */
+	bool WaitForRequests(unsigned int requests)
+	{
+		for (int i = 0; i < 500; i++)
+		{
+			if (mPreFetcher->GetStats().requests >= requests)
+			{
+				return true;
+			}
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		}
+		return false;
+	}
+
+	/**
+	 * @brief Wait for a number of createDrmSession calls to have started
+	 */
+	bool WaitForSessions(size_t sessions)
+	{
+		for (int i = 0; i < 500; i++)
+		{
+			{
+				std::lock_guard<std::mutex> lock(mOrderMutex);
+				if (mSessionOrder.size() >= sessions)
+				{
+					return true;
+				}
+			}
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		}
+		return false;
+	}
+
+	std::vector<uint8_t> GetSessionOrder()
+	{
+		std::lock_guard<std::mutex> lock(mOrderMutex);
+		return mSessionOrder;
+	}
+};
+
+/**
+ * @brief A track requesting a key another track already queued shares its request
+ */
+TEST_F(AampDRMLicPreFetcherTests, SameKeyForTwoTracksCreatesOneSession)
+{
+	CreatePreFetcher(1);
+	EXPECT_TRUE(mPreFetcher->QueueContentProtection(CreateHelper(0), "p0", 0, eMEDIATYPE_VIDEO));
+	ASSERT_TRUE(WaitForSessions(1));
+
+	EXPECT_TRUE(mPreFetcher->QueueContentProtection(CreateHelper(2), "p1", 0, eMEDIATYPE_VIDEO));
+	EXPECT_TRUE(mPreFetcher->QueueContentProtection(CreateHelper(2), "p1", 1, eMEDIATYPE_AUDIO));
+	// Requeued by the same track, already covered by its queued request
+	EXPECT_TRUE(mPreFetcher->QueueContentProtection(CreateHelper(2), "p1", 1, eMEDIATYPE_AUDIO));
+	ReleaseBlockedRequest();
+
+	ASSERT_TRUE(WaitForRequests(2));
+	EXPECT_EQ(GetSessionOrder(), (std::vector<uint8_t>{0, 2}));
+	LicensePreFetchStats stats = mPreFetcher->GetStats();
+	EXPECT_EQ(stats.requests, 2u);
+	EXPECT_EQ(stats.deduplicated, 1u);
+	EXPECT_EQ(stats.failures, 0u);
+}
+
+/**
+ * @brief A request for the key of an in progress request shares it too
+ */
+TEST_F(AampDRMLicPreFetcherTests, SameKeyAsInFlightRequestCreatesOneSession)
+{
+	CreatePreFetcher(1);
+	EXPECT_TRUE(mPreFetcher->QueueContentProtection(CreateHelper(0), "p0", 0, eMEDIATYPE_VIDEO));
+	ASSERT_TRUE(WaitForSessions(1));
+
+	EXPECT_TRUE(mPreFetcher->QueueContentProtection(CreateHelper(0), "p0", 1, eMEDIATYPE_AUDIO));
+	ReleaseBlockedRequest();
+
+	ASSERT_TRUE(WaitForRequests(1));
+	EXPECT_EQ(GetSessionOrder(), (std::vector<uint8_t>{0}));
+	EXPECT_EQ(mPreFetcher->GetStats().deduplicated, 1u);
+}
+
+/**
+ * @brief Queued requests are processed earliest deadline first, queue order among equal deadlines
+ */
+TEST_F(AampDRMLicPreFetcherTests, EarliestDeadlineFirst)
+{
+	CreatePreFetcher(1);
+	EXPECT_TRUE(mPreFetcher->QueueContentProtection(CreateHelper(0), "p0", 0, eMEDIATYPE_VIDEO));
+	ASSERT_TRUE(WaitForSessions(1));
+
+	EXPECT_TRUE(mPreFetcher->QueueContentProtection(CreateHelper(2), "p3", 0, eMEDIATYPE_VIDEO, false, 90.0));
+	EXPECT_TRUE(mPreFetcher->QueueContentProtection(CreateHelper(4), "p2", 0, eMEDIATYPE_VIDEO, false, 60.0));
+	EXPECT_TRUE(mPreFetcher->QueueContentProtection(CreateHelper(6), "p1", 0, eMEDIATYPE_VIDEO, false, 30.0));
+	EXPECT_TRUE(mPreFetcher->QueueContentProtection(CreateHelper(8), "p1", 1, eMEDIATYPE_AUDIO, false, 30.0));
+	ReleaseBlockedRequest();
+
+	ASSERT_TRUE(WaitForRequests(5));
+	EXPECT_EQ(GetSessionOrder(), (std::vector<uint8_t>{0, 6, 8, 4, 2}));
+	EXPECT_EQ(mPreFetcher->GetStats().missedDeadlines, 0u);
+}
+
+/**
+ * @brief A failure is not reported while another request for the same track is in progress
+ */
+TEST_F(AampDRMLicPreFetcherTests, FailureWithRequestInFlightIsNotReported)
+{
+	TestLicenseFetcher fetcher;
+	CreatePreFetcher(2);
+	mPreFetcher->SetLicenseFetcher(&fetcher);
+	mPreFetcher->SetSendErrorOnFailure(false);
+
+	EXPECT_CALL(*g_mockPrivateInstanceAAMP, SendDrmErrorEvent(_, _)).Times(0);
+	EXPECT_CALL(fetcher, UpdateFailedDRMStatus(_)).Times(1);
+
+	EXPECT_TRUE(mPreFetcher->QueueContentProtection(CreateHelper(0), "p0", 0, eMEDIATYPE_VIDEO));
+	ASSERT_TRUE(WaitForSessions(1));
+	// The second worker fails this one while the first is still acquiring the video license
+	EXPECT_TRUE(mPreFetcher->QueueContentProtection(CreateHelper(1), "p1", 0, eMEDIATYPE_VIDEO));
+	ASSERT_TRUE(WaitForRequests(1));
+	ReleaseBlockedRequest();
+
+	ASSERT_TRUE(WaitForRequests(2));
+	EXPECT_EQ(mPreFetcher->GetStats().failures, 1u);
+}
+
+/**
+ * @brief A failure is reported when no other request can provide a license for the track
+ */
+TEST_F(AampDRMLicPreFetcherTests, FailureWithoutPendingRequestIsReported)
+{
+	TestLicenseFetcher fetcher;
+	CreatePreFetcher(2);
+	mPreFetcher->SetLicenseFetcher(&fetcher);
+	mPreFetcher->SetSendErrorOnFailure(false);
+
+	EXPECT_CALL(*g_mockPrivateInstanceAAMP, SendDrmErrorEvent(_, _)).Times(1);
+	EXPECT_CALL(fetcher, UpdateFailedDRMStatus(_)).Times(0);
+
+	EXPECT_TRUE(mPreFetcher->QueueContentProtection(CreateHelper(0), "p0", 0, eMEDIATYPE_AUDIO));
+	ASSERT_TRUE(WaitForSessions(1));
+	// Only an audio request is in progress, nothing else can provide the video license
+	EXPECT_TRUE(mPreFetcher->QueueContentProtection(CreateHelper(1), "p1", 0, eMEDIATYPE_VIDEO));
+	ASSERT_TRUE(WaitForRequests(1));
+	ReleaseBlockedRequest();
+
+	ASSERT_TRUE(WaitForRequests(2));
+	EXPECT_EQ(mPreFetcher->GetStats().failures, 1u);
+}
+
+/**
+ * @brief A request completing after Term does not mark its track as licensed for the next tune
+ */
+TEST_F(AampDRMLicPreFetcherTests, RequestCompletedAfterTermIsIgnored)
+{
+	TestLicenseFetcher fetcher;
+	CreatePreFetcher(1);
+	mPreFetcher->SetSendErrorOnFailure(false);
+
+	EXPECT_CALL(*g_mockPrivateInstanceAAMP, SendDrmErrorEvent(_, _)).Times(1);
+	EXPECT_CALL(fetcher, UpdateFailedDRMStatus(_)).Times(0);
+
+	EXPECT_TRUE(mPreFetcher->QueueContentProtection(CreateHelper(0), "p0", 0, eMEDIATYPE_VIDEO));
+	ASSERT_TRUE(WaitForSessions(1));
+	mPreFetcher->Term();
+	mPreFetcher->Init();
+	mPreFetcher->SetLicenseFetcher(&fetcher);
+	ReleaseBlockedRequest();
+
+	// The only worker finishes the stale request first; the video failure of the new tune must still be reported
+	EXPECT_TRUE(mPreFetcher->QueueContentProtection(CreateHelper(1), "p1", 0, eMEDIATYPE_VIDEO));
+	ASSERT_TRUE(WaitForRequests(1));
+	LicensePreFetchStats stats = mPreFetcher->GetStats();
+	EXPECT_EQ(stats.requests, 1u);
+	EXPECT_EQ(stats.failures, 1u);
+}
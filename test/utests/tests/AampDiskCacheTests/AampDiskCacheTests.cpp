@@ -0,0 +1,349 @@
+/*
+* If not stated otherwise in this file or this component's license file the
+* following copyright and licenses apply:
+*
+* Copyright 2024 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "MockGLib.h"
+#include "AampDiskCache.h"
+#include "AampGrowableBuffer.h"
+
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/stat.h>
+
+using ::testing::NiceMock;
+using ::testing::_;
+
+class AampDiskCacheTests : public ::testing::Test
+{
+protected:
+	AampDiskCacheTests()
+	{
+		callMalloc = [](size_t size){ return malloc(size); };
+		callFree = [](gpointer ptr){ free(ptr); return; };
+	}
+
+	void SetUp() override
+	{
+		g_mockGLib = new NiceMock<MockGLib>();
+		ON_CALL(*g_mockGLib, g_malloc(_)).WillByDefault(callMalloc);
+		ON_CALL(*g_mockGLib, g_free(_)).WillByDefault(callFree);
+		char dirTemplate[] = "/tmp/aampDiskCacheXXXXXX";
+		mDirectory = mkdtemp(dirTemplate);
+		AampDiskCache::GetInstance().Configure(true, mDirectory, 64*1024, 3600);
+	}
+
+	void TearDown() override
+	{
+		AampDiskCache::GetInstance().Clear();
+		AampDiskCache::GetInstance().Configure(false, "", 0, 0);
+		rmdir(mDirectory.c_str());
+		delete g_mockGLib;
+		g_mockGLib = nullptr;
+	}
+
+	/**
+	 * @brief simulate a process restart by switching to another directory and back, which rebuilds the index
+	 */
+	void Reopen()
+	{
+		char dirTemplate[] = "/tmp/aampDiskCacheXXXXXX";
+		std::string other = mkdtemp(dirTemplate);
+		AampDiskCache::GetInstance().Configure(true, other, 64*1024, 3600);
+		AampDiskCache::GetInstance().Configure(true, mDirectory, 64*1024, 3600);
+		rmdir(other.c_str());
+	}
+
+	void Store(const std::string &url, size_t len, char fill, int maxAge = AAMP_DISK_CACHE_MAX_AGE_UNSPECIFIED)
+	{
+		AampGrowableBuffer buffer("test");
+		std::string data(len, fill);
+		buffer.AppendBytes(data.data(), data.size());
+		AampDiskCache::GetInstance().Store(url, &buffer, url + "?redirected", eMEDIATYPE_INIT_VIDEO, maxAge);
+	}
+
+	std::string mDirectory;
+	std::function<gpointer (size_t)>callMalloc;
+	std::function<void (gpointer)>callFree;
+};
+
+TEST_F(AampDiskCacheTests, StoreAndLoad)
+{
+	Store("http://host/init.mp4", 1000, 'a');
+	EXPECT_EQ(AampDiskCache::GetInstance().GetEntryCount(), 1);
+
+	AampGrowableBuffer buffer("test");
+	std::string effectiveUrl;
+	AampMediaType mediaType = eMEDIATYPE_DEFAULT;
+	EXPECT_TRUE(AampDiskCache::GetInstance().Load("http://host/init.mp4", &buffer, effectiveUrl, mediaType));
+	EXPECT_EQ(buffer.GetLen(), 1000);
+	EXPECT_EQ(buffer.GetPtr()[999], 'a');
+	EXPECT_EQ(effectiveUrl, "http://host/init.mp4?redirected");
+	EXPECT_EQ(mediaType, eMEDIATYPE_INIT_VIDEO);
+
+	EXPECT_FALSE(AampDiskCache::GetInstance().Load("http://host/other.mp4", &buffer, effectiveUrl, mediaType));
+}
+
+TEST_F(AampDiskCacheTests, SurvivesRestart)
+{
+	Store("http://host/init1.mp4", 100, 'a');
+	Store("http://host/init2.mp4", 200, 'b');
+	size_t size = AampDiskCache::GetInstance().GetSize();
+	Reopen();
+	EXPECT_EQ(AampDiskCache::GetInstance().GetEntryCount(), 2);
+	EXPECT_EQ(AampDiskCache::GetInstance().GetSize(), size);
+
+	AampGrowableBuffer buffer("test");
+	std::string effectiveUrl;
+	AampMediaType mediaType;
+	EXPECT_TRUE(AampDiskCache::GetInstance().Load("http://host/init2.mp4", &buffer, effectiveUrl, mediaType));
+	EXPECT_EQ(buffer.GetLen(), 200);
+	EXPECT_EQ(buffer.GetPtr()[0], 'b');
+}
+
+TEST_F(AampDiskCacheTests, EvictsLeastRecentlyUsed)
+{
+	Store("http://host/init1.mp4", 20*1024, 'a');
+	Store("http://host/init2.mp4", 20*1024, 'b');
+	Store("http://host/init3.mp4", 20*1024, 'c');
+
+	AampGrowableBuffer buffer("test");
+	std::string effectiveUrl;
+	AampMediaType mediaType;
+	EXPECT_TRUE(AampDiskCache::GetInstance().Load("http://host/init1.mp4", &buffer, effectiveUrl, mediaType));
+	buffer.Free();
+
+	// cap is 64KB; init2 is now least recently used
+	Store("http://host/init4.mp4", 20*1024, 'd');
+	EXPECT_EQ(AampDiskCache::GetInstance().GetEntryCount(), 3);
+	EXPECT_LE(AampDiskCache::GetInstance().GetSize(), 64*1024);
+	EXPECT_FALSE(AampDiskCache::GetInstance().Load("http://host/init2.mp4", &buffer, effectiveUrl, mediaType));
+	EXPECT_TRUE(AampDiskCache::GetInstance().Load("http://host/init1.mp4", &buffer, effectiveUrl, mediaType));
+	buffer.Free();
+	EXPECT_TRUE(AampDiskCache::GetInstance().Load("http://host/init4.mp4", &buffer, effectiveUrl, mediaType));
+}
+
+TEST_F(AampDiskCacheTests, RejectsNoStoreAndOversized)
+{
+	Store("http://host/nostore.mp4", 100, 'a', 0);
+	Store("http://host/huge.mp4", 128*1024, 'b');
+	EXPECT_EQ(AampDiskCache::GetInstance().GetEntryCount(), 0);
+}
+
+TEST_F(AampDiskCacheTests, ReplaceAndRemove)
+{
+	Store("http://host/init.mp4", 100, 'a');
+	Store("http://host/init.mp4", 300, 'b');
+	EXPECT_EQ(AampDiskCache::GetInstance().GetEntryCount(), 1);
+
+	AampGrowableBuffer buffer("test");
+	std::string effectiveUrl;
+	AampMediaType mediaType;
+	EXPECT_TRUE(AampDiskCache::GetInstance().Load("http://host/init.mp4", &buffer, effectiveUrl, mediaType));
+	EXPECT_EQ(buffer.GetLen(), 300);
+	buffer.Free();
+
+	AampDiskCache::GetInstance().Remove("http://host/init.mp4");
+	EXPECT_EQ(AampDiskCache::GetInstance().GetEntryCount(), 0);
+	EXPECT_EQ(AampDiskCache::GetInstance().GetSize(), 0);
+	EXPECT_FALSE(AampDiskCache::GetInstance().Load("http://host/init.mp4", &buffer, effectiveUrl, mediaType));
+}
+
+TEST_F(AampDiskCacheTests, DropsEntryWithCorruptLength)
+{
+	Store("http://host/init.mp4", 100, 'a');
+	ASSERT_EQ(AampDiskCache::GetInstance().GetEntryCount(), 1);
+
+	// corrupt the payload length of the stored file
+	std::string path;
+	DIR *dir = opendir(mDirectory.c_str());
+	ASSERT_NE(dir, nullptr);
+	while( struct dirent *entry = readdir(dir) )
+	{
+		if( entry->d_name[0] != '.' )
+		{
+			path = mDirectory + "/" + entry->d_name;
+		}
+	}
+	closedir(dir);
+	ASSERT_FALSE(path.empty());
+	FILE *fp = fopen(path.c_str(), "r+b");
+	ASSERT_NE(fp, nullptr);
+	uint64_t dataLength = 1ULL << 40;
+	ASSERT_EQ(fseek(fp, offsetof(AampDiskCacheFileHeader, dataLength), SEEK_SET), 0);
+	ASSERT_EQ(fwrite(&dataLength, sizeof(dataLength), 1, fp), 1);
+	fclose(fp);
+
+	EXPECT_CALL(*g_mockGLib, g_malloc(::testing::Gt(64*1024))).Times(0);
+	AampGrowableBuffer buffer("test");
+	std::string effectiveUrl;
+	AampMediaType mediaType;
+	EXPECT_FALSE(AampDiskCache::GetInstance().Load("http://host/init.mp4", &buffer, effectiveUrl, mediaType));
+	EXPECT_EQ(AampDiskCache::GetInstance().GetEntryCount(), 0);
+	EXPECT_NE(access(path.c_str(), F_OK), 0);
+}
+
+TEST_F(AampDiskCacheTests, DisabledCache)
+{
+	AampDiskCache::GetInstance().Configure(false, mDirectory, 64*1024, 3600);
+	EXPECT_FALSE(AampDiskCache::GetInstance().IsEnabled());
+	Store("http://host/init.mp4", 100, 'a');
+	EXPECT_EQ(AampDiskCache::GetInstance().GetEntryCount(), 0);
+	AampDiskCache::GetInstance().Configure(true, mDirectory, 64*1024, 3600);
+	EXPECT_TRUE(AampDiskCache::GetInstance().IsEnabled());
+}
+
+TEST_F(AampDiskCacheTests, CreatesPrivateDirectory)
+{
+	std::string parent = mDirectory + "/sub";
+	std::string directory = parent + "/cache";
+	AampDiskCache::GetInstance().Configure(true, directory, 64*1024, 3600);
+	EXPECT_TRUE(AampDiskCache::GetInstance().IsEnabled());
+	struct stat st;
+	ASSERT_EQ(stat(directory.c_str(), &st), 0);
+	EXPECT_EQ(st.st_mode & 0777, 0700);
+	ASSERT_EQ(stat(parent.c_str(), &st), 0);
+	EXPECT_EQ(st.st_mode & 0777, 0700);
+	AampDiskCache::GetInstance().Configure(true, mDirectory, 64*1024, 3600);
+	rmdir(directory.c_str());
+	rmdir(parent.c_str());
+}
+
+TEST_F(AampDiskCacheTests, RestrictsExistingDirectory)
+{
+	std::string directory = mDirectory + "/open";
+	ASSERT_EQ(mkdir(directory.c_str(), 0777), 0);
+	chmod(directory.c_str(), 0777);
+	AampDiskCache::GetInstance().Configure(true, directory, 64*1024, 3600);
+	EXPECT_TRUE(AampDiskCache::GetInstance().IsEnabled());
+	struct stat st;
+	ASSERT_EQ(stat(directory.c_str(), &st), 0);
+	EXPECT_EQ(st.st_mode & 0777, 0700);
+	AampDiskCache::GetInstance().Configure(true, mDirectory, 64*1024, 3600);
+	rmdir(directory.c_str());
+}
+
+TEST_F(AampDiskCacheTests, RefusesSymbolicLink)
+{
+	std::string link = mDirectory + "/link";
+	ASSERT_EQ(symlink(mDirectory.c_str(), link.c_str()), 0);
+	AampDiskCache::GetInstance().Configure(true, link, 64*1024, 3600);
+	EXPECT_FALSE(AampDiskCache::GetInstance().IsEnabled());
+	AampDiskCache::GetInstance().Configure(true, mDirectory, 64*1024, 3600);
+	unlink(link.c_str());
+}
+
+TEST_F(AampDiskCacheTests, DefaultDirectory)
+{
+	std::string home = getenv("HOME") ? getenv("HOME") : "";
+	std::string xdg = getenv("XDG_CACHE_HOME") ? getenv("XDG_CACHE_HOME") : "";
+	setenv("XDG_CACHE_HOME", "/xdg", 1);
+	EXPECT_EQ(AampDiskCache::GetDefaultDirectory(), "/xdg/aamp");
+	unsetenv("XDG_CACHE_HOME");
+	setenv("HOME", "/home/user", 1);
+	EXPECT_EQ(AampDiskCache::GetDefaultDirectory(), "/home/user/.cache/aamp");
+	unsetenv("HOME");
+	EXPECT_EQ(AampDiskCache::GetDefaultDirectory(), "/tmp/aamp_cache_" + std::to_string(geteuid()));
+	if( !home.empty() )
+	{
+		setenv("HOME", home.c_str(), 1);
+	}
+	if( !xdg.empty() )
+	{
+		setenv("XDG_CACHE_HOME", xdg.c_str(), 1);
+	}
+}
+
+TEST_F(AampDiskCacheTests, ConcurrentStoreAndLoad)
+{
+	std::vector<std::thread> threads;
+	for( int t = 0; t < 4; t++ )
+	{
+		threads.emplace_back([this, t]()
+		{
+			std::string url = "http://host/init" + std::to_string(t) + ".mp4";
+			for( int i = 0; i < 50; i++ )
+			{
+				Store(url, 1000 + i, (char)('a' + t));
+				AampGrowableBuffer buffer("test");
+				std::string effectiveUrl;
+				AampMediaType mediaType;
+				if( AampDiskCache::GetInstance().Load(url, &buffer, effectiveUrl, mediaType) )
+				{
+					EXPECT_EQ(buffer.GetPtr()[0], (char)('a' + t));
+					EXPECT_EQ(effectiveUrl, url + "?redirected");
+				}
+				buffer.Free();
+			}
+		});
+	}
+	for( auto &thread : threads )
+	{
+		thread.join();
+	}
+	EXPECT_EQ(AampDiskCache::GetInstance().GetEntryCount(), 4);
+	// no temporary files left behind
+	int files = 0;
+	DIR *dir = opendir(mDirectory.c_str());
+	ASSERT_NE(dir, nullptr);
+	struct dirent *dirEntry;
+	while( (dirEntry = readdir(dir)) != NULL )
+	{
+		if( dirEntry->d_name[0] != '.' )
+		{
+			files++;
+		}
+	}
+	closedir(dir);
+	EXPECT_EQ(files, 4);
+}
+
+TEST_F(AampDiskCacheTests, ParseCacheControl)
+{
+	EXPECT_EQ(AampDiskCache::ParseCacheControl(" max-age=600"), 600);
+	EXPECT_EQ(AampDiskCache::ParseCacheControl("public, max-age=30, must-revalidate"), 30);
+	EXPECT_EQ(AampDiskCache::ParseCacheControl("no-store"), 0);
+	EXPECT_EQ(AampDiskCache::ParseCacheControl("max-age=600, no-cache"), 0);
+	EXPECT_EQ(AampDiskCache::ParseCacheControl("Max-Age=10"), 10);
+	EXPECT_EQ(AampDiskCache::ParseCacheControl("public"), AAMP_DISK_CACHE_MAX_AGE_UNSPECIFIED);
+	EXPECT_EQ(AampDiskCache::ParseCacheControl("s-maxage=60"), AAMP_DISK_CACHE_MAX_AGE_UNSPECIFIED);
+	EXPECT_EQ(AampDiskCache::ParseCacheControl(""), AAMP_DISK_CACHE_MAX_AGE_UNSPECIFIED);
+}
+
+TEST_F(AampDiskCacheTests, CacheableMediaTypes)
+{
+	EXPECT_TRUE(AampDiskCache::IsCacheableMediaType(eMEDIATYPE_MANIFEST));
+	EXPECT_TRUE(AampDiskCache::IsCacheableMediaType(eMEDIATYPE_INIT_AUDIO));
+	EXPECT_TRUE(AampDiskCache::IsCacheableMediaType(eMEDIATYPE_PLAYLIST_VIDEO));
+	EXPECT_FALSE(AampDiskCache::IsCacheableMediaType(eMEDIATYPE_VIDEO));
+	EXPECT_FALSE(AampDiskCache::IsCacheableMediaType(eMEDIATYPE_LICENCE));
+}
+
+int main(int argc, char** argv)
+{
+	testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
@@ -60,6 +60,10 @@ protected:
             {
                 AsyncEvent();
             }
+            void CallAsyncEventBatch()
+            {
+                AsyncEventBatch();
+            }
     };
     void SetUp() override {
         handler = new TestableAampEventManager();
@@ -262,3 +266,55 @@ TEST_F(AampEventManagerTest, IsSpecificEventListenerAvailableTest_1)
     EXPECT_FALSE(val);
     }
 }
+
+TEST_F(AampEventManagerTest, EventBatchingCoalescesProgress)
+{
+    class RecordingEventListener : public EventListener
+    {
+        public:
+        std::vector<AAMPEventPtr> events;
+        void SendEvent(const AAMPEventPtr &event){
+            events.push_back(event);
+        }
+    };
+    RecordingEventListener listener;
+    handler->AddListenerForAllEvents(&listener);
+    handler->SetPlayerState(eSTATE_PLAYING);
+    handler->SetEventBatching(true);
+
+    AAMPEventPtr progress1 = std::make_shared<AAMPEventObject>(AAMP_EVENT_PROGRESS, session_id);
+    AAMPEventPtr bitrate = std::make_shared<AAMPEventObject>(AAMP_EVENT_BITRATE_CHANGED, session_id);
+    AAMPEventPtr progress2 = std::make_shared<AAMPEventObject>(AAMP_EVENT_PROGRESS, session_id);
+    AAMPEventPtr metadata1 = std::make_shared<AAMPEventObject>(AAMP_EVENT_ID3_METADATA, session_id);
+    AAMPEventPtr metadata2 = std::make_shared<AAMPEventObject>(AAMP_EVENT_ID3_METADATA, session_id);
+    handler->CallSendEventASync(progress1);
+    handler->CallSendEventASync(bitrate);
+    handler->CallSendEventASync(progress2);
+    handler->CallSendEventASync(metadata1);
+    handler->CallSendEventASync(metadata2);
+
+    // all pending events are delivered by one dispatch, in order, without the superseded progress
+    handler->CallAsyncEventBatch();
+    ASSERT_EQ(listener.events.size(), 4);
+    EXPECT_EQ(listener.events[0], bitrate);
+    EXPECT_EQ(listener.events[1], progress2);
+    EXPECT_EQ(listener.events[2], metadata1);
+    EXPECT_EQ(listener.events[3], metadata2);
+
+    AampEventStats stats;
+    EXPECT_TRUE(handler->GetEventStats(AAMP_EVENT_PROGRESS, stats));
+    EXPECT_EQ(stats.dispatched, 1);
+    EXPECT_EQ(stats.coalesced, 1);
+    EXPECT_EQ(stats.maxQueueDepth, 3);
+    EXPECT_TRUE(handler->GetEventStats(AAMP_EVENT_ID3_METADATA, stats));
+    EXPECT_EQ(stats.dispatched, 2);
+    EXPECT_EQ(stats.coalesced, 0);
+
+    // a progress event queued after the dispatch is not coalesced with the one already delivered
+    handler->CallSendEventASync(progress1);
+    handler->CallAsyncEventBatch();
+    ASSERT_EQ(listener.events.size(), 5);
+    EXPECT_EQ(listener.events[4], progress1);
+
+    handler->RemoveListenerForAllEvents(&listener);
+}
@@ -0,0 +1,147 @@
+/*
+* If not stated otherwise in this file or this component's license file the
+* following copyright and licenses apply:
+*
+* Copyright 2024 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "MockGLib.h"
+#include "AampGrowableBuffer.h"
+#include "AampBufferPool.h"
+
+#include <functional>
+#include <vector>
+
+using ::testing::NiceMock;
+using ::testing::_;
+
+class BufferPoolTests : public ::testing::Test
+{
+protected:
+	BufferPoolTests()
+	{
+		callMalloc = [](size_t size){ return malloc(size); };
+		callFree = [](gpointer ptr){ free(ptr); return; };
+	}
+
+	void SetUp() override
+	{
+		g_mockGLib = new NiceMock<MockGLib>();
+		ON_CALL(*g_mockGLib, g_malloc(_)).WillByDefault(callMalloc);
+		ON_CALL(*g_mockGLib, g_free(_)).WillByDefault(callFree);
+		AampBufferPool::SetEnabled(true);
+	}
+
+	void TearDown() override
+	{
+		AampBufferPool::SetEnabled(false);
+		AampBufferPool::GetInstance().Trim();
+		delete g_mockGLib;
+		g_mockGLib = nullptr;
+	}
+
+public:
+	std::function<gpointer (size_t)>callMalloc;
+	std::function<void (gpointer)>callFree;
+};
+
+TEST_F(BufferPoolTests, AllocateRoundsUpToSizeClass)
+{
+	AampBufferPool &pool = AampBufferPool::GetInstance();
+	size_t allocated = 0;
+
+	void *ptr = pool.Allocate(5000, allocated);
+	ASSERT_NE(ptr, nullptr);
+	EXPECT_EQ(allocated, 6*1024);
+	pool.Release(ptr, allocated);
+
+	ptr = pool.Allocate(AAMP_BUFFER_POOL_MIN_CLASS_SIZE, allocated);
+	ASSERT_NE(ptr, nullptr);
+	EXPECT_EQ(allocated, AAMP_BUFFER_POOL_MIN_CLASS_SIZE);
+	pool.Release(ptr, allocated);
+}
+
+TEST_F(BufferPoolTests, ReleasedBlockIsReused)
+{
+	AampBufferPool &pool = AampBufferPool::GetInstance();
+	AampBufferPoolStats before, after;
+	size_t allocated = 0;
+
+	void *first = pool.Allocate(100*1024, allocated);
+	ASSERT_NE(first, nullptr);
+	pool.Release(first, allocated);
+
+	pool.GetStats(before);
+	EXPECT_CALL(*g_mockGLib, g_malloc(_)).Times(0);
+	void *second = pool.Allocate(100*1024, allocated);
+	pool.GetStats(after);
+
+	EXPECT_EQ(second, first);
+	EXPECT_EQ(after.hits, before.hits + 1);
+	EXPECT_EQ(after.bytesInUse, before.bytesInUse + allocated);
+	EXPECT_GT(after.GetHitRate(), 0.0);
+	pool.Release(second, allocated);
+}
+
+TEST_F(BufferPoolTests, OversizedAllocationBypassesPool)
+{
+	AampBufferPool &pool = AampBufferPool::GetInstance();
+	size_t size = AAMP_BUFFER_POOL_MAX_CLASS_SIZE + 1;
+	size_t allocated = 0;
+
+	void *ptr = pool.Allocate(size, allocated);
+	ASSERT_NE(ptr, nullptr);
+	EXPECT_EQ(allocated, size);
+
+	EXPECT_CALL(*g_mockGLib, g_free(ptr)).WillOnce(callFree);
+	pool.Release(ptr, allocated);
+}
+
+TEST_F(BufferPoolTests, GrowableBufferRecyclesPooledMemory)
+{
+	const char data[] = "pooled fragment data";
+	char *firstPtr = NULL;
+	{
+		AampGrowableBuffer buffer("pooled");
+		buffer.ReserveBytes(20*1024);
+		EXPECT_GE(buffer.GetAvail(), 20*1024);
+		buffer.AppendBytes(data, sizeof(data));
+		firstPtr = buffer.GetPtr();
+
+		// growing past the block moves the content to a bigger class
+		std::vector<char> big(64*1024, 'x');
+		buffer.AppendBytes(big.data(), big.size());
+		EXPECT_EQ(memcmp(buffer.GetPtr(), data, sizeof(data)), 0);
+		EXPECT_EQ(buffer.GetLen(), sizeof(data) + big.size());
+	}
+
+	AampGrowableBuffer buffer("pooled");
+	buffer.ReserveBytes(20*1024);
+	EXPECT_EQ(buffer.GetPtr(), firstPtr);
+	buffer.Free();
+}
+
+TEST_F(BufferPoolTests, ExpectedSizeIsRunningAverage)
+{
+	AampBufferPool &pool = AampBufferPool::GetInstance();
+
+	EXPECT_EQ(pool.GetExpectedSize(eMEDIATYPE_IMAGE), 0);
+	pool.UpdateExpectedSize(eMEDIATYPE_IMAGE, 8000);
+	EXPECT_EQ(pool.GetExpectedSize(eMEDIATYPE_IMAGE), 8000);
+	pool.UpdateExpectedSize(eMEDIATYPE_IMAGE, 16000);
+	EXPECT_EQ(pool.GetExpectedSize(eMEDIATYPE_IMAGE), 9000);
+}
@@ -799,6 +799,78 @@ TEST_F(AampLogManagerTest, logprintf_MaxMessage)
 	logprintf(level, file.c_str(), line, "%s", message.c_str());
 }
 
+/*
+	Test logprintf with asynchronous logging enabled
+	sd_journal_print is expected to be called from the writer thread with the same header and message
+*/
+TEST_F(AampLogManagerTest, logprintf_Async)
+{
+	AAMP_LogLevel level = eLOGLEVEL_MIL;
+	std::string file("test.cpp");
+	int line = 2;
+	std::string message("async message");
+	AampLogManager::setAsyncLogging(true);
+	EXPECT_CALL(*g_mockSdJournal, sd_journal_print_mock(LOG_NOTICE, AllOf(HasSubstr("[" + std::to_string(-1) + "]"), HasSubstr("[MIL]"), HasSubstr("[" + file + "][2]"), HasSubstr(message))));
+	logprintf(level, file.c_str(), line, "%s", message.c_str());
+	file.clear(); // queued message must not refer to caller's storage
+	AampLogManager::flushAsyncLog();
+	AampLogManager::setAsyncLogging(false);
+	EXPECT_EQ(AampLogManager::getDroppedLogCount(), 0);
+}
+
+/*
+	Test module log levels
+	INFO logging of this file is expected to be enabled by its module log level, while other modules stay at WARN
+*/
+TEST_F(AampLogManagerTest, setModuleLogLevels)
+{
+	EXPECT_EQ(AampLogManager::getModuleLogLevel("test/utests/tests/AampLogManagerTests/AampLogManagerTests.cpp"), -1);
+	AampLogManager::setModuleLogLevels("AampLogManagerTests:info,drm:debug,other:bogus");
+	EXPECT_EQ(AampLogManager::getModuleLogLevel("test/utests/tests/AampLogManagerTests/AampLogManagerTests.cpp"), eLOGLEVEL_INFO);
+	EXPECT_EQ(AampLogManager::getModuleLogLevel("/src/aamp/drm/DrmSession.cpp"), eLOGLEVEL_DEBUG);
+	EXPECT_EQ(AampLogManager::getModuleLogLevel("drm/DrmSession.cpp"), eLOGLEVEL_DEBUG);
+	EXPECT_EQ(AampLogManager::getModuleLogLevel("fragmentcollector_mpd.cpp"), -1);
+	EXPECT_EQ(AampLogManager::getModuleLogLevel("other.cpp"), -1);
+
+	EXPECT_CALL(*g_mockSdJournal, sd_journal_print_mock(LOG_NOTICE, AllOf(HasSubstr("[INFO]"), HasSubstr("module info"))));
+	EXPECT_CALL(*g_mockSdJournal, sd_journal_print_mock(LOG_NOTICE, HasSubstr("module debug"))).Times(0);
+	AAMPLOG_INFO("module info");
+	AAMPLOG_DEBUG("module debug");
+
+	AampLogManager::setModuleLogLevels("");
+	EXPECT_EQ(AampLogManager::moduleLogLevelGeneration, 0);
+	EXPECT_CALL(*g_mockSdJournal, sd_journal_print_mock(LOG_NOTICE, HasSubstr("global info"))).Times(0);
+	AAMPLOG_INFO("global info");
+}
+
+static void LogModuleInfo()
+{
+	AAMPLOG_INFO("module site");
+}
+
+/*
+	Test changing module log levels after clearing them
+	The same call site is expected to follow the new level, not the one it cached before the clear
+*/
+TEST_F(AampLogManagerTest, setModuleLogLevels_SetClearSet)
+{
+	AampLogManager::setModuleLogLevels("AampLogManagerTests:info");
+	uint32_t generation = AampLogManager::moduleLogLevelGeneration;
+	EXPECT_CALL(*g_mockSdJournal, sd_journal_print_mock(LOG_NOTICE, HasSubstr("module site"))).Times(1);
+	LogModuleInfo();
+
+	AampLogManager::setModuleLogLevels("");
+	EXPECT_EQ(AampLogManager::moduleLogLevelGeneration, 0);
+	LogModuleInfo();
+
+	AampLogManager::setModuleLogLevels("AampLogManagerTests:error");
+	EXPECT_NE(AampLogManager::moduleLogLevelGeneration, 0);
+	EXPECT_NE(AampLogManager::moduleLogLevelGeneration, generation);
+	LogModuleInfo();
+
+	AampLogManager::setModuleLogLevels("");
+}
+
 TEST_F(AampLogManagerTest, snprintf_tests)
 {
 	char *format_ptr = NULL;
@@ -300,3 +300,127 @@ TEST_F(FunctionalTests, AampMPDDownloader_NotifyLockup)
 	EXPECT_NO_THROW(mAampMPDDownloader->UnRegisterCallback());
 	EXPECT_NO_THROW(mAampMPDDownloader->Release());
 }
+
+static std::string MakeLiveMPD(int firstPeriod, int liveEdgeSegments)
+{
+    std::string mpd = "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+        "<MPD xmlns=\"urn:mpeg:dash:schema:mpd:2011\" type=\"dynamic\" availabilityStartTime=\"2023-01-01T00:00:00Z\" minimumUpdatePeriod=\"PT2S\">\n";
+    for(int period = firstPeriod; period < firstPeriod + 3; period++)
+    {
+        int segments = (period == firstPeriod + 2) ? liveEdgeSegments : 30;
+        mpd += "<Period id=\"p" + std::to_string(period) + "\" start=\"PT" + std::to_string(period * 60) + "S\">\n";
+        mpd += "<AdaptationSet id=\"1\" contentType=\"video\" mimeType=\"video/mp4\">\n<SegmentTemplate timescale=\"1000\" media=\"v_$Time$.mp4\" initialization=\"v_init.mp4\">\n<SegmentTimeline>\n";
+        for(int segment = 0; segment < segments; segment++)
+        {
+            mpd += "<S t=\"" + std::to_string(segment * 2000) + "\" d=\"2000\"/>\n";
+        }
+        mpd += "</SegmentTimeline>\n</SegmentTemplate>\n<Representation id=\"v1\" bandwidth=\"800000\" codecs=\"avc1.4d401f\"/>\n</AdaptationSet>\n";
+        mpd += "<AdaptationSet id=\"2\" contentType=\"audio\" mimeType=\"audio/mp4\" lang=\"en\">\n<SegmentTemplate timescale=\"1000\" duration=\"2000\" media=\"a_$Number$.mp4\"/>\n<Representation id=\"a1\" bandwidth=\"64000\"/>\n</AdaptationSet>\n";
+        mpd += "</Period>\n";
+    }
+    mpd += "</MPD>\n";
+    return mpd;
+}
+
+static ManifestDownloadResponsePtr ParseLiveMPD(const std::string &mpd, MPDNodeCache *nodeCache, bool streamingParser = false)
+{
+    ManifestDownloadResponsePtr response = MakeSharedManifestDownloadResponsePtr();
+    response->mMPDDownloadResponse->replaceDownloadData(mpd);
+    response->mMPDDownloadResponse->sEffectiveUrl = url1;
+    response->parseMPD(nodeCache, streamingParser);
+    return response;
+}
+
+TEST_F(FunctionalTests, IncrementalRefreshReusesUnchangedElements)
+{
+    MPDNodeCache nodeCache;
+    // Elements are cached once seen unchanged, so reuse starts with the third refresh: the two
+    // older Periods and the audio AdaptationSet of the live edge Period. After a Period rolls
+    // off, the previous live edge Period is only parsed again until it is cached.
+    const size_t expectedReused[] = { 0, 0, 3, 2, 2, 3 };
+    const int refreshCount = 6;
+    for(int refresh = 0; refresh < refreshCount; refresh++)
+    {
+        // live edge Period grows on every refresh, a Period rolls off every third refresh
+        std::string mpd = MakeLiveMPD(refresh / 3, 10 + refresh);
+        ManifestDownloadResponsePtr full = ParseLiveMPD(mpd, NULL);
+        ManifestDownloadResponsePtr incremental = ParseLiveMPD(mpd, &nodeCache);
+        ASSERT_EQ(incremental->mMPDStatus, AAMPStatusType::eAAMPSTATUS_OK);
+
+        std::vector<dash::mpd::IPeriod *> fullPeriods = full->mMPDInstance->GetPeriods();
+        std::vector<dash::mpd::IPeriod *> periods = incremental->mMPDInstance->GetPeriods();
+        ASSERT_EQ(periods.size(), fullPeriods.size());
+        for(size_t i = 0; i < periods.size(); i++)
+        {
+            EXPECT_EQ(periods[i]->GetId(), fullPeriods[i]->GetId());
+            ASSERT_EQ(periods[i]->GetAdaptationSets().size(), 2u);
+            const dash::mpd::ISegmentTemplate *segmentTemplate = periods[i]->GetAdaptationSets().at(0)->GetSegmentTemplate();
+            const dash::mpd::ISegmentTemplate *fullSegmentTemplate = fullPeriods[i]->GetAdaptationSets().at(0)->GetSegmentTemplate();
+            ASSERT_NE(segmentTemplate, nullptr);
+            EXPECT_EQ(segmentTemplate->GetSegmentTimeline()->GetTimelines().size(), fullSegmentTemplate->GetSegmentTimeline()->GetTimelines().size());
+            EXPECT_EQ(periods[i]->GetAdaptationSets().at(1)->GetLang(), "en");
+        }
+        EXPECT_EQ(incremental->mMPDInstance->GetPeriods().back()->GetId(), "p" + std::to_string(refresh / 3 + 2));
+
+        EXPECT_EQ(nodeCache.GetReusedCount(), expectedReused[refresh]);
+    }
+}
+
+TEST_F(FunctionalTests, IncrementalRefreshSkipsManifestWithComments)
+{
+    MPDNodeCache nodeCache;
+    std::string mpd = MakeLiveMPD(0, 10);
+    mpd.insert(mpd.find("<Period"), "<!-- <Period id=\"p0\"> -->\n");
+    for(int refresh = 0; refresh < 3; refresh++)
+    {
+        ManifestDownloadResponsePtr response = ParseLiveMPD(mpd, &nodeCache);
+        ASSERT_EQ(response->mMPDStatus, AAMPStatusType::eAAMPSTATUS_OK);
+        EXPECT_EQ(response->mMPDInstance->GetPeriods().size(), 3u);
+        EXPECT_EQ(nodeCache.GetReusedCount(), 0u);
+        EXPECT_EQ(nodeCache.GetEntryCount(), 0u);
+    }
+}
+
+static void ExpectSameNodes(const Node *expected, const Node *actual)
+{
+    ASSERT_NE(actual, nullptr);
+    EXPECT_EQ(actual->GetName(), expected->GetName());
+    EXPECT_EQ(actual->GetType(), expected->GetType());
+    EXPECT_EQ(actual->GetText(), expected->GetText());
+    EXPECT_EQ(actual->GetAttributes(), expected->GetAttributes());
+    ASSERT_EQ(actual->GetSubNodes().size(), expected->GetSubNodes().size());
+    for(size_t i = 0; i < expected->GetSubNodes().size(); i++)
+    {
+        ExpectSameNodes(expected->GetSubNodes().at(i), actual->GetSubNodes().at(i));
+    }
+}
+
+TEST_F(FunctionalTests, StreamingParserMatchesReader)
+{
+    std::string mpd = MakeLiveMPD(0, 10);
+    mpd.insert(mpd.find("<Period"),
+        "<!-- comment -->\n<BaseURL>http://example.com/live/?a=1&amp;b=&#x32;</BaseURL>\n"
+        "<Location xmlns:x=\"urn:x\" x:attr=\"&lt;&quot;&#233;&quot;&gt;\">http://example.com/<!-- split -->live.mpd</Location>\n"
+        "<EventStream schemeIdUri=\"urn:x\"><Event id=\"1\"><![CDATA[<scte35/>]]></Event></EventStream>\n");
+    ManifestDownloadResponsePtr reader = ParseLiveMPD(mpd, NULL, false);
+    ManifestDownloadResponsePtr streaming = ParseLiveMPD(mpd, NULL, true);
+    ASSERT_EQ(streaming->mMPDStatus, AAMPStatusType::eAAMPSTATUS_OK);
+    ASSERT_NE(reader->mRootNode, nullptr);
+    ExpectSameNodes(reader->mRootNode, streaming->mRootNode);
+    EXPECT_EQ(streaming->mMPDInstance->GetPeriods().size(), 3u);
+    EXPECT_EQ(streaming->mMPDInstance->GetBaseUrls().at(0)->GetUrl(), "http://example.com/live/?a=1&b=2");
+
+    // combined with the node cache
+    MPDNodeCache nodeCache;
+    for(int refresh = 0; refresh < 3; refresh++)
+    {
+        mpd = MakeLiveMPD(0, 10 + refresh);
+        reader = ParseLiveMPD(mpd, NULL, false);
+        streaming = ParseLiveMPD(mpd, &nodeCache, true);
+        ExpectSameNodes(reader->mRootNode, streaming->mRootNode);
+    }
+    EXPECT_EQ(nodeCache.GetReusedCount(), 3u);
+
+    streaming = ParseLiveMPD("not a manifest", NULL, true);
+    EXPECT_EQ(streaming->mMPDStatus, AAMPStatusType::eAAMPSTATUS_MANIFEST_PARSE_ERROR);
+}
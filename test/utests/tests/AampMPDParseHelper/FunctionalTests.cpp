@@ -210,6 +210,33 @@ public:
 		GetMPDFromManifest(response);
 		return response;
 	}
+
+	std::vector<ITimeline *> &GetFirstTimeline(ManifestDownloadResponsePtr response)
+	{
+		IAdaptationSet *adaptationSet = response->mMPDInstance->GetPeriods().at(0)->GetAdaptationSets().at(0);
+		return adaptationSet->GetSegmentTemplate()->GetSegmentTimeline()->GetTimelines();
+	}
+
+	ManifestDownloadResponsePtr GetLiveTimelineManifest(const std::string &timeline)
+	{
+		mManifestText = R"(<?xml version="1.0" encoding="utf-8"?>
+<MPD xmlns="urn:mpeg:dash:schema:mpd:2011" availabilityStartTime="2023-01-01T00:00:00Z" minimumUpdatePeriod="PT2S" profiles="urn:mpeg:dash:profile:isoff-live:2011" type="dynamic">
+  <Period id="p0" start="PT0S">
+    <AdaptationSet contentType="video" mimeType="video/mp4" segmentAlignment="true" startWithSAP="1">
+      <SegmentTemplate initialization="video_init.mp4" media="video_$Time$.m4s" timescale="1000">
+        <SegmentTimeline>
+)" + timeline + R"(        </SegmentTimeline>
+      </SegmentTemplate>
+      <Representation id="1" codecs="avc1.640028" width="640" height="360" bandwidth="1000000" />
+    </AdaptationSet>
+  </Period>
+</MPD>
+)";
+		mManifest = mManifestText.c_str();
+		return GetManifestForMPDDownloader();
+	}
+
+	std::string mManifestText;
 };
 
 TEST_F(FunctionalTests, Live_TSBEmpty_PerioDurationTest)
@@ -1215,3 +1242,133 @@ TEST_F(FunctionalTests, TestForAbsoluteTime)
 
 	EXPECT_EQ(periodStartTime, 1721828763.00);
 }
+
+/** @brief SegmentTimelineIndex lookups over repeated, implicit and discontinuous S elements */
+TEST_F(FunctionalTests, SegmentTimelineIndexLookup)
+{
+	ManifestDownloadResponsePtr response = GetLiveTimelineManifest(
+		"<S t=\"1000\" d=\"200\" r=\"2\"/>\n"
+		"<S d=\"100\"/>\n"
+		"<S t=\"2000\" d=\"300\" r=\"1\"/>\n");
+	SegmentTimelineIndex index;
+	ASSERT_TRUE(index.Update(GetFirstTimeline(response)));
+	EXPECT_EQ(index.GetRunCount(), 3);
+	EXPECT_EQ(index.GetSegmentCount(), 6);
+	EXPECT_EQ(index.GetRun(1).startTime, 1600);
+	EXPECT_TRUE(index.HasImplicitStartTime());
+	EXPECT_TRUE(index.HasDiscontinuity());
+
+	int timeLineIndex = -1;
+	uint32_t repeatIndex = 0;
+	EXPECT_FALSE(index.FindTime(999, timeLineIndex, repeatIndex));
+	EXPECT_TRUE(index.FindTime(1650, timeLineIndex, repeatIndex));
+	EXPECT_EQ(timeLineIndex, 1);
+	EXPECT_EQ(repeatIndex, 0);
+	EXPECT_TRUE(index.FindTime(1850, timeLineIndex, repeatIndex)); // in the gap, last segment started before
+	EXPECT_EQ(timeLineIndex, 1);
+	EXPECT_TRUE(index.FindTime(2350, timeLineIndex, repeatIndex));
+	EXPECT_EQ(timeLineIndex, 2);
+	EXPECT_EQ(repeatIndex, 1);
+
+	EXPECT_TRUE(index.FindSegment(4, timeLineIndex, repeatIndex));
+	EXPECT_EQ(timeLineIndex, 2);
+	EXPECT_EQ(repeatIndex, 0);
+	EXPECT_FALSE(index.FindSegment(6, timeLineIndex, repeatIndex));
+	EXPECT_EQ(index.GetSegmentIndex(2, 1), 5);
+	EXPECT_EQ(index.GetSegmentIndex(3, 0), 6);
+	EXPECT_EQ(index.GetSegmentTime(2, 1), 2300);
+
+	EXPECT_EQ(index.GetMediaOffset(2, 1), 1000);
+	index.FindMediaOffset(750, timeLineIndex, repeatIndex);
+	EXPECT_EQ(timeLineIndex, 2);
+	EXPECT_EQ(repeatIndex, 0);
+	index.FindMediaOffset(5000, timeLineIndex, repeatIndex);
+	EXPECT_EQ(timeLineIndex, 2);
+	EXPECT_EQ(repeatIndex, 1);
+
+	EXPECT_EQ(index.FindRunEndingAfter(1650, 0), 1);
+	EXPECT_EQ(index.FindRunEndingAfter(1650, 2), 2);
+	EXPECT_EQ(index.FindRunEndingAfter(2600, 0), 3);
+}
+
+/** @brief SegmentTimelineIndex keeps the runs a refreshed timeline continues */
+TEST_F(FunctionalTests, SegmentTimelineIndexIncrementalRefresh)
+{
+	ManifestDownloadResponsePtr response1 = GetLiveTimelineManifest(
+		"<S t=\"100000\" d=\"2000\" r=\"9\"/>\n"
+		"<S t=\"120000\" d=\"1000\"/>\n"
+		"<S t=\"121000\" d=\"2000\" r=\"3\"/>\n");
+	SegmentTimelineIndex index;
+	ASSERT_TRUE(index.Update(GetFirstTimeline(response1)));
+	EXPECT_EQ(index.GetReusedRunCount(), 0);
+	EXPECT_FALSE(index.HasImplicitStartTime());
+	EXPECT_FALSE(index.HasDiscontinuity());
+	ASSERT_TRUE(index.Update(GetFirstTimeline(response1)));
+	EXPECT_EQ(index.GetReusedRunCount(), 3);
+
+	// first S dropped, last S grown, one S added
+	ManifestDownloadResponsePtr response2 = GetLiveTimelineManifest(
+		"<S t=\"120000\" d=\"1000\"/>\n"
+		"<S t=\"121000\" d=\"2000\" r=\"5\"/>\n"
+		"<S t=\"133000\" d=\"3000\" r=\"1\"/>\n");
+	ASSERT_TRUE(index.Update(GetFirstTimeline(response2)));
+	EXPECT_EQ(index.GetReusedRunCount(), 1);
+	EXPECT_EQ(index.GetRunCount(), 3);
+	EXPECT_EQ(index.GetSegmentCount(), 9);
+	EXPECT_EQ(index.GetSegmentIndex(2, 1), 8);
+	EXPECT_EQ(index.GetMediaOffset(2, 0), 13000);
+	int timeLineIndex = -1;
+	uint32_t repeatIndex = 0;
+	EXPECT_TRUE(index.FindTime(130000, timeLineIndex, repeatIndex));
+	EXPECT_EQ(timeLineIndex, 1);
+	EXPECT_EQ(repeatIndex, 4);
+
+	// timeline that does not continue the indexed one is indexed from scratch
+	ManifestDownloadResponsePtr response3 = GetLiveTimelineManifest(
+		"<S t=\"500000\" d=\"2000\" r=\"2\"/>\n");
+	ASSERT_TRUE(index.Update(GetFirstTimeline(response3)));
+	EXPECT_EQ(index.GetReusedRunCount(), 0);
+	EXPECT_EQ(index.GetSegmentCount(), 3);
+	EXPECT_EQ(index.GetSegmentTime(0, 2), 504000);
+}
+
+/** @brief SegmentTimelineIndex re-reads a timeline whose S elements changed at the same addresses */
+TEST_F(FunctionalTests, SegmentTimelineIndexReusedAddresses)
+{
+	class TestTimeline : public ITimeline
+	{
+	public:
+		TestTimeline(uint64_t startTime, uint32_t duration, uint32_t repeatCount) : mStartTime(startTime), mDuration(duration), mRepeatCount(repeatCount)
+		{
+		}
+		uint64_t GetStartTime() const override { return mStartTime; }
+		uint32_t GetDuration() const override { return mDuration; }
+		uint32_t GetRepeatCount() const override { return mRepeatCount; }
+		const std::vector<dash::xml::INode*> GetAdditionalSubNodes() const override { static std::vector<dash::xml::INode*> vec; return vec; }
+		const std::map<std::string, std::string> GetRawAttributes() const override { static std::map<std::string, std::string> rawAttributes; return rawAttributes; }
+
+		uint64_t mStartTime;
+		uint32_t mDuration;
+		uint32_t mRepeatCount;
+	};
+	TestTimeline first(100000, 2000, 9);
+	TestTimeline last(120000, 1000, 4);
+	std::vector<ITimeline *> timelines = { &first, &last };
+	SegmentTimelineIndex index;
+	ASSERT_TRUE(index.Update(timelines));
+	EXPECT_EQ(index.GetSegmentCount(), 15);
+	ASSERT_TRUE(index.Update(timelines));
+	EXPECT_EQ(index.GetReusedRunCount(), 2);
+
+	// same vector, same element addresses, same repeat count of the last S; only the values differ
+	first.mStartTime = 200000;
+	last.mStartTime = 220000;
+	ASSERT_TRUE(index.Update(timelines));
+	EXPECT_EQ(index.GetReusedRunCount(), 0);
+	EXPECT_EQ(index.GetSegmentTime(0, 0), 200000);
+	EXPECT_EQ(index.GetSegmentTime(1, 0), 220000);
+
+	last.mDuration = 2000;
+	ASSERT_TRUE(index.Update(timelines));
+	EXPECT_EQ(index.GetRun(1).duration, 2000);
+}
@@ -18,6 +18,7 @@
 */
 
 #include <gtest/gtest.h>
+#include <future>
 
 #include "../AampScheduler.h"
 #include "../AampConfig.h"
@@ -317,3 +318,88 @@ TEST_F(AampSchedulerTestsFixture, ScheduleTaskTest_MaxTaskIdWrapAround)
 	EXPECT_EQ(taskId1, AAMP_SCHEDULER_ID_MAX_VALUE - 1);
 	EXPECT_EQ(taskId2, AAMP_SCHEDULER_ID_DEFAULT);
 }
+
+TEST_F(AampSchedulerTestsFixture, SelectNextTask_QueueOrderAndCancel)
+{
+	mSchedulerRunning = true;
+	AsyncTaskCancelToken token = CreateCancelToken();
+	int tuneId = ScheduleTask(AsyncTaskObj([](void* data) {}, nullptr, "Tune", token));
+	int seekId = ScheduleTask(AsyncTaskObj([](void* data) {}, nullptr, "Seek"));
+	int rateId = ScheduleTask(AsyncTaskObj([](void* data) {}, nullptr, "SetRate"));
+
+	// Assert: tasks run in queue order
+	EXPECT_EQ(SelectNextTask()->mId, tuneId);
+
+	// Assert: cancelled tasks are dropped from the queue
+	token->store(true);
+	EXPECT_EQ(SelectNextTask()->mId, seekId);
+	EXPECT_EQ(mTaskQueue.size(), 2);
+	AsyncTaskLatencyStats stats;
+	EXPECT_TRUE(GetLatencyStats("Tune", stats));
+	EXPECT_EQ(stats.cancelled, 1);
+
+	mTaskQueue.erase(SelectNextTask());
+	EXPECT_EQ(SelectNextTask()->mId, rateId);
+	mTaskQueue.erase(SelectNextTask());
+	EXPECT_TRUE(SelectNextTask() == mTaskQueue.end());
+}
+
+TEST_F(AampSchedulerTestsFixture, ExecuteAsyncTask_TuneRunsBeforeLaterSeek)
+{
+	std::mutex mutex;
+	std::condition_variable cond;
+	std::vector<std::string> order;
+	std::promise<void> gate;
+	std::shared_future<void> opened = gate.get_future().share();
+	StartScheduler(0);
+	// hold the scheduler thread so that Tune and Seek queue up together
+	ScheduleTask(AsyncTaskObj([opened](void* data) { opened.wait(); }, nullptr, "Busy"));
+	ScheduleTask(AsyncTaskObj([&](void* data) {
+		std::lock_guard<std::mutex> lock(mutex);
+		order.push_back("Tune");
+	}, nullptr, "Tune"));
+	ScheduleTask(AsyncTaskObj([&](void* data) {
+		std::lock_guard<std::mutex> lock(mutex);
+		order.push_back("Seek");
+		cond.notify_one();
+	}, nullptr, "Seek"));
+	gate.set_value();
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		EXPECT_TRUE(cond.wait_for(lock, std::chrono::seconds(5), [&]() { return order.size() == 2; }));
+	}
+	StopScheduler();
+
+	ASSERT_EQ(order.size(), 2);
+	EXPECT_EQ(order[0], "Tune");
+	EXPECT_EQ(order[1], "Seek");
+}
+
+TEST_F(AampSchedulerTestsFixture, ExecuteAsyncTask_RecordsLatency)
+{
+	std::mutex mutex;
+	std::condition_variable cond;
+	bool done = false;
+	StartScheduler(0);
+	ScheduleTask(AsyncTaskObj([&](void* data) {
+		std::lock_guard<std::mutex> lock(mutex);
+		done = true;
+		cond.notify_one();
+	}, nullptr, "Measured"));
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		EXPECT_TRUE(cond.wait_for(lock, std::chrono::seconds(5), [&]() { return done; }));
+	}
+	StopScheduler();
+
+	AsyncTaskLatencyStats stats;
+	EXPECT_TRUE(GetLatencyStats("Measured", stats));
+	EXPECT_EQ(stats.executed, 1);
+	unsigned int total = 0;
+	for (int i = 0; i < AAMP_SCHEDULER_LATENCY_BUCKETS; i++)
+	{
+		total += stats.waitHistogram[i];
+	}
+	EXPECT_EQ(total, 1);
+	EXPECT_FALSE(GetLatencyStats("NotRun", stats));
+}
@@ -43,6 +43,7 @@
 #include "MockAampTsbAdMetaData.h"
 
 #include <thread>
+#include <future>
 #include <unistd.h>
 
 using ::testing::_;
@@ -313,6 +314,54 @@ TEST_F(FunctionalTests, Cullsegments)
 	EXPECT_DOUBLE_EQ(TSBDuration, FRAG_DURATION);
 }
 
+TEST_F(FunctionalTests, TrackWritesAreIndependent)
+{
+	double FRAG_DURATION = 3.0;
+	std::shared_ptr<CachedFragment> cachedFragment = std::make_shared<CachedFragment>();
+	cachedFragment->initFragment = true;
+	cachedFragment->fragment.AppendBytes(TEST_DATA, strlen(TEST_DATA));
+
+	const std::string initUrl = std::string(TEST_BASE_URL) + std::string("init.mp4");
+	std::string videoUrl = std::string(TEST_BASE_URL) + std::string("video.mp4");
+	std::string audioUrl = std::string(TEST_BASE_URL) + std::string("audio.mp4");
+	const std::string videoUrl_unique = videoUrl + std::string(".4567");
+
+	// Hold the video write until released, as a slow storage write would
+	std::promise<void> release;
+	std::shared_future<void> released = release.get_future().share();
+	EXPECT_CALL(*g_mockTSBStore, Write(_,_,_)).WillRepeatedly(Return(TSB::Status::OK));
+	EXPECT_CALL(*g_mockTSBStore, Write(videoUrl_unique,_,_)).WillOnce(InvokeWithoutArgs([released]()
+	{
+		released.wait();
+		return TSB::Status::OK;
+	}));
+	EXPECT_CALL(*g_mockPrivateInstanceAAMP, GetVidTimeScale()).WillRepeatedly(Return(1));
+	EXPECT_CALL(*g_mockPrivateInstanceAAMP, GetAudTimeScale()).WillRepeatedly(Return(1));
+
+	cachedFragment->type = eMEDIATYPE_INIT_VIDEO;
+	mAampTSBSessionManager->EnqueueWrite(initUrl, cachedFragment, TEST_PERIOD_ID);
+	cachedFragment->type = eMEDIATYPE_INIT_AUDIO;
+	mAampTSBSessionManager->EnqueueWrite(initUrl, cachedFragment, TEST_PERIOD_ID);
+	std::this_thread::sleep_for(std::chrono::milliseconds(25));
+
+	cachedFragment->duration = FRAG_DURATION;
+	cachedFragment->initFragment = false;
+	cachedFragment->absPosition = 4567;
+	cachedFragment->type = eMEDIATYPE_VIDEO;
+	mAampTSBSessionManager->EnqueueWrite(videoUrl, cachedFragment, TEST_PERIOD_ID);
+	cachedFragment->type = eMEDIATYPE_AUDIO;
+	mAampTSBSessionManager->EnqueueWrite(audioUrl, cachedFragment, TEST_PERIOD_ID);
+	std::this_thread::sleep_for(std::chrono::milliseconds(25));
+
+	// Audio is written and published while the video write is still in progress
+	EXPECT_DOUBLE_EQ(mAampTSBSessionManager->GetTotalStoreDuration(eMEDIATYPE_AUDIO), FRAG_DURATION);
+	EXPECT_DOUBLE_EQ(mAampTSBSessionManager->GetTotalStoreDuration(eMEDIATYPE_VIDEO), 0);
+
+	release.set_value();
+	std::this_thread::sleep_for(std::chrono::milliseconds(25));
+	EXPECT_DOUBLE_EQ(mAampTSBSessionManager->GetTotalStoreDuration(eMEDIATYPE_VIDEO), FRAG_DURATION);
+}
+
 TEST_F(FunctionalTests, TSBReadTests)
 {
 	constexpr double FRAG_FIRST_POS = 99.0;
@@ -371,10 +420,10 @@ TEST_F(FunctionalTests, TSBReadTests)
 	EXPECT_CALL(*g_mockTSBStore, Read(uniqueInitUrl, _, _)).WillOnce(Return(TSB::Status::OK));
 	EXPECT_CALL(*g_mockTSBStore, Read(videoUrl_unique, _, _)).WillOnce(Return(TSB::Status::OK));
 
-	EXPECT_CALL(*g_mockMediaStreamContext, CacheTsbFragment(_))
+	EXPECT_CALL(*g_mockMediaStreamContext, CacheTsbFragment(_, true))
 		.Times(2)
 		.WillOnce(Return(true))
-		.WillOnce(Invoke([](std::shared_ptr<CachedFragment> fragment)
+		.WillOnce(Invoke([](std::shared_ptr<CachedFragment> fragment, bool takeOwnership)
 		{
 			EXPECT_DOUBLE_EQ(fragment->position, FRAG_FIRST_PTS + FRAG_PTS_OFFSET);
 			return true;
@@ -0,0 +1,213 @@
+/*
+* If not stated otherwise in this file or this component's license file the
+* following copyright and licenses apply:
+*
+* Copyright 2024 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <gtest/gtest.h>
+#include "AampThreadPool.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+class AampThreadPoolTests : public ::testing::Test
+{
+protected:
+	/**
+	 * @brief Block until count reaches expected, or a generous timeout expires
+	 */
+	bool WaitForCount(const std::atomic<int> &count, int expected)
+	{
+		auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+		while( count < expected && std::chrono::steady_clock::now() < deadline )
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		return count >= expected;
+	}
+};
+
+TEST_F(AampThreadPoolTests, RunsAllTasks)
+{
+	AampThreadPool &pool = AampThreadPool::GetInstance();
+	EXPECT_GE(pool.GetWorkerCount(), AAMP_THREAD_POOL_MIN_WORKERS);
+	EXPECT_LE(pool.GetWorkerCount(), AAMP_THREAD_POOL_MAX_WORKERS);
+
+	std::atomic<int> count(0);
+	for( int i = 0; i < 1000; i++ )
+	{
+		pool.Submit([&count]() { count++; }, (AampTaskPriority)(i % eAAMP_TASK_PRIORITY_COUNT));
+	}
+	EXPECT_TRUE(WaitForCount(count, 1000));
+}
+
+TEST_F(AampThreadPoolTests, MostUrgentTaskRunsFirst)
+{
+	AampThreadPool &pool = AampThreadPool::GetInstance();
+	size_t workers = pool.GetWorkerCount();
+
+	// occupy every worker, so that tasks queue up
+	std::vector<std::promise<void>> gates(workers);
+	std::atomic<int> blocked(0);
+	for( auto &gate : gates )
+	{
+		std::shared_future<void> opened = gate.get_future().share();
+		pool.Submit([opened, &blocked]() { blocked++; opened.wait(); }, eAAMP_TASK_PRIORITY_HOUSEKEEPING);
+	}
+	ASSERT_TRUE(WaitForCount(blocked, (int)workers));
+
+	std::mutex mutex;
+	std::vector<int> order;
+	std::atomic<int> done(0);
+	const int perPriority = 8;
+	for( int i = 0; i < perPriority; i++ )
+	{
+		for( int priority = eAAMP_TASK_PRIORITY_HOUSEKEEPING; priority >= eAAMP_TASK_PRIORITY_INJECTION; priority-- )
+		{
+			pool.Submit([priority, &mutex, &order, &done]() {
+				std::lock_guard<std::mutex> lock(mutex);
+				order.push_back(priority);
+				done++;
+			}, (AampTaskPriority)priority);
+		}
+	}
+
+	// a single free worker drains the queues of all workers, in priority order
+	gates[0].set_value();
+	EXPECT_TRUE(WaitForCount(done, perPriority * eAAMP_TASK_PRIORITY_COUNT));
+	for( size_t i = 1; i < gates.size(); i++ )
+	{
+		gates[i].set_value();
+	}
+	std::lock_guard<std::mutex> lock(mutex);
+	ASSERT_EQ(order.size(), perPriority * eAAMP_TASK_PRIORITY_COUNT);
+	for( size_t i = 1; i < order.size(); i++ )
+	{
+		EXPECT_LE(order[i-1], order[i]);
+	}
+	EXPECT_GT(pool.GetStealCount(), 0);
+}
+
+TEST_F(AampThreadPoolTests, IdleWorkersStealNestedTasks)
+{
+	AampThreadPool &pool = AampThreadPool::GetInstance();
+	size_t steals = pool.GetStealCount();
+	std::atomic<int> count(0);
+	// tasks submitted from a worker are queued to that worker only
+	pool.Submit([&pool, &count]() {
+		for( int i = 0; i < 64; i++ )
+		{
+			pool.Submit([&count]() {
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+				count++;
+			}, eAAMP_TASK_PRIORITY_DOWNLOAD);
+		}
+	}, eAAMP_TASK_PRIORITY_DOWNLOAD);
+	EXPECT_TRUE(WaitForCount(count, 64));
+	EXPECT_GT(pool.GetStealCount(), steals);
+}
+
+TEST_F(AampThreadPoolTests, ExceptionDoesNotStopWorker)
+{
+	AampThreadPool &pool = AampThreadPool::GetInstance();
+	std::atomic<int> count(0);
+	for( size_t i = 0; i < pool.GetWorkerCount(); i++ )
+	{
+		pool.Submit([]() { throw std::runtime_error("test"); }, eAAMP_TASK_PRIORITY_INJECTION);
+	}
+	for( int i = 0; i < 100; i++ )
+	{
+		pool.Submit([&count]() { count++; }, eAAMP_TASK_PRIORITY_HOUSEKEEPING);
+	}
+	EXPECT_TRUE(WaitForCount(count, 100));
+}
+
+TEST_F(AampThreadPoolTests, EnableFlag)
+{
+	EXPECT_FALSE(AampThreadPool::IsEnabled());
+	AampThreadPool::SetEnabled(true);
+	EXPECT_TRUE(AampThreadPool::IsEnabled());
+	AampThreadPool::SetEnabled(false);
+	EXPECT_FALSE(AampThreadPool::IsEnabled());
+}
+
+TEST_F(AampThreadPoolTests, ReservedWorkersKeepShortTasksRunning)
+{
+	AampThreadPool &pool = AampThreadPool::GetInstance();
+	size_t base = pool.GetWorkerCount();
+	const int reserved = 2 * AAMP_THREAD_POOL_MAX_WORKERS;
+	for( int i = 0; i < reserved; i++ )
+	{
+		ASSERT_TRUE(pool.ReserveWorker());
+	}
+	EXPECT_EQ(pool.GetReservedCount(), reserved);
+	EXPECT_GE(pool.GetWorkerCount(), base + reserved);
+
+	// each reservation holder blocks, as a track worker waiting on a download does
+	std::promise<void> gate;
+	std::shared_future<void> opened = gate.get_future().share();
+	std::atomic<int> blocked(0);
+	for( int i = 0; i < reserved; i++ )
+	{
+		pool.Submit([opened, &blocked]() { blocked++; opened.wait(); }, eAAMP_TASK_PRIORITY_DOWNLOAD);
+	}
+	EXPECT_TRUE(WaitForCount(blocked, reserved));
+
+	std::atomic<int> count(0);
+	for( int i = 0; i < 100; i++ )
+	{
+		pool.Submit([&count]() { count++; }, eAAMP_TASK_PRIORITY_HOUSEKEEPING);
+	}
+	EXPECT_TRUE(WaitForCount(count, 100));
+
+	gate.set_value();
+	for( int i = 0; i < reserved; i++ )
+	{
+		pool.ReleaseWorker();
+	}
+	EXPECT_EQ(pool.GetReservedCount(), 0);
+}
+
+TEST_F(AampThreadPoolTests, ReserveFailsAtCapacity)
+{
+	AampThreadPool &pool = AampThreadPool::GetInstance();
+	int reserved = 0;
+	while( pool.ReserveWorker() )
+	{
+		reserved++;
+		ASSERT_LE(reserved, AAMP_THREAD_POOL_CAPACITY);
+	}
+	EXPECT_GT(reserved, 0);
+	EXPECT_EQ(pool.GetWorkerCount(), AAMP_THREAD_POOL_CAPACITY);
+	EXPECT_EQ(pool.GetReservedCount(), reserved);
+	for( int i = 0; i < reserved; i++ )
+	{
+		pool.ReleaseWorker();
+	}
+	EXPECT_TRUE(pool.ReserveWorker());
+	pool.ReleaseWorker();
+}
+
+int main(int argc, char** argv)
+{
+	testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
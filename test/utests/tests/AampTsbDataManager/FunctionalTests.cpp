@@ -618,3 +618,79 @@ TEST_F(FunctionalTests, TestFlush)
     EXPECT_EQ(mDataManager->GetFirstFragment(), nullptr);
     EXPECT_FALSE(mDataManager->IsFragmentPresent(1005.0)); // Confirm Init Fragments have been removed
 }
+
+TEST_F(FunctionalTests, ManyFragmentsRollingWindow)
+{
+    mDataManager->AddInitFragment(url, eMEDIATYPE_VIDEO, streamInfo, period, absPosition);
+
+    // Add and cull enough fragments for the index to grow and wrap around
+    for (int i = 0; i < 500; i++)
+    {
+        writeData.cachedFragment->absPosition = 1000.0 + (i * 2.0);
+        EXPECT_TRUE(mDataManager->AddFragment(writeData, eMEDIATYPE_VIDEO, (i % 50) == 0));
+        if (i >= 100)
+        {
+            bool deleteInit = false;
+            TsbFragmentDataPtr removed = mDataManager->RemoveFragment(deleteInit);
+            ASSERT_NE(removed, nullptr);
+            EXPECT_EQ(removed->GetAbsolutePosition(), static_cast<AampTime>(1000.0 + ((i - 100) * 2.0)));
+        }
+    }
+
+    EXPECT_DOUBLE_EQ(mDataManager->GetFirstFragmentPosition(), 1800.0);
+    EXPECT_DOUBLE_EQ(mDataManager->GetLastFragmentPosition(), 1998.0);
+
+    bool eos = true;
+    TsbFragmentDataPtr fragment = mDataManager->GetFragment(1900.0, eos);
+    ASSERT_NE(fragment, nullptr);
+    EXPECT_FALSE(eos);
+    EXPECT_EQ(mDataManager->GetFragment(1901.0, eos), nullptr);
+
+    fragment = mDataManager->GetNearestFragment(1900.9);
+    ASSERT_NE(fragment, nullptr);
+    EXPECT_EQ(fragment->GetAbsolutePosition(), static_cast<AampTime>(1900.0));
+    fragment = mDataManager->GetNearestFragment(1901.1);
+    ASSERT_NE(fragment, nullptr);
+    EXPECT_EQ(fragment->GetAbsolutePosition(), static_cast<AampTime>(1902.0));
+
+    fragment = mDataManager->GetNextDiscFragment(1850.0, false);
+    ASSERT_NE(fragment, nullptr);
+    EXPECT_EQ(fragment->GetAbsolutePosition(), static_cast<AampTime>(1900.0));
+    fragment = mDataManager->GetNextDiscFragment(2100.0, true);
+    ASSERT_NE(fragment, nullptr);
+    EXPECT_EQ(fragment->GetAbsolutePosition(), static_cast<AampTime>(1900.0));
+
+    std::list<TsbFragmentDataPtr> removed = mDataManager->RemoveFragments(1950.0);
+    EXPECT_EQ(removed.size(), 75u);
+    EXPECT_DOUBLE_EQ(mDataManager->GetFirstFragmentPosition(), 1950.0);
+}
+
+TEST_F(FunctionalTests, AddFragmentOutOfOrderAndReplace)
+{
+    mDataManager->AddInitFragment(url, eMEDIATYPE_VIDEO, streamInfo, period, absPosition);
+
+    writeData.url = url1;
+    writeData.cachedFragment->absPosition = 1010.0;
+    mDataManager->AddFragment(writeData, eMEDIATYPE_VIDEO, false);
+
+    writeData.url = url2;
+    writeData.cachedFragment->absPosition = 1005.0;
+    mDataManager->AddFragment(writeData, eMEDIATYPE_VIDEO, false);
+
+    writeData.url = url3;
+    writeData.cachedFragment->absPosition = 1010.0;
+    mDataManager->AddFragment(writeData, eMEDIATYPE_VIDEO, false);
+
+    EXPECT_DOUBLE_EQ(mDataManager->GetFirstFragmentPosition(), 1005.0);
+    EXPECT_DOUBLE_EQ(mDataManager->GetLastFragmentPosition(), 1010.0);
+    EXPECT_EQ(mDataManager->GetFirstFragment()->GetUrl(), url2);
+    EXPECT_EQ(mDataManager->GetLastFragment()->GetUrl(), url3);
+
+    bool eos = false;
+    TsbFragmentDataPtr fragment = mDataManager->GetFragment(1005.0, eos);
+    ASSERT_NE(fragment, nullptr);
+    EXPECT_FALSE(eos);
+    fragment = mDataManager->GetFragment(1010.0, eos);
+    ASSERT_NE(fragment, nullptr);
+    EXPECT_TRUE(eos);
+}
@@ -236,7 +236,7 @@ TEST_F(AampTsbSessionManagerTests, SameInitFragment)
 	EXPECT_CALL(*g_mockTSBStore, GetSize(_)).WillOnce(Return(10));
 
 	// Called only once for the media fragment injection
-	EXPECT_CALL(*g_mockMediaStreamContext, CacheTsbFragment(_)).WillOnce(Return(true));
+	EXPECT_CALL(*g_mockMediaStreamContext, CacheTsbFragment(_, true)).WillOnce(Return(true));
 
 	EXPECT_TRUE(mAampTSBSessionManager->PushNextTsbFragment(mMediaStreamContext.get(), numFreeFragments));
 }
@@ -275,7 +275,7 @@ TEST_F(AampTsbSessionManagerTests, FirstDownload_Success)
 	EXPECT_CALL(*g_mockTSBStore, GetSize(_)).Times(2).WillRepeatedly(Return(10));
 
 	// Called for the init fragment injection followed by the first media fragment
-	EXPECT_CALL(*g_mockMediaStreamContext, CacheTsbFragment(_)).Times(2).WillRepeatedly(Return(true));
+	EXPECT_CALL(*g_mockMediaStreamContext, CacheTsbFragment(_, true)).Times(2).WillRepeatedly(Return(true));
 
 	EXPECT_TRUE(mAampTSBSessionManager->PushNextTsbFragment(mMediaStreamContext.get(), numFreeFragments));
 }
@@ -309,14 +309,14 @@ TEST_F(AampTsbSessionManagerTests, OnlyFreeFragmentForInit)
 	EXPECT_CALL(*g_mockTSBReader, ReadNext(_)).Times(0);
 	// CacheFragment not called because need space for both init and media fragments
 	EXPECT_CALL(*g_mockTSBStore, GetSize(_)).Times(0);
-	EXPECT_CALL(*g_mockMediaStreamContext, CacheTsbFragment(_)).Times(0);
+	EXPECT_CALL(*g_mockMediaStreamContext, CacheTsbFragment(_, _)).Times(0);
 	EXPECT_FALSE(mAampTSBSessionManager->PushNextTsbFragment(mMediaStreamContext.get(), 1));
 
 	EXPECT_CALL(*g_mockTSBReader, FindNext(_)).WillOnce(Return(mockFragmentData));
 	EXPECT_CALL(*g_mockTSBReader, ReadNext(_)).Times(1);
 	// Called twice for init and media fragments
 	EXPECT_CALL(*g_mockTSBStore, GetSize(_)).Times(2).WillRepeatedly(Return(10));
-	EXPECT_CALL(*g_mockMediaStreamContext, CacheTsbFragment(_)).Times(2).WillRepeatedly(Return(true));
+	EXPECT_CALL(*g_mockMediaStreamContext, CacheTsbFragment(_, true)).Times(2).WillRepeatedly(Return(true));
 	EXPECT_TRUE(mAampTSBSessionManager->PushNextTsbFragment(mMediaStreamContext.get(), numFreeFragments));
 }
 
@@ -368,7 +368,7 @@ TEST_F(AampTsbSessionManagerTests, SkipFragments)
 	EXPECT_CALL(*g_mockTSBStore, GetSize(_)).Times(2).WillRepeatedly(Return(10));
 
 	// Called for the init fragment injection followed by the first media fragment
-	EXPECT_CALL(*g_mockMediaStreamContext, CacheTsbFragment(_)).Times(2).WillRepeatedly(Return(true));
+	EXPECT_CALL(*g_mockMediaStreamContext, CacheTsbFragment(_, true)).Times(2).WillRepeatedly(Return(true));
 
 	// Call PushNextTsbFragment, expect the init fragment to be read and injected
 	EXPECT_TRUE(mAampTSBSessionManager->PushNextTsbFragment(mMediaStreamContext.get(), numFreeFragments));
@@ -175,6 +175,16 @@ TEST(_AampUtils, StartsWith)
 	EXPECT_FALSE(result);
 }
 
+TEST(_AampUtils, aamp_GetByteRangeLength)
+{
+	EXPECT_EQ(aamp_GetByteRangeLength("0-99"), 100u);
+	EXPECT_EQ(aamp_GetByteRangeLength("1000-1000"), 1u);
+	EXPECT_EQ(aamp_GetByteRangeLength("100-"), 0u);
+	EXPECT_EQ(aamp_GetByteRangeLength("200-100"), 0u);
+	EXPECT_EQ(aamp_GetByteRangeLength(""), 0u);
+	EXPECT_EQ(aamp_GetByteRangeLength(NULL), 0u);
+}
+
 
 TEST(_AampUtils, aamp_Base64_URL_Encode)
 {
@@ -0,0 +1,275 @@
+/*
+* If not stated otherwise in this file or this component's license file the
+* following copyright and licenses apply:
+*
+* Copyright 2024 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <gtest/gtest.h>
+#include "Aes.h"
+
+#include <openssl/evp.h>
+#include <cstring>
+#include <vector>
+
+static const unsigned char kKey[16] = {
+	0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6, 0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c };
+static const unsigned char kIv[DRM_IV_LEN] = {
+	0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f };
+
+class AesDecryptTests : public ::testing::Test
+{
+protected:
+	std::shared_ptr<AesDec> mAes;
+	unsigned char mKeyCopy[16];
+
+	void SetUp() override
+	{
+		memcpy(mKeyCopy, kKey, sizeof(mKeyCopy));
+		mAes = std::make_shared<AesDec>();
+		mAes->RegisterGetCurlInitCb([](int &curlInstance) { curlInstance = 0; });
+		mAes->RegisterTerminateCurlInstanceCb([](int curlInstance) {});
+		mAes->RegisterNotifyDrmErrorCb([](int drmFailure) {});
+		mAes->RegisterProfileUpdateCb([](bool type, int bucketType) {});
+		mAes->RegisterGetAccessKeyCb([this](std::string &keyURI, std::string &tempEffectiveUrl, int &http_error, double &downloadTime,
+			unsigned int curlInstance, bool &keyAcquisitionStatus, int &failureReason, char **ptr) {
+			*ptr = (char *)mKeyCopy;
+			keyAcquisitionStatus = true;
+		});
+	}
+
+	void TearDown() override
+	{
+		mAes.reset();
+	}
+
+	/**
+	 * @brief Acquire the key through the registered callbacks and wait for it
+	 */
+	void AcquireKey()
+	{
+		DrmInfo drmInfo;
+		drmInfo.manifestURL = "http://host/playlist.m3u8";
+		drmInfo.keyURI = "key.bin";
+		memcpy(drmInfo.iv, kIv, DRM_IV_LEN);
+		ASSERT_EQ(mAes->SetDecryptInfo(&drmInfo, 1000), eDRM_SUCCESS);
+		for (int i = 0; i < 1000 && mAes->GetState() != eDRM_KEY_ACQUIRED; i++)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		ASSERT_EQ(mAes->GetState(), eDRM_KEY_ACQUIRED);
+	}
+
+	/**
+	 * @brief Encrypt with OpenSSL, PKCS#7 padded unless padding is false
+	 */
+	static std::vector<unsigned char> Encrypt(const std::vector<unsigned char> &plain, bool padding = true)
+	{
+		std::vector<unsigned char> cipher(plain.size() + 16);
+		int len = 0;
+		int finalLen = 0;
+		EVP_CIPHER_CTX *ctx = EVP_CIPHER_CTX_new();
+		EXPECT_TRUE(EVP_EncryptInit_ex(ctx, EVP_aes_128_cbc(), NULL, kKey, kIv));
+		EVP_CIPHER_CTX_set_padding(ctx, padding ? 1 : 0);
+		EXPECT_TRUE(EVP_EncryptUpdate(ctx, cipher.data(), &len, plain.data(), (int)plain.size()));
+		EXPECT_TRUE(EVP_EncryptFinal_ex(ctx, cipher.data() + len, &finalLen));
+		EVP_CIPHER_CTX_free(ctx);
+		cipher.resize(len + finalLen);
+		return cipher;
+	}
+
+	static std::vector<unsigned char> Plain(size_t len, unsigned char seed)
+	{
+		std::vector<unsigned char> plain(len);
+		for (size_t i = 0; i < len; i++)
+		{
+			plain[i] = (unsigned char)(seed + i * 7);
+		}
+		return plain;
+	}
+
+	/**
+	 * @brief Check the fragment holds the plain text followed by the zeroed padding
+	 */
+	static void ExpectDecrypted(const std::vector<unsigned char> &buffer, size_t len, const std::vector<unsigned char> &plain)
+	{
+		ASSERT_GE(len, plain.size());
+		EXPECT_EQ(memcmp(buffer.data(), plain.data(), plain.size()), 0);
+		for (size_t i = plain.size(); i < len; i++)
+		{
+			EXPECT_EQ(buffer[i], 0) << "padding byte " << i;
+		}
+	}
+};
+
+TEST_F(AesDecryptTests, DecryptInPlaceClearsPadding)
+{
+	AcquireKey();
+	std::vector<unsigned char> plain = Plain(1000, 3);
+	std::vector<unsigned char> buffer = Encrypt(plain);
+	ASSERT_EQ(buffer.size(), 1008);
+
+	EXPECT_EQ(mAes->Decrypt(DRM_PROFILE_BUCKET_DECRYPT_VIDEO, buffer.data(), buffer.size(), 100), eDRM_SUCCESS);
+	ExpectDecrypted(buffer, buffer.size(), plain);
+}
+
+TEST_F(AesDecryptTests, DecryptFullPaddingBlock)
+{
+	AcquireKey();
+	std::vector<unsigned char> plain = Plain(64, 9);
+	std::vector<unsigned char> buffer = Encrypt(plain);
+	ASSERT_EQ(buffer.size(), 80);
+
+	EXPECT_EQ(mAes->Decrypt(DRM_PROFILE_BUCKET_DECRYPT_VIDEO, buffer.data(), buffer.size(), 100), eDRM_SUCCESS);
+	ExpectDecrypted(buffer, buffer.size(), plain);
+}
+
+TEST_F(AesDecryptTests, DecryptBadPaddingFails)
+{
+	AcquireKey();
+	// last byte 0x20 is not a valid pad length
+	std::vector<unsigned char> plain(64, 0x20);
+	std::vector<unsigned char> buffer = Encrypt(plain, false);
+	EXPECT_EQ(mAes->Decrypt(DRM_PROFILE_BUCKET_DECRYPT_VIDEO, buffer.data(), buffer.size(), 100), eDRM_ERROR);
+
+	// pad length 4, but not all pad bytes are 4
+	plain.assign(64, 0x11);
+	plain[63] = 4;
+	plain[62] = 4;
+	plain[61] = 4;
+	buffer = Encrypt(plain, false);
+	EXPECT_EQ(mAes->Decrypt(DRM_PROFILE_BUCKET_DECRYPT_VIDEO, buffer.data(), buffer.size(), 100), eDRM_ERROR);
+
+	// not a whole number of blocks
+	buffer = Encrypt(Plain(64, 1));
+	EXPECT_EQ(mAes->Decrypt(DRM_PROFILE_BUCKET_DECRYPT_VIDEO, buffer.data(), buffer.size() - 1, 100), eDRM_ERROR);
+}
+
+TEST_F(AesDecryptTests, StreamNeedsAcquiredKey)
+{
+	EXPECT_EQ(mAes->CreateDecryptStream(DRM_PROFILE_BUCKET_DECRYPT_VIDEO, kIv), nullptr);
+}
+
+TEST_F(AesDecryptTests, StreamDecryptsBlocksAsTheyArrive)
+{
+	AcquireKey();
+	std::vector<unsigned char> plain = Plain(5000, 5);
+	std::vector<unsigned char> cipher = Encrypt(plain);
+	std::vector<unsigned char> buffer(cipher.size());
+	std::unique_ptr<HlsDrmDecryptStream> stream = mAes->CreateDecryptStream(DRM_PROFILE_BUCKET_DECRYPT_VIDEO, kIv);
+	ASSERT_NE(stream, nullptr);
+
+	// network writes of uneven sizes; only whole blocks received so far are decrypted
+	const size_t writes[] = { 1, 15, 16, 17, 100, 511, 1024, 7 };
+	size_t len = 0;
+	for (size_t i = 0; len < cipher.size(); i++)
+	{
+		size_t count = std::min(writes[i % (sizeof(writes) / sizeof(writes[0]))], cipher.size() - len);
+		memcpy(buffer.data() + len, cipher.data() + len, count);
+		stream->Update(buffer.data(), len, len + count);
+		len += count;
+		size_t blocksLen = len - (len % 16);
+		size_t checkLen = std::min(blocksLen, plain.size());
+		ASSERT_EQ(memcmp(buffer.data(), plain.data(), checkLen), 0) << "after " << len << " bytes";
+		if (blocksLen < len)
+		{ // partial block stays encrypted until complete
+			ASSERT_EQ(memcmp(buffer.data() + blocksLen, cipher.data() + blocksLen, len - blocksLen), 0);
+		}
+	}
+	EXPECT_EQ(stream->Finish(buffer.data(), buffer.size()), eDRM_SUCCESS);
+	ExpectDecrypted(buffer, buffer.size(), plain);
+}
+
+TEST_F(AesDecryptTests, StreamRestartsWhenDownloadRestarts)
+{
+	AcquireKey();
+	std::vector<unsigned char> plain = Plain(300, 2);
+	std::vector<unsigned char> cipher = Encrypt(plain);
+	std::vector<unsigned char> buffer(cipher.size());
+	std::unique_ptr<HlsDrmDecryptStream> stream = mAes->CreateDecryptStream(DRM_PROFILE_BUCKET_DECRYPT_VIDEO, kIv);
+	ASSERT_NE(stream, nullptr);
+
+	memcpy(buffer.data(), cipher.data(), 200);
+	stream->Update(buffer.data(), 0, 200);
+	// retry writes the fragment again from the start
+	memcpy(buffer.data(), cipher.data(), 40);
+	stream->Update(buffer.data(), 0, 40);
+	memcpy(buffer.data() + 40, cipher.data() + 40, cipher.size() - 40);
+	stream->Update(buffer.data(), 40, cipher.size());
+	EXPECT_EQ(stream->Finish(buffer.data(), buffer.size()), eDRM_SUCCESS);
+	ExpectDecrypted(buffer, buffer.size(), plain);
+}
+
+TEST_F(AesDecryptTests, FinishRestartsWhenRetryShrinksBuffer)
+{
+	AcquireKey();
+	std::vector<unsigned char> first = Plain(300, 4);
+	std::vector<unsigned char> cipher = Encrypt(first);
+	std::vector<unsigned char> buffer(cipher.begin(), cipher.end());
+	std::unique_ptr<HlsDrmDecryptStream> stream = mAes->CreateDecryptStream(DRM_PROFILE_BUCKET_DECRYPT_VIDEO, kIv);
+	ASSERT_NE(stream, nullptr);
+	stream->Update(buffer.data(), 0, buffer.size());
+
+	// the retry delivered a shorter response without passing through Update
+	std::vector<unsigned char> second = Plain(50, 8);
+	std::vector<unsigned char> shorter = Encrypt(second);
+	memcpy(buffer.data(), shorter.data(), shorter.size());
+	EXPECT_EQ(stream->Finish(buffer.data(), shorter.size()), eDRM_SUCCESS);
+	ExpectDecrypted(buffer, shorter.size(), second);
+}
+
+TEST_F(AesDecryptTests, FinishDecryptsPartialTail)
+{
+	AcquireKey();
+	std::vector<unsigned char> plain = Plain(250, 6);
+	std::vector<unsigned char> cipher = Encrypt(plain);
+	std::vector<unsigned char> buffer(cipher.begin(), cipher.end());
+	std::unique_ptr<HlsDrmDecryptStream> stream = mAes->CreateDecryptStream(DRM_PROFILE_BUCKET_DECRYPT_VIDEO, kIv);
+	ASSERT_NE(stream, nullptr);
+
+	// last write ended mid block; the tail is left for Finish
+	stream->Update(buffer.data(), 0, 170);
+	EXPECT_EQ(memcmp(buffer.data(), plain.data(), 160), 0);
+	EXPECT_EQ(memcmp(buffer.data() + 160, cipher.data() + 160, cipher.size() - 160), 0);
+	EXPECT_EQ(stream->Finish(buffer.data(), buffer.size()), eDRM_SUCCESS);
+	ExpectDecrypted(buffer, buffer.size(), plain);
+}
+
+TEST_F(AesDecryptTests, FinishFailsOnTruncatedFragment)
+{
+	AcquireKey();
+	std::vector<unsigned char> cipher = Encrypt(Plain(250, 6));
+	std::unique_ptr<HlsDrmDecryptStream> stream = mAes->CreateDecryptStream(DRM_PROFILE_BUCKET_DECRYPT_VIDEO, kIv);
+	ASSERT_NE(stream, nullptr);
+	stream->Update(cipher.data(), 0, cipher.size() - 5);
+	EXPECT_EQ(stream->Finish(cipher.data(), cipher.size() - 5), eDRM_ERROR);
+}
+
+TEST_F(AesDecryptTests, FinishFailsOnBadPadding)
+{
+	AcquireKey();
+	std::vector<unsigned char> plain(96, 0x55);
+	std::vector<unsigned char> cipher = Encrypt(plain, false);
+	std::unique_ptr<HlsDrmDecryptStream> stream = mAes->CreateDecryptStream(DRM_PROFILE_BUCKET_DECRYPT_VIDEO, kIv);
+	ASSERT_NE(stream, nullptr);
+	stream->Update(cipher.data(), 0, cipher.size());
+	EXPECT_EQ(stream->Finish(cipher.data(), cipher.size()), eDRM_ERROR);
+}
+
+int main(int argc, char** argv)
+{
+	testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
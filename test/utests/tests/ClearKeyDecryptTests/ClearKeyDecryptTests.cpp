@@ -0,0 +1,265 @@
+/*
+* If not stated otherwise in this file or this component's license file the
+* following copyright and licenses apply:
+*
+* Copyright 2024 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <gtest/gtest.h>
+#include <gst/gst.h>
+#include "ClearKeyDrmSession.h"
+#include "DrmData.h"
+#include "PlayerUtils.h"
+
+#include <openssl/evp.h>
+#include <cstring>
+#include <vector>
+
+static const unsigned char kKey[16] = {
+	0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6, 0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c };
+static const unsigned char kKeyId[16] = {
+	0xfe, 0xed, 0xf0, 0x0d, 0xee, 0xde, 0xad, 0xbe, 0xef, 0xf0, 0xba, 0xad, 0xf0, 0x0d, 0xd0, 0x0d };
+static const unsigned char kIv[16] = {
+	0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 };
+
+/**
+ * @brief Clear and encrypted byte counts of one subsample
+ */
+struct Subsample
+{
+	uint16_t clear;
+	uint32_t encrypted;
+};
+
+class ClearKeyDecryptTests : public ::testing::Test
+{
+protected:
+	ClearKeySession *mSession;
+
+	void SetUp() override
+	{
+		mSession = new ClearKeySession();
+		mSession->setKeyId((const char *)kKeyId, sizeof(kKeyId));
+		std::string url;
+		DrmData *request = mSession->generateKeyRequest(url, 0);
+		ASSERT_NE(request, nullptr);
+		delete request;
+
+		char *key = base64_URL_Encode(kKey, sizeof(kKey));
+		char *keyId = base64_URL_Encode(kKeyId, sizeof(kKeyId));
+		std::string response = std::string("{\"keys\":[{\"kty\":\"oct\",\"k\":\"") + key + "\",\"kid\":\"" + keyId + "\"}]}";
+		free(key);
+		free(keyId);
+		DrmData license(response.c_str(), response.size());
+		ASSERT_EQ(mSession->processDRMKey(&license, 0), 1);
+		ASSERT_EQ(mSession->getState(), KEY_READY);
+	}
+
+	void TearDown() override
+	{
+		delete mSession;
+	}
+
+	static std::vector<unsigned char> Sample(size_t len, unsigned char seed)
+	{
+		std::vector<unsigned char> sample(len);
+		for (size_t i = 0; i < len; i++)
+		{
+			sample[i] = (unsigned char)(seed + i * 13);
+		}
+		return sample;
+	}
+
+	/**
+	 * @brief Encrypt the protected ranges of a sample, as a 'cenc' or 'cbcs' packager does
+	 *
+	 * 'cenc' runs one CTR key stream over all encrypted ranges. 'cbcs' restarts CBC from the constant
+	 * IV for each subsample, encrypts crypt blocks of every crypt + skip pattern and leaves a trailing
+	 * partial block clear.
+	 */
+	static std::vector<unsigned char> Encrypt(const std::vector<unsigned char> &clear, const std::vector<Subsample> &subsamples,
+		bool cbcs, unsigned crypt = 0, unsigned skip = 0)
+	{
+		std::vector<unsigned char> sample(clear);
+		std::vector<Subsample> ranges(subsamples);
+		if (ranges.empty())
+		{
+			ranges.push_back({0, (uint32_t)sample.size()});
+		}
+		EVP_CIPHER_CTX *ctx = EVP_CIPHER_CTX_new();
+		int len = 0;
+		EXPECT_TRUE(EVP_EncryptInit_ex(ctx, cbcs ? EVP_aes_128_cbc() : EVP_aes_128_ctr(), NULL, kKey, kIv));
+		EVP_CIPHER_CTX_set_padding(ctx, 0);
+		size_t offset = 0;
+		for (const Subsample &range : ranges)
+		{
+			offset += range.clear;
+			unsigned char *data = sample.data() + offset;
+			if (!cbcs)
+			{
+				EXPECT_TRUE(range.encrypted == 0 || EVP_EncryptUpdate(ctx, data, &len, data, (int)range.encrypted));
+			}
+			else
+			{
+				EXPECT_TRUE(EVP_EncryptInit_ex(ctx, NULL, NULL, NULL, kIv));
+				size_t blocks = range.encrypted / 16;
+				for (size_t block = 0; block < blocks; block++)
+				{
+					if (crypt == 0 || (block % (crypt + skip)) < crypt)
+					{
+						EXPECT_TRUE(EVP_EncryptUpdate(ctx, data + block * 16, &len, data + block * 16, 16));
+					}
+				}
+			}
+			offset += range.encrypted;
+		}
+		EVP_CIPHER_CTX_free(ctx);
+		return sample;
+	}
+
+	static GstBuffer *NewBuffer(const void *data, size_t size)
+	{
+		GstBuffer *buffer = gst_buffer_new_allocate(NULL, size, NULL);
+		gst_buffer_fill(buffer, 0, data, size);
+		return buffer;
+	}
+
+	static GstBuffer *NewSubsampleBuffer(const std::vector<Subsample> &subsamples)
+	{
+		std::vector<unsigned char> map;
+		for (const Subsample &range : subsamples)
+		{
+			map.push_back((unsigned char)(range.clear >> 8));
+			map.push_back((unsigned char)range.clear);
+			map.push_back((unsigned char)(range.encrypted >> 24));
+			map.push_back((unsigned char)(range.encrypted >> 16));
+			map.push_back((unsigned char)(range.encrypted >> 8));
+			map.push_back((unsigned char)range.encrypted);
+		}
+		return NewBuffer(map.data(), map.size());
+	}
+
+	/**
+	 * @brief Decrypt a sample through the gstreamer entry point used by the decryptor plugin
+	 */
+	int Decrypt(std::vector<unsigned char> &sample, const std::vector<Subsample> &subsamples, size_t ivLen,
+		const char *cipherMode = NULL, unsigned crypt = 0, unsigned skip = 0)
+	{
+		GstBuffer *buffer = NewBuffer(sample.data(), sample.size());
+		GstBuffer *iv = NewBuffer(kIv, ivLen);
+		GstBuffer *subsampleBuffer = subsamples.empty() ? NULL : NewSubsampleBuffer(subsamples);
+		if (cipherMode)
+		{
+			gst_buffer_add_protection_meta(buffer, gst_structure_new("application/x-cenc",
+				"cipher-mode", G_TYPE_STRING, cipherMode,
+				"crypt_byte_block", G_TYPE_UINT, crypt,
+				"skip_byte_block", G_TYPE_UINT, skip, NULL));
+		}
+		int ret = mSession->decrypt(NULL, iv, buffer, (unsigned)subsamples.size(), subsampleBuffer, NULL);
+		gst_buffer_extract(buffer, 0, sample.data(), sample.size());
+		gst_buffer_unref(buffer);
+		gst_buffer_unref(iv);
+		if (subsampleBuffer)
+		{
+			gst_buffer_unref(subsampleBuffer);
+		}
+		return ret;
+	}
+};
+
+TEST_F(ClearKeyDecryptTests, CencFullSample)
+{
+	std::vector<unsigned char> clear = Sample(1000, 1);
+	std::vector<unsigned char> sample = Encrypt(clear, {}, false);
+	ASSERT_NE(sample, clear);
+	EXPECT_EQ(Decrypt(sample, {}, 8), 0);
+	EXPECT_EQ(sample, clear);
+
+	// payload entry point used for HLS
+	sample = Encrypt(clear, {}, false);
+	EXPECT_EQ(mSession->decrypt(kIv, 16, sample.data(), (uint32_t)sample.size(), NULL), 0);
+	EXPECT_EQ(sample, clear);
+}
+
+TEST_F(ClearKeyDecryptTests, CencSubsamples)
+{
+	// key stream continues across subsamples; ranges need not be block aligned
+	std::vector<Subsample> subsamples = { {5, 100}, {33, 7}, {0, 250}, {40, 0}, {12, 53} };
+	std::vector<unsigned char> clear = Sample(5 + 100 + 33 + 7 + 250 + 40 + 12 + 53, 2);
+	std::vector<unsigned char> sample = Encrypt(clear, subsamples, false);
+	ASSERT_NE(sample, clear);
+	EXPECT_EQ(memcmp(sample.data(), clear.data(), 5), 0);
+	EXPECT_EQ(Decrypt(sample, subsamples, 16), 0);
+	EXPECT_EQ(sample, clear);
+}
+
+TEST_F(ClearKeyDecryptTests, CbcsPatternWithPartialBlock)
+{
+	// 1:9 pattern as used for video; each subsample ends in a partial block that stays clear
+	std::vector<Subsample> subsamples = { {10, 16 * 25 + 9}, {7, 16 * 3 + 1}, {0, 16 * 11} };
+	std::vector<unsigned char> clear = Sample(10 + 16 * 25 + 9 + 7 + 16 * 3 + 1 + 16 * 11, 3);
+	std::vector<unsigned char> sample = Encrypt(clear, subsamples, true, 1, 9);
+	ASSERT_NE(sample, clear);
+	// skipped blocks and the partial tail were not encrypted
+	EXPECT_EQ(memcmp(sample.data() + 10 + 16, clear.data() + 10 + 16, 16 * 9), 0);
+	EXPECT_EQ(memcmp(sample.data() + 10 + 16 * 25, clear.data() + 10 + 16 * 25, 9), 0);
+	EXPECT_EQ(Decrypt(sample, subsamples, 16, "cbcs", 1, 9), 0);
+	EXPECT_EQ(sample, clear);
+}
+
+TEST_F(ClearKeyDecryptTests, CbcsFullSampleWithoutPattern)
+{
+	std::vector<unsigned char> clear = Sample(16 * 20 + 5, 4);
+	std::vector<unsigned char> sample = Encrypt(clear, {}, true);
+	ASSERT_NE(sample, clear);
+	EXPECT_EQ(Decrypt(sample, {}, 16, "cbcs", 0, 0), 0);
+	EXPECT_EQ(sample, clear);
+}
+
+TEST_F(ClearKeyDecryptTests, SubsamplesOverrunSample)
+{
+	std::vector<Subsample> subsamples = { {10, 100}, {10, 100} };
+	std::vector<unsigned char> clear = Sample(200, 5);
+	std::vector<unsigned char> sample = Encrypt(clear, { {10, 100}, {10, 80} }, false);
+	std::vector<unsigned char> original(sample);
+	EXPECT_NE(Decrypt(sample, subsamples, 16), 0);
+	// nothing past the sample was touched, and the last range was not decrypted
+	EXPECT_EQ(memcmp(sample.data() + 120, original.data() + 120, 80), 0);
+}
+
+TEST_F(ClearKeyDecryptTests, SubsampleMapShorterThanCount)
+{
+	std::vector<unsigned char> sample = Sample(100, 6);
+	GstBuffer *buffer = NewBuffer(sample.data(), sample.size());
+	GstBuffer *iv = NewBuffer(kIv, 16);
+	GstBuffer *subsampleBuffer = NewSubsampleBuffer({ {10, 50} });
+	EXPECT_NE(mSession->decrypt(NULL, iv, buffer, 2, subsampleBuffer, NULL), 0);
+	gst_buffer_unref(buffer);
+	gst_buffer_unref(iv);
+	gst_buffer_unref(subsampleBuffer);
+}
+
+TEST_F(ClearKeyDecryptTests, InvalidIvLength)
+{
+	std::vector<unsigned char> sample = Sample(64, 7);
+	EXPECT_NE(Decrypt(sample, {}, 12), 0);
+}
+
+int main(int argc, char** argv)
+{
+	gst_init(&argc, &argv);
+	testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
@@ -114,3 +114,62 @@ TEST_F(AampLegacyDrmSessionTests, TestCreateClearkeySession)
 	const MockCurlOpts *curlOpts = MockCurlGetOpts();
 	ASSERT_STREQ(ckLicenseServerURL.c_str(), curlOpts->url);
 }
+
+TEST_F(AampLegacyDrmSessionTests, TestReuseClearkeySessionByKeyId)
+{
+	AampDRMLicenseManager *sessionManager = mUtils->getSessionManager();
+
+	cJSON *keysObj = cJSON_CreateObject();
+	cJSON *keyInstanceObj = cJSON_CreateObject();
+	cJSON_AddStringToObject(keyInstanceObj, "alg", "cbc");
+	cJSON_AddStringToObject(keyInstanceObj, "k", "_u3wDe7erb7v8Lqt8A3QDQ");
+	cJSON_AddStringToObject(keyInstanceObj, "kid", "_u3wDe7erb7v8Lqt8A3QDQ");
+	cJSON *keysArr = cJSON_AddArrayToObject(keysObj, "keys");
+	cJSON_AddItemToArray(keysArr, keyInstanceObj);
+
+	char *keyResponse = cJSON_PrintUnformatted(keysObj);
+	mUtils->setupCurlPerformResponse(keyResponse);
+	cJSON_free(keyResponse);
+	cJSON_Delete(keysObj);
+
+	const unsigned char initData[] = {
+		0x00, 0x00, 0x00, 0x34, 0x70, 0x73, 0x73, 0x68, 0x01, 0x00, 0x00, 0x00, 0x10,
+		0x77, 0xef, 0xec, 0xc0, 0xb2, 0x4d, 0x02, 0xac, 0xe3, 0x3c, 0x1e, 0x52, 0xe2,
+		0xfb, 0x4b, 0x00, 0x00, 0x00, 0x01, 0xfe, 0xed, 0xf0, 0x0d, 0xee, 0xde, 0xad,
+		0xbe, 0xef, 0xf0, 0xba, 0xad, 0xf0, 0x0d, 0xd0, 0x0d, 0x00, 0x00, 0x00, 0x00};
+	const std::vector<uint8_t> keyId = {
+		0xfe, 0xed, 0xf0, 0x0d, 0xee, 0xde, 0xad, 0xbe, 0xef, 0xf0, 0xba, 0xad, 0xf0, 0x0d, 0xd0, 0x0d};
+
+	DrmMetaDataEventPtr aampEvent =
+		std::make_shared<DrmMetaDataEvent>(AAMP_TUNE_FAILURE_UNKNOWN, "", 0, 0, false, "");
+	gpGlobalConfig->SetConfigValue(AAMP_APPLICATION_SETTING, eAAMPConfig_CKLicenseServerUrl,
+								   std::string("http://licenseserver.example/license"));
+	void *ptr = static_cast<void*>(&aampEvent);
+	int err = -1;
+	DrmSessionManager *drmSessionManager = sessionManager->mDrmSessionManager;
+	bool status = false;
+	EXPECT_FALSE(drmSessionManager->IsKeyIdProcessed(keyId, status));
+
+	DrmSession *drmSession = drmSessionManager->createDrmSession(err,
+		"1077efec-c0b2-4d02-ace3-3c1e52e2fb4b", eMEDIAFORMAT_DASH, initData, sizeof(initData),
+		(int)eMEDIATYPE_VIDEO, mAamp, ptr, NULL, true);
+	ASSERT_TRUE(drmSession != NULL);
+	EXPECT_TRUE(drmSessionManager->IsKeyIdProcessed(keyId, status));
+	EXPECT_TRUE(status);
+
+	// the audio track with the same key ID gets the ready session from the key ID index
+	DrmSession *audioSession = drmSessionManager->createDrmSession(err,
+		"1077efec-c0b2-4d02-ace3-3c1e52e2fb4b", eMEDIAFORMAT_DASH, initData, sizeof(initData),
+		(int)eMEDIATYPE_AUDIO, mAamp, ptr, NULL, true);
+	EXPECT_EQ(drmSession, audioSession);
+	EXPECT_GE(drmSessionManager->getSlotIdForSession(drmSession), 0);
+
+	DrmSessionReuseStats stats = drmSessionManager->GetSessionReuseStats();
+	EXPECT_EQ(stats.misses, 1u);
+	EXPECT_EQ(stats.readyHits, 1u);
+	EXPECT_EQ(stats.evictions, 0u);
+
+	drmSessionManager->clearSessionData();
+	EXPECT_FALSE(drmSessionManager->IsKeyIdProcessed(keyId, status));
+	EXPECT_EQ(drmSessionManager->getSlotIdForSession(drmSession), -1);
+}
@@ -26,6 +26,7 @@
 #include "AampDRMLicPreFetcherInterface.h"
 #include "AampConfig.h"
 #include "MockAampConfig.h"
+#include "MockStreamAbstractionAAMP.h"
 
 #include "fragmentcollector_mpd.h"
 #include "StreamAbstractionAAMP.h"
@@ -204,3 +205,68 @@ TEST_F(MediaStreamContextTest, DefaultDurationTest)
     //Assert:check durationValue variable value
     EXPECT_EQ(durationValue,6000);
 }
+
+TEST_F(MediaStreamContextTest, CacheTsbFragmentOwnedTest)
+{
+    static char data[] = "owned-fragment-data";
+    CachedFragment slot;
+    std::shared_ptr<CachedFragment> fragment = std::make_shared<CachedFragment>();
+    fragment->fragment.AppendBytes(data, sizeof(data));
+    fragment->position = 10.0;
+    g_mockMediaTrackFetchBuffer = new MockMediaTrackFetchBuffer();
+    EXPECT_CALL(*g_mockMediaTrackFetchBuffer, GetFetchChunkBuffer(true)).WillOnce(Return(&slot));
+
+    //Act:hand the fragment over to the chunk cache
+    bool retResult = mMediaStreamContext->CacheTsbFragment(fragment, true);
+
+    //Assert:data is moved into the slot and the caller's fragment is left empty
+    EXPECT_TRUE(retResult);
+    EXPECT_EQ(slot.fragment.GetPtr(), data);
+    EXPECT_EQ(slot.fragment.GetLen(), sizeof(data));
+    EXPECT_DOUBLE_EQ(slot.position, 10.0);
+    EXPECT_EQ(fragment->fragment.GetPtr(), nullptr);
+    EXPECT_EQ(fragment->fragment.GetLen(), 0u);
+    delete g_mockMediaTrackFetchBuffer;
+    g_mockMediaTrackFetchBuffer = nullptr;
+}
+
+TEST_F(MediaStreamContextTest, CacheTsbFragmentSharedTest)
+{
+    static char data[] = "shared-fragment-data";
+    CachedFragment slot;
+    std::shared_ptr<CachedFragment> fragment = std::make_shared<CachedFragment>();
+    fragment->fragment.AppendBytes(data, sizeof(data));
+    fragment->position = 20.0;
+    g_mockMediaTrackFetchBuffer = new MockMediaTrackFetchBuffer();
+    EXPECT_CALL(*g_mockMediaTrackFetchBuffer, GetFetchChunkBuffer(true)).WillOnce(Return(&slot));
+
+    //Act:cache a fragment the caller still uses
+    bool retResult = mMediaStreamContext->CacheTsbFragment(fragment, false);
+
+    //Assert:data is copied into the slot and the caller's fragment is untouched
+    EXPECT_TRUE(retResult);
+    EXPECT_EQ(slot.fragment.GetLen(), sizeof(data));
+    EXPECT_DOUBLE_EQ(slot.position, 20.0);
+    EXPECT_EQ(fragment->fragment.GetPtr(), data);
+    EXPECT_EQ(fragment->fragment.GetLen(), sizeof(data));
+    delete g_mockMediaTrackFetchBuffer;
+    g_mockMediaTrackFetchBuffer = nullptr;
+}
+
+TEST_F(MediaStreamContextTest, CacheTsbFragmentNoSlotTest)
+{
+    static char data[] = "fragment-data";
+    std::shared_ptr<CachedFragment> fragment = std::make_shared<CachedFragment>();
+    fragment->fragment.AppendBytes(data, sizeof(data));
+    g_mockMediaTrackFetchBuffer = new MockMediaTrackFetchBuffer();
+    EXPECT_CALL(*g_mockMediaTrackFetchBuffer, GetFetchChunkBuffer(true)).WillOnce(Return(nullptr));
+
+    //Act:cache with no fetch buffer available
+    bool retResult = mMediaStreamContext->CacheTsbFragment(fragment, true);
+
+    //Assert:nothing is cached and the caller keeps its data
+    EXPECT_FALSE(retResult);
+    EXPECT_EQ(fragment->fragment.GetPtr(), data);
+    delete g_mockMediaTrackFetchBuffer;
+    g_mockMediaTrackFetchBuffer = nullptr;
+}
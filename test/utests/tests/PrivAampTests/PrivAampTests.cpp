@@ -810,6 +810,70 @@ TEST_F(PrivAampTests, HandleSSLWriteCallbackTest)
 	EXPECT_EQ(val,0);
 }
 
+TEST_F(PrivAampTests, HandleSSLWriteCallbackContentLengthTest)
+{
+	char data[10] = {0};
+	AampGrowableBuffer buffer("download-test");
+	CurlCallbackContext context(p_aamp, &buffer);
+	context.mediaType = eMEDIATYPE_VIDEO;
+	context.contentLength = 500;
+	context.expectedLength = 1000;
+	p_aamp->EnableMediaDownloads(eMEDIATYPE_VIDEO);
+
+	size_t val = p_aamp->HandleSSLWriteCallback(data, 1, sizeof(data), &context);
+
+	// Content-Length wins over the size hint; 2 extra bytes for the NUL terminator
+	EXPECT_EQ(val, sizeof(data));
+	EXPECT_EQ(buffer.GetAvail(), 502u);
+}
+
+TEST_F(PrivAampTests, HandleSSLWriteCallbackExpectedLengthTest)
+{
+	char data[10] = {0};
+	AampGrowableBuffer buffer("download-test");
+	CurlCallbackContext context(p_aamp, &buffer);
+	context.mediaType = eMEDIATYPE_VIDEO;
+	context.expectedLength = 1000;
+	p_aamp->EnableMediaDownloads(eMEDIATYPE_VIDEO);
+
+	size_t val = p_aamp->HandleSSLWriteCallback(data, 1, sizeof(data), &context);
+
+	// No Content-Length (chunked transfer); pre-sized from the byte range or learned size
+	EXPECT_EQ(val, sizeof(data));
+	EXPECT_EQ(buffer.GetAvail(), 1002u);
+}
+
+TEST_F(PrivAampTests, HandleSSLWriteCallbackNoSizeHintTest)
+{
+	char data[10] = {0};
+	AampGrowableBuffer buffer("download-test");
+	CurlCallbackContext context(p_aamp, &buffer);
+	context.mediaType = eMEDIATYPE_VIDEO;
+	p_aamp->EnableMediaDownloads(eMEDIATYPE_VIDEO);
+
+	size_t val = p_aamp->HandleSSLWriteCallback(data, 1, sizeof(data), &context);
+
+	// Nothing known about the size; the buffer grows as data arrives
+	EXPECT_EQ(val, sizeof(data));
+	EXPECT_EQ(buffer.GetAvail(), 0u);
+}
+
+TEST_F(PrivAampTests, HandleSSLWriteCallbackDownloadsDisabledTest)
+{
+	char data[10] = {0};
+	AampGrowableBuffer buffer("download-test");
+	CurlCallbackContext context(p_aamp, &buffer);
+	context.mediaType = eMEDIATYPE_VIDEO;
+	context.expectedLength = 1000;
+	p_aamp->DisableMediaDownloads(eMEDIATYPE_VIDEO);
+
+	size_t val = p_aamp->HandleSSLWriteCallback(data, 1, sizeof(data), &context);
+
+	// Aborted download is not pre-sized
+	EXPECT_EQ(val, 0u);
+	EXPECT_EQ(buffer.GetAvail(), 0u);
+}
+
 TEST_F(PrivAampTests, RunPausePositionMonitoringTest)
 {
 	p_aamp->RunPausePositionMonitoring();
@@ -1251,6 +1251,58 @@ TEST_F(TrackStateTests, IndexPlaylist_ProcessEXTINF)
     TrackStateobj->IndexPlaylist(isRefresh, culledSec);
 }
 
+TEST_F(TrackStateTests, IndexPlaylist_ReusePreviousIndexOnRefresh)
+{
+    auto makePlaylist = [](int firstSequence, int count)
+    {
+        std::string text = "#EXTM3U\n#EXT-X-TARGETDURATION:3\n#EXT-X-MEDIA-SEQUENCE:" + std::to_string(firstSequence) + "\n#EXT-X-DISCONTINUITY-SEQUENCE:3\n";
+        for (int sequence = firstSequence; sequence < firstSequence + count; sequence++)
+        {
+            if (sequence == 105)
+            {
+                text += "#EXT-X-DISCONTINUITY\n";
+            }
+            text += "#EXTINF:" + std::to_string(2.0 + (sequence % 3) * 0.5) + ",\nseg" + std::to_string(sequence) + ".ts\n";
+        }
+        return text;
+    };
+    std::string before = makePlaylist(100, 10);
+    std::string after = makePlaylist(102, 10);
+    AampTime culledSec{};
+    EXPECT_CALL(*g_mockAampConfig, IsConfigSet(_)).WillRepeatedly(Return(false));
+    EXPECT_CALL(*g_mockAampConfig, IsConfigSet(eAAMPConfig_HLSIncrementalIndex)).WillRepeatedly(Return(true));
+
+    TrackStateobj->playlist.AppendBytes(before.c_str(), before.size());
+    TrackStateobj->playlist.AppendNulTerminator();
+    TrackStateobj->IndexPlaylist(false, culledSec);
+    ASSERT_EQ(TrackStateobj->index.size(), 10);
+
+    AampGrowableBuffer previousPlaylist("previousPlaylist");
+    previousPlaylist.Replace(&TrackStateobj->playlist);
+    TrackStateobj->playlist.AppendBytes(after.c_str(), after.size());
+    TrackStateobj->playlist.AppendNulTerminator();
+    TrackStateobj->IndexPlaylist(true, culledSec, &previousPlaylist);
+    std::vector<IndexNode> reusedIndex = TrackStateobj->index;
+    std::vector<DiscontinuityIndexNode> reusedDiscontinuityIndex = TrackStateobj->mDiscontinuityIndex;
+    previousPlaylist.Free();
+
+    // full parse of the same playlist text
+    TrackStateobj->IndexPlaylist(false, culledSec);
+    ASSERT_EQ(reusedIndex.size(), TrackStateobj->index.size());
+    for (size_t idx = 0; idx < reusedIndex.size(); idx++)
+    {
+        EXPECT_EQ(reusedIndex[idx].mediaSequenceNumber, TrackStateobj->index[idx].mediaSequenceNumber);
+        EXPECT_EQ(reusedIndex[idx].completionTimeSecondsFromStart, TrackStateobj->index[idx].completionTimeSecondsFromStart);
+        EXPECT_EQ(reusedIndex[idx].pFragmentInfo.getPtr(), TrackStateobj->index[idx].pFragmentInfo.getPtr());
+        EXPECT_EQ(reusedIndex[idx].pFragmentInfo.getLen(), TrackStateobj->index[idx].pFragmentInfo.getLen());
+    }
+    ASSERT_EQ(reusedDiscontinuityIndex.size(), 1);
+    ASSERT_EQ(TrackStateobj->mDiscontinuityIndex.size(), 1);
+    EXPECT_EQ(reusedDiscontinuityIndex[0].fragmentIdx, TrackStateobj->mDiscontinuityIndex[0].fragmentIdx);
+    EXPECT_EQ(reusedDiscontinuityIndex[0].discontinuitySequenceIndex, TrackStateobj->mDiscontinuityIndex[0].discontinuitySequenceIndex);
+    EXPECT_EQ(reusedDiscontinuityIndex[0].position, TrackStateobj->mDiscontinuityIndex[0].position);
+}
+
 TEST_F(TrackStateTests, GetNextFragmentUri_WithReloadUri)
 {
     bool reloadUri = true;
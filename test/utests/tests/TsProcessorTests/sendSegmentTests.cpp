@@ -198,6 +198,15 @@ protected:
         double getApparentFrameRate() const {
             return m_apparentFrameRate;
         }
+
+        int GetPidRole(int pid, int pmtPid, int videoPid, int pcrPid)
+        {
+            m_pmtPid = pmtPid;
+            m_videoPid = videoPid;
+            m_pcrPid = pcrPid;
+            updatePidRoles();
+            return m_pidRoles[pid];
+        }
     };
 
     void SetUp() override
@@ -980,3 +989,47 @@ TEST_F(sendSegmentTests, AbortTest)
     mTSProcessor->setRate(2.22, PlayMode_reverse_GOP);
     mTSProcessor->abort();
 }
+
+TEST_F(sendSegmentTests, ScanTSPacketHeadersTest)
+{
+    const int packetCount = 11;
+    unsigned char buffer[packetCount * tsPacketLength] = {};
+    for (int i = 0; i < packetCount; i++)
+    {
+        unsigned char *packet = &buffer[i * tsPacketLength];
+        int pid = 0x100 + i * 0x111;
+        packet[0] = 0x47;
+        packet[1] = ((i & 1) ? 0x40 : 0x00) | 0xA0 | ((pid >> 8) & 0x1F);
+        packet[2] = (pid & 0xFF);
+        packet[3] = 0x80 | 0x30 | (i & 0xF);
+    }
+    buffer[9 * tsPacketLength] = 0x46;
+
+    TSPacketHeader headers[packetCount];
+    EXPECT_EQ(ScanTSPacketHeaders(buffer, packetCount, tsPacketLength, headers), 9);
+    for (int i = 0; i < packetCount; i++)
+    {
+        EXPECT_EQ(TSHeaderPid(headers[i]), 0x100 + i * 0x111);
+        EXPECT_EQ(TSHeaderPayloadStart(headers[i]), (i & 1) != 0);
+        EXPECT_EQ(TSHeaderAdaptation(headers[i]), 3);
+        EXPECT_EQ(TSHeaderContinuity(headers[i]), i & 0xF);
+        EXPECT_EQ(TSHeaderScrambling(headers[i]), 2);
+    }
+    EXPECT_EQ(ScanTSPacketHeaders(buffer, 9, tsPacketLength, headers), 9);
+}
+
+TEST_F(sendSegmentTests, PidRolesTest)
+{
+    EXPECT_EQ(mTSProcessor->GetPidRole(0, 0x1000, 0x100, 0x101), ePID_ROLE_PAT);
+    EXPECT_EQ(mTSProcessor->GetPidRole(0x1000, 0x1000, 0x100, 0x101), ePID_ROLE_PMT);
+    EXPECT_EQ(mTSProcessor->GetPidRole(0x100, 0x1000, 0x100, 0x101), ePID_ROLE_VIDEO);
+    EXPECT_EQ(mTSProcessor->GetPidRole(0x101, 0x1000, 0x100, 0x101), ePID_ROLE_VIDEO);
+    EXPECT_EQ(mTSProcessor->GetPidRole(0x102, 0x1000, 0x100, 0x101), ePID_ROLE_OTHER);
+    // previous PIDs are released when they change
+    EXPECT_EQ(mTSProcessor->GetPidRole(0x100, 0x1001, 0x200, -1), ePID_ROLE_OTHER);
+    EXPECT_EQ(mTSProcessor->GetPidRole(0x101, 0x1001, 0x200, -1), ePID_ROLE_OTHER);
+    EXPECT_EQ(mTSProcessor->GetPidRole(0x1000, 0x1001, 0x200, -1), ePID_ROLE_OTHER);
+    EXPECT_EQ(mTSProcessor->GetPidRole(0x1001, 0x1001, 0x200, -1), ePID_ROLE_PMT);
+    // PMT takes precedence over a shared video PID
+    EXPECT_EQ(mTSProcessor->GetPidRole(0x300, 0x300, 0x300, 0x300), ePID_ROLE_PMT);
+}
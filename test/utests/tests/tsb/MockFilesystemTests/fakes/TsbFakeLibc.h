@@ -20,9 +20,11 @@
 #ifndef __TSB_FAKE_LIBC__
 #define __TSB_FAKE_LIBC__
 
-// Included for open() and flock() flags
+// Included for open(), flock() and fcntl() flags and struct stat
 #include <fcntl.h>
 #include <sys/file.h>
+#include <sys/stat.h>
+#include <sys/types.h>
 
 namespace TSB
 {
@@ -31,8 +33,16 @@ namespace FS
 {
 
 int open(const char *, int);
+int open(const char *, int, mode_t);
 int close(int);
 int flock(int, int);
+ssize_t pread(int, void *, size_t, off_t);
+ssize_t pwrite(int, const void *, size_t, off_t);
+int fstat(int, struct stat *);
+int fchmod(int, mode_t);
+int fcntl(int, int, int = 0);
+int fallocate(int, int, off_t, off_t);
+int ftruncate(int, off_t);
 
 } // namespace FS
 
@@ -306,6 +306,20 @@ int open(const char *pathname, int flags)
 	return rv;
 }
 
+int open(const char *pathname, int flags, mode_t mode)
+{
+	int rv = 0;
+	LOG(pathname);
+	LOG(flags);
+	LOG(mode);
+	if (g_mockLibc)
+	{
+		rv = g_mockLibc->open(pathname, flags, mode);
+	}
+	LOG(rv);
+	return rv;
+}
+
 int close(int fd)
 {
 	int rv = 0;
@@ -331,6 +345,101 @@ int flock(int fd, int op)
 	return rv;
 }
 
+ssize_t pread(int fd, void *buf, size_t count, off_t offset)
+{
+	ssize_t rv = static_cast<ssize_t>(count);
+	LOG(fd);
+	LOG(count);
+	LOG(offset);
+	if (g_mockLibc)
+	{
+		rv = g_mockLibc->pread(fd, buf, count, offset);
+	}
+	LOG(rv);
+	return rv;
+}
+
+ssize_t pwrite(int fd, const void *buf, size_t count, off_t offset)
+{
+	ssize_t rv = static_cast<ssize_t>(count);
+	LOG(fd);
+	LOG(count);
+	LOG(offset);
+	if (g_mockLibc)
+	{
+		rv = g_mockLibc->pwrite(fd, buf, count, offset);
+	}
+	LOG(rv);
+	return rv;
+}
+
+int fstat(int fd, struct stat *statbuf)
+{
+	int rv = 0;
+	LOG(fd);
+	if (g_mockLibc)
+	{
+		rv = g_mockLibc->fstat(fd, statbuf);
+	}
+	LOG(rv);
+	return rv;
+}
+
+int fchmod(int fd, mode_t mode)
+{
+	int rv = 0;
+	LOG(fd);
+	LOG(mode);
+	if (g_mockLibc)
+	{
+		rv = g_mockLibc->fchmod(fd, mode);
+	}
+	LOG(rv);
+	return rv;
+}
+
+int fcntl(int fd, int cmd, int arg)
+{
+	int rv = 0;
+	LOG(fd);
+	LOG(cmd);
+	LOG(arg);
+	if (g_mockLibc)
+	{
+		rv = g_mockLibc->fcntl(fd, cmd, arg);
+	}
+	LOG(rv);
+	return rv;
+}
+
+int fallocate(int fd, int mode, off_t offset, off_t len)
+{
+	int rv = 0;
+	LOG(fd);
+	LOG(mode);
+	LOG(offset);
+	LOG(len);
+	if (g_mockLibc)
+	{
+		rv = g_mockLibc->fallocate(fd, mode, offset, len);
+	}
+	LOG(rv);
+	return rv;
+}
+
+int ftruncate(int fd, off_t length)
+{
+	int rv = 0;
+	LOG(fd);
+	LOG(length);
+	if (g_mockLibc)
+	{
+		rv = g_mockLibc->ftruncate(fd, length);
+	}
+	LOG(rv);
+	return rv;
+}
+
 } // namespace FS
 
 } // namespace TSB
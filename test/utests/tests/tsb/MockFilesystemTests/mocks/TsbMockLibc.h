@@ -22,9 +22,11 @@
 
 #include <gmock/gmock.h>
 
-// Included for open() and flock() flags
+// Included for open(), flock() and fcntl() flags and struct stat
 #include <fcntl.h>
 #include <sys/file.h>
+#include <sys/stat.h>
+#include <sys/types.h>
 
 class TsbMockLibc
 {
@@ -32,6 +34,14 @@ public:
 	MOCK_METHOD(int, open, (const char*, int));
 	MOCK_METHOD(int, close, (int));
 	MOCK_METHOD(int, flock, (int, int));
+	MOCK_METHOD(int, open, (const char*, int, mode_t));
+	MOCK_METHOD(ssize_t, pread, (int, void*, size_t, off_t));
+	MOCK_METHOD(ssize_t, pwrite, (int, const void*, size_t, off_t));
+	MOCK_METHOD(int, fstat, (int, struct stat*));
+	MOCK_METHOD(int, fchmod, (int, mode_t));
+	MOCK_METHOD(int, fcntl, (int, int, int));
+	MOCK_METHOD(int, fallocate, (int, int, off_t, off_t));
+	MOCK_METHOD(int, ftruncate, (int, off_t));
 };
 
 extern TsbMockLibc* g_mockLibc;
@@ -68,6 +68,7 @@ const std::string kFileIncPath{kActiveDir + "/" + kDir + "/" + kFile};
 const std::string kDirIncPath{kActiveDir + "/" + kDir};
 const char kFileContent[]{"content of the file"};
 const int kTsbLocationFd{1};
+const int kFileFd{10};
 const int kTestLoggerData{54321};
 
 // Directly called internally by the tests.
@@ -191,6 +192,19 @@ protected:
 		return store;
 	}
 
+	std::unique_ptr<TSB::Store> createStorePosix()
+	{
+		EXPECT_CALL(*g_mockFilesystem, space(fs::path(kTsbLocation), _))
+			.WillOnce(DoAll(SetArgReferee<1>(std::error_code()),
+							Return(fs::space_info{kCapacity, 0, 0})));
+
+		TSB::Store::Config tsbConfig = {kTsbLocation, kMinFreePercent, kMaxCapacity, TSB::IoBackend::POSIX};
+		auto store = std::make_unique<TSB::Store>(tsbConfig, TsbLogger, kTestLoggerData, TSB::LogLevel::TRACE);
+
+		waitForFlushCompletion();
+		return store;
+	}
+
 	std::unique_ptr<TSB::Store> createStoreDefault()
 	{
 		EXPECT_CALL(*g_mockFilesystem, space(fs::path(kTsbLocation), _))
@@ -932,3 +946,54 @@ TEST_F(TsbStoreTests, GetSize_Nofile)
 
 	EXPECT_EQ(store->GetSize(kUrl), expected_size);
 }
+
+TEST_F(TsbStoreTests, PosixWriteSuccess)
+{
+	std::unique_ptr<TSB::Store> store = createStorePosix();
+	const mode_t mode = S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP | S_IROTH | S_IWOTH;
+
+	// Exclusive create replaces the existence check, and the directories are only created once
+	EXPECT_CALL(*g_mockFilesystem, exists(fs::path(kFileIncPath))).Times(0);
+	createDirectoriesExpectations(fs::path{kDirIncPath}, fs::path{kTsbLocation});
+	EXPECT_CALL(*g_mockLibc, open(StrEq(kFileIncPath.c_str()), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, mode))
+		.WillOnce(Return(kFileFd));
+	EXPECT_CALL(*g_mockLibc, open(StrEq(kDirIncPath + "/file2.mp4"), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, mode))
+		.WillOnce(Return(kFileFd + 1));
+	EXPECT_CALL(*g_mockLibc, fchmod(_, mode)).Times(2);
+	EXPECT_CALL(*g_mockLibc, pwrite(_, kFileContent, sizeof(kFileContent), 0))
+		.Times(2)
+		.WillRepeatedly(Return(sizeof(kFileContent)));
+
+	ASSERT_THAT(store->Write(kUrl, kFileContent, sizeof(kFileContent)), TSB::Status::OK);
+	ASSERT_THAT(store->Write("https://" + kDir + "/file2.mp4", kFileContent, sizeof(kFileContent)), TSB::Status::OK);
+
+	// The descriptor of the written file is reused to get its size
+	EXPECT_CALL(*g_mockLibc, fstat(kFileFd, _)).WillOnce(Return(0));
+	EXPECT_CALL(*g_mockFilesystem, file_size(_, _)).Times(0);
+	store->GetSize(kUrl);
+}
+
+TEST_F(TsbStoreTests, PosixWriteFailExists)
+{
+	std::unique_ptr<TSB::Store> store = createStorePosix();
+
+	EXPECT_CALL(*g_mockLibc, open(StrEq(kFileIncPath.c_str()), _, _)).WillOnce(SetErrnoAndReturn(EEXIST, -1));
+	EXPECT_CALL(*g_mockLibc, pwrite(_, _, _, _)).Times(0);
+	EXPECT_CALL(*g_mockFilesystem, remove(_, _)).Times(0);
+
+	ASSERT_THAT(store->Write(kUrl, kFileContent, sizeof(kFileContent)), TSB::Status::ALREADY_EXISTS);
+}
+
+TEST_F(TsbStoreTests, PosixWriteFailNoSpace)
+{
+	std::unique_ptr<TSB::Store> store = createStorePosix();
+
+	EXPECT_CALL(*g_mockLibc, open(StrEq(kFileIncPath.c_str()), _, _)).WillOnce(Return(kFileFd));
+	EXPECT_CALL(*g_mockLibc, pwrite(kFileFd, _, _, _)).WillOnce(SetErrnoAndReturn(ENOSPC, -1));
+	EXPECT_CALL(*g_mockLibc, close(_)).Times(AnyNumber());
+	// The file must be closed before it is removed
+	Expectation closeFile = EXPECT_CALL(*g_mockLibc, close(kFileFd)).WillOnce(Return(0));
+	EXPECT_CALL(*g_mockFilesystem, remove(fs::path(kFileIncPath), _)).After(closeFile).WillOnce(Return(true));
+
+	ASSERT_THAT(store->Write(kUrl, kFileContent, sizeof(kFileContent)), TSB::Status::NO_SPACE);
+}
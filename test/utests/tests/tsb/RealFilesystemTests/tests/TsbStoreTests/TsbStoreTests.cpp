@@ -24,6 +24,7 @@
 #include <fstream>
 #include <chrono>
 #include <cstring>
+#include <vector>
 
 #include "TsbApi.h"
 
@@ -256,3 +257,246 @@ TEST_F(TsbStoreTests, SecondSequentialInstanceSameLocationSuccess)
 	// that the Store location was unlocked when the first instance was destructed, above.
 	EXPECT_NO_THROW(mTsbStore = new TSB::Store(tsbConfig, TsbLogger, kTestLoggerData, TSB::LogLevel::TRACE));
 }
+
+class TsbStorePosixTests : public TsbStoreTests
+{
+protected:
+	void SetUp() override
+	{
+		std::filesystem::create_directories(TSB_BASE_LOCATION);
+		char templatebuf[] = TSB_LOCATION_TEMPLATE;
+		mTsbLocation = mkdtemp(templatebuf);
+
+		TSB::Store::Config tsbConfig{mTsbLocation, kMinFreePercent, kMaxCapacity, TSB::IoBackend::POSIX, kDirectIoThreshold};
+		mTsbStore = new TSB::Store(tsbConfig, TsbLogger, kTestLoggerData, TSB::LogLevel::TRACE);
+
+		EXPECT_TRUE(WaitForFlush(mTsbLocation + "/0"));
+	}
+
+	static constexpr uint32_t kDirectIoThreshold{64 * 1024};
+};
+
+TEST_F(TsbStorePosixTests, WriteReadDelete)
+{
+	std::vector<char> readBuffer(sizeof(kFileContent));
+
+	EXPECT_EQ(writeOperation(kUrl), TSB::Status::OK);
+	EXPECT_EQ(writeOperation(kUrl), TSB::Status::ALREADY_EXISTS);
+	EXPECT_EQ(mTsbStore->GetSize(kUrl), sizeof(kFileContent));
+	EXPECT_EQ(mTsbStore->Read(kUrl, readBuffer.data(), readBuffer.size()), TSB::Status::OK);
+	EXPECT_EQ(std::memcmp(readBuffer.data(), kFileContent, sizeof(kFileContent)), 0);
+
+	mTsbStore->Delete(kUrl);
+	EXPECT_FALSE(fs::exists(mTsbLocation + "/1/" + kFile));
+	EXPECT_EQ(mTsbStore->GetSize(kUrl), 0);
+	EXPECT_EQ(mTsbStore->Read(kUrl, readBuffer.data(), readBuffer.size()), TSB::Status::FAILED);
+
+	// The file can be written again once deleted
+	EXPECT_EQ(writeOperation(kUrl), TSB::Status::OK);
+}
+
+TEST_F(TsbStorePosixTests, CheckPermissions)
+{
+	const std::filesystem::perms fileExpectedPermissions {std::filesystem::perms::owner_read |
+														  std::filesystem::perms::owner_write |
+														  std::filesystem::perms::group_read |
+														  std::filesystem::perms::group_write |
+														  std::filesystem::perms::others_read |
+														  std::filesystem::perms::others_write};
+	mode_t oldUmask = umask(S_IRWXU);
+
+	EXPECT_EQ(writeOperation(kUrl), TSB::Status::OK);
+
+	std::filesystem::perms permissions = std::filesystem::status(mTsbLocation + "/1/" + kFile).permissions();
+	EXPECT_TRUE((permissions & std::filesystem::perms::all) == fileExpectedPermissions);
+	permissions = std::filesystem::status(mTsbLocation + "/1").permissions();
+	EXPECT_TRUE((permissions & std::filesystem::perms::all) == std::filesystem::perms::all);
+
+	umask(oldUmask);
+}
+
+TEST_F(TsbStorePosixTests, LargeSegmentDirectIo)
+{
+	// Not a multiple of the direct I/O alignment, and not aligned in memory, so both the
+	// bounce buffer and the buffered tail are exercised (or plain buffered writes, on
+	// filesystems without O_DIRECT support)
+	const std::size_t size{3 * kDirectIoThreshold + 123};
+	std::vector<char> writeBuffer(size + 1);
+	for (std::size_t i = 0; i < writeBuffer.size(); i++)
+	{
+		writeBuffer[i] = static_cast<char>(i * 7);
+	}
+	std::vector<char> readBuffer(size);
+
+	EXPECT_EQ(mTsbStore->Write(kUrl, writeBuffer.data() + 1, size), TSB::Status::OK);
+	EXPECT_EQ(fs::file_size(mTsbLocation + "/1/" + kFile), size);
+	EXPECT_EQ(mTsbStore->GetSize(kUrl), size);
+	EXPECT_EQ(mTsbStore->Read(kUrl, readBuffer.data(), size), TSB::Status::OK);
+	EXPECT_EQ(std::memcmp(readBuffer.data(), writeBuffer.data() + 1, size), 0);
+}
+
+TEST_F(TsbStorePosixTests, WriteAfterFlush)
+{
+	std::vector<char> readBuffer(sizeof(kFileContent));
+
+	EXPECT_EQ(writeOperation(kUrl), TSB::Status::OK);
+	mTsbStore->Flush();
+
+	// The segment directories are recreated in the new active directory
+	EXPECT_EQ(mTsbStore->Read(kUrl, readBuffer.data(), readBuffer.size()), TSB::Status::FAILED);
+	EXPECT_EQ(writeOperation(kUrl), TSB::Status::OK);
+	EXPECT_TRUE(fs::exists(mTsbLocation + "/2/" + kFile));
+	EXPECT_EQ(mTsbStore->Read(kUrl, readBuffer.data(), readBuffer.size()), TSB::Status::OK);
+}
+
+class TsbStorePackTests : public TsbStoreTests
+{
+protected:
+	void SetUp() override
+	{
+		std::filesystem::create_directories(TSB_BASE_LOCATION);
+		char templatebuf[] = TSB_LOCATION_TEMPLATE;
+		mTsbLocation = mkdtemp(templatebuf);
+
+		// 1 MiB pack files
+		TSB::Store::Config tsbConfig{mTsbLocation, kMinFreePercent, kMaxCapacity, TSB::IoBackend::PACK, 0, 1};
+		mTsbStore = new TSB::Store(tsbConfig, TsbLogger, kTestLoggerData, TSB::LogLevel::TRACE);
+
+		EXPECT_TRUE(WaitForFlush(mTsbLocation + "/0"));
+	}
+
+	std::string SegmentUrl(const std::string& track, int number) const
+	{
+		return "https://cdn.example.com/live/" + track + "/segment" + std::to_string(number) + ".m4s";
+	}
+
+	std::size_t CountPackFiles() const
+	{
+		std::size_t count = 0;
+		for (const auto& entry : fs::recursive_directory_iterator(mTsbLocation))
+		{
+			if (entry.is_regular_file())
+			{
+				EXPECT_EQ(entry.path().extension(), ".pack");
+				count++;
+			}
+		}
+		return count;
+	}
+
+	static constexpr std::size_t kSegmentSize{300 * 1024};
+};
+
+TEST_F(TsbStorePackTests, WriteReadDelete)
+{
+	std::vector<char> readBuffer(sizeof(kFileContent));
+
+	EXPECT_EQ(writeOperation(kUrl), TSB::Status::OK);
+	EXPECT_EQ(writeOperation(kUrl), TSB::Status::ALREADY_EXISTS);
+	EXPECT_EQ(mTsbStore->GetSize(kUrl), sizeof(kFileContent));
+	EXPECT_EQ(mTsbStore->Read(kUrl, readBuffer.data(), readBuffer.size()), TSB::Status::OK);
+	EXPECT_EQ(std::memcmp(readBuffer.data(), kFileContent, sizeof(kFileContent)), 0);
+
+	// No file per segment, and no directories per URL
+	EXPECT_FALSE(fs::exists(mTsbLocation + "/1/" + kFile));
+	EXPECT_EQ(CountPackFiles(), 1u);
+
+	mTsbStore->Delete(kUrl);
+	EXPECT_EQ(mTsbStore->GetSize(kUrl), 0u);
+	EXPECT_EQ(mTsbStore->Read(kUrl, readBuffer.data(), readBuffer.size()), TSB::Status::FAILED);
+	EXPECT_EQ(CountPackFiles(), 0u);
+}
+
+TEST_F(TsbStorePackTests, RollAndCullPacks)
+{
+	// Interleave two tracks, each of which gets its own sequence of packs
+	std::vector<char> segment(kSegmentSize);
+	const int kSegmentsPerTrack{10};
+	for (int i = 0; i < kSegmentsPerTrack; i++)
+	{
+		std::memset(segment.data(), 'v' + i, segment.size());
+		EXPECT_EQ(mTsbStore->Write(SegmentUrl("video", i), segment.data(), segment.size()), TSB::Status::OK);
+		std::memset(segment.data(), 'a' + i, segment.size());
+		EXPECT_EQ(mTsbStore->Write(SegmentUrl("audio", i), segment.data(), segment.size()), TSB::Status::OK);
+	}
+	// 3 segments per 1 MiB pack
+	const std::size_t kPacksPerTrack{(kSegmentsPerTrack + 2) / 3};
+	EXPECT_EQ(CountPackFiles(), 2 * kPacksPerTrack);
+
+	std::vector<char> readBuffer(kSegmentSize);
+	for (int i = 0; i < kSegmentsPerTrack; i++)
+	{
+		EXPECT_EQ(mTsbStore->Read(SegmentUrl("video", i), readBuffer.data(), readBuffer.size()), TSB::Status::OK);
+		EXPECT_EQ(readBuffer[0], static_cast<char>('v' + i));
+		EXPECT_EQ(readBuffer[kSegmentSize - 1], static_cast<char>('v' + i));
+	}
+
+	// Culling the oldest video segments frees their pack once all of them are gone
+	mTsbStore->Delete(SegmentUrl("video", 0));
+	mTsbStore->Delete(SegmentUrl("video", 1));
+	EXPECT_EQ(CountPackFiles(), 2 * kPacksPerTrack);
+	mTsbStore->Delete(SegmentUrl("video", 2));
+	EXPECT_EQ(CountPackFiles(), 2 * kPacksPerTrack - 1);
+
+	EXPECT_EQ(mTsbStore->Read(SegmentUrl("audio", 0), readBuffer.data(), readBuffer.size()), TSB::Status::OK);
+	EXPECT_EQ(readBuffer[0], 'a');
+	EXPECT_EQ(mTsbStore->Read(SegmentUrl("video", 3), readBuffer.data(), readBuffer.size()), TSB::Status::OK);
+	EXPECT_EQ(readBuffer[0], static_cast<char>('v' + 3));
+}
+
+TEST_F(TsbStorePackTests, WriteAfterFlush)
+{
+	std::vector<char> readBuffer(sizeof(kFileContent));
+
+	EXPECT_EQ(writeOperation(kUrl), TSB::Status::OK);
+	mTsbStore->Flush();
+	EXPECT_TRUE(WaitForFlush(mTsbLocation + "/1"));
+
+	EXPECT_EQ(mTsbStore->Read(kUrl, readBuffer.data(), readBuffer.size()), TSB::Status::FAILED);
+	EXPECT_EQ(writeOperation(kUrl), TSB::Status::OK);
+	EXPECT_EQ(mTsbStore->Read(kUrl, readBuffer.data(), readBuffer.size()), TSB::Status::OK);
+	EXPECT_EQ(CountPackFiles(), 1u);
+}
+
+class TsbStorePackDirectIoTests : public TsbStorePackTests
+{
+protected:
+	void SetUp() override
+	{
+		std::filesystem::create_directories(TSB_BASE_LOCATION);
+		char templatebuf[] = TSB_LOCATION_TEMPLATE;
+		mTsbLocation = mkdtemp(templatebuf);
+
+		// 1 MiB capacity, which is also the pack file size
+		TSB::Store::Config tsbConfig{mTsbLocation, kMinFreePercent, 1, TSB::IoBackend::PACK, kDirectIoThreshold};
+		mTsbStore = new TSB::Store(tsbConfig, TsbLogger, kTestLoggerData, TSB::LogLevel::TRACE);
+
+		EXPECT_TRUE(WaitForFlush(mTsbLocation + "/0"));
+	}
+
+	static constexpr std::size_t kCapacity{1024 * 1024};
+	static constexpr uint32_t kDirectIoThreshold{64 * 1024};
+	static constexpr std::size_t kAlignment{4096};
+};
+
+TEST_F(TsbStorePackDirectIoTests, AlignmentPaddingCountsAgainstCapacity)
+{
+	const std::size_t kSmallSize{100};
+	const std::size_t kAvailable{70000};
+	// The first segment of a pack is not padded
+	std::vector<char> filler(kCapacity - kSmallSize - kAvailable, 'f');
+	EXPECT_EQ(mTsbStore->Write(SegmentUrl("audio", 0), filler.data(), filler.size()), TSB::Status::OK);
+	std::vector<char> small(kSmallSize, 's');
+	EXPECT_EQ(mTsbStore->Write(SegmentUrl("video", 0), small.data(), small.size()), TSB::Status::OK);
+
+	// Fits in the available space, but not once it is moved to the next block boundary
+	std::vector<char> large(kAvailable - 2000, 'l');
+	ASSERT_GT(large.size() + kAlignment - kSmallSize, kAvailable);
+	EXPECT_EQ(mTsbStore->Write(SegmentUrl("video", 1), large.data(), large.size()), TSB::Status::NO_SPACE);
+	EXPECT_EQ(mTsbStore->GetSize(SegmentUrl("video", 1)), 0u);
+
+	// The capacity is still enforced
+	std::vector<char> oversized(kAvailable + 1, 'o');
+	EXPECT_EQ(mTsbStore->Write(SegmentUrl("text", 0), oversized.data(), oversized.size()), TSB::Status::NO_SPACE);
+	EXPECT_EQ(mTsbStore->Write(SegmentUrl("text", 0), large.data(), large.size()), TSB::Status::OK);
+}
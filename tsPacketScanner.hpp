@@ -0,0 +1,185 @@
+/*
+ * If not stated otherwise in this file or this component's license file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2024 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/**
+* @file tsPacketScanner.hpp
+* @brief Batched extraction of MPEG-2 TS packet header fields
+*/
+
+#ifndef __TSPACKETSCANNER_HPP__
+#define __TSPACKETSCANNER_HPP__
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#include <arm_neon.h>
+#define TS_SCAN_NEON
+#endif
+
+#define TS_SYNC_BYTE (0x47)
+#define TS_SCAN_BATCH (64)	/**< Packets scanned per batch; headers of a batch stay in L1 */
+
+/**
+ * @brief Header fields of one TS packet, packed in 32 bits
+ *
+ * bits 0-12 hold the PID, bit 16 the payload_unit_start_indicator and bits 24-31 the fourth
+ * header byte: transport_scrambling_control, adaptation_field_control and continuity_counter.
+ */
+typedef uint32_t TSPacketHeader;
+
+/**
+ * @brief Get the PID of a scanned packet
+ */
+static inline int TSHeaderPid(TSPacketHeader header)
+{
+	return (int)(header & 0x1FFF);
+}
+
+/**
+ * @brief Check the payload_unit_start_indicator of a scanned packet
+ */
+static inline bool TSHeaderPayloadStart(TSPacketHeader header)
+{
+	return (header & 0x10000) != 0;
+}
+
+/**
+ * @brief Get the adaptation_field_control of a scanned packet; bit 0 payload present, bit 1 adaptation field present
+ */
+static inline int TSHeaderAdaptation(TSPacketHeader header)
+{
+	return (int)((header >> 28) & 0x3);
+}
+
+/**
+ * @brief Get the continuity_counter of a scanned packet
+ */
+static inline int TSHeaderContinuity(TSPacketHeader header)
+{
+	return (int)((header >> 24) & 0xF);
+}
+
+/**
+ * @brief Get the transport_scrambling_control of a scanned packet
+ */
+static inline int TSHeaderScrambling(TSPacketHeader header)
+{
+	return (int)(header >> 30);
+}
+
+/**
+ * @brief Pack the first four bytes of a packet, loaded as a little endian word, into a TSPacketHeader
+ */
+static inline TSPacketHeader TSPackHeaderWord(uint32_t word)
+{
+	return (word & 0x1F00) | ((word >> 16) & 0xFF) | ((word & 0x4000) << 2) | (word & 0xFF000000);
+}
+
+/**
+ * @brief Extract the header fields of a run of TS packets
+ *
+ * Packets are stride bytes apart, so the four header bytes of each packet are gathered with
+ * one unaligned load and four packets are masked and checked for sync in each vector step.
+ * Headers are extracted for all packets, including any that fail the sync check.
+ *
+ * @param[in] packet - first byte of the first packet
+ * @param[in] count - number of packets to scan
+ * @param[in] stride - distance between packets, 188 or 192 with timestamp prefix
+ * @param[out] headers - receives count packed headers
+ * @retval index of the first packet without sync byte, count if all are in sync
+ */
+static inline size_t ScanTSPacketHeaders(const unsigned char *packet, size_t count, size_t stride, TSPacketHeader *headers)
+{
+	size_t firstLost = count;
+	size_t i = 0;
+#if defined(__SSE2__)
+	const __m128i pidMask = _mm_set1_epi32(0x1F00);
+	const __m128i byteMask = _mm_set1_epi32(0xFF);
+	const __m128i startMask = _mm_set1_epi32(0x4000);
+	const __m128i flagsMask = _mm_set1_epi32((int)0xFF000000);
+	const __m128i sync = _mm_set1_epi32(TS_SYNC_BYTE);
+	for (; i + 4 <= count; i += 4)
+	{
+		uint32_t words[4];
+		for (int j = 0; j < 4; j++)
+		{
+			memcpy(&words[j], packet + (i + j) * stride, sizeof(uint32_t));
+		}
+		__m128i word = _mm_loadu_si128((const __m128i *)words);
+		__m128i header = _mm_or_si128(
+			_mm_or_si128(_mm_and_si128(word, pidMask), _mm_and_si128(_mm_srli_epi32(word, 16), byteMask)),
+			_mm_or_si128(_mm_slli_epi32(_mm_and_si128(word, startMask), 2), _mm_and_si128(word, flagsMask)));
+		_mm_storeu_si128((__m128i *)(headers + i), header);
+		int inSync = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(word, byteMask), sync)));
+		if ((inSync != 0xF) && (firstLost == count))
+		{
+			firstLost = i + __builtin_ctz(~inSync & 0xF);
+		}
+	}
+#elif defined(TS_SCAN_NEON)
+	const uint32x4_t pidMask = vdupq_n_u32(0x1F00);
+	const uint32x4_t byteMask = vdupq_n_u32(0xFF);
+	const uint32x4_t startMask = vdupq_n_u32(0x4000);
+	const uint32x4_t flagsMask = vdupq_n_u32(0xFF000000);
+	const uint32x4_t sync = vdupq_n_u32(TS_SYNC_BYTE);
+	for (; i + 4 <= count; i += 4)
+	{
+		uint32_t words[4];
+		for (int j = 0; j < 4; j++)
+		{
+			memcpy(&words[j], packet + (i + j) * stride, sizeof(uint32_t));
+		}
+		uint32x4_t word = vld1q_u32(words);
+		uint32x4_t header = vorrq_u32(
+			vorrq_u32(vandq_u32(word, pidMask), vandq_u32(vshrq_n_u32(word, 16), byteMask)),
+			vorrq_u32(vshlq_n_u32(vandq_u32(word, startMask), 2), vandq_u32(word, flagsMask)));
+		vst1q_u32(headers + i, header);
+		uint32x4_t inSync = vceqq_u32(vandq_u32(word, byteMask), sync);
+		uint32x2_t half = vand_u32(vget_low_u32(inSync), vget_high_u32(inSync));
+		if (((vget_lane_u32(half, 0) & vget_lane_u32(half, 1)) == 0) && (firstLost == count))
+		{
+			for (int j = 0; j < 4; j++)
+			{
+				if (packet[(i + j) * stride] != TS_SYNC_BYTE)
+				{
+					firstLost = i + j;
+					break;
+				}
+			}
+		}
+	}
+#endif
+	for (; i < count; i++)
+	{
+		const unsigned char *p = packet + i * stride;
+		uint32_t word = (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+		headers[i] = TSPackHeaderWord(word);
+		if ((p[0] != TS_SYNC_BYTE) && (firstLost == count))
+		{
+			firstLost = i;
+		}
+	}
+	return firstLost;
+}
+
+#endif /* __TSPACKETSCANNER_HPP__ */
@@ -51,6 +51,19 @@ enum class LogLevel
 	ERROR  /**< Operation cannot continue, e.g. invalid arguments or filesystem error. */
 };
 
+/**
+ * @brief Filesystem I/O backends supported by the TSB Store
+ */
+enum class IoBackend
+{
+	STREAM, /**< C++ file streams, one open/write/close per segment. */
+	POSIX,  /**< File descriptors with exclusive create, cached descriptors for recently written
+	             segments, cached directories and optional preallocated direct I/O. */
+	PACK    /**< As POSIX, but segments are appended to large pack files, one sequence of packs
+	             per URL directory, with an in-memory index. A pack file is deleted, and its space
+	             reclaimed, once all segments in it have been deleted. */
+};
+
 /**
  *  @fn Logging callback
  *
@@ -112,6 +125,32 @@ public:
 		 *        Example: 10240
 		 */
 		uint32_t maxCapacity{0};
+
+		/**
+		 * @brief Filesystem I/O backend used to write and read segments.
+		 *
+		 *        Example: IoBackend::POSIX
+		 */
+		IoBackend ioBackend{IoBackend::STREAM};
+
+		/**
+		 * @brief Segments of at least this many bytes are preallocated and written with
+		 *        O_DIRECT, bypassing the page cache, when the POSIX backend is used.
+		 *        Falls back to buffered writes if the filesystem does not support O_DIRECT.
+		 *        0 disables direct I/O.
+		 *
+		 *        Example: 262144
+		 */
+		uint32_t directIoThreshold{0};
+
+		/**
+		 * @brief Size at which a pack file is closed and a new one started, in mebibytes,
+		 *        when the PACK backend is used. Limited to 1/16 of the capacity, so that
+		 *        space is reclaimed in reasonably small steps. 0 selects the default (32 MiB).
+		 *
+		 *        Example: 32
+		 */
+		uint32_t packFileSize{0};
 	};
 
 	/**
@@ -21,6 +21,11 @@
 #include <atomic>
 #include <cerrno>
 #include <cstring>
+#include <cstdlib>
+#include <list>
+#include <unordered_set>
+#include <unordered_map>
+#include <algorithm>
 
 #include "TsbApi.h"
 #include "TsbLog.h"
@@ -29,10 +34,47 @@
 #include "TsbFs.h"
 
 #define TSB_BYTES_IN_MIB    (1024 * 1024)
+#define TSB_FILE_CACHE_SIZE         16      // Descriptors of recently written segments kept open for reads
+#define TSB_MAX_CREATED_DIRS        1024    // Bound on the created directories cache, cleared when reached
+#define TSB_DIRECT_IO_ALIGNMENT     4096    // Buffer, offset and length alignment of O_DIRECT writes
+#define TSB_MAX_PACK_LANES          8       // URL directories appended to concurrently, e.g. one per track
+#define TSB_DEFAULT_PACK_FILE_SIZE  (32 * TSB_BYTES_IN_MIB)
+#define TSB_MIN_PACK_FILE_SIZE      TSB_BYTES_IN_MIB
+#define TSB_PACK_FILE_EXT           ".pack"
+#define TSB_FILE_MODE   (S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP | S_IROTH | S_IWOTH)
 
 using namespace TSB;
 using namespace std::chrono_literals;
 
+/**
+ * @brief Owner of an open file descriptor, closed when the last reference is dropped.
+ *        Shared between the file cache and readers, so that a segment deleted while it
+ *        is being read remains readable until the read completes.
+ */
+class FileDescriptor
+{
+public:
+	explicit FileDescriptor(int fd) : mFd(fd)
+	{
+	}
+
+	~FileDescriptor()
+	{
+		(void)FS::close(mFd);
+	}
+
+	FileDescriptor(const FileDescriptor&) = delete;
+	FileDescriptor& operator=(const FileDescriptor&) = delete;
+
+	int Get() const
+	{
+		return mFd;
+	}
+
+private:
+	const int mFd;
+};
+
 class TSB::StoreImpl
 {
 public:
@@ -55,6 +97,8 @@ private:
 	const FS::path mLocation;
 	const uint32_t mMinFreePercent;
 	const uintmax_t mMaxCapacity;         // Expressed in bytes
+	const IoBackend mIoBackend;
+	const std::size_t mDirectIoThreshold; // Expressed in bytes, 0 if direct I/O is disabled
 	uintmax_t mCapacity{0};               // Expressed in bytes
 	uintmax_t mAvailable{0};              // Expressed in bytes
 	std::atomic_uint32_t mFlushDirNum;	  // This variable is atomic because it can be accessed from multiple threads
@@ -63,12 +107,63 @@ private:
 	std::thread mFlusherThread{};
 	Sem mFlusherSem{};
 	std::unique_ptr<LocationLock> mLocationLock{};
+	// POSIX backend state. mCreatedDirs and mDirectIoBuffer are protected by mApiMutex
+	std::unordered_set<std::string> mCreatedDirs{};
+	std::unique_ptr<char, decltype(&std::free)> mDirectIoBuffer{nullptr, &std::free};
+	std::size_t mDirectIoBufferSize{0};
+	mutable std::mutex mFileCacheMutex{};
+	mutable std::list<std::pair<std::string, std::shared_ptr<FileDescriptor>>> mFileCache{}; // Most recently used first
+
+	// PACK backend state, modified with both mApiMutex and mPackMutex held, read with either
+	struct PackEntry
+	{
+		uint32_t pack{0};      // Pack file number
+		off_t offset{0};       // Offset of the segment in the pack file
+		std::size_t size{0};   // Segment size
+	};
+	struct PackFile
+	{
+		std::string path{};
+		off_t size{0};                              // Bytes appended, including alignment padding
+		uint32_t liveCount{0};                      // Segments not deleted yet
+		std::shared_ptr<FileDescriptor> file{};     // Set while segments are appended to the pack
+	};
+	struct PackLane
+	{
+		uint32_t pack{0};      // Pack file currently appended to
+		uint64_t lastWrite{0}; // Write sequence number of the last append
+	};
+	uintmax_t mPackFileSize{0};           // Expressed in bytes
+	uint32_t mNextPackNum{0};
+	uint64_t mPackWriteCount{0};
+	mutable std::mutex mPackMutex{};
+	std::unordered_map<std::string, PackEntry> mPackIndex{};  // Segment path to location in a pack file
+	std::unordered_map<uint32_t, PackFile> mPackFiles{};
+	std::unordered_map<std::string, PackLane> mPackLanes{};   // Segment directory to pack lane
 
 	static std::string SanitizePath(const std::string &);
 	Status UrlToFileMapper(const std::string& url, FS::path& path) const;
 	void Flusher(void);
 	bool CreateDirectoriesWithPermissions(const std::filesystem::path& path);
 	Status WriteBuffer(const FS::path& path, const void* buffer, std::size_t size, bool retry);
+	Status WriteBufferPosix(const FS::path& path, const void* buffer, std::size_t size, bool retry);
+	Status GetWriteErrorStatus(int err, const FS::path& path, std::size_t size, bool& retry,
+							   std::chrono::milliseconds& timeWaited);
+	int WriteFile(int fd, const void* buffer, std::size_t size, off_t fileOffset);
+	std::size_t WriteFileDirect(int fd, const char* buffer, std::size_t size, off_t fileOffset, int& err);
+	Status ReadBufferPosix(const FS::path& path, void* buffer, std::size_t size) const;
+	int ReadFile(int fd, void* buffer, std::size_t size, off_t fileOffset) const;
+	Status WriteBufferPack(const FS::path& path, const void* buffer, std::size_t size, bool retry);
+	PackFile* GetPackForWrite(const std::string& lane, std::size_t size);
+	PackFile* CreatePack(const std::string& lane);
+	Status ReadBufferPack(const FS::path& path, void* buffer, std::size_t size) const;
+	bool FindPackEntry(const FS::path& path, PackEntry& entry, std::string& packPath) const;
+	void DeletePackEntry(const FS::path& path);
+	bool CreateSegmentDirectories(const FS::path& path);
+	std::shared_ptr<FileDescriptor> FindCachedFile(const FS::path& path) const;
+	void CacheFile(const FS::path& path, std::shared_ptr<FileDescriptor> file) const;
+	void UncacheFile(const FS::path& path);
+	void ClearFileCache();
 	uintmax_t GetCapacityMinFree(uintmax_t capacity) const;
 	FS::space_info GetFilesystemSpace() const;
 };
@@ -263,13 +358,16 @@ StoreImpl::StoreImpl(const Store::Config& config, LogFunction logger, int logger
 					mLocation(SanitizePath(config.location)),
 					mMinFreePercent(config.minFreePercentage),
 					mMaxCapacity(static_cast<uintmax_t>(config.maxCapacity) * TSB_BYTES_IN_MIB),
+					mIoBackend(config.ioBackend),
+					mDirectIoThreshold(config.directIoThreshold),
 					mFlushDirNum(0),
 					mActiveDirNum(1)
 {
 	std::error_code ec;
 
 	TSB_LOG_TRACE(mLogger, "Construct Store", "location", config.location, "minFreePercentage",
-				  mMinFreePercent, "maxCapacity", mMaxCapacity);
+				  mMinFreePercent, "maxCapacity", mMaxCapacity, "ioBackend", static_cast<int>(mIoBackend),
+				  "directIoThreshold", mDirectIoThreshold);
 
 	if (!mLocation.is_absolute())
 	{
@@ -323,11 +421,19 @@ StoreImpl::StoreImpl(const Store::Config& config, LogFunction logger, int logger
 	{
 		mCapacity = std::min(mMaxCapacity, GetCapacityMinFree(s.capacity));
 		mAvailable = mCapacity;
+		if (mIoBackend == IoBackend::PACK)
+		{
+			uintmax_t packFileSize = (config.packFileSize != 0) ?
+									 (static_cast<uintmax_t>(config.packFileSize) * TSB_BYTES_IN_MIB) :
+									 TSB_DEFAULT_PACK_FILE_SIZE;
+			mPackFileSize = std::max<uintmax_t>(std::min<uintmax_t>(packFileSize, mCapacity / 16),
+												TSB_MIN_PACK_FILE_SIZE);
+		}
 		mFlusherThread = std::thread(&StoreImpl::Flusher, this);
 		mFlusherSem.Post();
 		TSB_LOG_MIL(mLogger, "Store Constructed", "instance", this,
 					"location", mLocation, "availableSpace", mAvailable,
-					"activeDirNum", mActiveDirNum.load());
+					"activeDirNum", mActiveDirNum.load(), "packFileSize", mPackFileSize);
 	}
 }
 
@@ -351,7 +457,7 @@ Status StoreImpl::Read(const std::string &url, void *buffer, std::size_t size) c
 	{
 		TSB_LOG_ERROR(mLogger, "Could not map URL to a file", "segmentUrl", url);
 	}
-	else if (!FS::exists(path))
+	else if ((mIoBackend == IoBackend::STREAM) && !FS::exists(path))
 	{
 		TSB_LOG_WARN(mLogger, "File does not exist", "file", path);
 	}
@@ -363,6 +469,14 @@ Status StoreImpl::Read(const std::string &url, void *buffer, std::size_t size) c
 	{
 		TSB_LOG_ERROR(mLogger, "Size is 0");
 	}
+	else if (mIoBackend == IoBackend::POSIX)
+	{
+		returnStatus = ReadBufferPosix(path, buffer, size);
+	}
+	else if (mIoBackend == IoBackend::PACK)
+	{
+		returnStatus = ReadBufferPack(path, buffer, size);
+	}
 	else
 	{
 		FS::ifstream stream;
@@ -501,11 +615,15 @@ Status StoreImpl::Write(const std::string& url, const void* buffer, std::size_t
 	auto returnStatus = Status::FAILED;
 	std::error_code ec;
 	FS::path path;
+	PackEntry entry;
+	std::string packPath;
 	if (UrlToFileMapper(url, path) != Status::OK)
 	{
 		TSB_LOG_ERROR(mLogger, "Could not map URL to a file", "segmentUrl", url);
 	}
-	else if (FS::exists(path))
+	// The POSIX backend detects an existing file when creating it exclusively
+	else if (((mIoBackend == IoBackend::STREAM) && FS::exists(path)) ||
+			 ((mIoBackend == IoBackend::PACK) && FindPackEntry(path, entry, packPath)))
 	{
 		TSB_LOG_TRACE(mLogger, "File already exists", "path", path);
 		returnStatus = Status::ALREADY_EXISTS;
@@ -525,7 +643,8 @@ Status StoreImpl::Write(const std::string& url, const void* buffer, std::size_t
 						"availableSpace", mAvailable);
 		returnStatus = Status::NO_SPACE;
 	}
-	else if (!CreateDirectoriesWithPermissions(path.parent_path()))
+	// Pack files are all in the active directory, created with the first pack
+	else if ((mIoBackend != IoBackend::PACK) && !CreateSegmentDirectories(path.parent_path()))
 	{
 		TSB_LOG_ERROR(mLogger, "Failed to create directory", "directory", path.parent_path());
 	}
@@ -538,7 +657,18 @@ Status StoreImpl::Write(const std::string& url, const void* buffer, std::size_t
 			// Write during Flush
 			retry = true;
 		}
-		returnStatus = WriteBuffer(path, buffer, size, retry);
+		if (mIoBackend == IoBackend::POSIX)
+		{
+			returnStatus = WriteBufferPosix(path, buffer, size, retry);
+		}
+		else if (mIoBackend == IoBackend::PACK)
+		{
+			returnStatus = WriteBufferPack(path, buffer, size, retry);
+		}
+		else
+		{
+			returnStatus = WriteBuffer(path, buffer, size, retry);
+		}
 	}
 
 	return returnStatus;
@@ -548,10 +678,31 @@ std::size_t StoreImpl::GetSize(const std::string& url) const
 {
 	std::size_t returnSize = 0;
 	FS::path path;
+	std::shared_ptr<FileDescriptor> file;
+	struct stat fileStat{};
+	PackEntry entry;
+	std::string packPath;
 	if (UrlToFileMapper(url, path) != Status::OK)
 	{
 		TSB_LOG_ERROR(mLogger, "Could not map URL to a file", "segmentUrl", url);
 	}
+	else if (mIoBackend == IoBackend::PACK)
+	{
+		if (FindPackEntry(path, entry, packPath))
+		{
+			TSB_LOG_TRACE(mLogger, "Got size", "file", path, "segmentSize", entry.size);
+			returnSize = entry.size;
+		}
+		else
+		{
+			TSB_LOG_WARN(mLogger, "File does not exist", "path", path);
+		}
+	}
+	else if ((file = FindCachedFile(path)) && (FS::fstat(file->Get(), &fileStat) == 0))
+	{
+		TSB_LOG_TRACE(mLogger, "Got size", "file", path, "segmentSize", fileStat.st_size);
+		returnSize = static_cast<std::size_t>(fileStat.st_size);
+	}
 	else if (!FS::exists(path))
 	{
 		TSB_LOG_WARN(mLogger, "File does not exist", "path", path);
@@ -581,6 +732,10 @@ void StoreImpl::Delete(const std::string& url)
 	{
 		TSB_LOG_ERROR(mLogger, "Could not map URL to a file", "segmentUrl", url);
 	}
+	else if (mIoBackend == IoBackend::PACK)
+	{
+		DeletePackEntry(path);
+	}
 	else if (!FS::exists(path))
 	{
 		// File probably deleted already, so TRACE log only
@@ -589,6 +744,7 @@ void StoreImpl::Delete(const std::string& url)
 	else
 	{
 		std::error_code ec;
+		UncacheFile(path);
 		std::uintmax_t size = FS::file_size(path, ec);
 		if (size == static_cast<std::uintmax_t>(-1))
 		{
@@ -614,6 +770,14 @@ void StoreImpl::Flush()
 		uintmax_t oldAvailable = mAvailable;
 		uint32_t oldActiveDirNum = mActiveDirNum.fetch_add(1);
 		mAvailable = mCapacity;
+		mCreatedDirs.clear();
+		ClearFileCache();
+		{
+			std::lock_guard<std::mutex> packLock(mPackMutex);
+			mPackIndex.clear();
+			mPackFiles.clear();
+		}
+		mPackLanes.clear();
 
 		TSB_LOG_MIL(mLogger, "Flush triggered", "oldActiveDirNum", oldActiveDirNum,
 					"oldAvailableSpace", oldAvailable, "activeDirNum", (oldActiveDirNum + 1),
@@ -644,3 +808,704 @@ FS::space_info StoreImpl::GetFilesystemSpace() const
 				  "available", spaceInfo.available);
 	return spaceInfo;
 }
+
+/*	@fn		CreateSegmentDirectories
+	@brief	Creates the directory of a segment, if needed
+
+	The POSIX backend remembers the directories it created in the active directory, so that
+	segments after the first one in a directory are written without checking every path component.
+
+	@param[in] path - 	The directory to create
+	@retval		true 	If the directory exists
+*/
+bool StoreImpl::CreateSegmentDirectories(const FS::path& path)
+{
+	bool success = true;
+
+	if (mIoBackend == IoBackend::STREAM)
+	{
+		success = CreateDirectoriesWithPermissions(path);
+	}
+	else if (mCreatedDirs.find(path.native()) == mCreatedDirs.end())
+	{
+		success = CreateDirectoriesWithPermissions(path);
+		if (success)
+		{
+			if (mCreatedDirs.size() >= TSB_MAX_CREATED_DIRS)
+			{
+				mCreatedDirs.clear();
+			}
+			mCreatedDirs.insert(path.native());
+		}
+	}
+	return success;
+}
+
+/*	@fn		WriteBufferPosix
+	@brief	Writes a segment file using a file descriptor
+
+	Same retry and NO_SPACE semantics as WriteBuffer. The file is created exclusively, so an
+	existing file is reported without a separate existence check, and its descriptor is kept
+	in the file cache on success, for the reads that typically follow shortly after.
+
+	@retval		OK, NO_SPACE, ALREADY_EXISTS or FAILED
+*/
+Status StoreImpl::WriteBufferPosix(const FS::path& path, const void* buffer, std::size_t size, bool retry)
+{
+	auto status = Status::FAILED;
+	auto timeWaited = 0ms;
+
+	do
+	{
+		int fd = FS::open(path.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, TSB_FILE_MODE);
+		if (fd < 0)
+		{
+			retry = false;
+			if (errno == EEXIST)
+			{
+				TSB_LOG_TRACE(mLogger, "File already exists", "path", path);
+				status = Status::ALREADY_EXISTS;
+			}
+			else
+			{
+				TSB_LOG_ERROR(mLogger, "Failed to open the file", "file", path, "errno", std::strerror(errno));
+			}
+		}
+		else
+		{
+			auto file = std::make_shared<FileDescriptor>(fd);
+
+			// Set read and write permissions for all, regardless of umask. This is necessary so other
+			// AAMP instances can delete the file, in case the first instance does not exit cleanly.
+			if (FS::fchmod(fd, TSB_FILE_MODE) != 0)
+			{
+				retry = false;
+				TSB_LOG_ERROR(mLogger, "Failed to set permissions", "file", path, "errno", std::strerror(errno));
+			}
+			else
+			{
+				int err = WriteFile(fd, buffer, size, 0);
+				if (err == 0)
+				{
+					mAvailable -= size;
+					TSB_LOG_TRACE(mLogger, "File written", "file", path,
+									"fileSize", size, "availableSpace", mAvailable);
+					retry = false;
+					status = Status::OK;
+					CacheFile(path, std::move(file));
+				}
+				else
+				{
+					status = GetWriteErrorStatus(err, path, size, retry, timeWaited);
+				}
+			}
+
+			if (status != Status::OK)
+			{
+				std::error_code ec;
+
+				// Remove the partially written file to allow retries - either by TSB, or its client.
+				file.reset();
+				if (!FS::remove(path, ec))
+				{
+					TSB_LOG_WARN(mLogger, "Error deleting file", "file", path, "errorCode", ec);
+				}
+			}
+		}
+	} while (retry);
+
+	return status;
+}
+
+/*	@fn		GetWriteErrorStatus
+	@brief	Maps a failed file descriptor write to a status, with the same retry and timeout
+			semantics as WriteBuffer. Sleeps before returning if the write is to be retried.
+
+	@param[in] err - 				errno of the failure
+	@param[in,out] retry - 			true if the write may be retried, cleared if it must not
+	@param[in,out] timeWaited - 	time spent retrying so far
+	@retval		NO_SPACE or FAILED
+*/
+Status StoreImpl::GetWriteErrorStatus(int err, const FS::path& path, std::size_t size, bool& retry,
+									  std::chrono::milliseconds& timeWaited)
+{
+	auto status = Status::FAILED;
+	constexpr auto timeout = 5000ms;
+	constexpr auto sleepTime = 2ms;
+
+	if ((timeWaited >= timeout) && (err == ENOSPC))
+	{
+		retry = false;
+		TSB_LOG_ERROR(mLogger, "Not enough space to write - timed out", "file", path, "timeout", timeout.count());
+		status = Status::NO_SPACE;
+	}
+	else if (timeWaited >= timeout)
+	{
+		retry = false;
+		TSB_LOG_ERROR(mLogger, "Failed to write - timed out", "file", path, "timeout", timeout.count(),
+						"errno", std::strerror(err));
+	}
+	else if (retry && (err == ENOSPC))
+	{
+		TSB_LOG_TRACE(mLogger, "Not enough space to write - retrying...",
+						"sleepTime", sleepTime.count(),
+						"fileSize", size,
+						"available", mAvailable,
+						"errno", std::strerror(err));
+		FS::sleep_for(sleepTime);
+		timeWaited += sleepTime;
+	}
+	else if (err == ENOSPC)
+	{
+		// This is a TRACE only, as the client can cull (delete files) and retry the Write
+		TSB_LOG_TRACE(mLogger, "Not enough space to write", "file", path,
+						"size", size);
+		status = Status::NO_SPACE;
+	}
+	else
+	{
+		retry = false;
+		TSB_LOG_ERROR(mLogger, "Failed to write to file", "file", path,
+						"size", size, "errno", std::strerror(err));
+	}
+	return status;
+}
+
+/*	@fn		WriteFile
+	@brief	Writes the whole buffer to an open file, at the given offset
+
+	Segments of at least mDirectIoThreshold bytes are preallocated, so that ENOSPC is reported
+	before any data is written and the filesystem can allocate the segment contiguously, and
+	then written with O_DIRECT as far as the alignment constraints allow.
+
+	@retval		0 on success, otherwise the errno of the failure
+*/
+int StoreImpl::WriteFile(int fd, const void* buffer, std::size_t size, off_t fileOffset)
+{
+	int err = 0;
+	const char* data = static_cast<const char *>(buffer);
+	std::size_t offset = 0;
+
+	if ((mDirectIoThreshold != 0) && (size >= mDirectIoThreshold))
+	{
+		// Not every filesystem supports preallocation, in which case the blocks are allocated on write
+		if ((FS::fallocate(fd, 0, fileOffset, static_cast<off_t>(size)) != 0) && (errno == ENOSPC))
+		{
+			err = ENOSPC;
+		}
+		else if ((fileOffset % TSB_DIRECT_IO_ALIGNMENT) == 0)
+		{
+			offset = WriteFileDirect(fd, data, size, fileOffset, err);
+		}
+	}
+
+	while ((err == 0) && (offset < size))
+	{
+		ssize_t written = FS::pwrite(fd, data + offset, size - offset, fileOffset + static_cast<off_t>(offset));
+		if (written > 0)
+		{
+			offset += static_cast<std::size_t>(written);
+		}
+		else if (written == 0)
+		{
+			err = EIO;
+		}
+		else if (errno != EINTR)
+		{
+			err = errno;
+		}
+	}
+	return err;
+}
+
+/*	@fn		WriteFileDirect
+	@brief	Writes the block aligned head of the buffer with O_DIRECT
+
+	The file offset must be block aligned. The buffer is staged through an aligned bounce buffer,
+	unless already suitably aligned.
+	The descriptor is switched back to buffered I/O before returning, for the unaligned tail
+	and for subsequent reads of the cached descriptor.
+
+	@param[out] err - errno of a failure that must not be retried with buffered I/O, else 0
+	@retval		Number of bytes written, 0 if direct I/O is not supported
+*/
+std::size_t StoreImpl::WriteFileDirect(int fd, const char* buffer, std::size_t size, off_t fileOffset, int& err)
+{
+	std::size_t offset = 0;
+	const std::size_t alignedSize = size & ~static_cast<std::size_t>(TSB_DIRECT_IO_ALIGNMENT - 1);
+	const char* data = buffer;
+	int flags = FS::fcntl(fd, F_GETFL);
+
+	err = 0;
+	if ((alignedSize != 0) && (flags >= 0))
+	{
+		if ((reinterpret_cast<uintptr_t>(buffer) % TSB_DIRECT_IO_ALIGNMENT) != 0)
+		{
+			if (mDirectIoBufferSize < alignedSize)
+			{
+				void* mem = nullptr;
+				mDirectIoBuffer.reset();
+				mDirectIoBufferSize = 0;
+				if (posix_memalign(&mem, TSB_DIRECT_IO_ALIGNMENT, alignedSize) == 0)
+				{
+					mDirectIoBuffer.reset(static_cast<char *>(mem));
+					mDirectIoBufferSize = alignedSize;
+				}
+			}
+			data = mDirectIoBuffer.get();
+			if (data)
+			{
+				std::memcpy(mDirectIoBuffer.get(), buffer, alignedSize);
+			}
+		}
+
+		// Filesystems without O_DIRECT support (e.g. tmpfs) reject the flag; the segment is then written buffered
+		if (data && (FS::fcntl(fd, F_SETFL, flags | O_DIRECT) == 0))
+		{
+			while ((err == 0) && (offset < alignedSize))
+			{
+				ssize_t written = FS::pwrite(fd, data + offset, alignedSize - offset, fileOffset + static_cast<off_t>(offset));
+				if (written > 0)
+				{
+					offset += static_cast<std::size_t>(written);
+				}
+				else if ((written == 0) || (errno == EINVAL))
+				{
+					// Rejected by the device, leave the rest to buffered I/O
+					break;
+				}
+				else if (errno != EINTR)
+				{
+					err = errno;
+				}
+			}
+			// Any unaligned remainder of a short write is completed with buffered I/O
+			(void)FS::fcntl(fd, F_SETFL, flags);
+		}
+	}
+	return offset;
+}
+
+/*	@fn		ReadBufferPosix
+	@brief	Reads a segment file using a file descriptor, from the file cache if available
+
+	@retval		OK or FAILED
+*/
+Status StoreImpl::ReadBufferPosix(const FS::path& path, void* buffer, std::size_t size) const
+{
+	auto status = Status::FAILED;
+	std::shared_ptr<FileDescriptor> file = FindCachedFile(path);
+
+	if (!file)
+	{
+		int fd = FS::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+		if (fd >= 0)
+		{
+			file = std::make_shared<FileDescriptor>(fd);
+		}
+		else if (errno == ENOENT)
+		{
+			TSB_LOG_WARN(mLogger, "File does not exist", "file", path);
+		}
+		else
+		{
+			TSB_LOG_ERROR(mLogger, "Failed to open the file", "file", path, "errno", std::strerror(errno));
+		}
+	}
+
+	if (file)
+	{
+		int err = ReadFile(file->Get(), buffer, size, 0);
+		if (err != 0)
+		{
+			TSB_LOG_ERROR(mLogger, "Failed to read file", "file", path, "size", size, "errno", std::strerror(err));
+		}
+		else
+		{
+			TSB_LOG_TRACE(mLogger, "File Read", "file", path, "size", size);
+			status = Status::OK;
+		}
+	}
+	return status;
+}
+
+/*	@fn		ReadFile
+	@brief	Reads size bytes from an open file, at the given offset
+
+	@retval		0 on success, otherwise the errno of the failure (EIO if the file is too short)
+*/
+int StoreImpl::ReadFile(int fd, void* buffer, std::size_t size, off_t fileOffset) const
+{
+	char* data = static_cast<char *>(buffer);
+	std::size_t offset = 0;
+	int err = 0;
+
+	while ((err == 0) && (offset < size))
+	{
+		ssize_t bytesRead = FS::pread(fd, data + offset, size - offset, fileOffset + static_cast<off_t>(offset));
+		if (bytesRead > 0)
+		{
+			offset += static_cast<std::size_t>(bytesRead);
+		}
+		else if (bytesRead == 0)
+		{
+			err = EIO;
+		}
+		else if (errno != EINTR)
+		{
+			err = errno;
+		}
+	}
+	return err;
+}
+
+/*	@fn		WriteBufferPack
+	@brief	Appends a segment to the pack file of its URL directory
+
+	Same retry and NO_SPACE semantics as WriteBuffer. The space used by a segment is only
+	returned to mAvailable when its whole pack file is deleted, see DeletePackEntry.
+
+	@retval		OK, NO_SPACE or FAILED
+*/
+Status StoreImpl::WriteBufferPack(const FS::path& path, const void* buffer, std::size_t size, bool retry)
+{
+	auto status = Status::FAILED;
+	auto timeWaited = 0ms;
+	const std::string lane{path.parent_path().native()};
+
+	do
+	{
+		PackFile* pack = GetPackForWrite(lane, size);
+		if (pack == nullptr)
+		{
+			retry = false;
+		}
+		else
+		{
+			off_t offset = pack->size;
+			if ((mDirectIoThreshold != 0) && (size >= mDirectIoThreshold))
+			{
+				// Start large segments on a block boundary, so they can be written with O_DIRECT
+				offset = (offset + TSB_DIRECT_IO_ALIGNMENT - 1) & ~static_cast<off_t>(TSB_DIRECT_IO_ALIGNMENT - 1);
+			}
+
+			// Write checked the segment size only, the alignment padding is taken from mAvailable too
+			uintmax_t required = static_cast<uintmax_t>(offset - pack->size) + size;
+			if (required > mAvailable)
+			{
+				// As in Write, the client can cull and retry
+				TSB_LOG_TRACE(mLogger, "Not Enough space to write", "file", path, "fileSize", size,
+								"padding", offset - pack->size, "availableSpace", mAvailable);
+				retry = false;
+				status = Status::NO_SPACE;
+			}
+			else
+			{
+				int err = WriteFile(pack->file->Get(), buffer, size, offset);
+				if (err == 0)
+				{
+					off_t packSize = offset + static_cast<off_t>(size);
+					mAvailable -= static_cast<uintmax_t>(packSize - pack->size);
+					{
+						std::lock_guard<std::mutex> lock(mPackMutex);
+						pack->size = packSize;
+						pack->liveCount++;
+						mPackIndex[path.native()] = PackEntry{mPackLanes[lane].pack, offset, size};
+					}
+					TSB_LOG_TRACE(mLogger, "File written", "file", path, "pack", pack->path, "offset", offset,
+									"fileSize", size, "availableSpace", mAvailable);
+					retry = false;
+					status = Status::OK;
+				}
+				else
+				{
+					// Release anything written past the end of the pack, it is not referenced by the index
+					(void)FS::ftruncate(pack->file->Get(), pack->size);
+					status = GetWriteErrorStatus(err, path, size, retry, timeWaited);
+				}
+			}
+		}
+	} while (retry);
+
+	return status;
+}
+
+/*	@fn		GetPackForWrite
+	@brief	Gets the pack file to append a segment of the given size to, for a URL directory.
+			A new pack is started when the segment does not fit the current one.
+
+	@retval		Pack file, nullptr on failure
+*/
+StoreImpl::PackFile* StoreImpl::GetPackForWrite(const std::string& lane, std::size_t size)
+{
+	PackFile* pack = nullptr;
+	auto laneIt = mPackLanes.find(lane);
+
+	if (laneIt != mPackLanes.end())
+	{
+		auto packIt = mPackFiles.find(laneIt->second.pack);
+		if ((packIt != mPackFiles.end()) && packIt->second.file)
+		{
+			if ((packIt->second.size == 0) ||
+				((static_cast<uintmax_t>(packIt->second.size) + size) <= mPackFileSize))
+			{
+				pack = &packIt->second;
+				laneIt->second.lastWrite = ++mPackWriteCount;
+			}
+			else
+			{
+				// Full, segments remain readable through the file cache until the pack is deleted
+				packIt->second.file.reset();
+			}
+		}
+	}
+
+	if (pack == nullptr)
+	{
+		pack = CreatePack(lane);
+	}
+	return pack;
+}
+
+/*	@fn		CreatePack
+	@brief	Creates a new pack file in the active directory and makes it current for a URL directory
+
+	@retval		Pack file, nullptr on failure
+*/
+StoreImpl::PackFile* StoreImpl::CreatePack(const std::string& lane)
+{
+	PackFile* pack = nullptr;
+	const uint32_t packNum = mNextPackNum++;
+	const FS::path dir{mLocation / std::to_string(mActiveDirNum.load())};
+	const FS::path packPath{dir / (std::to_string(packNum) + TSB_PACK_FILE_EXT)};
+
+	if (!CreateSegmentDirectories(dir))
+	{
+		TSB_LOG_ERROR(mLogger, "Failed to create directory", "directory", dir);
+	}
+	else
+	{
+		int fd = FS::open(packPath.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, TSB_FILE_MODE);
+		if (fd < 0)
+		{
+			TSB_LOG_ERROR(mLogger, "Failed to open the file", "file", packPath, "errno", std::strerror(errno));
+		}
+		else
+		{
+			auto file = std::make_shared<FileDescriptor>(fd);
+
+			// Set read and write permissions for all, as for segment files in the other backends
+			if (FS::fchmod(fd, TSB_FILE_MODE) != 0)
+			{
+				TSB_LOG_ERROR(mLogger, "Failed to set permissions", "file", packPath, "errno", std::strerror(errno));
+				file.reset();
+				std::error_code ec;
+				(void)FS::remove(packPath, ec);
+			}
+			else
+			{
+				if ((mPackLanes.find(lane) == mPackLanes.end()) && (mPackLanes.size() >= TSB_MAX_PACK_LANES))
+				{
+					// Stop appending to the least recently written directory, e.g. a track no longer downloaded
+					auto oldest = std::min_element(mPackLanes.begin(), mPackLanes.end(),
+												   [](const std::pair<const std::string, PackLane>& a,
+													  const std::pair<const std::string, PackLane>& b)
+												   { return a.second.lastWrite < b.second.lastWrite; });
+					auto packIt = mPackFiles.find(oldest->second.pack);
+					if (packIt != mPackFiles.end())
+					{
+						packIt->second.file.reset();
+					}
+					mPackLanes.erase(oldest);
+				}
+
+				CacheFile(packPath, file);
+				{
+					std::lock_guard<std::mutex> lock(mPackMutex);
+					PackFile& newPack = mPackFiles[packNum];
+					newPack.path = packPath.native();
+					newPack.file = std::move(file);
+					pack = &newPack;
+				}
+				mPackLanes[lane] = PackLane{packNum, ++mPackWriteCount};
+				TSB_LOG_TRACE(mLogger, "Pack file created", "file", packPath, "directory", lane);
+			}
+		}
+	}
+	return pack;
+}
+
+/*	@fn		ReadBufferPack
+	@brief	Reads a segment from its pack file
+
+	@retval		OK or FAILED
+*/
+Status StoreImpl::ReadBufferPack(const FS::path& path, void* buffer, std::size_t size) const
+{
+	auto status = Status::FAILED;
+	PackEntry entry;
+	std::string packPath;
+
+	if (!FindPackEntry(path, entry, packPath))
+	{
+		TSB_LOG_WARN(mLogger, "File does not exist", "file", path);
+	}
+	else if (size > entry.size)
+	{
+		TSB_LOG_ERROR(mLogger, "Failed to read file", "file", path, "size", size, "fileSize", entry.size);
+	}
+	else
+	{
+		std::shared_ptr<FileDescriptor> file = FindCachedFile(packPath);
+		if (!file)
+		{
+			int fd = FS::open(packPath.c_str(), O_RDONLY | O_CLOEXEC);
+			if (fd < 0)
+			{
+				// The segment may have been deleted meanwhile, taking the pack with it
+				TSB_LOG_ERROR(mLogger, "Failed to open the file", "file", packPath, "errno", std::strerror(errno));
+			}
+			else
+			{
+				file = std::make_shared<FileDescriptor>(fd);
+				CacheFile(packPath, file);
+			}
+		}
+
+		if (file)
+		{
+			int err = ReadFile(file->Get(), buffer, size, entry.offset);
+			if (err != 0)
+			{
+				TSB_LOG_ERROR(mLogger, "Failed to read file", "file", path, "pack", packPath, "size", size,
+							  "errno", std::strerror(err));
+			}
+			else
+			{
+				TSB_LOG_TRACE(mLogger, "File Read", "file", path, "pack", packPath, "offset", entry.offset, "size", size);
+				status = Status::OK;
+			}
+		}
+	}
+	return status;
+}
+
+/*	@fn		FindPackEntry
+	@brief	Looks up the location of a segment in the pack files
+
+	@param[out] entry - 	Location of the segment
+	@param[out] packPath - 	Path of the pack file holding the segment
+	@retval		true if the segment is stored
+*/
+bool StoreImpl::FindPackEntry(const FS::path& path, PackEntry& entry, std::string& packPath) const
+{
+	bool found = false;
+	std::lock_guard<std::mutex> lock(mPackMutex);
+	auto it = mPackIndex.find(path.native());
+
+	if (it != mPackIndex.end())
+	{
+		auto packIt = mPackFiles.find(it->second.pack);
+		if (packIt != mPackFiles.end())
+		{
+			entry = it->second;
+			packPath = packIt->second.path;
+			found = true;
+		}
+	}
+	return found;
+}
+
+/*	@fn		DeletePackEntry
+	@brief	Removes a segment from the index, and deletes its pack file once no segment in it remains
+*/
+void StoreImpl::DeletePackEntry(const FS::path& path)
+{
+	bool deletePack = false;
+	std::string packPath;
+	off_t packSize = 0;
+
+	{
+		std::lock_guard<std::mutex> lock(mPackMutex);
+		auto it = mPackIndex.find(path.native());
+		if (it == mPackIndex.end())
+		{
+			// File probably deleted already, so TRACE log only
+			TSB_LOG_TRACE(mLogger, "File does not exist", "path", path);
+		}
+		else
+		{
+			auto packIt = mPackFiles.find(it->second.pack);
+			TSB_LOG_TRACE(mLogger, "Deleted file", "file", path, "fileSize", it->second.size);
+			mPackIndex.erase(it);
+			if ((packIt != mPackFiles.end()) && (--packIt->second.liveCount == 0))
+			{
+				deletePack = true;
+				packPath = packIt->second.path;
+				packSize = packIt->second.size;
+				mPackFiles.erase(packIt);
+			}
+		}
+	}
+
+	if (deletePack)
+	{
+		std::error_code ec;
+
+		UncacheFile(packPath);
+		if (!FS::remove(packPath, ec))
+		{
+			TSB_LOG_WARN(mLogger, "Error deleting file", "file", packPath, "errorCode", ec);
+		}
+		else
+		{
+			mAvailable += static_cast<uintmax_t>(packSize);
+			TSB_LOG_TRACE(mLogger, "Deleted pack file", "file", packPath, "fileSize", packSize,
+						  "availableSpace", mAvailable);
+		}
+	}
+}
+
+std::shared_ptr<FileDescriptor> StoreImpl::FindCachedFile(const FS::path& path) const
+{
+	std::shared_ptr<FileDescriptor> file;
+	std::lock_guard<std::mutex> lock(mFileCacheMutex);
+
+	for (const auto& entry : mFileCache)
+	{
+		if (entry.first == path.native())
+		{
+			file = entry.second;
+			break;
+		}
+	}
+	return file;
+}
+
+void StoreImpl::CacheFile(const FS::path& path, std::shared_ptr<FileDescriptor> file) const
+{
+	std::lock_guard<std::mutex> lock(mFileCacheMutex);
+
+	mFileCache.remove_if([&path](const std::pair<std::string, std::shared_ptr<FileDescriptor>>& entry)
+						 { return entry.first == path.native(); });
+	mFileCache.emplace_front(path.native(), std::move(file));
+	if (mFileCache.size() > TSB_FILE_CACHE_SIZE)
+	{
+		mFileCache.pop_back();
+	}
+}
+
+void StoreImpl::UncacheFile(const FS::path& path)
+{
+	std::lock_guard<std::mutex> lock(mFileCacheMutex);
+
+	mFileCache.remove_if([&path](const std::pair<std::string, std::shared_ptr<FileDescriptor>>& entry)
+						 { return entry.first == path.native(); });
+}
+
+void StoreImpl::ClearFileCache()
+{
+	std::lock_guard<std::mutex> lock(mFileCacheMutex);
+
+	mFileCache.clear();
+}
@@ -26,6 +26,7 @@
 #include <fcntl.h>
 #include <unistd.h>
 #include <sys/file.h>
+#include <sys/stat.h>
 
 namespace TSB
 {
@@ -54,6 +55,13 @@ using std::this_thread::sleep_for;
 using ::open;
 using ::close;
 using ::flock;
+using ::pread;
+using ::pwrite;
+using ::fstat;
+using ::fchmod;
+using ::fcntl;
+using ::fallocate;
+using ::ftruncate;
 
 } // namespace FS
 
@@ -42,6 +42,7 @@
 
 #include <iomanip>
 #include <unordered_set>
+#include <algorithm>
 
 #define PACKET_SIZE (188)
 #define MAX_PACKET_SIZE (208)
@@ -208,6 +209,10 @@ TSProcessor::TSProcessor(class PrivateInstanceAAMP *aamp,StreamOperation streamO
 	memset(m_SPS, 0, 32 * sizeof(H264SPS));
 	memset(m_PPS, 0, 256 * sizeof(H264PPS));
 	m_versionPMT = 0;
+	memset(m_pidRoles, ePID_ROLE_OTHER, sizeof(m_pidRoles));
+	m_pidRoles[0] = ePID_ROLE_PAT;
+	m_pidRolesPmtPid = m_pidRolesVideoPid = m_pidRolesPcrPid = -1;
+	updatePidRoles();
 
 	if ((m_streamOperation == eStreamOp_DEMUX_ALL) || (m_streamOperation == eStreamOp_DEMUX_VIDEO) || (m_streamOperation == eStreamOp_DEMUX_VIDEO_AND_AUX))
 	{
@@ -985,6 +990,43 @@ bool TSProcessor::throttle()
 	return aborted;
 }
 
+/**
+ * @brief Refresh m_pidRoles after the PMT, video or PCR PID changed
+ */
+void TSProcessor::updatePidRoles()
+{
+	if ((m_pidRolesPmtPid == m_pmtPid) && (m_pidRolesVideoPid == m_videoPid) && (m_pidRolesPcrPid == m_pcrPid))
+	{
+		return;
+	}
+	int oldPids[] = { m_pidRolesVideoPid, m_pidRolesPcrPid, m_pidRolesPmtPid };
+	for (int oldPid : oldPids)
+	{
+		if ((oldPid >= 0) && (oldPid < 0x2000))
+		{
+			m_pidRoles[oldPid] = ePID_ROLE_OTHER;
+		}
+	}
+	// Assigned in reverse order of precedence; PAT wins over PMT, which wins over video and PCR
+	if ((m_videoPid >= 0) && (m_videoPid < 0x2000))
+	{
+		m_pidRoles[m_videoPid] = ePID_ROLE_VIDEO;
+	}
+	if ((m_pcrPid >= 0) && (m_pcrPid < 0x2000))
+	{
+		m_pidRoles[m_pcrPid] = ePID_ROLE_VIDEO;
+	}
+	if ((m_pmtPid >= 0) && (m_pmtPid < 0x2000))
+	{
+		m_pidRoles[m_pmtPid] = ePID_ROLE_PMT;
+	}
+	m_pidRoles[0] = ePID_ROLE_PAT;
+	m_pidRolesPmtPid = m_pmtPid;
+	m_pidRolesVideoPid = m_videoPid;
+	m_pidRolesPcrPid = m_pcrPid;
+	AAMPLOG_TRACE("pmt pid %d video pid %d pcr pid %d", m_pmtPid, m_videoPid, m_pcrPid);
+}
+
 /**
  * @brief Process buffers and update internal states related to media components
  * @retval false if operation is aborted.
@@ -996,6 +1038,10 @@ bool TSProcessor::processBuffer(unsigned char *buffer, int size, bool &insPatPmt
 	int pid, payloadStart, adaptation, payloadOffset;
 	int continuity, scramblingControl;
 	int packetCount = 0;
+	TSPacketHeader headers[TS_SCAN_BATCH];
+	int batchCount = 0;
+	int batchIndex = 0;
+	bool syncLost = false;
 	insPatPmt = false;
 	bool removePatPmt = false;
 	m_packetStartAfterFirstPTS = -1;
@@ -1032,17 +1078,33 @@ bool TSProcessor::processBuffer(unsigned char *buffer, int size, bool &insPatPmt
 		m_havePMT = false;
 	}
 
+	// PAT and PMT packets may change these; refreshed again after each one below
+	updatePidRoles();
+
 	bufferEnd = packet + size - m_ttsSize;
 	while (packet < bufferEnd)
 	{
-		pid = (((packet[1] << 8) | packet[2]) & 0x1FFF);
-		AAMPLOG_TRACE("pid = %d, m_ttsSize %d", pid, m_ttsSize);
+		if (batchIndex == batchCount)
+		{
+			// Extract the headers of the next batch up front, leaving only the PID lookup per packet
+			batchCount = (int)std::min<long>(TS_SCAN_BATCH, (bufferEnd - packet + m_packetSize - 1) / m_packetSize);
+			int firstLost = (int)ScanTSPacketHeaders(packet, batchCount, m_packetSize, headers);
+			if ((firstLost < batchCount) && !syncLost)
+			{
+				AAMPLOG_WARN("Warning: lost TS sync at offset %llx", (long long)((packetCount + firstLost) * m_packetSize));
+				syncLost = true;
+			}
+			batchIndex = 0;
+		}
+		TSPacketHeader header = headers[batchIndex++];
+		pid = TSHeaderPid(header);
+		int role = m_pidRoles[pid];
 
 		if (m_checkContinuity)
 		{
-			if ((pid != 0x1FFF) && (packet[3] & 0x10))
+			if ((pid != 0x1FFF) && (TSHeaderAdaptation(header) & 0x01))
 			{
-				continuity = (packet[3] & 0x0F);
+				continuity = TSHeaderContinuity(header);
 				int expected = m_continuityCounters[pid];
 				expected = ((expected + 1) & 0xF); //CID:94829 - No effect
 				if (expected != continuity)
@@ -1055,9 +1117,9 @@ bool TSProcessor::processBuffer(unsigned char *buffer, int size, bool &insPatPmt
 			}
 		}
 
-		if (pid == 0)
+		if (role == ePID_ROLE_PAT)
 		{
-			adaptation = ((packet[3] & 0x30) >> 4);
+			adaptation = TSHeaderAdaptation(header);
 			if (adaptation & 0x01)
 			{
 				payloadOffset = 4;
@@ -1067,7 +1129,7 @@ bool TSProcessor::processBuffer(unsigned char *buffer, int size, bool &insPatPmt
 					payloadOffset += (1 + packet[4]);
 				}
 
-				payloadStart = (packet[1] & 0x40);
+				payloadStart = TSHeaderPayloadStart(header);
 				if (payloadStart)
 				{
 					int tableid = packet[payloadOffset + 1];
@@ -1161,10 +1223,10 @@ bool TSProcessor::processBuffer(unsigned char *buffer, int size, bool &insPatPmt
 				packet[2] = 0xFF;
 			}
 		}
-		else if (pid == m_pmtPid)
+		else if (role == ePID_ROLE_PMT)
 		{
 			AAMPLOG_TRACE("Got PMT : m_pmtPid %d", m_pmtPid);
-			adaptation = ((packet[3] & 0x30) >> 4);
+			adaptation = TSHeaderAdaptation(header);
 			if (adaptation & 0x01)
 			{
 				payloadOffset = 4;
@@ -1174,7 +1236,7 @@ bool TSProcessor::processBuffer(unsigned char *buffer, int size, bool &insPatPmt
 					payloadOffset += (1 + packet[4]);
 				}
 
-				payloadStart = (packet[1] & 0x40);
+				payloadStart = TSHeaderPayloadStart(header);
 				if (payloadStart)
 				{
 					int tableid = packet[payloadOffset + 1];
@@ -1304,16 +1366,16 @@ bool TSProcessor::processBuffer(unsigned char *buffer, int size, bool &insPatPmt
 				packet[2] = 0xFF;
 			}
 		}
-		else if ((pid == m_videoPid) || (pid == m_pcrPid))
+		else if (role == ePID_ROLE_VIDEO)
 		{
 
 			if ((m_actualStartPTS == -1LL) && doThrottle)
 			{
 				payloadOffset = 4;
-				adaptation = ((packet[3] & 0x30) >> 4);
-				payloadStart = (packet[1] & 0x40);
+				adaptation = TSHeaderAdaptation(header);
+				payloadStart = TSHeaderPayloadStart(header);
 
-				scramblingControl = ((packet[3] & 0xC0) >> 6);
+				scramblingControl = TSHeaderScrambling(header);
 				if (scramblingControl)
 				{
 					if (!m_scrambledWarningIssued)
@@ -1425,6 +1487,10 @@ bool TSProcessor::processBuffer(unsigned char *buffer, int size, bool &insPatPmt
 		}
 
 	done:
+		if ((role == ePID_ROLE_PAT) || (role == ePID_ROLE_PMT))
+		{
+			updatePidRoles();
+		}
 		packet += m_packetSize;
 		++packetCount;
 	}
@@ -1512,10 +1578,21 @@ bool TSProcessor::demuxAndSend(const void *ptr, size_t len, double position, dou
 
 	std::unordered_set<Demuxer*> updated_demuxers{};
 	const unsigned char * packetStart = (const unsigned char *)ptr;
+	TSPacketHeader headers[TS_SCAN_BATCH];
+	int batchCount = 0;
+	int batchIndex = 0;
+	int discardedCount = 0;
 	while (len >= PACKET_SIZE)
 	{
+		if (batchIndex == batchCount)
+		{
+			batchCount = (int)std::min<size_t>(TS_SCAN_BATCH, len / PACKET_SIZE);
+			(void)ScanTSPacketHeaders(packetStart, batchCount, PACKET_SIZE, headers);
+			batchIndex = 0;
+		}
+		TSPacketHeader header = headers[batchIndex++];
 		Demuxer* demuxer = NULL;
-		int pid = (packetStart[1] & 0x1f) << 8 | packetStart[2];
+		int pid = TSHeaderPid(header);
 		bool dsmccDemuxerUsed = false;
 
 		if (m_vidDemuxer && (pid == videoPid))
@@ -1535,7 +1612,7 @@ bool TSProcessor::demuxAndSend(const void *ptr, size_t len, double position, dou
 		if ((discontinuous || !m_demuxInitialized ) && !firstPcr && (pid == m_pcrPid))
 		{
 			int adaptation_fieldlen = 0;
-			if ((packetStart[3] & 0x20) == 0x20)
+			if (TSHeaderAdaptation(header) & 0x02)
 			{
 				adaptation_fieldlen = packetStart[4];
 				if (0 != adaptation_fieldlen && (packetStart[5] & 0x10))
@@ -1647,13 +1724,18 @@ bool TSProcessor::demuxAndSend(const void *ptr, size_t len, double position, dou
 			}
 			else
 			{
-				AAMPLOG_INFO("demuxAndSend : discarded packet with pid %d", pid);
+				AAMPLOG_TRACE("demuxAndSend : discarded packet with pid %d", pid);
+				discardedCount++;
 			}
 		}
 
 		packetStart += PACKET_SIZE;
 		len -= PACKET_SIZE;
 	}
+	if (discardedCount)
+	{
+		AAMPLOG_INFO("demuxAndSend : discarded %d packets of other pids", discardedCount);
+	}
 
 	for (auto demuxer : updated_demuxers)
 	{
@@ -28,6 +28,7 @@
 #include "mediaprocessor.h"
 #include "ID3Metadata.hpp"
 #include "uint33_t.h"
+#include "tsPacketScanner.hpp"
 #include "main_aamp.h"
 #include <stdio.h>
 #include <mutex>
@@ -89,6 +90,18 @@ typedef enum
 	ePC_Track_Both 		/**< Demux and send audio and video*/
 }TrackToDemux;
 
+/**
+ * @enum TSPidRole
+ * @brief Handling of a PID in TSProcessor::processBuffer
+ */
+typedef enum
+{
+	ePID_ROLE_OTHER,	/**< Not used by the processor; nulled out in trick modes */
+	ePID_ROLE_PAT,		/**< Program association table */
+	ePID_ROLE_PMT,		/**< Program map table of the selected program */
+	ePID_ROLE_VIDEO		/**< Video or PCR; used for throttle and re-timestamping */
+}TSPidRole;
+
 /**
 * @class TSProcessor
 * @brief MPEG TS Processor. Supports software Demuxer/ PTS re-stamping for trickmode.
@@ -444,6 +457,10 @@ class TSProcessor : public MediaProcessor
       unsigned char m_continuityCounters[8192];
       unsigned char m_pidFilter[8192];
       unsigned char m_pidFilterTrick[8192];
+      unsigned char m_pidRoles[8192];	/**< TSPidRole of each PID, refreshed by updatePidRoles */
+      int m_pidRolesPmtPid;		/**< PMT PID m_pidRoles was built for */
+      int m_pidRolesVideoPid;		/**< Video PID m_pidRoles was built for */
+      int m_pidRolesPcrPid;		/**< PCR PID m_pidRoles was built for */
 
       unsigned char *m_nullPFrame;
       int m_nullPFrameLength;
@@ -510,6 +527,11 @@ class TSProcessor : public MediaProcessor
        * @param[out] insPatPmt indicates if PAT and PMT needs to inserted
        */
       bool processBuffer(unsigned char *buffer, int size, bool &insPatPmt, bool discontinuity_pending);
+      /**
+       * @fn updatePidRoles
+       * @brief Refresh m_pidRoles after the PMT, video or PCR PID changed
+       */
+      void updatePidRoles();
       /**
        * @fn getCurrentTime
        */